@@ -37,6 +37,7 @@
 #define PCL_COMMON_CENTROID_H_
 
 #include <pcl/point_cloud.h>
+#include <pcl/point_cloud_soa.h>
 #include <pcl/ros/point_traits.h>
 #include <pcl/PointIndices.h>
 
@@ -58,6 +59,15 @@ namespace pcl
   template <typename PointT> inline void 
   compute3DCentroid (const pcl::PointCloud<PointT> &cloud, Eigen::Vector4f &centroid);
 
+  /** 
+   * \brief Compute the 3D (X-Y-Z) centroid of a set of points and return it as a 3D vector.
+   * \param cloud the input point cloud in structure-of-arrays layout (only the x, y and z columns are read)
+   * \param centroid the output centroid
+   * \ingroup common
+   */
+  template <typename PointT> inline void 
+  compute3DCentroid (const pcl::PointCloudSoA<PointT> &cloud, Eigen::Vector4f &centroid);
+
   /** \brief Compute the 3D (X-Y-Z) centroid of a set of points using their indices and 
     * return it as a 3D vector.
     * \param cloud the input point cloud
@@ -39,6 +39,7 @@
 #define PCL_COMMON_H_
 
 #include <pcl/pcl_base.h>
+#include <pcl/point_cloud_soa.h>
 #include <cfloat>
 
 /**
@@ -118,6 +119,16 @@ namespace pcl
   getMinMax3D (const pcl::PointCloud<PointT> &cloud, 
                Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
 
+  /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions in a given pointcloud
+    * \param cloud the point cloud data in structure-of-arrays layout (only the x, y and z columns are read)
+    * \param min_pt the resultant minimum bounds (the fourth component is set to 0)
+    * \param max_pt the resultant maximum bounds (the fourth component is set to 0)
+    * \ingroup common
+    */
+  template <typename PointT> inline void 
+  getMinMax3D (const pcl::PointCloudSoA<PointT> &cloud, 
+               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
+
   /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions in a given pointcloud
     * \param cloud the point cloud data message
     * \param indices the vector of point indices to use from \a cloud
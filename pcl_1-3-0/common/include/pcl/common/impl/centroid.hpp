@@ -79,6 +79,48 @@ pcl::compute3DCentroid (const pcl::PointCloud<PointT> &cloud, Eigen::Vector4f &c
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> inline void
+pcl::compute3DCentroid (const pcl::PointCloudSoA<PointT> &cloud, Eigen::Vector4f &centroid)
+{
+  // Initialize to 0
+  centroid.setZero ();
+  if (cloud.empty ()) 
+    return;
+  const float *x = cloud.x (), *y = cloud.y (), *z = cloud.z ();
+  size_t nr_points = cloud.size ();
+  float sum_x = 0, sum_y = 0, sum_z = 0;
+  size_t cp = 0;
+
+  // If the data is dense, we don't need to check for NaN
+  if (cloud.is_dense)
+  {
+    for (size_t i = 0; i < nr_points; ++i)
+    {
+      sum_x += x[i];
+      sum_y += y[i];
+      sum_z += z[i];
+    }
+    cp = nr_points;
+  }
+  // NaN or Inf values could exist => check for them
+  else
+  {
+    for (size_t i = 0; i < nr_points; ++i)
+    {
+      // Check if the point is invalid
+      if (!pcl_isfinite (x[i]) || !pcl_isfinite (y[i]) || !pcl_isfinite (z[i]))
+        continue;
+      sum_x += x[i];
+      sum_y += y[i];
+      sum_z += z[i];
+      cp++;
+    }
+  }
+  centroid = Eigen::Vector4f (sum_x, sum_y, sum_z, 0);
+  centroid /= cp;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> inline void
 pcl::compute3DCentroid (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices,
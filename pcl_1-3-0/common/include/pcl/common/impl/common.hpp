@@ -274,6 +274,42 @@ pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, Eigen::Vector4f &min_pt,
   max_pt = max_p;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> inline void
+pcl::getMinMax3D (const pcl::PointCloudSoA<PointT> &cloud, Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt)
+{
+  float min_x = FLT_MAX, min_y = FLT_MAX, min_z = FLT_MAX;
+  float max_x = -FLT_MAX, max_y = -FLT_MAX, max_z = -FLT_MAX;
+  const float *x = cloud.x (), *y = cloud.y (), *z = cloud.z ();
+  size_t nr_points = cloud.size ();
+
+  // If the data is dense, we don't need to check for NaN
+  if (cloud.is_dense)
+  {
+    for (size_t i = 0; i < nr_points; ++i)
+    {
+      min_x = (std::min) (min_x, x[i]); max_x = (std::max) (max_x, x[i]);
+      min_y = (std::min) (min_y, y[i]); max_y = (std::max) (max_y, y[i]);
+      min_z = (std::min) (min_z, z[i]); max_z = (std::max) (max_z, z[i]);
+    }
+  }
+  // NaN or Inf values could exist => check for them
+  else
+  {
+    for (size_t i = 0; i < nr_points; ++i)
+    {
+      // Check if the point is invalid
+      if (!pcl_isfinite (x[i]) || !pcl_isfinite (y[i]) || !pcl_isfinite (z[i]))
+        continue;
+      min_x = (std::min) (min_x, x[i]); max_x = (std::max) (max_x, x[i]);
+      min_y = (std::min) (min_y, y[i]); max_y = (std::max) (max_y, y[i]);
+      min_z = (std::min) (min_z, z[i]); max_z = (std::max) (max_z, z[i]);
+    }
+  }
+  min_pt = Eigen::Vector4f (min_x, min_y, min_z, 0);
+  max_pt = Eigen::Vector4f (max_x, max_y, max_z, 0);
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> inline void
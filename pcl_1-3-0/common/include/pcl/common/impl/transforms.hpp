@@ -35,53 +35,138 @@
  */
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> void
-pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
-                          pcl::PointCloud<PointT> &cloud_out,
-                          const Eigen::Affine3f &transform)
+inline
+pcl::detail::Transformer::Transformer (const Eigen::Matrix4f &tf)
 {
-  if (&cloud_in != &cloud_out)
-  {
-    // Note: could be replaced by cloud_out = cloud_in
-    cloud_out.header   = cloud_in.header;
-    cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.width    = cloud_in.width;
-    cloud_out.height   = cloud_in.height;
-    cloud_out.points.reserve (cloud_out.points.size ());
-    cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
-  }
+#if defined(__SSE__)
+  for (int i = 0; i < 4; ++i)
+    c_[i] = _mm_setr_ps (tf (0, i), tf (1, i), tf (2, i), 0.0f);
+  union { unsigned int i[4]; float f[4]; } w_mask = {{0, 0, 0, 0xffffffff}};
+  w_mask_ = _mm_loadu_ps (w_mask.f);
+#else
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 3; ++j)
+      c_[i][j] = tf (j, i);
+#endif
+}
 
-  if (cloud_in.is_dense)
-  {
-    // If the dataset is dense, simply transform it!
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-      cloud_out.points[i].getVector3fMap () = transform * 
-                                              cloud_in.points[i].getVector3fMap ();
-  }
-  else
+//////////////////////////////////////////////////////////////////////////////////////////////
+inline void
+pcl::detail::Transformer::se3 (const float *src, float *tgt) const
+{
+#if defined(__SSE__)
+  __m128 p = _mm_loadu_ps (src);
+  __m128 r = _mm_add_ps (_mm_mul_ps (c_[0], _mm_shuffle_ps (p, p, _MM_SHUFFLE (0, 0, 0, 0))),
+                         _mm_mul_ps (c_[1], _mm_shuffle_ps (p, p, _MM_SHUFFLE (1, 1, 1, 1))));
+  r = _mm_add_ps (r, _mm_mul_ps (c_[2], _mm_shuffle_ps (p, p, _MM_SHUFFLE (2, 2, 2, 2))));
+  r = _mm_add_ps (r, c_[3]);
+  // Keep the fourth element of the record
+  _mm_storeu_ps (tgt, _mm_or_ps (_mm_andnot_ps (w_mask_, r), _mm_and_ps (w_mask_, p)));
+#else
+  float x = src[0], y = src[1], z = src[2];
+  for (int j = 0; j < 3; ++j)
+    tgt[j] = c_[0][j] * x + c_[1][j] * y + c_[2][j] * z + c_[3][j];
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+inline void
+pcl::detail::Transformer::so3 (const float *src, float *tgt) const
+{
+#if defined(__SSE__)
+  __m128 p = _mm_loadu_ps (src);
+  __m128 r = _mm_add_ps (_mm_mul_ps (c_[0], _mm_shuffle_ps (p, p, _MM_SHUFFLE (0, 0, 0, 0))),
+                         _mm_mul_ps (c_[1], _mm_shuffle_ps (p, p, _MM_SHUFFLE (1, 1, 1, 1))));
+  r = _mm_add_ps (r, _mm_mul_ps (c_[2], _mm_shuffle_ps (p, p, _MM_SHUFFLE (2, 2, 2, 2))));
+  // Keep the fourth element of the record
+  _mm_storeu_ps (tgt, _mm_or_ps (_mm_andnot_ps (w_mask_, r), _mm_and_ps (w_mask_, p)));
+#else
+  float x = src[0], y = src[1], z = src[2];
+  for (int j = 0; j < 3; ++j)
+    tgt[j] = c_[0][j] * x + c_[1][j] * y + c_[2][j] * z;
+#endif
+}
+
+namespace pcl
+{
+  namespace detail
   {
-    // Dataset might contain NaNs and Infs, so check for them first,
-    // otherwise we get errors during the multiplication (?)
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
+    /** \brief Copy the header and the organization of cloud_in into cloud_out and size its points. */
+    template <typename PointT> inline void
+    prepareTransformOutput (const pcl::PointCloud<PointT> &cloud_in, pcl::PointCloud<PointT> &cloud_out)
+    {
+      cloud_out.header   = cloud_in.header;
+      cloud_out.is_dense = cloud_in.is_dense;
+      cloud_out.width    = cloud_in.width;
+      cloud_out.height   = cloud_in.height;
+      // The points themselves are copied while they are transformed
+      cloud_out.points.resize (cloud_in.points.size ());
+    }
+
+    /** \brief Transform the points of a cloud with tf and its normals with normal_tf. */
+    template <typename PointT> void
+    transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in,
+                                    pcl::PointCloud<PointT> &cloud_out,
+                                    const Transformer &tf,
+                                    const Transformer &normal_tf,
+                                    unsigned int nr_threads)
     {
-      if (!pcl_isfinite (cloud_in.points[i].x) || 
-          !pcl_isfinite (cloud_in.points[i].y) || 
-          !pcl_isfinite (cloud_in.points[i].z))
-        continue;
-      cloud_out.points[i].getVector3fMap () = transform * 
-                                              cloud_in.points[i].getVector3fMap ();
+      if (nr_threads == 0)
+        nr_threads = 1;
+      const bool copy = (&cloud_in != &cloud_out);
+      if (copy)
+        prepareTransformOutput (cloud_in, cloud_out);
+
+      // If the data is dense, we don't need to check for NaN
+      const bool check_finite = !cloud_in.is_dense;
+      int nr_points = (int)cloud_in.points.size ();
+#pragma omp parallel for schedule (static) num_threads (nr_threads)
+      for (int i = 0; i < nr_points; ++i)
+      {
+        const PointT &point_in = cloud_in.points[i];
+        PointT &point_out = cloud_out.points[i];
+        if (copy)
+          point_out = point_in;
+        if (check_finite && 
+            (!pcl_isfinite (point_in.x) || !pcl_isfinite (point_in.y) || !pcl_isfinite (point_in.z)))
+          continue;
+        tf.se3 (point_in.data, point_out.data);
+        // Rotate normals
+        normal_tf.so3 (point_in.data_n, point_out.data_n);
+      }
     }
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
+                          pcl::PointCloud<PointT> &cloud_out,
+                          const Eigen::Affine3f &transform,
+                          unsigned int nr_threads)
+{
+  transformPointCloud (cloud_in, cloud_out, transform.matrix (), nr_threads);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                           const std::vector<int> &indices, 
                           pcl::PointCloud<PointT> &cloud_out,
-                          const Eigen::Affine3f &transform)
+                          const Eigen::Affine3f &transform,
+                          unsigned int nr_threads)
 {
-  size_t npts = indices.size ();
+  if (&cloud_in == &cloud_out)
+  {
+    // The output is resized and filled in parallel, so the points must not be read from it
+    const pcl::PointCloud<PointT> cloud_copy (cloud_in);
+    transformPointCloud (cloud_copy, indices, cloud_out, transform, nr_threads);
+    return;
+  }
+  if (nr_threads == 0)
+    nr_threads = 1;
+
+  int npts = (int)indices.size ();
   // In order to transform the data, we need to remove NaNs
   cloud_out.is_dense = cloud_in.is_dense;
   cloud_out.header   = cloud_in.header;
@@ -89,26 +174,19 @@ pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in,
   cloud_out.height   = 1;
   cloud_out.points.resize (npts);
 
-  if (cloud_in.is_dense)
+  const pcl::detail::Transformer tf (transform.matrix ());
+  // Dataset might contain NaNs and Infs, so check for them first
+  const bool check_finite = !cloud_in.is_dense;
+#pragma omp parallel for schedule (static) num_threads (nr_threads)
+  for (int i = 0; i < npts; ++i)
   {
-    // If the dataset is dense, simply transform it!
-    for (size_t i = 0; i < npts; ++i)
-      cloud_out.points[i].getVector3fMap () = transform *
-                                              cloud_in.points[indices[i]].getVector3fMap ();
-  }
-  else
-  {
-    // Dataset might contain NaNs and Infs, so check for them first,
-    // otherwise we get errors during the multiplication (?)
-    for (size_t i = 0; i < npts; ++i)
-    {
-      if (!pcl_isfinite (cloud_in.points[indices[i]].x) || 
-          !pcl_isfinite (cloud_in.points[indices[i]].y) || 
-          !pcl_isfinite (cloud_in.points[indices[i]].z))
-        continue;
-      cloud_out.points[i].getVector3fMap () = transform *
-                                              cloud_in.points[indices[i]].getVector3fMap ();
-    }
+    const PointT &point_in = cloud_in.points[indices[i]];
+    PointT &point_out = cloud_out.points[i];
+    point_out = point_in;
+    if (check_finite && 
+        (!pcl_isfinite (point_in.x) || !pcl_isfinite (point_in.y) || !pcl_isfinite (point_in.z)))
+      continue;
+    tf.se3 (point_in.data, point_out.data);
   }
 }
 
@@ -116,89 +194,45 @@ pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in,
 template <typename PointT> void
 pcl::transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                      pcl::PointCloud<PointT> &cloud_out,
-                                     const Eigen::Affine3f &transform)
+                                     const Eigen::Affine3f &transform,
+                                     unsigned int nr_threads)
 {
-  if (&cloud_in != &cloud_out)
-  {
-    // Note: could be replaced by cloud_out = cloud_in
-    cloud_out.header   = cloud_in.header;
-    cloud_out.width    = cloud_in.width;
-    cloud_out.height   = cloud_in.height;
-    cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.points.reserve (cloud_out.points.size ());
-    cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
-  }
-
-  // If the data is dense, we don't need to check for NaN
-  if (cloud_in.is_dense)
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      cloud_out.points[i].getVector3fMap() = transform * 
-                                             cloud_in.points[i].getVector3fMap ();
-
-      // Rotate normals
-      cloud_out.points[i].getNormalVector3fMap() = transform.rotation () * 
-                                                   cloud_in.points[i].getNormalVector3fMap ();
-    }
-  }
-  // Dataset might contain NaNs and Infs, so check for them first.
-  else
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      if (!pcl_isfinite (cloud_in.points[i].x) || 
-          !pcl_isfinite (cloud_in.points[i].y) || 
-          !pcl_isfinite (cloud_in.points[i].z))
-        continue;
-      cloud_out.points[i].getVector3fMap() = transform * 
-                                             cloud_in.points[i].getVector3fMap ();
-
-      // Rotate normals
-      cloud_out.points[i].getNormalVector3fMap() = transform.rotation () * 
-                                                   cloud_in.points[i].getNormalVector3fMap ();
-    }
-  }
+  Eigen::Matrix4f rotation = Eigen::Matrix4f::Identity ();
+  rotation.block<3, 3> (0, 0) = transform.rotation ();
+  pcl::detail::transformPointCloudWithNormals (cloud_in, cloud_out,
+                                               pcl::detail::Transformer (transform.matrix ()),
+                                               pcl::detail::Transformer (rotation), nr_threads);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                           pcl::PointCloud<PointT> &cloud_out,
-                          const Eigen::Matrix4f &transform)
+                          const Eigen::Matrix4f &transform,
+                          unsigned int nr_threads)
 {
-  if (&cloud_in != &cloud_out)
-  {
-    // Note: could be replaced by cloud_out = cloud_in
-    cloud_out.header   = cloud_in.header;
-    cloud_out.width    = cloud_in.width;
-    cloud_out.height   = cloud_in.height;
-    cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.points.reserve (cloud_out.points.size ());
-    cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
-  }
+  if (nr_threads == 0)
+    nr_threads = 1;
+  const bool copy = (&cloud_in != &cloud_out);
+  if (copy)
+    pcl::detail::prepareTransformOutput (cloud_in, cloud_out);
 
-  Eigen::Matrix3f rot   = transform.block<3, 3> (0, 0);
-  Eigen::Vector3f trans = transform.block<3, 1> (0, 3);
+  const pcl::detail::Transformer tf (transform);
   // If the data is dense, we don't need to check for NaN
-  if (cloud_in.is_dense)
+  const bool check_finite = !cloud_in.is_dense;
+  int nr_points = (int)cloud_in.points.size ();
+  // Copy and transform in a single pass over the data
+#pragma omp parallel for schedule (static) num_threads (nr_threads)
+  for (int i = 0; i < nr_points; ++i)
   {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-      cloud_out.points[i].getVector3fMap () = rot * 
-                                              cloud_in.points[i].getVector3fMap () + trans;
-  }
-  // Dataset might contain NaNs and Infs, so check for them first.
-  else
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      if (!pcl_isfinite (cloud_in.points[i].x) || 
-          !pcl_isfinite (cloud_in.points[i].y) || 
-          !pcl_isfinite (cloud_in.points[i].z))
-        continue;
-      cloud_out.points[i].getVector3fMap () = rot * 
-                                              cloud_in.points[i].getVector3fMap () + trans;
-    }
+    const PointT &point_in = cloud_in.points[i];
+    PointT &point_out = cloud_out.points[i];
+    if (copy)
+      point_out = point_in;
+    if (check_finite && 
+        (!pcl_isfinite (point_in.x) || !pcl_isfinite (point_in.y) || !pcl_isfinite (point_in.z)))
+      continue;
+    tf.se3 (point_in.data, point_out.data);
   }
 }
 
@@ -206,51 +240,42 @@ pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in,
 template <typename PointT> void
 pcl::transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                      pcl::PointCloud<PointT> &cloud_out,
-                                     const Eigen::Matrix4f &transform)
+                                     const Eigen::Matrix4f &transform,
+                                     unsigned int nr_threads)
 {
-  if (&cloud_in != &cloud_out)
-  {
-    // Note: could be replaced by cloud_out = cloud_in
-    cloud_out.header   = cloud_in.header;
-    cloud_out.width    = cloud_in.width;
-    cloud_out.height   = cloud_in.height;
-    cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.points.reserve (cloud_out.points.size ());
-    cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
-  }
-
-  Eigen::Matrix3f rot   = transform.block<3, 3> (0, 0);
-  Eigen::Vector3f trans = transform.block<3, 1> (0, 3);
+  pcl::detail::transformPointCloudWithNormals (cloud_in, cloud_out,
+                                               pcl::detail::Transformer (transform),
+                                               pcl::detail::Transformer (transform), nr_threads);
+}
 
-  // If the data is dense, we don't need to check for NaN
-  if (cloud_in.is_dense)
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      cloud_out.points[i].getVector3fMap () = rot * 
-                                              cloud_in.points[i].getVector3fMap () + trans;
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::transformPointCloud (const pcl::PointCloudSoA<PointT> &cloud_in, 
+                          pcl::PointCloudSoA<PointT> &cloud_out,
+                          const Eigen::Matrix4f &transform,
+                          unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+    nr_threads = 1;
+  if (&cloud_in != &cloud_out)
+    cloud_out = cloud_in;
 
-      // Rotate normals
-      cloud_out.points[i].getNormalVector3fMap() = rot * 
-                                                   cloud_in.points[i].getNormalVector3fMap ();
-    }
-  }
-  // Dataset might contain NaNs and Infs, so check for them first.
-  else
+  float *x = cloud_out.x (), *y = cloud_out.y (), *z = cloud_out.z ();
+  const float r00 = transform (0, 0), r01 = transform (0, 1), r02 = transform (0, 2), t0 = transform (0, 3);
+  const float r10 = transform (1, 0), r11 = transform (1, 1), r12 = transform (1, 2), t1 = transform (1, 3);
+  const float r20 = transform (2, 0), r21 = transform (2, 1), r22 = transform (2, 2), t2 = transform (2, 3);
+  const bool check_finite = !cloud_out.is_dense;
+  int nr_points = (int)cloud_out.size ();
+#pragma omp parallel for schedule (static) num_threads (nr_threads)
+  for (int i = 0; i < nr_points; ++i)
   {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      if (!pcl_isfinite (cloud_in.points[i].x) || 
-          !pcl_isfinite (cloud_in.points[i].y) || 
-          !pcl_isfinite (cloud_in.points[i].z))
-        continue;
-      cloud_out.points[i].getVector3fMap () = rot * 
-                                              cloud_in.points[i].getVector3fMap () + trans;
-
-      // Rotate normals
-      cloud_out.points[i].getNormalVector3fMap() = rot * 
-                                                   cloud_in.points[i].getNormalVector3fMap ();
-    }
+    const float px = x[i], py = y[i], pz = z[i];
+    // Dataset might contain NaNs and Infs, so check for them first
+    if (check_finite && (!pcl_isfinite (px) || !pcl_isfinite (py) || !pcl_isfinite (pz)))
+      continue;
+    x[i] = r00 * px + r01 * py + r02 * pz + t0;
+    y[i] = r10 * px + r11 * py + r12 * pz + t1;
+    z[i] = r20 * px + r21 * py + r22 * pz + t2;
   }
 }
 
@@ -102,9 +102,10 @@ namespace pcl
       bool quit_;
       bool running_;
 
-      boost::thread timer_thread_;
       boost::condition_variable condition_;
       boost::mutex condition_mutex_;
+      // constructed last, the thread uses the members above right away
+      boost::thread timer_thread_;
   };
 }
 
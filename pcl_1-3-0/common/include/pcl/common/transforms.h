@@ -37,17 +37,55 @@
 #define PCL_TRANSFORMS_H_
 
 #include <pcl/point_cloud.h>
+#include <pcl/point_cloud_soa.h>
 #include <pcl/point_types.h>
 #include "pcl/common/centroid.h"
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 namespace pcl
 {
+  namespace detail
+  {
+    /** \brief Applies an affine transform to the first three elements of 4-float point records (xyz or
+      * normal_x/y/z), leaving the fourth element untouched. Uses one SSE register per record when available.
+      * \note src and tgt may point to the same record.
+      */
+    class Transformer
+    {
+      public:
+        /** \brief Constructor.
+          * \param[in] tf the affine transform, only the upper 3x4 block is used
+          */
+        Transformer (const Eigen::Matrix4f &tf);
+
+        /** \brief Transform a point: tgt = R * src + t. */
+        inline void
+        se3 (const float *src, float *tgt) const;
+
+        /** \brief Rotate a direction: tgt = R * src. */
+        inline void
+        so3 (const float *src, float *tgt) const;
+
+      private:
+#if defined(__SSE__)
+        __m128 c_[4];
+        __m128 w_mask_;
+#else
+        float c_[4][3];
+#endif
+    };
+  }
+
   /** \brief Apply an affine transform defined by an Eigen Transform
     * \param cloud_in the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (default: 1)
     * \note The density of the point cloud is lost, since density implies that
     * the origin is the point of view
     * \note Can be used with cloud_in equal to cloud_out
@@ -56,13 +94,15 @@ namespace pcl
   template <typename PointT> void 
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
-                       const Eigen::Affine3f &transform);
+                       const Eigen::Affine3f &transform,
+                       unsigned int nr_threads = 1);
 
   /** \brief Apply an affine transform defined by an Eigen Transform
     * \param cloud_in the input point cloud
     * \param indices the set of point indices to use from the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (default: 1)
     * \note The density of the point cloud is lost, since density implies that
     * the origin is the point of view
     * \note Can be used with cloud_in equal to cloud_out
@@ -72,12 +112,14 @@ namespace pcl
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        const std::vector<int> &indices, 
                        pcl::PointCloud<PointT> &cloud_out, 
-                       const Eigen::Affine3f &transform);
+                       const Eigen::Affine3f &transform,
+                       unsigned int nr_threads = 1);
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
     * \param cloud_in the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (default: 1)
     * \note The density of the point cloud is lost, since density implies that
     * the origin is the point of view
     * \note Can be used with cloud_in equal to cloud_out
@@ -85,12 +127,14 @@ namespace pcl
   template <typename PointT> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   pcl::PointCloud<PointT> &cloud_out, 
-                                  const Eigen::Affine3f &transform);
+                                  const Eigen::Affine3f &transform,
+                                  unsigned int nr_threads = 1);
 
   /** \brief Apply an affine transform defined by an Eigen Transform
     * \param cloud_in the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (default: 1)
     * \note The density of the point cloud is lost, since density implies that
     * the origin is the point of view
     * \note Can be used with cloud_in equal to cloud_out
@@ -99,12 +143,14 @@ namespace pcl
   template <typename PointT> void 
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
-                       const Eigen::Matrix4f &transform);
+                       const Eigen::Matrix4f &transform,
+                       unsigned int nr_threads = 1);
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
     * \param cloud_in the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (default: 1)
     * \note The density of the point cloud is lost, since density implies that
     * the origin is the point of view
     * \note Can be used with cloud_in equal to cloud_out
@@ -113,7 +159,23 @@ namespace pcl
   template <typename PointT> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   pcl::PointCloud<PointT> &cloud_out, 
-                                  const Eigen::Matrix4f &transform);
+                                  const Eigen::Matrix4f &transform,
+                                  unsigned int nr_threads = 1);
+
+  /** \brief Apply an affine transform to a cloud in structure-of-arrays layout. Only the x, y and z columns
+    * are transformed, the other columns are copied when cloud_out is a different cloud.
+    * \param cloud_in the input point cloud
+    * \param cloud_out the resultant output point cloud
+    * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (default: 1)
+    * \note Can be used with cloud_in equal to cloud_out
+    * \ingroup common
+    */
+  template <typename PointT> void 
+  transformPointCloud (const pcl::PointCloudSoA<PointT> &cloud_in, 
+                       pcl::PointCloudSoA<PointT> &cloud_out, 
+                       const Eigen::Matrix4f &transform,
+                       unsigned int nr_threads = 1);
 
   /** \brief Apply a rigid transform defined by a 3D offset and a quaternion
     * \param cloud_in the input point cloud
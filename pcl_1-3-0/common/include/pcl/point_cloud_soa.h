@@ -0,0 +1,291 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_POINT_CLOUD_SOA_H_
+#define PCL_POINT_CLOUD_SOA_H_
+
+#include <cstring>
+#include <vector>
+#include <Eigen/StdVector>
+#include <boost/mpl/begin_end.hpp>
+#include <boost/mpl/distance.hpp>
+#include <boost/mpl/find.hpp>
+#include <boost/mpl/size.hpp>
+#include "pcl/point_cloud.h"
+#include "pcl/point_types.h"
+#include "pcl/ros/point_traits.h"
+#include "pcl/ros/for_each_type.h"
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Position of the field Key in the registered field list of PointT. */
+    template <typename PointT, typename Key>
+    struct fieldIndex
+    {
+      typedef typename pcl::traits::fieldList<PointT>::type FieldList;
+      static const int value = boost::mpl::distance<typename boost::mpl::begin<FieldList>::type,
+                                                    typename boost::mpl::find<FieldList, Key>::type>::value;
+    };
+
+    /** \brief Helper functor copying one registered field of a block of points into its column. */
+    template <typename PointT>
+    struct PointsToColumnsFunctor
+    {
+      PointsToColumnsFunctor (const PointT *points, size_t begin, size_t end, uint8_t * const *columns)
+        : points_ (points), begin_ (begin), end_ (end), columns_ (columns) { }
+
+      template<typename Key> inline void operator() ()
+      {
+        typedef typename pcl::traits::datatype<PointT, Key>::type T;
+        const size_t offset = pcl::traits::offset<PointT, Key>::value;
+        uint8_t *column = columns_[fieldIndex<PointT, Key>::value];
+        for (size_t i = begin_; i < end_; ++i)
+          memcpy (column + i * sizeof (T), reinterpret_cast<const uint8_t*> (&points_[i]) + offset, sizeof (T));
+      }
+
+      private:
+        const PointT *points_;
+        size_t begin_, end_;
+        uint8_t * const *columns_;
+    };
+
+    /** \brief Helper functor copying one column back into the registered field of a block of points. */
+    template <typename PointT>
+    struct ColumnsToPointsFunctor
+    {
+      ColumnsToPointsFunctor (const uint8_t * const *columns, size_t begin, size_t end, PointT *points)
+        : columns_ (columns), begin_ (begin), end_ (end), points_ (points) { }
+
+      template<typename Key> inline void operator() ()
+      {
+        typedef typename pcl::traits::datatype<PointT, Key>::type T;
+        const size_t offset = pcl::traits::offset<PointT, Key>::value;
+        const uint8_t *column = columns_[fieldIndex<PointT, Key>::value];
+        for (size_t i = begin_; i < end_; ++i)
+          memcpy (reinterpret_cast<uint8_t*> (&points_[i]) + offset, column + i * sizeof (T), sizeof (T));
+      }
+
+      private:
+        const uint8_t * const *columns_;
+        size_t begin_, end_;
+        PointT *points_;
+    };
+  }
+
+  /** \brief @b PointCloudSoA is a structure-of-arrays companion to PointCloud<PointT>. Every field registered
+    * with POINT_CLOUD_REGISTER_POINT_STRUCT is stored in its own contiguous, 16-byte aligned column, so loops
+    * that only read xyz stream 12 bytes per point instead of the whole (padded) point struct.
+    * \note Only registered fields are stored - struct padding (e.g. data[3] of PointXYZ) is not kept.
+    * \note Array fields (e.g. histograms) keep their elements together: element k of point i is at
+    * getField<Key> ()[i * count + k].
+    * \ingroup common
+    */
+  template <typename PointT>
+  class PointCloudSoA
+  {
+    public:
+      typedef typename pcl::traits::fieldList<PointT>::type FieldList;
+      typedef std::vector<uint8_t, Eigen::aligned_allocator<uint8_t> > Column;
+
+      /** \brief Scalar type of the field Key. */
+      template <typename Key>
+      struct FieldType
+      {
+        typedef typename pcl::traits::datatype<PointT, Key>::decomposed::type type;
+      };
+
+      PointCloudSoA () : width (0), height (0), is_dense (true), size_ (0),
+                         columns_ (boost::mpl::size<FieldList>::value)
+      {}
+
+      /** \brief Build the columns from an array-of-structs cloud.
+        * \param cloud the cloud to convert
+        * \param nr_threads the number of threads used for the conversion
+        */
+      explicit PointCloudSoA (const PointCloud<PointT> &cloud, unsigned int nr_threads = 1)
+        : width (0), height (0), is_dense (true), size_ (0),
+          columns_ (boost::mpl::size<FieldList>::value)
+      {
+        fromPointCloud (cloud, nr_threads);
+      }
+
+      /** \brief Copy all points of an array-of-structs cloud into the columns.
+        * \param cloud the cloud to convert
+        * \param nr_threads the number of threads used for the conversion
+        */
+      void
+      fromPointCloud (const PointCloud<PointT> &cloud, unsigned int nr_threads = 1)
+      {
+        header   = cloud.header;
+        width    = cloud.width;
+        height   = cloud.height;
+        is_dense = cloud.is_dense;
+        resize (cloud.points.size ());
+        if (size_ == 0)
+          return;
+
+        std::vector<uint8_t*> columns (columns_.size ());
+        for (size_t f = 0; f < columns_.size (); ++f)
+          columns[f] = &columns_[f][0];
+
+        // Convert in blocks so that the structs of a block stay in cache while all fields are copied
+        const PointT *points = &cloud.points[0];
+        int nr_blocks = (int)((size_ + block_size_ - 1) / block_size_);
+#pragma omp parallel for schedule (static) num_threads (nr_threads)
+        for (int b = 0; b < nr_blocks; ++b)
+        {
+          size_t begin = (size_t)b * block_size_;
+          size_t end = (std::min) (begin + block_size_, size_);
+          pcl::for_each_type<FieldList> (detail::PointsToColumnsFunctor<PointT> (points, begin, end, &columns[0]));
+        }
+      }
+
+      /** \brief Copy the columns back into an array-of-structs cloud.
+        * \param cloud the resultant cloud
+        * \param nr_threads the number of threads used for the conversion
+        */
+      void
+      toPointCloud (PointCloud<PointT> &cloud, unsigned int nr_threads = 1) const
+      {
+        cloud.header   = header;
+        cloud.width    = width;
+        cloud.height   = height;
+        cloud.is_dense = is_dense;
+        cloud.points.resize (size_);
+        if (size_ == 0)
+          return;
+
+        std::vector<const uint8_t*> columns (columns_.size ());
+        for (size_t f = 0; f < columns_.size (); ++f)
+          columns[f] = &columns_[f][0];
+
+        PointT *points = &cloud.points[0];
+        int nr_blocks = (int)((size_ + block_size_ - 1) / block_size_);
+#pragma omp parallel for schedule (static) num_threads (nr_threads)
+        for (int b = 0; b < nr_blocks; ++b)
+        {
+          size_t begin = (size_t)b * block_size_;
+          size_t end = (std::min) (begin + block_size_, size_);
+          pcl::for_each_type<FieldList> (detail::ColumnsToPointsFunctor<PointT> (&columns[0], begin, end, points));
+        }
+      }
+
+      /** \brief Resize all columns to hold n points. */
+      void
+      resize (size_t n)
+      {
+        pcl::for_each_type<FieldList> (ResizeFunctor (columns_, n));
+        size_ = n;
+      }
+
+      /** \brief The number of points. */
+      inline size_t
+      size () const { return (size_); }
+
+      inline bool
+      empty () const { return (size_ == 0); }
+
+      /** \brief Get the column of the field Key, e.g. getField<pcl::fields::rgb> (). */
+      template <typename Key> inline typename FieldType<Key>::type*
+      getField ()
+      {
+        return (size_ == 0 ? NULL :
+                reinterpret_cast<typename FieldType<Key>::type*> (&columns_[detail::fieldIndex<PointT, Key>::value][0]));
+      }
+
+      /** \brief Get the column of the field Key, e.g. getField<pcl::fields::rgb> (). */
+      template <typename Key> inline const typename FieldType<Key>::type*
+      getField () const
+      {
+        return (size_ == 0 ? NULL :
+                reinterpret_cast<const typename FieldType<Key>::type*> (&columns_[detail::fieldIndex<PointT, Key>::value][0]));
+      }
+
+      /** \brief Shortcuts to the coordinate columns (only for point types with x, y and z). */
+      inline float* x () { return (getField<pcl::fields::x> ()); }
+      inline float* y () { return (getField<pcl::fields::y> ()); }
+      inline float* z () { return (getField<pcl::fields::z> ()); }
+      inline const float* x () const { return (getField<pcl::fields::x> ()); }
+      inline const float* y () const { return (getField<pcl::fields::y> ()); }
+      inline const float* z () const { return (getField<pcl::fields::z> ()); }
+
+      /** \brief The point cloud header. It contains information about the acquisition time, as well as a transform
+        * frame (see \a tf). */
+      std_msgs::Header header;
+
+      /** \brief The point cloud width (if organized as an image-structure). */
+      uint32_t width;
+      /** \brief The point cloud height (if organized as an image-structure). */
+      uint32_t height;
+
+      /** \brief True if no points are invalid (e.g., have NaN or Inf values). */
+      bool is_dense;
+
+      typedef boost::shared_ptr<PointCloudSoA<PointT> > Ptr;
+      typedef boost::shared_ptr<const PointCloudSoA<PointT> > ConstPtr;
+
+    private:
+      /** \brief Helper functor sizing the column of each field. */
+      struct ResizeFunctor
+      {
+        ResizeFunctor (std::vector<Column> &columns, size_t n) : columns_ (columns), n_ (n) { }
+
+        template<typename Key> inline void operator() ()
+        {
+          columns_[detail::fieldIndex<PointT, Key>::value].resize (n_ * sizeof (typename pcl::traits::datatype<PointT, Key>::type));
+        }
+
+        std::vector<Column> &columns_;
+        size_t n_;
+      };
+
+      /** \brief Number of points converted together. */
+      static const size_t block_size_ = 256;
+
+      /** \brief The number of points. */
+      size_t size_;
+
+      /** \brief One column per registered field. */
+      std::vector<Column> columns_;
+  };
+}
+
+#endif  //#ifndef PCL_POINT_CLOUD_SOA_H_
@@ -129,6 +129,9 @@ namespace pcl
       
       /** \brief Return the number of dimensions in the point's vector representation. */
       inline int getNumberOfDimensions () const { return (nr_dimensions_); }
+
+      /** \brief Return whether vectorize () rescales the point's vector representation. */
+      inline bool isRescaled () const { return (!alpha_.empty ()); }
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -391,6 +394,97 @@ namespace pcl
   };
 
 
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief @b StaticPointRepresentation is the statically dispatched counterpart of DefaultPointRepresentation. It is
+    * specialized for the common point and feature types, so that their default representation can be applied by
+    * inlined code instead of the virtual copyToFloatArray. For all other types value is false, and the
+    * PointRepresentation interface has to be used.
+    */
+  template <typename PointT>
+  struct StaticPointRepresentation
+  {
+    static const bool value = false;
+    static const int dimensions = 0;
+
+    static inline void
+    copyToFloatArray (const PointT &, float *) {}
+  };
+
+#define PCL_STATIC_XYZ_REPRESENTATION(PointT)                                 \
+  template <>                                                                 \
+  struct StaticPointRepresentation<PointT>                                    \
+  {                                                                           \
+    static const bool value = true;                                           \
+    static const int dimensions = 3;                                          \
+                                                                              \
+    static inline void                                                        \
+    copyToFloatArray (const PointT &p, float *out)                            \
+    {                                                                         \
+      out[0] = p.x;                                                           \
+      out[1] = p.y;                                                           \
+      out[2] = p.z;                                                           \
+    }                                                                         \
+  };
+
+#define PCL_STATIC_ARRAY_REPRESENTATION(PointT, field, size)                  \
+  template <>                                                                 \
+  struct StaticPointRepresentation<PointT>                                    \
+  {                                                                           \
+    static const bool value = true;                                           \
+    static const int dimensions = size;                                       \
+                                                                              \
+    static inline void                                                        \
+    copyToFloatArray (const PointT &p, float *out)                            \
+    {                                                                         \
+      for (int i = 0; i < size; ++i)                                          \
+        out[i] = p.field[i];                                                  \
+    }                                                                         \
+  };
+
+  PCL_STATIC_XYZ_REPRESENTATION (PointXYZ)
+  PCL_STATIC_XYZ_REPRESENTATION (PointXYZI)
+  PCL_STATIC_XYZ_REPRESENTATION (PointXYZRGB)
+  PCL_STATIC_XYZ_REPRESENTATION (PointXYZRGBA)
+  PCL_STATIC_XYZ_REPRESENTATION (PointNormal)
+  PCL_STATIC_XYZ_REPRESENTATION (PointXYZRGBNormal)
+  PCL_STATIC_XYZ_REPRESENTATION (PointXYZINormal)
+  PCL_STATIC_ARRAY_REPRESENTATION (PFHSignature125, histogram, 125)
+  PCL_STATIC_ARRAY_REPRESENTATION (PFHRGBSignature250, histogram, 250)
+  PCL_STATIC_ARRAY_REPRESENTATION (FPFHSignature33, histogram, 33)
+  PCL_STATIC_ARRAY_REPRESENTATION (VFHSignature308, histogram, 308)
+  PCL_STATIC_ARRAY_REPRESENTATION (NormalBasedSignature12, values, 12)
+
+  template <>
+  struct StaticPointRepresentation<PPFSignature>
+  {
+    static const bool value = true;
+    static const int dimensions = 4;
+
+    static inline void
+    copyToFloatArray (const PPFSignature &p, float *out)
+    {
+      out[0] = p.f1;
+      out[1] = p.f2;
+      out[2] = p.f3;
+      out[3] = p.f4;
+    }
+  };
+
+  /** \brief Convert a point into its default vector representation with StaticPointRepresentation.
+    * \param[in] p the input point
+    * \param[out] out the output vector, StaticPointRepresentation<PointT>::dimensions long
+    * \return false if the point is not valid, i.e. if a dimension is not finite
+    */
+  template <typename PointT> inline bool
+  vectorizeStatic (const PointT &p, float *out)
+  {
+    StaticPointRepresentation<PointT>::copyToFloatArray (p, out);
+    for (int i = 0; i < StaticPointRepresentation<PointT>::dimensions; ++i)
+      if (!pcl_isfinite (out[i]))
+        return (false);
+    return (true);
+  }
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   /** \brief @b CustomPointRepresentation extends PointRepresentation to allow for sub-part selection on the point.
    */
@@ -151,7 +151,7 @@ namespace pcl
   }
 
   template<typename PointT>  
-  void fromROSMsg (const sensor_msgs::PointCloud2& msg, pcl::PointCloud<PointT>& cloud,
+  void fromROSMsg (const sensor_msgs::PointCloud2& msg, const uint8_t* msg_data, pcl::PointCloud<PointT>& cloud,
                    const MsgFieldMap& field_map)
   {
     // Copy info fields
@@ -172,11 +172,10 @@ namespace pcl
         msg.point_step == sizeof(PointT))
     {
       uint32_t cloud_row_step = sizeof(PointT) * cloud.width;
-      const uint8_t* msg_data = &msg.data[0];
       // Should usually be able to copy all rows at once
       if (msg.row_step == cloud_row_step)
       {
-        memcpy (cloud_data, msg_data, msg.data.size());
+        memcpy (cloud_data, msg_data, msg.row_step * msg.height);
       }
       else
       {
@@ -190,13 +189,13 @@ namespace pcl
       // If not, memcpy each group of contiguous fields separately
       for (uint32_t row = 0; row < msg.height; ++row)
       {
-        const uint8_t* row_data = &msg.data[row * msg.row_step];
+        const uint8_t* row_data = msg_data + row * msg.row_step;
         for (uint32_t col = 0; col < msg.width; ++col)
         {
-          const uint8_t* msg_data = row_data + col * msg.point_step;
+          const uint8_t* point_data = row_data + col * msg.point_step;
           BOOST_FOREACH (const detail::FieldMapping& mapping, field_map)
           {
-            memcpy (cloud_data + mapping.struct_offset, msg_data + mapping.serialized_offset, mapping.size);
+            memcpy (cloud_data + mapping.struct_offset, point_data + mapping.serialized_offset, mapping.size);
           }
           cloud_data += sizeof (PointT);
         }
@@ -204,6 +203,13 @@ namespace pcl
     }
   }
 
+  template<typename PointT>  
+  void fromROSMsg (const sensor_msgs::PointCloud2& msg, pcl::PointCloud<PointT>& cloud,
+                   const MsgFieldMap& field_map)
+  {
+    fromROSMsg (msg, msg.data.empty () ? NULL : &msg.data[0], cloud, field_map);
+  }
+
   template<typename PointT>  
   void fromROSMsg (const sensor_msgs::PointCloud2& msg, pcl::PointCloud<PointT>& cloud)
   {
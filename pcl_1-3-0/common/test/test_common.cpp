@@ -40,6 +40,9 @@
 #include <pcl/common/distances.h>
 #include <pcl/common/intersections.h>
 #include <pcl/common/eigen.h>
+#include <pcl/common/transforms.h>
+#include <pcl/common/centroid.h>
+#include <pcl/point_cloud_soa.h>
 #include <pcl/point_types.h>
 #include <pcl/point_cloud.h>
 
@@ -252,6 +255,178 @@ TEST (PCL, Intersections)
   //intersection: [ 3.06416e+08    15.2237     3.06416e+08       4.04468e-34 ]
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, Transforms)
+{
+  PointCloud<PointXYZRGBNormal> cloud;
+  cloud.width = 10; cloud.height = 10;
+  cloud.is_dense = false;
+  cloud.points.resize (cloud.width * cloud.height);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = 0.1f * (i % 10);
+    cloud.points[i].y = 0.2f * (i / 10);
+    cloud.points[i].z = 1.0f - 0.05f * i;
+    cloud.points[i].getNormalVector3fMap () = Eigen::Vector3f (0.1f * (i % 7), 1.0f, 0.2f).normalized ();
+    cloud.points[i].rgb = 42.0f;
+    cloud.points[i].curvature = 0.5f;
+  }
+  cloud.points[17].x = std::numeric_limits<float>::quiet_NaN ();
+
+  Eigen::Affine3f transform;
+  transform = Eigen::Translation3f (1.0f, -2.0f, 0.5f) * Eigen::AngleAxisf (0.7f, Eigen::Vector3f (1, 2, 3).normalized ());
+
+  PointCloud<PointXYZRGBNormal> cloud_out, cloud_out_mt, cloud_inplace = cloud;
+  transformPointCloudWithNormals (cloud, cloud_out, transform);
+  transformPointCloudWithNormals (cloud, cloud_out_mt, transform.matrix (), 4);
+  transformPointCloudWithNormals (cloud_inplace, cloud_inplace, transform);
+  EXPECT_EQ (cloud_out.width, cloud.width);
+  EXPECT_EQ (cloud_out.height, cloud.height);
+  ASSERT_EQ (cloud_out.points.size (), cloud.points.size ());
+
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_EQ (cloud_out.points[i].rgb, 42.0f);
+    EXPECT_EQ (cloud_out.points[i].curvature, 0.5f);
+    if (i == 17)
+    {
+      EXPECT_FALSE (pcl_isfinite (cloud_out.points[i].x));
+      EXPECT_EQ (cloud_out.points[i].y, cloud.points[i].y);
+      continue;
+    }
+    Eigen::Vector3f p = transform * cloud.points[i].getVector3fMap ();
+    Eigen::Vector3f n = transform.rotation () * cloud.points[i].getNormalVector3fMap ();
+    for (int d = 0; d < 3; ++d)
+    {
+      EXPECT_NEAR (cloud_out.points[i].data[d], p[d], 1e-5);
+      EXPECT_NEAR (cloud_out.points[i].data_n[d], n[d], 1e-5);
+      EXPECT_NEAR (cloud_out_mt.points[i].data[d], p[d], 1e-5);
+      EXPECT_NEAR (cloud_out_mt.points[i].data_n[d], n[d], 1e-5);
+      EXPECT_EQ (cloud_inplace.points[i].data[d], cloud_out.points[i].data[d]);
+      EXPECT_EQ (cloud_inplace.points[i].data_n[d], cloud_out.points[i].data_n[d]);
+    }
+    EXPECT_EQ (cloud_out.points[i].data[3], cloud.points[i].data[3]);
+  }
+
+  // Transforming a subset keeps all other fields of the selected points
+  std::vector<int> indices;
+  indices.push_back (3); indices.push_back (17); indices.push_back (42);
+  PointCloud<PointXYZRGBNormal> subset;
+  transformPointCloud (cloud, indices, subset, transform, 2);
+  ASSERT_EQ (subset.points.size (), indices.size ());
+  EXPECT_EQ (subset.width, indices.size ());
+  EXPECT_EQ (subset.height, 1);
+  EXPECT_FALSE (pcl_isfinite (subset.points[1].x));
+  for (int d = 0; d < 3; ++d)
+  {
+    EXPECT_EQ (subset.points[0].data[d], cloud_out.points[3].data[d]);
+    EXPECT_EQ (subset.points[2].data[d], cloud_out.points[42].data[d]);
+    EXPECT_EQ (subset.points[2].data_n[d], cloud.points[42].data_n[d]);
+  }
+  EXPECT_EQ (subset.points[2].rgb, 42.0f);
+
+  // The subset can be written into the input cloud (point 0 is read after output point 0 is written),
+  // zero threads fall back to one
+  std::vector<int> indices_inplace;
+  indices_inplace.push_back (42); indices_inplace.push_back (0);
+  PointCloud<PointXYZRGBNormal> subset_inplace = cloud;
+  transformPointCloud (subset_inplace, indices_inplace, subset_inplace, transform, 0);
+  ASSERT_EQ (subset_inplace.points.size (), indices_inplace.size ());
+  for (int d = 0; d < 3; ++d)
+  {
+    EXPECT_EQ (subset_inplace.points[0].data[d], cloud_out.points[42].data[d]);
+    EXPECT_EQ (subset_inplace.points[1].data[d], cloud_out.points[0].data[d]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PointCloudSoA)
+{
+  PointCloud<PointXYZRGBNormal> cloud;
+  cloud.width = 1000; cloud.height = 1;
+  cloud.is_dense = false;
+  cloud.points.resize (cloud.width * cloud.height);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = 0.01f * i;
+    cloud.points[i].y = 2.0f - 0.03f * (i % 17);
+    cloud.points[i].z = 0.5f * (i % 5);
+    cloud.points[i].rgb = (float)i;
+    cloud.points[i].normal_x = 1.0f; cloud.points[i].normal_y = 0.0f; cloud.points[i].normal_z = -1.0f;
+    cloud.points[i].curvature = 0.001f * i;
+  }
+  cloud.points[500].y = std::numeric_limits<float>::quiet_NaN ();
+
+  PointCloudSoA<PointXYZRGBNormal> soa (cloud, 4);
+  EXPECT_EQ (soa.size (), cloud.points.size ());
+  EXPECT_EQ (soa.width, cloud.width);
+  EXPECT_EQ (soa.is_dense, cloud.is_dense);
+  const float *rgb = soa.getField<pcl::fields::rgb> ();
+  const float *curvature = soa.getField<pcl::fields::curvature> ();
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_EQ (soa.x ()[i], cloud.points[i].x);
+    EXPECT_EQ (soa.z ()[i], cloud.points[i].z);
+    EXPECT_EQ (rgb[i], cloud.points[i].rgb);
+    EXPECT_EQ (curvature[i], cloud.points[i].curvature);
+  }
+
+  // Round trip
+  PointCloud<PointXYZRGBNormal> cloud_back;
+  soa.toPointCloud (cloud_back, 2);
+  ASSERT_EQ (cloud_back.points.size (), cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    if (i != 500)
+      EXPECT_EQ (cloud_back.points[i].y, cloud.points[i].y);
+    EXPECT_EQ (cloud_back.points[i].x, cloud.points[i].x);
+    EXPECT_EQ (cloud_back.points[i].normal_z, cloud.points[i].normal_z);
+    EXPECT_EQ (cloud_back.points[i].rgb, cloud.points[i].rgb);
+    EXPECT_EQ (cloud_back.points[i].curvature, cloud.points[i].curvature);
+  }
+
+  // Array fields keep their elements together
+  PointCloud<FPFHSignature33> signatures;
+  signatures.points.resize (3);
+  for (size_t i = 0; i < signatures.points.size (); ++i)
+    for (int k = 0; k < 33; ++k)
+      signatures.points[i].histogram[k] = (float)(i * 100 + k);
+  PointCloudSoA<FPFHSignature33> signatures_soa (signatures);
+  EXPECT_EQ (signatures_soa.getField<pcl::fields::fpfh> ()[2 * 33 + 5], 205.0f);
+
+  // Algorithms working on the coordinate columns
+  Eigen::Vector4f min_aos, max_aos, min_soa, max_soa;
+  getMinMax3D (cloud, min_aos, max_aos);
+  getMinMax3D (soa, min_soa, max_soa);
+  for (int d = 0; d < 3; ++d)
+  {
+    EXPECT_EQ (min_soa[d], min_aos[d]);
+    EXPECT_EQ (max_soa[d], max_aos[d]);
+  }
+
+  Eigen::Vector4f centroid_aos, centroid_soa;
+  compute3DCentroid (cloud, centroid_aos);
+  compute3DCentroid (soa, centroid_soa);
+  for (int d = 0; d < 4; ++d)
+    EXPECT_NEAR (centroid_soa[d], centroid_aos[d], 1e-5);
+
+  Eigen::Affine3f transform;
+  transform = Eigen::Translation3f (0.3f, 0.2f, -1.0f) * Eigen::AngleAxisf (-0.4f, Eigen::Vector3f::UnitY ());
+  PointCloud<PointXYZRGBNormal> cloud_out;
+  PointCloudSoA<PointXYZRGBNormal> soa_out;
+  transformPointCloud (cloud, cloud_out, transform);
+  transformPointCloud (soa, soa_out, transform.matrix (), 2);
+  EXPECT_EQ (soa_out.size (), soa.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_NEAR (soa_out.x ()[i], cloud_out.points[i].x, 1e-5);
+    if (i != 500)
+      EXPECT_NEAR (soa_out.y ()[i], cloud_out.points[i].y, 1e-5);
+    EXPECT_NEAR (soa_out.z ()[i], cloud_out.points[i].z, 1e-5);
+    EXPECT_EQ (soa_out.getField<pcl::fields::rgb> ()[i], cloud.points[i].rgb);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
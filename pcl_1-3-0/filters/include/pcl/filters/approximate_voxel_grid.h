@@ -40,15 +40,10 @@
 
 #include "pcl/filters/filter.h"
 #include <boost/mpl/size.hpp>
+#include <algorithm>
 
 namespace pcl
 {
-  struct he {
-    int ix, iy, iz;
-    int count;
-    Eigen::VectorXf centroid;
-  };
-
   /** \brief Helper functor structure for copying data between an Eigen::VectorXf and a PointT. */
   template <typename PointT>
   struct xNdCopyEigenPointFunctor
@@ -106,6 +101,19 @@ namespace pcl
     * a bit slower than approximating them with the center of the voxel, but it
     * represents the underlying surface more accurately.
     *
+    * Instead of storing all the voxels, the centroids are accumulated in a small
+    * hash table (the history). A voxel is looked up in \a setProbeLength ()
+    * consecutive slots; if it is not found and no slot is free, one of the
+    * voxels in these slots is evicted (see \a setEvictionPolicy ()) and written
+    * out. Every output point is thus the centroid of points of a single voxel
+    * and lies within that voxel, but a voxel evicted n times yields n + 1
+    * output points. With \a setMergePartialVoxels (true) the partial centroids
+    * are merged at the end, so that every occupied voxel yields exactly one
+    * point, the same centroid VoxelGrid computes.
+    *
+    * With \a setNumberOfThreads () the input is split into one contiguous
+    * block per thread, each with its own history table.
+    *
     * \author Radu Bogdan Rusu, Bastian Steder
     * \ingroup filters
     */
@@ -126,12 +134,21 @@ namespace pcl
     typedef typename PointCloud::ConstPtr PointCloudConstPtr;
 
     public:
+      /** \brief Which of the probed voxels is written out when a new voxel does not fit into the history. */
+      enum EvictionPolicy
+      {
+        /** \brief the voxel in the first probed slot */
+        EVICT_FIRST,
+        /** \brief the probed voxel with the least points accumulated so far */
+        EVICT_SMALLEST
+      };
+
       /** \brief Empty constructor. */
-      ApproximateVoxelGrid () : downsample_all_data_ (true), histsize(512)
+      ApproximateVoxelGrid () : downsample_all_data_ (true), histsize (512), probe_length_ (1), 
+                                eviction_policy_ (EVICT_FIRST), merge_partial_voxels_ (false), threads_ (1)
       {
         setLeafSize(1, 1, 1);
         filter_name_ = "ApproximateVoxelGrid";
-        history = new he[histsize];
       }
 
       /** \brief Destructor. */
@@ -176,6 +193,64 @@ namespace pcl
       inline bool 
       getDownsampleAllData () { return (downsample_all_data_); }
 
+      /** \brief Set the number of slots of the history table of each thread.
+        * \param size the table size, rounded up to a power of 2. 0 sizes the
+        * tables from the number of leaves spanned by the input (and the number of
+        * points per thread), up to 2^20 slots. Default: 512
+        */
+      inline void
+      setHistorySize (size_t size) { histsize = size; }
+
+      /** \brief Get the number of slots of the history table of each thread (0 = automatic). */
+      inline size_t
+      getHistorySize () const { return (histsize); }
+
+      /** \brief Set the number of consecutive slots a voxel is looked up in before a voxel is evicted.
+        * \param length the probe length (at least 1), default: 1
+        */
+      inline void
+      setProbeLength (int length) { probe_length_ = (std::max) (length, 1); }
+
+      /** \brief Get the number of consecutive slots a voxel is looked up in. */
+      inline int
+      getProbeLength () const { return (probe_length_); }
+
+      /** \brief Set the voxel that is evicted when a new voxel does not fit into the history.
+        * \param policy the eviction policy, default: EVICT_FIRST
+        */
+      inline void
+      setEvictionPolicy (EvictionPolicy policy) { eviction_policy_ = policy; }
+
+      /** \brief Get the eviction policy. */
+      inline EvictionPolicy
+      getEvictionPolicy () const { return (eviction_policy_); }
+
+      /** \brief Set to true to merge the partial centroids of evicted voxels (and of
+        * voxels seen by several threads), so that every voxel yields exactly one point.
+        * \param merge the new value (true/false), default: false
+        */
+      inline void
+      setMergePartialVoxels (bool merge) { merge_partial_voxels_ = merge; }
+
+      /** \brief Get whether the partial centroids of a voxel are merged. */
+      inline bool
+      getMergePartialVoxels () const { return (merge_partial_voxels_); }
+
+      /** \brief Set the number of threads, each of them downsamples a contiguous block of the input.
+        * \param nr_threads the number of threads to use (0 is treated as 1), default: 1
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads used. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
     protected:
       /** \brief The size of a leaf. */
       Eigen::Vector3f leaf_size_;
@@ -186,11 +261,43 @@ namespace pcl
       /** \brief Set to true if all fields need to be downsampled, or false if just XYZ. */
       bool downsample_all_data_;
 
-      /** \brief history buffer size, power of 2 */
+      /** \brief history buffer size, power of 2 (0 = automatic) */
       size_t histsize;
 
-      /** \brief history buffer */
-      struct he *history;
+      /** \brief Number of consecutive slots a voxel is looked up in. */
+      int probe_length_;
+
+      /** \brief Which voxel to evict if a new voxel does not fit into the history. */
+      EvictionPolicy eviction_policy_;
+
+      /** \brief Merge the partial centroids of a voxel into one output point. */
+      bool merge_partial_voxels_;
+
+      /** \brief The number of threads used. */
+      unsigned int threads_;
+
+      /** \brief Voxel coordinates and point count of a (partial) voxel. The sums of the
+        * accumulated fields are stored separately, centroid_size floats per voxel.
+        */
+      struct VoxelEntry
+      {
+        int ix, iy, iz;
+        int count;
+
+        /** \brief Order by voxel coordinates only. */
+        inline bool
+        operator < (const VoxelEntry &other) const
+        {
+          return (ix < other.ix || (ix == other.ix && (iy < other.iy || (iy == other.iy && iz < other.iz))));
+        }
+      };
+
+      /** \brief A list of (partial) voxels with their accumulated field sums. */
+      struct VoxelList
+      {
+        std::vector<VoxelEntry> entries;
+        std::vector<float> sums;
+      };
 
       typedef typename pcl::traits::fieldList<PointT>::type FieldList;
 
@@ -200,9 +307,23 @@ namespace pcl
       void 
       applyFilter (PointCloud &output);
 
-      /** \brief Write a single point from the hash to the output cloud
+      /** \brief Accumulate a block of input points into a history table and append
+        * all evicted and remaining voxels to a list.
+        * \param begin the first input point of the block
+        * \param end one past the last input point of the block
+        * \param table_size the size of the history table, a power of 2
+        * \param rgba_index the byte offset of the rgb field or -1
+        * \param centroid_size the number of accumulated values per voxel
+        * \param voxels the list the voxels are appended to
         */
-      void flush(PointCloud &output, size_t op, he *hhe, int rgba_index, int centroid_size);
+      void 
+      accumulateBlock (size_t begin, size_t end, size_t table_size, int rgba_index, int centroid_size, VoxelList &voxels);
+
+      /** \brief Write a single voxel centroid to the output cloud
+        */
+      void 
+      flush (PointCloud &output, size_t op, const VoxelEntry &voxel, const float *sums, 
+             int rgba_index, int centroid_size, Eigen::VectorXf &scratch);
   };
 }
 
@@ -40,6 +40,8 @@
 
 #include <pcl/filters/filter.h>
 #include <pcl/search/pcl_search.h>
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
 
 namespace pcl
 {
@@ -48,6 +50,18 @@ namespace pcl
     * <b>C. Tomasi and R. Manduchi. Bilateral Filtering for Gray and Color Images.
     * In Proceedings of the IEEE International Conference on Computer Vision,
     * 1998.</b>
+    *
+    * Besides the exact evaluation over a radius search (NEIGHBOR_SEARCH), two
+    * approximations are available through \a setComputeMode ():
+    *  - PIXEL_WINDOW, for organized clouds: the neighbors are the points in a
+    *    fixed window of pixels around each point, and \a sigma_s_ is given in
+    *    pixels. The spatial weights of the window are precomputed, the
+    *    intensity weights are read from a lookup table.
+    *  - BILATERAL_GRID, for any cloud: the intensities are splatted into a
+    *    sparse grid over (x, y, z, intensity) with cells of \a sigma_s_ and
+    *    \a sigma_r_, the grid is blurred and the result is interpolated back
+    *    at every point (see <b>S. Paris and F. Durand. A Fast Approximation of
+    *    the Bilateral Filter using a Signal Processing Approach. ECCV 2006.</b>)
     * \author Luca Penasa
     */
   template<typename PointT>
@@ -59,11 +73,24 @@ namespace pcl
     typedef typename pcl::search::Search<PointT>::Ptr KdTreePtr;
 
     public:
+      /** \brief How the filter response is computed. */
+      enum ComputeMode
+      {
+        /** \brief exact, over the neighbors found by a radius search of 2 * sigma_s */
+        NEIGHBOR_SEARCH,
+        /** \brief over a window of pixels, organized clouds only */
+        PIXEL_WINDOW,
+        /** \brief bilateral grid approximation */
+        BILATERAL_GRID
+      };
+
       /** \brief Constructor. 
         * Sets \ref sigma_s_ to 0 and \ref sigma_r_ to MAXDBL
         */
       BilateralFilter () : sigma_s_ (0), 
-                           sigma_r_ (std::numeric_limits<double>::max ())
+                           sigma_r_ (std::numeric_limits<double>::max ()),
+                           mode_ (NEIGHBOR_SEARCH), threads_ (1),
+                           intensity_lut_ (), intensity_lut_scale_ (0)
       {
       }
 
@@ -124,7 +151,89 @@ namespace pcl
         tree_ = tree;
       }
 
+      /** \brief Set how the filter response is computed.
+        * \param[in] mode the compute mode, default is NEIGHBOR_SEARCH
+        */
+      inline void
+      setComputeMode (ComputeMode mode) { mode_ = mode; }
+
+      /** \brief Get how the filter response is computed. */
+      inline ComputeMode
+      getComputeMode () const { return (mode_); }
+
+      /** \brief Set the number of threads to use.
+        * \note In NEIGHBOR_SEARCH mode the search object is queried concurrently, so it must
+        * support concurrent radiusSearch () calls (e.g. search::KdTree). An OrganizedNeighbor
+        * search object is always queried from a single thread.
+        * \param[in] nr_threads the number of threads to use (0 is treated as 1), default is 1
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads used. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
     private:
+      /** \brief Filter an organized cloud over a window of pixels.
+        * \param[out] output the resultant point cloud, a copy of the input
+        */
+      void
+      applyPixelWindow (PointCloud &output);
+
+      /** \brief Filter a cloud through a bilateral grid.
+        * \param[out] output the resultant point cloud, a copy of the input
+        */
+      void
+      applyBilateralGrid (PointCloud &output);
+
+      /** \brief Fill the intensity kernel lookup table for the current sigma_r_. */
+      void
+      initIntensityKernel ();
+
+      /** \brief Look up the intensity kernel.
+        * \param[in] x the absolute intensity difference
+        */
+      inline float
+      intensityKernel (float x) const
+      {
+        float pos = x * intensity_lut_scale_;
+        if (!(pos < (float)(intensity_lut_.size () - 1)))
+          return (0.0f);
+        int i = (int)pos;
+        float t = pos - (float)i;
+        return (intensity_lut_[i] + t * (intensity_lut_[i + 1] - intensity_lut_[i]));
+      }
+
+      /** \brief Integer coordinates of a bilateral grid cell: x, y, z and intensity. */
+      struct GridKey
+      {
+        int c[4];
+
+        inline bool
+        operator == (const GridKey &other) const 
+        { 
+          return (c[0] == other.c[0] && c[1] == other.c[1] && c[2] == other.c[2] && c[3] == other.c[3]);
+        }
+      };
+
+      /** \brief Hash functor for GridKey. */
+      struct GridKeyHash
+      {
+        inline std::size_t
+        operator () (const GridKey &key) const
+        {
+          std::size_t seed = 0;
+          for (int d = 0; d < 4; ++d)
+            boost::hash_combine (seed, key.c[d]);
+          return (seed);
+        }
+      };
 
       /** \brief The bilateral filter Gaussian distance kernel.
         * \param[in] x the spatial distance (distance or intensity)
@@ -143,6 +252,18 @@ namespace pcl
 
       /** \brief A pointer to the spatial search object. */
       KdTreePtr tree_;
+
+      /** \brief How the filter response is computed. */
+      ComputeMode mode_;
+
+      /** \brief The number of threads used. */
+      unsigned int threads_;
+
+      /** \brief The intensity kernel sampled at equidistant intensity differences. */
+      std::vector<float> intensity_lut_;
+
+      /** \brief Maps an intensity difference to a (fractional) index into intensity_lut_. */
+      float intensity_lut_scale_;
   };
 }
 
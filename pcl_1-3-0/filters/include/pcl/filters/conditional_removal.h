@@ -72,6 +72,18 @@ namespace pcl
         */
       int
       compare (const PointT& p, const double& val);
+
+      /** \brief Compare the data of a block of consecutive points against a value.
+        * The datatype and the operator are resolved once for the whole block.
+        * \param points the first point of the block
+        * \param nr_points the number of points in the block
+        * \param val the value to compare the points to
+        * \param op the comparison operator
+        * \param result set to 1 for every point that satisfies the comparison, 0 otherwise
+        */
+      void
+      compare (const PointT *points, int nr_points, const double& val, 
+               ComparisonOps::CompareOp op, uint8_t *result);
     protected:
       /** \brief The type of data. */
       uint8_t datatype_;
@@ -104,6 +116,15 @@ namespace pcl
       virtual bool
       evaluate (const PointT &point) const = 0;
 
+      /** \brief Evaluate the comparison for a block of consecutive points.
+        * The default implementation calls evaluate () for every point.
+        * \param points the first point of the block
+        * \param nr_points the number of points in the block
+        * \param result set to 1 for every point that satisfies the comparison, 0 otherwise
+        */
+      virtual void
+      evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const;
+
     protected:
       /** \brief True if capable. */
       bool capable_;
@@ -148,6 +169,14 @@ namespace pcl
       virtual bool
       evaluate (const PointT &point) const;
 
+      /** \brief Determine the result of this comparison for a block of consecutive points.
+        * \param points the first point of the block
+        * \param nr_points the number of points in the block
+        * \param result set to 1 for every point that satisfies the comparison, 0 otherwise
+        */
+      virtual void
+      evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const;
+
     protected:
       /** \brief All types (that we care about) can be represented as a double. */
       double compare_val_;
@@ -184,6 +213,14 @@ namespace pcl
       virtual bool
       evaluate (const PointT &point) const;
 
+      /** \brief Determine the result of this comparison for a block of consecutive points.
+        * \param points the first point of the block
+        * \param nr_points the number of points in the block
+        * \param result set to 1 for every point that satisfies the comparison, 0 otherwise
+        */
+      virtual void
+      evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const;
+
     protected:
       /** \brief The name of the component. */
       std::string component_name_;
@@ -224,6 +261,16 @@ namespace pcl
       virtual bool
       evaluate (const PointT &point) const;
 
+      /** \brief Determine the result of this comparison for a block of consecutive points.
+        * Unlike evaluate (), the HSI values are computed per point without caching and
+        * the function is safe to call from several threads.
+        * \param points the first point of the block
+        * \param nr_points the number of points in the block
+        * \param result set to 1 for every point that satisfies the comparison, 0 otherwise
+        */
+      virtual void
+      evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const;
+
       typedef enum
       {
         H, // -128 to 127 corresponds to -pi to pi
@@ -304,6 +351,18 @@ namespace pcl
       virtual bool
       evaluate (const PointT &point) const = 0;
 
+      /** \brief Determine which points of a block of consecutive points meet this condition.
+        * The default implementation calls evaluate () for every point.
+        * \param points the first point of the block
+        * \param nr_points the number of points in the block
+        * \param result set to 1 for every point that meets this condition, 0 otherwise
+        */
+      virtual void
+      evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const;
+
+      /** \brief The number of points evaluated at once by evaluateBlock (). */
+      static const int BLOCK_SIZE = 256;
+
     protected:
       /** \brief True if capable. */
       bool capable_;
@@ -341,6 +400,16 @@ namespace pcl
         */
       virtual bool
       evaluate (const PointT &point) const;
+
+      /** \brief Determine which points of a block of consecutive points meet this condition.
+        * Every comparison and nested condition is evaluated over the whole block and the 
+        * results are combined, stopping as soon as no point of the block is left.
+        * \param points the first point of the block
+        * \param nr_points the number of points in the block
+        * \param result set to 1 for every point that meets this condition, 0 otherwise
+        */
+      virtual void
+      evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const;
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////
@@ -369,6 +438,16 @@ namespace pcl
         */
       virtual bool
       evaluate (const PointT &point) const;
+
+      /** \brief Determine which points of a block of consecutive points meet this condition.
+        * Every comparison and nested condition is evaluated over the whole block and the 
+        * results are combined, stopping as soon as all points of the block are accepted.
+        * \param points the first point of the block
+        * \param nr_points the number of points in the block
+        * \param result set to 1 for every point that meets this condition, 0 otherwise
+        */
+      virtual void
+      evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const;
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////
@@ -399,6 +478,11 @@ namespace pcl
     *  range_filt.setCondition (range_cond);
     *  range_filt.setKeepOrganized (false);
     *
+    * The condition is evaluated over blocks of ConditionBase::BLOCK_SIZE points
+    * with ConditionBase::evaluateBlock (), so that every comparison resolves its
+    * field type and operator once per block instead of once per point. Blocks
+    * are evaluated in parallel, see \a setNumberOfThreads ().
+    *
     * \author Louis LeGrand, Intel Labs Seattle
     * \ingroup filters
     */
@@ -429,7 +513,7 @@ namespace pcl
         */
       ConditionalRemoval (int extract_removed_indices = false) :
         Filter<PointT>::Filter (extract_removed_indices), keep_organized_ (false), condition_ (),
-        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ())
+        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ()), threads_ (1)
       {
         filter_name_ = "ConditionalRemoval";
       }
@@ -441,7 +525,7 @@ namespace pcl
         */
       ConditionalRemoval (ConditionBasePtr condition, bool extract_removed_indices = false) :
         Filter<PointT>::Filter (extract_removed_indices), keep_organized_ (false), condition_ (),
-        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ())
+        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ()), threads_ (1)
       {
         filter_name_ = "ConditionalRemoval";
         setCondition (condition);
@@ -487,6 +571,26 @@ namespace pcl
       void
       setCondition (ConditionBasePtr condition);
 
+      /** \brief Set the number of threads used to evaluate the condition. 
+        * Comparisons and conditions are shared by all threads, custom comparisons 
+        * must therefore be safe to evaluate concurrently when more than one thread is used.
+        * \param nr_threads the number of threads to use (0 is treated as 1)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads used to evaluate the condition. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
     protected:
       /** \brief Filter a Point Cloud.
         * \param output the resultant point cloud message
@@ -511,6 +615,9 @@ namespace pcl
         * the correct field type. 
         */
       float user_filter_value_;
+
+      /** \brief The number of threads used to evaluate the condition. */
+      unsigned int threads_;
   };
 }
 
@@ -159,6 +159,16 @@ namespace pcl
         return (transform_);
       }
 
+      /** \brief Compute the box rotation used by \a testPoint (). */
+      bool
+      initPointTest ();
+
+      /** \brief Check whether a single point lies inside the box.
+        * \param point the point to test
+        */
+      bool
+      testPoint (const PointT &point) const;
+
     protected:
       /** \brief Sample of point indices into a separate PointCloud
         * \param output the resultant point cloud
@@ -179,6 +189,12 @@ namespace pcl
       Eigen::Vector3f translation_;
       Eigen::Vector3f rotation_;
       Eigen::Affine3f transform_;
+
+      /** \brief Inverse of the box rotation, set by initPointTest (). */
+      Eigen::Affine3f inverse_transform_;
+
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
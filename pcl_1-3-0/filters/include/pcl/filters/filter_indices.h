@@ -91,6 +91,30 @@ namespace pcl
         deinitCompute ();
       }
 
+      /** \brief Prepare the filter for point-wise evaluation through \a testPoint ().
+        * Filters that decide on every point without looking at any other point 
+        * (e.g. PassThrough, CropBox) override this method together with \a testPoint (),
+        * which allows FilterPipeline to run several of them in a single sweep over the data.
+        * The input cloud has to be set before calling this method.
+        * \return true if \a testPoint () can be used, false otherwise (default)
+        */
+      virtual bool
+      initPointTest ()
+      {
+        return (false);
+      }
+
+      /** \brief Check whether a single point passes the filter. Only valid after 
+        * \a initPointTest () returned true. Does not modify the filter, and can therefore 
+        * be called from several threads at once.
+        * \return true if the point is kept by the filter, false otherwise
+        */
+      virtual bool
+      testPoint (const PointT &) const
+      {
+        return (true);
+      }
+
     protected:
 
       /** \brief Abstract filter method for point cloud indices.
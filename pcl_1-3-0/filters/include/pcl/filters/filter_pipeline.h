@@ -0,0 +1,184 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FILTERS_FILTER_PIPELINE_H_
+#define PCL_FILTERS_FILTER_PIPELINE_H_
+
+#include "pcl/filters/filter_indices.h"
+
+namespace pcl
+{
+  ////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief @b FilterPipeline applies a chain of filters to a point cloud while avoiding the
+    * intermediate point clouds that calling the filters one after another would create.
+    *
+    * Filters derived from FilterIndices (e.g. PassThrough, CropBox, RandomSample) are run on
+    * index views: each of them receives the input cloud plus the indices left by the previous
+    * filters, and hands its own resulting indices to the next one. Consecutive filters that
+    * support point-wise evaluation (see FilterIndices::initPointTest ()) are fused and run in a
+    * single (parallel) sweep over the current indices.
+    *
+    * Other filters (e.g. VoxelGrid, StatisticalOutlierRemoval) produce new points. They get
+    * the surviving points copied into a new cloud first, unless they were added with
+    * \a use_indices set, in which case they are given the current indices directly. The
+    * output of the last filter is written to the output cloud directly; if the pipeline ends
+    * with index filters, the surviving points are copied to the output once.
+    *
+    * The pipeline sets the input cloud and the indices of every filter it runs. As with the
+    * individual filters, the output is not organized and removed indices are not reported.
+    *
+    * Here is an example usage:
+    *  pcl::FilterPipeline<PointT> pipeline;
+    *  pipeline.addFilter (pass_through);     // boost::shared_ptr<pcl::PassThrough<PointT> >
+    *  pipeline.addFilter (crop_box);         // boost::shared_ptr<pcl::CropBox<PointT> >
+    *  pipeline.addFilter (voxel_grid);       // boost::shared_ptr<pcl::VoxelGrid<PointT> >
+    *  pipeline.addFilter (outlier_removal);  // boost::shared_ptr<pcl::StatisticalOutlierRemoval<PointT> >
+    *  pipeline.setInputCloud (cloud);
+    *  pipeline.filter (cloud_filtered);
+    *
+    * \ingroup filters
+    */
+  template<typename PointT>
+  class FilterPipeline : public Filter<PointT>
+  {
+    using Filter<PointT>::input_;
+    using Filter<PointT>::indices_;
+    using Filter<PointT>::fake_indices_;
+    using Filter<PointT>::filter_name_;
+    using Filter<PointT>::getClassName;
+
+    typedef typename Filter<PointT>::PointCloud PointCloud;
+    typedef typename PointCloud::Ptr PointCloudPtr;
+    typedef typename PointCloud::ConstPtr PointCloudConstPtr;
+
+    public:
+      typedef typename Filter<PointT>::Ptr FilterPtr;
+      typedef boost::shared_ptr<FilterIndices<PointT> > FilterIndicesPtr;
+
+      /** \brief Empty constructor. */
+      FilterPipeline () : stages_ (), threads_ (1)
+      {
+        filter_name_ = "FilterPipeline";
+      }
+
+      /** \brief Append a filter to the end of the pipeline.
+        * \param filter the filter to add
+        * \param use_indices only used for filters that do not derive from FilterIndices: set
+        * to true if the filter restricts its computation to the indices given through 
+        * setIndices (), so that it can be run on the input cloud directly instead of on a copy
+        * of the points that survived the previous filters
+        */
+      inline void
+      addFilter (const FilterPtr &filter, bool use_indices = false)
+      {
+        Stage stage;
+        stage.filter = filter;
+        stage.indices_filter = boost::dynamic_pointer_cast<FilterIndices<PointT> > (filter);
+        stage.use_indices = use_indices;
+        stages_.push_back (stage);
+      }
+
+      /** \brief Remove all filters from the pipeline. */
+      inline void
+      clearFilters ()
+      {
+        stages_.clear ();
+      }
+
+      /** \brief Get the number of filters in the pipeline. */
+      inline size_t
+      getNumberOfFilters () const
+      {
+        return (stages_.size ());
+      }
+
+      /** \brief Set the number of threads used by the fused point-wise sweeps.
+        * \param nr_threads the number of threads to use (0 is treated as 1)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads used by the fused point-wise sweeps. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
+    protected:
+      /** \brief Run all filters of the pipeline on the input cloud.
+        * \param output the resultant point cloud
+        */
+      void
+      applyFilter (PointCloud &output);
+
+      /** \brief Run a group of point-wise filters over the given indices in one sweep.
+        * \param cloud the point cloud the indices refer to
+        * \param indices the indices to test
+        * \param tests the point-wise filters, already prepared through initPointTest ()
+        * \param passed the indices of the points that pass all tests
+        */
+      void
+      testPoints (const PointCloud &cloud, const std::vector<int> &indices,
+                  const std::vector<FilterIndicesPtr> &tests, std::vector<int> &passed);
+
+    private:
+      /** \brief A filter in the pipeline. */
+      struct Stage
+      {
+        /** \brief The filter. */
+        FilterPtr filter;
+        /** \brief The same filter if it derives from FilterIndices, NULL otherwise. */
+        FilterIndicesPtr indices_filter;
+        /** \brief True if the filter can be run on an index view. */
+        bool use_indices;
+      };
+
+      /** \brief The filters, in the order they are applied. */
+      std::vector<Stage> stages_;
+
+      /** \brief The number of threads used by the fused point-wise sweeps. */
+      unsigned int threads_;
+  };
+}
+
+#endif  //#ifndef PCL_FILTERS_FILTER_PIPELINE_H_
@@ -43,27 +43,133 @@
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
-pcl::ApproximateVoxelGrid<PointT>::flush (PointCloud &output, size_t op, he *hhe, int rgba_index, int centroid_size)
+pcl::ApproximateVoxelGrid<PointT>::flush (PointCloud &output, size_t op, const VoxelEntry &voxel, const float *sums, 
+                                          int rgba_index, int centroid_size, Eigen::VectorXf &scratch)
 {
-  hhe->centroid /= hhe->count;
-  pcl::for_each_type <FieldList> (pcl::xNdCopyEigenPointFunctor <PointT> (hhe->centroid, output.points[op]));
+  for (int k = 0; k < centroid_size; ++k)
+    scratch[k] = sums[k] / voxel.count;
+  if (downsample_all_data_)
+    pcl::for_each_type <FieldList> (pcl::xNdCopyEigenPointFunctor <PointT> (scratch, output.points[op]));
+  else
+  {
+    output.points[op].x = scratch[0];
+    output.points[op].y = scratch[1];
+    output.points[op].z = scratch[2];
+  }
   // ---[ RGB special case
   if (rgba_index >= 0)
   {
     // pack r/g/b into rgb
-    float r = hhe->centroid[centroid_size-3], 
-          g = hhe->centroid[centroid_size-2], 
-          b = hhe->centroid[centroid_size-1];
+    float r = scratch[centroid_size-3], 
+          g = scratch[centroid_size-2], 
+          b = scratch[centroid_size-1];
     int rgb = ((int)r) << 16 | ((int)g) << 8 | ((int)b);
     memcpy (((char *)&output.points[op]) + rgba_index, &rgb, sizeof (float));
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ApproximateVoxelGrid<PointT>::accumulateBlock (size_t begin, size_t end, size_t table_size, 
+                                                    int rgba_index, int centroid_size, VoxelList &voxels)
+{
+  size_t mask = table_size - 1;
+  int probe_length = (int)(std::min) ((size_t)probe_length_, table_size);
+
+  VoxelEntry empty;
+  empty.ix = empty.iy = empty.iz = empty.count = 0;
+  std::vector<VoxelEntry> history (table_size, empty);
+  std::vector<float> history_sums (table_size * centroid_size, 0.0f);
+  Eigen::VectorXf scratch = Eigen::VectorXf::Zero (centroid_size);
+
+  for (size_t cp = begin; cp < end; ++cp) 
+  {
+    const PointT &point = input_->points[cp];
+    if (!pcl_isfinite (point.x) || !pcl_isfinite (point.y) || !pcl_isfinite (point.z))
+      continue;
+
+    int ix = (int)floor (point.x * inverse_leaf_size_[0]);
+    int iy = (int)floor (point.y * inverse_leaf_size_[1]);
+    int iz = (int)floor (point.z * inverse_leaf_size_[2]);
+    unsigned int hash = (unsigned int)ix * 7171u + (unsigned int)iy * 3079u + (unsigned int)iz * 4231u;
+
+    // Look for the voxel or a free slot
+    size_t slot = table_size;
+    for (int j = 0; j < probe_length; ++j)
+    {
+      size_t s = (hash + j) & mask;
+      if (!history[s].count || (history[s].ix == ix && history[s].iy == iy && history[s].iz == iz))
+      {
+        slot = s;
+        break;
+      }
+    }
+
+    // No luck, write out one of the probed voxels
+    if (slot == table_size)
+    {
+      slot = hash & mask;
+      if (eviction_policy_ == EVICT_SMALLEST)
+      {
+        for (int j = 1; j < probe_length; ++j)
+        {
+          size_t s = (hash + j) & mask;
+          if (history[s].count < history[slot].count)
+            slot = s;
+        }
+      }
+      voxels.entries.push_back (history[slot]);
+      float *sums = &history_sums[slot * centroid_size];
+      voxels.sums.insert (voxels.sums.end (), sums, sums + centroid_size);
+      std::fill (sums, sums + centroid_size, 0.0f);
+      history[slot].count = 0;
+    }
+
+    VoxelEntry &hhe = history[slot];
+    hhe.ix = ix;
+    hhe.iy = iy;
+    hhe.iz = iz;
+    hhe.count++;
+
+    // Unpack the point into scratch, then accumulate
+    // ---[ RGB special case
+    if (rgba_index >= 0)
+    {
+      // fill r/g/b data
+      pcl::RGB rgb;
+      memcpy (&rgb, ((char *)&point) + rgba_index, sizeof (RGB));
+      scratch[centroid_size-3] = rgb.r;
+      scratch[centroid_size-2] = rgb.g;
+      scratch[centroid_size-1] = rgb.b;
+    }
+    if (downsample_all_data_)
+      pcl::for_each_type <FieldList> (xNdCopyPointEigenFunctor <PointT> (point, scratch));
+    else
+    {
+      scratch[0] = point.x;
+      scratch[1] = point.y;
+      scratch[2] = point.z;
+    }
+    float *sums = &history_sums[slot * centroid_size];
+    for (int k = 0; k < centroid_size; ++k)
+      sums[k] += scratch[k];
+  }
+
+  // Write out the voxels still in the history
+  for (size_t s = 0; s < table_size; ++s) 
+  {
+    if (!history[s].count)
+      continue;
+    voxels.entries.push_back (history[s]);
+    voxels.sums.insert (voxels.sums.end (), &history_sums[s * centroid_size], &history_sums[s * centroid_size] + centroid_size);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::ApproximateVoxelGrid<PointT>::applyFilter (PointCloud &output)
 {
-  int centroid_size = 4;
+  int centroid_size = 3;
   if (downsample_all_data_)
     centroid_size = boost::mpl::size<FieldList>::value;
 
@@ -79,53 +185,76 @@ pcl::ApproximateVoxelGrid<PointT>::applyFilter (PointCloud &output)
     centroid_size += 3;
   }
 
-  for (size_t i = 0; i < histsize; i++) 
+  size_t nr_points = input_->points.size ();
+  size_t nr_blocks = (std::max) ((size_t)1, (std::min) ((size_t)threads_, nr_points));
+
+  // Size the history tables
+  size_t table_size = histsize;
+  if (table_size == 0)
   {
-    history[i].count = 0;
-    history[i].centroid = Eigen::VectorXf::Zero (centroid_size);
+    // Room for every leaf spanned by the input, but not more than twice the points of a block
+    Eigen::Vector4f min_p, max_p;
+    pcl::getMinMax3D (*input_, min_p, max_p);
+    double nr_leaves = 1;
+    for (int d = 0; d < 3; ++d)
+      nr_leaves *= floor (max_p[d] * inverse_leaf_size_[d]) - floor (min_p[d] * inverse_leaf_size_[d]) + 1;
+    double points_per_block = (double)nr_points / nr_blocks;
+    if (!pcl_isfinite (nr_leaves) || nr_leaves > points_per_block)
+      nr_leaves = points_per_block;
+    table_size = (size_t)(std::max) (1.0, (std::min) (2 * nr_leaves, (double)(1 << 20)));
   }
-  Eigen::VectorXf scratch = Eigen::VectorXf::Zero (centroid_size);
+  size_t power = 1;
+  while (power < table_size)
+    power <<= 1;
+  table_size = power;
 
-  output.points.resize (input_->points.size ());   // size output for worst case
+  // Downsample every block into its own list of voxels
+  std::vector<VoxelList> lists (nr_blocks);
+#pragma omp parallel for schedule (static, 1) num_threads (threads_)
+  for (int b = 0; b < (int)nr_blocks; ++b)
+    accumulateBlock (nr_points * b / nr_blocks, nr_points * (b + 1) / nr_blocks, table_size, rgba_index, centroid_size, lists[b]);
+
+  Eigen::VectorXf scratch (centroid_size);
   size_t op = 0;    // output pointer
-  for (size_t cp = 0; cp < input_->points.size (); ++cp) 
+  if (!merge_partial_voxels_)
   {
-    int ix = (int)floor (input_->points[cp].x * inverse_leaf_size_[0]);
-    int iy = (int)floor (input_->points[cp].y * inverse_leaf_size_[1]);
-    int iz = (int)floor (input_->points[cp].z * inverse_leaf_size_[2]);
-    unsigned int hash = (ix * 7171 + iy * 3079 + iz * 4231) & (histsize - 1);
-    he *hhe = &history[hash];
-    if (hhe->count && ((ix != hhe->ix) || (iy != hhe->iy) || (iz != hhe->iz))) 
-    {
-      flush (output, op++, hhe, rgba_index, centroid_size);
-      hhe->count = 0;
-      hhe->centroid.setZero ();// = Eigen::VectorXf::Zero (centroid_size);
-    }
-    hhe->ix = ix;
-    hhe->iy = iy;
-    hhe->iz = iz;
-    hhe->count++;
+    size_t nr_voxels = 0;
+    for (size_t b = 0; b < nr_blocks; ++b)
+      nr_voxels += lists[b].entries.size ();
+    output.points.resize (nr_voxels);
+    for (size_t b = 0; b < nr_blocks; ++b)
+      for (size_t v = 0; v < lists[b].entries.size (); ++v)
+        flush (output, op++, lists[b].entries[v], &lists[b].sums[v * centroid_size], rgba_index, centroid_size, scratch);
+  }
+  else
+  {
+    // Sort the partial voxels of all blocks by voxel, then merge the runs
+    std::vector<std::pair<VoxelEntry, std::pair<int, int> > > order;
+    for (size_t b = 0; b < nr_blocks; ++b)
+      for (size_t v = 0; v < lists[b].entries.size (); ++v)
+        order.push_back (std::make_pair (lists[b].entries[v], std::make_pair ((int)b, (int)v)));
+    std::sort (order.begin (), order.end ());
 
-    // Unpack the point into scratch, then accumulate
-    // ---[ RGB special case
-    if (rgba_index >= 0)
+    output.points.resize (order.size ());
+    std::vector<float> sums (centroid_size);
+    for (size_t i = 0; i < order.size (); )
     {
-      // fill r/g/b data
-      pcl::RGB rgb;
-      memcpy (&rgb, ((char *)&(input_->points[cp])) + rgba_index, sizeof (RGB));
-      scratch[centroid_size-3] = rgb.r;
-      scratch[centroid_size-2] = rgb.g;
-      scratch[centroid_size-1] = rgb.b;
+      VoxelEntry voxel = order[i].first;
+      voxel.count = 0;
+      std::fill (sums.begin (), sums.end (), 0.0f);
+      size_t j = i;
+      for (; j < order.size () && !(voxel < order[j].first) && !(order[j].first < voxel); ++j)
+      {
+        const VoxelList &list = lists[order[j].second.first];
+        voxel.count += order[j].first.count;
+        for (int k = 0; k < centroid_size; ++k)
+          sums[k] += list.sums[order[j].second.second * centroid_size + k];
+      }
+      flush (output, op++, voxel, &sums[0], rgba_index, centroid_size, scratch);
+      i = j;
     }
-    pcl::for_each_type <FieldList> (xNdCopyPointEigenFunctor <PointT> (input_->points[cp], scratch));
-    hhe->centroid += scratch;
-  }
-  for (size_t i = 0; i < histsize; i++) 
-  {
-    he *hhe = &history[i];
-    if (hhe->count)
-      flush (output, op++, hhe, rgba_index, centroid_size);
   }
+
   output.points.resize (op);
   output.width = output.points.size ();
   output.height       = 1;                    // downsampling breaks the organized structure
@@ -76,6 +76,23 @@ pcl::BilateralFilter<PointT>::applyFilter (PointCloud &output)
     PCL_ERROR ("[pcl::BilateralFilter::applyFilter] Need a sigma_s value given before continuing.\n");
     return;
   }
+
+  if (mode_ == PIXEL_WINDOW)
+  {
+    if (!input_->isOrganized ())
+    {
+      PCL_ERROR ("[pcl::BilateralFilter::applyFilter] PIXEL_WINDOW needs an organized input cloud.\n");
+      return;
+    }
+    applyPixelWindow (output);
+    return;
+  }
+  if (mode_ == BILATERAL_GRID)
+  {
+    applyBilateralGrid (output);
+    return;
+  }
+
   // In case a search method has not been given, initialize it using some defaults
   if (!tree_)
   {
@@ -88,20 +105,231 @@ pcl::BilateralFilter<PointT>::applyFilter (PointCloud &output)
   }
   tree_->setInputCloud (input_);
 
-  std::vector<int> k_indices;
-  std::vector<float> k_distances;
+  // Organized neighbor searches keep state in the search object
+  unsigned int nr_threads = threads_;
+  if (boost::dynamic_pointer_cast<pcl::search::OrganizedNeighbor<PointT> > (tree_))
+    nr_threads = 1;
 
   // Copy the input data into the output
   output = *input_;
 
   // For all the indices given (equal to the entire cloud if none given)
-  for (size_t i = 0; i < indices_->size (); ++i)
+  int nr_indices = (int)indices_->size ();
+#pragma omp parallel num_threads (nr_threads)
+  {
+    std::vector<int> k_indices;
+    std::vector<float> k_distances;
+
+#pragma omp for schedule (dynamic, 256)
+    for (int i = 0; i < nr_indices; ++i)
+    {
+      // Perform a radius search to find the nearest neighbors
+      tree_->radiusSearch ((*indices_)[i], sigma_s_ * 2, k_indices, k_distances);
+
+      // Overwrite the intensity value with the computed average
+      output.points[(*indices_)[i]].intensity = computePointWeight ((*indices_)[i], k_indices, k_distances);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::BilateralFilter<PointT>::initIntensityKernel ()
+{
+  // Sample the kernel up to 6 sigma, where it drops below 1e-7
+  const int nr_samples = 1024;
+  intensity_lut_.resize (nr_samples + 1);
+  double range = 6 * sigma_r_;
+  if (!pcl_isfinite (range))
+  {
+    std::fill (intensity_lut_.begin (), intensity_lut_.end (), 1.0f);
+    intensity_lut_scale_ = 0;
+    return;
+  }
+  for (int i = 0; i <= nr_samples; ++i)
+    intensity_lut_[i] = (float)kernel (range * i / nr_samples, sigma_r_);
+  intensity_lut_scale_ = (float)(nr_samples / range);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::BilateralFilter<PointT>::applyPixelWindow (PointCloud &output)
+{
+  initIntensityKernel ();
+
+  // Precompute the spatial weights of a round window of 2 * sigma_s pixels
+  int half = (int)ceil (2 * sigma_s_);
+  int size = 2 * half + 1;
+  double max_sqr_dist = 4 * sigma_s_ * sigma_s_;
+  std::vector<float> spatial (size * size, 0.0f);
+  for (int dv = -half; dv <= half; ++dv)
+  {
+    for (int du = -half; du <= half; ++du)
+    {
+      double sqr_dist = du * du + dv * dv;
+      if (sqr_dist <= max_sqr_dist)
+        spatial[(dv + half) * size + du + half] = (float)kernel (sqrt (sqr_dist), sigma_s_);
+    }
+  }
+
+  // Copy the input data into the output
+  output = *input_;
+
+  int width = (int)input_->width, height = (int)input_->height;
+  int nr_indices = (int)indices_->size ();
+#pragma omp parallel for schedule (static) num_threads (threads_)
+  for (int i = 0; i < nr_indices; ++i)
+  {
+    int idx = (*indices_)[i];
+    const PointT &point = input_->points[idx];
+    if (!pcl_isfinite (point.x) || !pcl_isfinite (point.y) || !pcl_isfinite (point.z))
+      continue;
+
+    int u = idx % width, v = idx / width;
+    int v_min = (std::max) (v - half, 0), v_max = (std::min) (v + half, height - 1);
+    int u_min = (std::max) (u - half, 0), u_max = (std::min) (u + half, width - 1);
+
+    float BF = 0, W = 0;
+    for (int nv = v_min; nv <= v_max; ++nv)
+    {
+      const int spatial_row = (nv - v + half) * size;
+      for (int nu = u_min; nu <= u_max; ++nu)
+      {
+        const float spatial_weight = spatial[spatial_row + (nu - u + half)];
+        const PointT &neighbor = input_->points[nv * width + nu];
+        if (spatial_weight == 0 ||
+            !pcl_isfinite (neighbor.x) || !pcl_isfinite (neighbor.y) || !pcl_isfinite (neighbor.z))
+          continue;
+
+        float weight = spatial_weight * intensityKernel (fabs (point.intensity - neighbor.intensity));
+        BF += weight * neighbor.intensity;
+        W += weight;
+      }
+    }
+    if (W > 0)
+      output.points[idx].intensity = BF / W;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::BilateralFilter<PointT>::applyBilateralGrid (PointCloud &output)
+{
+  // Grid coordinates are sampled at sigma in every dimension
+  const double inv_cell[4] = {1.0 / sigma_s_, 1.0 / sigma_s_, 1.0 / sigma_s_, 1.0 / sigma_r_};
+  // Keep the integer cell coordinates far from overflowing
+  const double max_coord = 1e9;
+
+  // Copy the input data into the output
+  output = *input_;
+
+  // Find the cell every point splats into
+  int nr_points = (int)input_->points.size ();
+  std::vector<GridKey> keys (nr_points);
+  std::vector<uint8_t> valid (nr_points);
+#pragma omp parallel for schedule (static) num_threads (threads_)
+  for (int i = 0; i < nr_points; ++i)
+  {
+    const PointT &point = input_->points[i];
+    const double g[4] = {point.x * inv_cell[0], point.y * inv_cell[1], point.z * inv_cell[2], point.intensity * inv_cell[3]};
+    valid[i] = 1;
+    for (int d = 0; d < 4; ++d)
+    {
+      if (!(fabs (g[d]) < max_coord))
+      {
+        valid[i] = 0;
+        break;
+      }
+      keys[i].c[d] = (int)floor (g[d] + 0.5);
+    }
+  }
+
+  // Splat the intensities (nearest cell)
+  typedef boost::unordered_map<GridKey, int, GridKeyHash> CellMap;
+  CellMap cells;
+  std::vector<GridKey> cell_keys;
+  std::vector<double> values, weights;
+  for (int i = 0; i < nr_points; ++i)
   {
-    // Perform a radius search to find the nearest neighbors
-    tree_->radiusSearch ((*indices_)[i], sigma_s_ * 2, k_indices, k_distances);
+    if (!valid[i])
+      continue;
+    std::pair<typename CellMap::iterator, bool> it = cells.insert (std::make_pair (keys[i], (int)cell_keys.size ()));
+    if (it.second)
+    {
+      cell_keys.push_back (keys[i]);
+      values.push_back (0);
+      weights.push_back (0);
+    }
+    values[it.first->second] += input_->points[i].intensity;
+    weights[it.first->second] += 1;
+  }
+
+  // Blur the grid with a [1 2 1] kernel along every dimension
+  int nr_cells = (int)cell_keys.size ();
+  std::vector<double> blurred_values (nr_cells), blurred_weights (nr_cells);
+  for (int d = 0; d < 4; ++d)
+  {
+#pragma omp parallel for schedule (static) num_threads (threads_)
+    for (int c = 0; c < nr_cells; ++c)
+    {
+      double value = 2 * values[c], weight = 2 * weights[c];
+      GridKey key = cell_keys[c];
+      for (int step = -1; step <= 1; step += 2)
+      {
+        key.c[d] = cell_keys[c].c[d] + step;
+        typename CellMap::const_iterator it = cells.find (key);
+        if (it == cells.end ())
+          continue;
+        value += values[it->second];
+        weight += weights[it->second];
+      }
+      blurred_values[c] = value / 4;
+      blurred_weights[c] = weight / 4;
+    }
+    values.swap (blurred_values);
+    weights.swap (blurred_weights);
+  }
+
+  // Slice the grid (quadrilinear interpolation between the 16 surrounding cells)
+  int nr_indices = (int)indices_->size ();
+#pragma omp parallel for schedule (static) num_threads (threads_)
+  for (int i = 0; i < nr_indices; ++i)
+  {
+    int idx = (*indices_)[i];
+    if (!valid[idx])
+      continue;
+
+    const PointT &point = input_->points[idx];
+    const double g[4] = {point.x * inv_cell[0], point.y * inv_cell[1], point.z * inv_cell[2], point.intensity * inv_cell[3]};
+    int base[4];
+    double frac[4];
+    for (int d = 0; d < 4; ++d)
+    {
+      base[d] = (int)floor (g[d]);
+      frac[d] = g[d] - base[d];
+    }
 
-    // Overwrite the intensity value with the computed average
-    output.points[(*indices_)[i]].intensity = computePointWeight ((*indices_)[i], k_indices, k_distances);
+    double value = 0, weight = 0;
+    for (int corner = 0; corner < 16; ++corner)
+    {
+      GridKey key;
+      double w = 1;
+      for (int d = 0; d < 4; ++d)
+      {
+        int bit = (corner >> d) & 1;
+        key.c[d] = base[d] + bit;
+        w *= bit ? frac[d] : 1 - frac[d];
+      }
+      if (w == 0)
+        continue;
+      typename CellMap::const_iterator it = cells.find (key);
+      if (it == cells.end ())
+        continue;
+      value += w * values[it->second];
+      weight += w * weights[it->second];
+    }
+    if (weight > 0)
+      output.points[idx].intensity = (float)(value / weight);
   }
 }
  
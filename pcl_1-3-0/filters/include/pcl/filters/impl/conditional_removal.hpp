@@ -41,6 +41,136 @@
 #include <pcl/common/io.h>
 #include <boost/shared_ptr.hpp>
 #include <vector>
+#include <cstring>
+
+namespace pcl
+{
+  namespace detail
+  {
+    //////////////////////////////////////////////////////////////////////////
+    /** \brief Compare a strided field of type T against val, with the same 
+      * semantics as the three-way comparison in PointDataAtOffset::compare ().
+      */
+    template <typename T> inline void
+    compareFieldBlock (const uint8_t *data, size_t stride, int nr_points, 
+                       ComparisonOps::CompareOp op, const T val, uint8_t *result)
+    {
+      T pt_val;
+      switch (op)
+      {
+        case ComparisonOps::GT :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&pt_val, data, sizeof (T));
+            result[i] = (pt_val > val);
+          }
+          break;
+        case ComparisonOps::GE :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&pt_val, data, sizeof (T));
+            result[i] = !(pt_val < val);
+          }
+          break;
+        case ComparisonOps::LT :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&pt_val, data, sizeof (T));
+            result[i] = (pt_val < val);
+          }
+          break;
+        case ComparisonOps::LE :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&pt_val, data, sizeof (T));
+            result[i] = !(pt_val > val);
+          }
+          break;
+        case ComparisonOps::EQ :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&pt_val, data, sizeof (T));
+            result[i] = !(pt_val < val) & !(pt_val > val);
+          }
+          break;
+        default:
+          PCL_WARN ("[pcl::FieldComparison::evaluateBlock] unrecognized op_!\n");
+          memset (result, 0, nr_points);
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    /** \brief Compare a strided value of type T against val, with the same 
+      * semantics as PackedRGBComparison::evaluate () and PackedHSIComparison::evaluate ().
+      */
+    template <typename T> inline void
+    compareValueBlock (const uint8_t *data, size_t stride, int nr_points, 
+                       ComparisonOps::CompareOp op, const double val, uint8_t *result)
+    {
+      T my_val;
+      switch (op)
+      {
+        case ComparisonOps::GT :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&my_val, data, sizeof (T));
+            result[i] = (my_val > val);
+          }
+          break;
+        case ComparisonOps::GE :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&my_val, data, sizeof (T));
+            result[i] = (my_val >= val);
+          }
+          break;
+        case ComparisonOps::LT :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&my_val, data, sizeof (T));
+            result[i] = (my_val < val);
+          }
+          break;
+        case ComparisonOps::LE :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&my_val, data, sizeof (T));
+            result[i] = (my_val <= val);
+          }
+          break;
+        case ComparisonOps::EQ :
+          for (int i = 0; i < nr_points; ++i, data += stride)
+          {
+            memcpy (&my_val, data, sizeof (T));
+            result[i] = (my_val == val);
+          }
+          break;
+        default:
+          PCL_WARN ("[pcl::ComparisonBase::evaluateBlock] unrecognized op_!\n");
+          memset (result, 0, nr_points);
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    /** \brief Return true if any of the first n entries in mask equals val. */
+    inline bool
+    anyEqual (const uint8_t *mask, int n, uint8_t val)
+    {
+      for (int i = 0; i < n; ++i)
+        if (mask[i] == val)
+          return (true);
+      return (false);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ComparisonBase<PointT>::evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const
+{
+  for (int i = 0; i < nr_points; ++i)
+    result[i] = evaluate (points[i]);
+}
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -132,6 +262,20 @@ pcl::FieldComparison<PointT>::evaluate (const PointT &point) const
   }
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FieldComparison<PointT>::evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const
+{
+  if (!this->capable_)
+  {
+    PCL_WARN ("[pcl::FieldComparison::evaluateBlock] invalid compariosn!\n");
+    memset (result, 0, nr_points);
+    return;
+  }
+
+  point_data_->compare (points, nr_points, compare_val_, this->op_, result);
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -225,6 +369,14 @@ pcl::PackedRGBComparison<PointT>::evaluate (const PointT &point) const
   }
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PackedRGBComparison<PointT>::evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const
+{
+  const uint8_t* pt_data = reinterpret_cast<const uint8_t*> (points) + component_offset_;
+  pcl::detail::compareValueBlock<uint8_t> (pt_data, sizeof (PointT), nr_points, this->op_, this->compare_val_, result);
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -375,6 +527,53 @@ pcl::PackedHSIComparison<PointT>::evaluate (const PointT &point) const
   }
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PackedHSIComparison<PointT>::evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const
+{
+  const int block_size = ConditionBase<PointT>::BLOCK_SIZE;
+  float my_val[block_size];
+
+  const uint8_t* pt_data = reinterpret_cast<const uint8_t*> (points) + rgb_offset_;
+  for (int start = 0; start < nr_points; start += block_size)
+  {
+    int n = (nr_points - start < block_size) ? nr_points - start : block_size;
+
+    // Same conversion as in evaluate (), only the requested component is computed
+    for (int i = 0; i < n; ++i, pt_data += sizeof (PointT))
+    {
+      uint32_t rgb_val;
+      memcpy (&rgb_val, pt_data, sizeof (uint32_t));
+      uint8_t r = (uint8_t)(rgb_val >> 16);
+      uint8_t g = (uint8_t)(rgb_val >> 8);
+      uint8_t b = (uint8_t)(rgb_val);
+
+      if (component_id_ == H)
+      {
+        float hx = (2*r - g - b)/4.0;  // hue x component -127 to 127
+        float hy = (g - b) * 111.0 / 255.0; // hue y component -111 to 111
+        my_val[i] = (float)(int8_t) (atan2(hy, hx) * 128.0 / M_PI);
+        continue;
+      }
+
+      int32_t intensity = (r+g+b)/3; // 0 to 255
+      if (component_id_ == I)
+      {
+        my_val[i] = (float)(uint8_t)intensity;
+        continue;
+      }
+
+      int32_t m;  // min(r,g,b)
+      m = (r < g) ? r : g;
+      m = (m < b) ? m : b;
+      my_val[i] = (float)(uint8_t)((intensity == 0) ? 0 : 255 - (m*255)/intensity); // saturation 0 to 255
+    }
+
+    pcl::detail::compareValueBlock<float> (reinterpret_cast<const uint8_t*> (my_val), sizeof (float), n, 
+                                           this->op_, this->compare_val_, result + start);
+  }
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -444,6 +643,50 @@ pcl::PointDataAtOffset<PointT>::compare (const PointT& p, const double& val)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PointDataAtOffset<PointT>::compare (const PointT *points, int nr_points, const double& val, 
+                                         ComparisonOps::CompareOp op, uint8_t *result)
+{
+  const uint8_t* pt_data = reinterpret_cast<const uint8_t*> (points) + this->offset_;
+  const size_t stride = sizeof (PointT);
+
+  switch (datatype_) 
+  {
+    case sensor_msgs::PointField::INT8 : 
+      pcl::detail::compareFieldBlock<int8_t> (pt_data, stride, nr_points, op, (int8_t)val, result);
+      break;
+    case sensor_msgs::PointField::UINT8 : 
+      pcl::detail::compareFieldBlock<uint8_t> (pt_data, stride, nr_points, op, (uint8_t)val, result);
+      break;
+    case sensor_msgs::PointField::INT16 : 
+      pcl::detail::compareFieldBlock<int16_t> (pt_data, stride, nr_points, op, (int16_t)val, result);
+      break;
+    case sensor_msgs::PointField::UINT16 : 
+      pcl::detail::compareFieldBlock<uint16_t> (pt_data, stride, nr_points, op, (uint16_t)val, result);
+      break;
+    case sensor_msgs::PointField::INT32 : 
+      pcl::detail::compareFieldBlock<int32_t> (pt_data, stride, nr_points, op, (int32_t)val, result);
+      break;
+    case sensor_msgs::PointField::UINT32 : 
+      pcl::detail::compareFieldBlock<uint32_t> (pt_data, stride, nr_points, op, (uint32_t)val, result);
+      break;
+    case sensor_msgs::PointField::FLOAT32 : 
+      pcl::detail::compareFieldBlock<float> (pt_data, stride, nr_points, op, (float)val, result);
+      break;
+    case sensor_msgs::PointField::FLOAT64 : 
+      pcl::detail::compareFieldBlock<double> (pt_data, stride, nr_points, op, val, result);
+      break;
+    default : 
+    {
+      // compare () treats unknown data as equal to val
+      PCL_WARN ("[pcl::pcl::PointDataAtOffset::compare] unknown data_type!\n");
+      uint8_t equal = (op == ComparisonOps::GE || op == ComparisonOps::LE || op == ComparisonOps::EQ);
+      memset (result, equal, nr_points);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -464,6 +707,14 @@ pcl::ConditionBase<PointT>::addCondition (Ptr condition)
   conditions_.push_back (condition);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ConditionBase<PointT>::evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const
+{
+  for (int i = 0; i < nr_points; ++i)
+    result[i] = evaluate (points[i]);
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -481,6 +732,36 @@ pcl::ConditionAnd<PointT>::evaluate (const PointT &point) const
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ConditionAnd<PointT>::evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const
+{
+  const int block_size = ConditionBase<PointT>::BLOCK_SIZE;
+  uint8_t partial[block_size];
+
+  for (int start = 0; start < nr_points; start += block_size)
+  {
+    int n = (nr_points - start < block_size) ? nr_points - start : block_size;
+    uint8_t *block_result = result + start;
+    memset (block_result, 1, n);
+
+    for (size_t c = 0; c < comparisons_.size () + conditions_.size (); ++c)
+    {
+      // Stop as soon as every point of the block has failed
+      if (!pcl::detail::anyEqual (block_result, n, 1))
+        break;
+
+      if (c < comparisons_.size ())
+        comparisons_[c]->evaluateBlock (points + start, n, partial);
+      else
+        conditions_[c - comparisons_.size ()]->evaluateBlock (points + start, n, partial);
+
+      for (int i = 0; i < n; ++i)
+        block_result[i] &= partial[i];
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -500,6 +781,42 @@ pcl::ConditionOr<PointT>::evaluate (const PointT &point) const
   return (false);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ConditionOr<PointT>::evaluateBlock (const PointT *points, int nr_points, uint8_t *result) const
+{
+  if (comparisons_.empty () && conditions_.empty ()) 
+  {
+    memset (result, 1, nr_points);
+    return;
+  }
+
+  const int block_size = ConditionBase<PointT>::BLOCK_SIZE;
+  uint8_t partial[block_size];
+
+  for (int start = 0; start < nr_points; start += block_size)
+  {
+    int n = (nr_points - start < block_size) ? nr_points - start : block_size;
+    uint8_t *block_result = result + start;
+    memset (block_result, 0, n);
+
+    for (size_t c = 0; c < comparisons_.size () + conditions_.size (); ++c)
+    {
+      // Stop as soon as every point of the block has passed
+      if (!pcl::detail::anyEqual (block_result, n, 0))
+        break;
+
+      if (c < comparisons_.size ())
+        comparisons_[c]->evaluateBlock (points + start, n, partial);
+      else
+        conditions_[c - comparisons_.size ()]->evaluateBlock (points + start, n, partial);
+
+      for (int i = 0; i < n; ++i)
+        block_result[i] |= partial[i];
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -548,6 +865,19 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
   output.points.resize (input_->points.size ());
   removed_indices_->resize (input_->points.size ());
 
+  // Evaluate the condition block by block, each block only writes its own part of the mask
+  std::vector<uint8_t> passed (input_->points.size ());
+  const int nr_points = static_cast<int> (input_->points.size ());
+  const int block_size = ConditionBase::BLOCK_SIZE;
+  const int nr_blocks = (nr_points + block_size - 1) / block_size;
+#pragma omp parallel for schedule (static) num_threads (threads_)
+  for (int b = 0; b < nr_blocks; ++b)
+  {
+    int start = b * block_size;
+    int n = (nr_points - start < block_size) ? nr_points - start : block_size;
+    condition_->evaluateBlock (&input_->points[start], n, &passed[start]);
+  }
+
   int nr_p = 0;
   int nr_removed_p = 0;
 
@@ -568,7 +898,7 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
         continue;
       } 
 
-      if (condition_->evaluate (input_->points[cp]))
+      if (passed[cp])
       {
         pcl::for_each_type <FieldList> (pcl::NdConcatenateFunctor <PointT, PointT> (input_->points[cp], output.points[nr_p]));
         nr_p++;
@@ -592,7 +922,7 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
     {
       // copy all the fields
       pcl::for_each_type <FieldList> (pcl::NdConcatenateFunctor <PointT, PointT> (input_->points[cp], output.points[cp]));
-      if (!condition_->evaluate (input_->points[cp]))
+      if (!passed[cp])
       {
         output.points[cp].getVector4fMap ().setConstant (user_filter_value_);
 
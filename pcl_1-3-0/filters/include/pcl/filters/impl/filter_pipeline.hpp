@@ -0,0 +1,150 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FILTERS_IMPL_FILTER_PIPELINE_H_
+#define PCL_FILTERS_IMPL_FILTER_PIPELINE_H_
+
+#include "pcl/filters/filter_pipeline.h"
+#include "pcl/common/io.h"
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::testPoints (const PointCloud &cloud, const std::vector<int> &indices,
+                                         const std::vector<FilterIndicesPtr> &tests, std::vector<int> &passed)
+{
+  // Test all points in parallel, then compact the indices in order
+  std::vector<uint8_t> mask (indices.size ());
+  const int nr_indices = static_cast<int> (indices.size ());
+#pragma omp parallel for schedule (static) num_threads (threads_)
+  for (int i = 0; i < nr_indices; ++i)
+  {
+    const PointT &point = cloud.points[indices[i]];
+    bool pass = true;
+    for (size_t t = 0; t < tests.size () && pass; ++t)
+      pass = tests[t]->testPoint (point);
+    mask[i] = pass;
+  }
+
+  passed.resize (indices.size ());
+  int nr_p = 0;
+  for (int i = 0; i < nr_indices; ++i)
+    if (mask[i])
+      passed[nr_p++] = indices[i];
+  passed.resize (nr_p);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::applyFilter (PointCloud &output)
+{
+  // The cloud the current indices refer to, and whether they cover all of it in order
+  PointCloudConstPtr cloud = input_;
+  IndicesPtr indices = indices_;
+  bool all_points = fake_indices_;
+
+  size_t s = 0;
+  while (s < stages_.size ())
+  {
+    if (stages_[s].indices_filter)
+    {
+      // Collect the run of consecutive point-wise filters starting here
+      std::vector<FilterIndicesPtr> tests;
+      size_t e = s;
+      for (; e < stages_.size () && stages_[e].indices_filter; ++e)
+      {
+        stages_[e].indices_filter->setInputCloud (cloud);
+        if (!stages_[e].indices_filter->initPointTest ())
+          break;
+        tests.push_back (stages_[e].indices_filter);
+      }
+
+      IndicesPtr passed (new std::vector<int>);
+      if (!tests.empty ())
+      {
+        testPoints (*cloud, *indices, tests, *passed);
+        s = e;
+      }
+      else
+      {
+        stages_[s].indices_filter->setIndices (indices);
+        stages_[s].indices_filter->filter (*passed);
+        ++s;
+      }
+      indices = passed;
+      all_points = false;
+      continue;
+    }
+
+    // The filter produces new points: hand it either the current indices or a copy of the points
+    const Stage &stage = stages_[s];
+    if (all_points || stage.use_indices)
+    {
+      stage.filter->setInputCloud (cloud);
+      stage.filter->setIndices (indices);
+    }
+    else
+    {
+      PointCloudPtr subset (new PointCloud);
+      pcl::copyPointCloud (*cloud, *indices, *subset);
+      stage.filter->setInputCloud (subset);
+      stage.filter->setIndices (IndicesPtr ());
+    }
+
+    // The last filter writes to the output directly
+    if (s + 1 == stages_.size ())
+    {
+      stage.filter->filter (output);
+      return;
+    }
+
+    PointCloudPtr result (new PointCloud);
+    stage.filter->filter (*result);
+    cloud = result;
+    indices.reset (new std::vector<int> (result->points.size ()));
+    for (size_t i = 0; i < indices->size (); ++i)
+      (*indices)[i] = static_cast<int> (i);
+    all_points = true;
+    ++s;
+  }
+
+  // Make the one copy of the surviving points
+  pcl::copyPointCloud (*cloud, *indices, output);
+}
+
+#define PCL_INSTANTIATE_FilterPipeline(T) template class PCL_EXPORTS pcl::FilterPipeline<T>;
+
+#endif    // PCL_FILTERS_IMPL_FILTER_PIPELINE_H_
@@ -230,6 +230,67 @@ pcl::PassThrough<PointT>::applyFilter (PointCloud &output)
   removed_indices_->resize(nr_removed_p);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::PassThrough<PointT>::initPointTest ()
+{
+  field_offset_ = -1;
+  if (filter_field_name_.empty ())
+    return (true);
+
+  // Get the distance field index
+  std::vector<sensor_msgs::PointField> fields;
+  int distance_idx = pcl::getFieldIndex (*input_, filter_field_name_, fields);
+  if (distance_idx == -1)
+    return (false);
+
+  field_offset_ = fields[distance_idx].offset;
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::PassThrough<PointT>::testPoint (const PointT &point) const
+{
+  // Check if the point is invalid
+  if (!pcl_isfinite (point.x) || !pcl_isfinite (point.y) || !pcl_isfinite (point.z))
+    return (false);
+
+  if (field_offset_ == -1)
+    return (true);
+
+  // Get the distance value
+  const uint8_t* pt_data = (const uint8_t*)&point;
+  float distance_value = 0;
+  memcpy (&distance_value, pt_data + field_offset_, sizeof (float));
+
+  if (filter_limit_negative_)
+    // Use a threshold for cutting out points which inside the interval
+    return (!((distance_value < filter_limit_max_) && (distance_value > filter_limit_min_)));
+  else
+    // Use a threshold for cutting out points which are too close/far away
+    return (!((distance_value > filter_limit_max_) || (distance_value < filter_limit_min_)));
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PassThrough<PointT>::applyFilter (std::vector<int> &indices)
+{
+  if (!initPointTest ())
+  {
+    PCL_WARN ("[pcl::%s::applyFilter] Invalid filter field name %s.\n", getClassName ().c_str (), filter_field_name_.c_str ());
+    indices.clear ();
+    return;
+  }
+
+  indices.resize (indices_->size ());
+  int nr_p = 0;
+  for (size_t i = 0; i < indices_->size (); ++i)
+    if (testPoint (input_->points[(*indices_)[i]]))
+      indices[nr_p++] = (*indices_)[i];
+  indices.resize (nr_p);
+}
+
 #define PCL_INSTANTIATE_PassThrough(T) template class PCL_EXPORTS pcl::PassThrough<T>;
 
 #endif    // PCL_FILTERS_IMPL_PASSTHROUGH_H_
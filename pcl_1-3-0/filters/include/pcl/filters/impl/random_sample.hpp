@@ -80,9 +80,9 @@ template<typename PointT>
 void
 pcl::RandomSample<PointT>::applyFilter (std::vector<int> &indices)
 {
-  // If sample size is 0 or if the sample size is greater then input cloud size
+  // If sample size is 0 or if the sample size is greater then the number of input indices
   //   then return all indices
-  if (sample_ >= input_->size ())
+  if (sample_ >= indices_->size ())
   {
     indices = *indices_;
   }
@@ -142,25 +142,7 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
   else
     getMinMax3D<PointT>(*input_, min_p, max_p);
 
-  // Compute the minimum and maximum bounding box values
-//  min_b_ = (min_p.array () * inverse_leaf_size_).template cast<int> ();
-//  max_b_ = (max_p.array () * inverse_leaf_size_).template cast<int> ();
-  min_b_[0] = (int)(floor (min_p[0] * inverse_leaf_size_[0]));
-  max_b_[0] = (int)(floor (max_p[0] * inverse_leaf_size_[0]));
-  min_b_[1] = (int)(floor (min_p[1] * inverse_leaf_size_[1]));
-  max_b_[1] = (int)(floor (max_p[1] * inverse_leaf_size_[1]));
-  min_b_[2] = (int)(floor (min_p[2] * inverse_leaf_size_[2]));
-  max_b_[2] = (int)(floor (max_p[2] * inverse_leaf_size_[2]));
-
-  // Compute the number of divisions needed along all axis
-  div_b_ = max_b_ - min_b_ + Eigen::Vector4i::Ones ();
-  div_b_[3] = 0;
-
-  // Clear the leaves
-  leaves_.clear ();
-
-  // Set up the division multiplier
-  divb_mul_ = Eigen::Vector4i (1, div_b_[0], div_b_[0] * div_b_[1], 0);
+  initGrid (min_p, max_p);
 
   int centroid_size = 4;
   if (downsample_all_data_)
@@ -312,6 +294,38 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
   }
 
   // Second pass: go over all leaves and compute centroids
+  computeCentroids (output, centroid_size, rgba_index);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::VoxelGrid<PointT>::initGrid (const Eigen::Vector4f &min_p, const Eigen::Vector4f &max_p)
+{
+  // Compute the minimum and maximum bounding box values
+//  min_b_ = (min_p.array () * inverse_leaf_size_).template cast<int> ();
+//  max_b_ = (max_p.array () * inverse_leaf_size_).template cast<int> ();
+  min_b_[0] = (int)(floor (min_p[0] * inverse_leaf_size_[0]));
+  max_b_[0] = (int)(floor (max_p[0] * inverse_leaf_size_[0]));
+  min_b_[1] = (int)(floor (min_p[1] * inverse_leaf_size_[1]));
+  max_b_[1] = (int)(floor (max_p[1] * inverse_leaf_size_[1]));
+  min_b_[2] = (int)(floor (min_p[2] * inverse_leaf_size_[2]));
+  max_b_[2] = (int)(floor (max_p[2] * inverse_leaf_size_[2]));
+
+  // Compute the number of divisions needed along all axis
+  div_b_ = max_b_ - min_b_ + Eigen::Vector4i::Ones ();
+  div_b_[3] = 0;
+
+  // Clear the leaves
+  leaves_.clear ();
+
+  // Set up the division multiplier
+  divb_mul_ = Eigen::Vector4i (1, div_b_[0], div_b_[0] * div_b_[1], 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::VoxelGrid<PointT>::computeCentroids (PointCloud &output, int centroid_size, int rgba_index)
+{
   output.points.resize (leaves_.size ());
   int cp = 0, i = 0;
   if (save_leaf_layout_)
@@ -363,6 +377,100 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
   output.width = output.points.size ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::VoxelGrid<PointT>::filter (const PointCloudSoA<PointT> &input, PointCloud &output)
+{
+  // Copy header at a minimum
+  output.header   = input.header;
+  output.height   = 1;                    // downsampling breaks the organized structure
+  output.is_dense = true;                 // we filter out invalid points
+
+  if (input.empty ())
+  {
+    output.width = 0;
+    output.points.clear ();
+    return;
+  }
+
+  if (!filter_field_name_.empty ())
+    PCL_WARN ("[pcl::%s::filter] The field limits are not applied to structure-of-arrays input!\n", getClassName ().c_str ());
+
+  Eigen::Vector4f min_p, max_p;
+  getMinMax3D<PointT> (input, min_p, max_p);
+  initGrid (min_p, max_p);
+
+  int centroid_size = 4;
+  if (downsample_all_data_)
+    centroid_size = boost::mpl::size<FieldList>::value;
+
+  // ---[ RGB special case
+  std::vector<sensor_msgs::PointField> fields;
+  const uint8_t *rgba_column = NULL;
+  int rgba_index = -1;
+  rgba_index = pcl::getFieldIndex (output, "rgb", fields);
+  if (rgba_index == -1)
+    rgba_index = pcl::getFieldIndex (output, "rgba", fields);
+  if (rgba_index >= 0)
+  {
+    pcl::for_each_type <FieldList> (FindColumnFunctor <PointT> (input, fields[rgba_index].name, rgba_column));
+    rgba_index = fields[rgba_index].offset;
+    centroid_size += 3;
+  }
+
+  // First pass: go over all points and insert them into the right leaf
+  const float *x = input.x (), *y = input.y (), *z = input.z ();
+  for (size_t cp = 0; cp < input.size (); ++cp)
+  {
+    if (!input.is_dense)
+      // Check if the point is invalid
+      if (!pcl_isfinite (x[cp]) || !pcl_isfinite (y[cp]) || !pcl_isfinite (z[cp]))
+        continue;
+
+    Eigen::Vector4i ijk = Eigen::Vector4i::Zero ();
+    ijk[0] = (int)(floor (x[cp] * inverse_leaf_size_[0]));
+    ijk[1] = (int)(floor (y[cp] * inverse_leaf_size_[1]));
+    ijk[2] = (int)(floor (z[cp] * inverse_leaf_size_[2]));
+
+    // Compute the centroid leaf index
+    int idx = (ijk - min_b_).dot (divb_mul_);
+    Leaf& leaf = leaves_[idx];
+    if (leaf.nr_points == 0)
+    {
+      leaf.centroid.resize (centroid_size);
+      leaf.centroid.setZero ();
+    }
+
+    // Do we need to process all the fields?
+    if (!downsample_all_data_)
+    {
+      Eigen::Vector4f pt (x[cp], y[cp], z[cp], 0);
+      leaf.centroid.template head<4> () += pt;
+    }
+    else
+    {
+      // Copy all the fields
+      Eigen::VectorXf centroid = Eigen::VectorXf::Zero (centroid_size);
+      // ---[ RGB special case
+      if (rgba_column)
+      {
+        // Fill r/g/b data, assuming that the order is BGRA
+        pcl::RGB rgb;
+        memcpy (&rgb, rgba_column + cp * sizeof (RGB), sizeof (RGB));
+        centroid[centroid_size-3] = rgb.r;
+        centroid[centroid_size-2] = rgb.g;
+        centroid[centroid_size-1] = rgb.b;
+      }
+      pcl::for_each_type <FieldList> (NdCopyColumnsEigenFunctor <PointT> (input, cp, centroid));
+      leaf.centroid += centroid;
+    }
+    ++leaf.nr_points;
+  }
+
+  // Second pass: go over all leaves and compute centroids
+  computeCentroids (output, centroid_size, rgba_index);
+}
+
 #define PCL_INSTANTIATE_VoxelGrid(T) template class PCL_EXPORTS pcl::VoxelGrid<T>;
 #define PCL_INSTANTIATE_getMinMax3D(T) template PCL_EXPORTS void pcl::getMinMax3D<T> (const pcl::PointCloud<T>::ConstPtr &, const std::string &, float, float, Eigen::Vector4f &, Eigen::Vector4f &, bool);
 
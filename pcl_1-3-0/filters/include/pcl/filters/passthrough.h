@@ -38,7 +38,7 @@
 #ifndef PCL_FILTERS_PASSTHROUGH_H_
 #define PCL_FILTERS_PASSTHROUGH_H_
 
-#include "pcl/filters/filter.h"
+#include "pcl/filters/filter_indices.h"
 
 namespace pcl
 {
@@ -49,9 +49,10 @@ namespace pcl
     * \ingroup filters
     */
   template<typename PointT>
-  class PassThrough : public Filter<PointT>
+  class PassThrough : public FilterIndices<PointT>
   {
     using Filter<PointT>::input_;
+    using Filter<PointT>::indices_;
     using Filter<PointT>::filter_name_;
     using Filter<PointT>::filter_field_name_;
     using Filter<PointT>::filter_limit_min_;
@@ -69,9 +70,10 @@ namespace pcl
     public:
       /** \brief Constructor. */
       PassThrough (bool extract_removed_indices = false) :
-        Filter<PointT>::Filter (extract_removed_indices), keep_organized_ (false), 
-        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ())
+        keep_organized_ (false), user_filter_value_ (std::numeric_limits<float>::quiet_NaN ()),
+        field_offset_ (-1)
       {
+        extract_removed_indices_ = extract_removed_indices;
         filter_name_ = "PassThrough";
       }
 
@@ -105,6 +107,20 @@ namespace pcl
       {
         user_filter_value_ = val;
       }
+
+      /** \brief Resolve the filter field for \a testPoint ().
+        * \return false if the filter field name is invalid
+        */
+      bool
+      initPointTest ();
+
+      /** \brief Check whether a single point passes the filter, i.e. has finite x, y and z 
+        * and (if a filter field name is set) a field value that satisfies the filter limits.
+        * \param point the point to test
+        */
+      bool
+      testPoint (const PointT &point) const;
+
     protected:
       /** \brief Filter a Point Cloud.
         * \param output the resultant point cloud message
@@ -112,6 +128,13 @@ namespace pcl
       void
       applyFilter (PointCloud &output);
 
+      /** \brief Filter a Point Cloud and return the indices of the points that pass.
+        * The organized structure is never kept, i.e. \a setKeepOrganized () is ignored.
+        * \param indices the resultant point cloud indices
+        */
+      void
+      applyFilter (std::vector<int> &indices);
+
       typedef typename pcl::traits::fieldList<PointT>::type FieldList;
 
     private:
@@ -124,6 +147,9 @@ namespace pcl
         * the correct field type. 
         */
       float user_filter_value_;
+
+      /** \brief Byte offset of the filter field, -1 if no field is filtered. Set by initPointTest (). */
+      int field_offset_;
   };
 
   ////////////////////////////////////////////////////////////////////////////////////////////
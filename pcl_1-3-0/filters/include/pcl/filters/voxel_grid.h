@@ -39,6 +39,7 @@
 #define PCL_FILTERS_VOXEL_GRID_MAP_H_
 
 #include "pcl/filters/filter.h"
+#include "pcl/point_cloud_soa.h"
 #include <map>
 #include <boost/unordered_map.hpp>
 #include <boost/mpl/size.hpp>
@@ -119,6 +120,44 @@ namespace pcl
       int f_idx_;
   };
 
+  /** \brief Helper functor structure for copying the fields of one point of a PointCloudSoA into an Eigen::VectorXf. */
+  template <typename PointT>
+  struct NdCopyColumnsEigenFunctor
+  {
+    NdCopyColumnsEigenFunctor (const PointCloudSoA<PointT> &p1, size_t index, Eigen::VectorXf &p2)
+      : p1_ (p1), index_ (index), p2_ (p2), f_idx_ (0) { }
+
+    template<typename Key> inline void operator() ()
+    {
+      p2_[f_idx_++] = p1_.template getField<Key> ()[index_];
+    }
+
+    private:
+      const PointCloudSoA<PointT> &p1_;
+      size_t index_;
+      Eigen::VectorXf &p2_;
+      int f_idx_;
+  };
+
+  /** \brief Helper functor structure for finding the column of a field of a PointCloudSoA by name. */
+  template <typename PointT>
+  struct FindColumnFunctor
+  {
+    FindColumnFunctor (const PointCloudSoA<PointT> &cloud, const std::string &name, const uint8_t *&column)
+      : cloud_ (cloud), name_ (name), column_ (column) { }
+
+    template<typename Key> inline void operator() ()
+    {
+      if (name_ == pcl::traits::name<PointT, Key>::value)
+        column_ = reinterpret_cast<const uint8_t*> (cloud_.template getField<Key> ());
+    }
+
+    private:
+      const PointCloudSoA<PointT> &cloud_;
+      const std::string &name_;
+      const uint8_t *&column_;
+  };
+
   /** \brief @b VoxelGrid assembles a local 3D grid over a given PointCloud, and downsamples + filters the data.
     *
     * The @b VoxelGrid class creates a *3D voxel grid* (think about a voxel
@@ -163,6 +202,16 @@ namespace pcl
         leaves_.clear();
       }
 
+      using Filter<PointT>::filter;
+
+      /** \brief Downsample a structure-of-arrays dataset, reading the x, y and z columns directly.
+        * \param input the structure-of-arrays input dataset (used instead of the input cloud)
+        * \param output the resultant point cloud
+        * \note The indices and the field limits (setFilterFieldName) are not applied to \a input.
+        */
+      void
+      filter (const PointCloudSoA<PointT> &input, PointCloud &output);
+
       /** \brief Set the voxel grid leaf size.
         * \param leaf_size the voxel grid leaf size
         */
@@ -347,6 +396,21 @@ namespace pcl
         */
       void 
       applyFilter (PointCloud &output);
+
+      /** \brief Compute the bin bounds and divisions of the grid and clear the leaves.
+        * \param min_p the minimum bounds of the data
+        * \param max_p the maximum bounds of the data
+        */
+      void
+      initGrid (const Eigen::Vector4f &min_p, const Eigen::Vector4f &max_p);
+
+      /** \brief Second pass: write the centroid of every leaf into the output.
+        * \param output the resultant point cloud
+        * \param centroid_size the number of values accumulated per leaf
+        * \param rgba_index the byte offset of the rgb/rgba field in PointT, or -1 if there is none
+        */
+      void
+      computeCentroids (PointCloud &output, int centroid_size, int rgba_index);
   };
 
   /** \brief @b VoxelGrid assembles a local 3D grid over a given PointCloud, and downsamples + filters the data.
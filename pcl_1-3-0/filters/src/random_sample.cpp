@@ -86,9 +86,9 @@ pcl::RandomSample<sensor_msgs::PointCloud2>::applyFilter (PointCloud2 &output)
 void
 pcl::RandomSample<sensor_msgs::PointCloud2>::applyFilter (std::vector<int> &indices)
 {
-  // If sample size is 0 or if the sample size is greater then input cloud size
+  // If sample size is 0 or if the sample size is greater then the number of input indices
   //   then return all indices
-  if (sample_ >= input_->width * input_->height)
+  if (sample_ >= indices_->size ())
   {
     indices = *indices_;
   }
@@ -0,0 +1,128 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2010, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+using namespace std;
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/filters/bilateral.h>
+using namespace pcl;
+
+/** \brief Brute-force bilateral filter over a round window of 2 * sigma_s pixels. */
+float
+bilateralReference (const PointCloud<PointXYZI> &cloud, int u, int v, double sigma_s, double sigma_r)
+{
+  const PointXYZI &point = cloud (u, v);
+  double BF = 0, W = 0;
+  for (int nv = 0; nv < (int)cloud.height; ++nv)
+  {
+    for (int nu = 0; nu < (int)cloud.width; ++nu)
+    {
+      const PointXYZI &neighbor = cloud (nu, nv);
+      double sqr_dist = (nu - u) * (nu - u) + (nv - v) * (nv - v);
+      if (sqr_dist > 4 * sigma_s * sigma_s || !pcl_isfinite (neighbor.x))
+        continue;
+      double intensity_dist = neighbor.intensity - point.intensity;
+      double weight = exp (-sqr_dist / (2 * sigma_s * sigma_s)) *
+                      exp (-intensity_dist * intensity_dist / (2 * sigma_r * sigma_r));
+      BF += weight * neighbor.intensity;
+      W += weight;
+    }
+  }
+  return ((float)(BF / W));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, BilateralFilter_pixelWindow)
+{
+  // A tilted plane with a step in intensity and some noise, organized as a 64x48 image
+  PointCloud<PointXYZI>::Ptr cloud (new PointCloud<PointXYZI> ());
+  cloud->width = 64;
+  cloud->height = 48;
+  cloud->is_dense = false;
+  cloud->points.resize (cloud->width * cloud->height);
+  srand (0);
+  for (int v = 0; v < (int)cloud->height; ++v)
+  {
+    for (int u = 0; u < (int)cloud->width; ++u)
+    {
+      PointXYZI &point = (*cloud) (u, v);
+      point.x = 0.01f * u;
+      point.y = 0.01f * v;
+      point.z = 1.0f + 0.005f * u;
+      point.intensity = (u < 30 ? 0.2f : 0.8f) + 0.05f * (rand () / (float)RAND_MAX);
+    }
+  }
+  (*cloud) (10, 10).x = numeric_limits<float>::quiet_NaN ();
+
+  const double sigma_s = 2.0, sigma_r = 0.1;
+  BilateralFilter<PointXYZI> filter;
+  filter.setInputCloud (cloud);
+  filter.setHalfSize (sigma_s);
+  filter.setStdDev (sigma_r);
+  filter.setComputeMode (BilateralFilter<PointXYZI>::PIXEL_WINDOW);
+  filter.setNumberOfThreads (2);
+  PointCloud<PointXYZI> output;
+  filter.filter (output);
+
+  ASSERT_EQ (output.points.size (), cloud->points.size ());
+  EXPECT_EQ (output (10, 10).intensity, (*cloud) (10, 10).intensity);
+  for (int v = 0; v < (int)cloud->height; ++v)
+  {
+    for (int u = 0; u < (int)cloud->width; ++u)
+    {
+      if (u == 10 && v == 10)
+        continue;
+      // The intensity kernel is read from a lookup table
+      EXPECT_NEAR (output (u, v).intensity, bilateralReference (*cloud, u, v, sigma_s, sigma_r), 1e-4);
+    }
+  }
+
+  // The step in intensity is preserved
+  EXPECT_LT (output (28, 20).intensity, 0.3f);
+  EXPECT_GT (output (31, 20).intensity, 0.7f);
+}
+
+/* ---[ */
+int
+  main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
@@ -0,0 +1,342 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#ifndef PCL_COMPRESSED_POINT_CLOUD_CONTAINER_H
+#define PCL_COMPRESSED_POINT_CLOUD_CONTAINER_H
+
+#include "pcl/point_cloud.h"
+#include "octree_pointcloud_compression.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace pcl
+{
+  namespace octree
+  {
+    /** \brief Index entry of a frame stored in a compressed point cloud container */
+    struct CompressedFrameInfo
+    {
+      /** \brief Byte offset of the encoded frame within the container file */
+      uint64_t offset;
+
+      /** \brief Size of the encoded frame in bytes */
+      uint64_t size;
+
+      /** \brief Frame timestamp, taken from the point cloud header by default */
+      uint64_t timestamp;
+
+      /** \brief Frame is an I-frame and can be decoded without previous frames */
+      bool iFrame;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /** \brief @b Compressed point cloud container writer
+     *  \note Writes a sequence of point clouds encoded by PointCloudCompression to a file. When the file is closed, a
+     *  frame index (offset, size, timestamp and frame type of every frame) and a keyframe table listing all I-frames
+     *  are appended, which allows CompressedPointCloudReader to seek to any frame.
+     *  \note File layout: container identifier, encoded frames, index identifier, frame index, keyframe table, byte
+     *  offset of the index identifier.
+     *  \note typename: PointT: type of point used in pointcloud
+     *  \ingroup io
+     */
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      class CompressedPointCloudWriter
+      {
+      public:
+
+        typedef pcl::PointCloud<PointT> PointCloud;
+        typedef typename PointCloud::ConstPtr PointCloudConstPtr;
+
+        typedef PointCloudCompression<PointT> Encoder;
+
+        /** \brief Constructor
+         *  \param compressionProfile_arg:  compression profile of the frame encoder
+         * */
+        CompressedPointCloudWriter (
+            compression_Profiles_e compressionProfile_arg = MED_RES_ONLINE_COMPRESSION_WITH_COLOR) :
+          encoder_ (compressionProfile_arg), file_ (), frameIndex_ ()
+        {
+        }
+
+        /** \brief Deconstructor. Closes the container if it is still open. */
+        virtual
+        ~CompressedPointCloudWriter ()
+        {
+          close ();
+        }
+
+        /** \brief Get the frame encoder, e.g. to set the amount of partitions or threads.
+         *  \return reference to the frame encoder
+         * */
+        inline Encoder&
+        getEncoder ()
+        {
+          return (encoder_);
+        }
+
+        /** \brief Create a container file. A previously opened container is closed first.
+         *  \param fileName_arg: name of the container file
+         *  \return 0 on success, -1 on error
+         * */
+        int
+        open (const std::string& fileName_arg);
+
+        /** \brief Encode a point cloud and append it to the container.
+         *  \param cloud_arg: point cloud to be compressed
+         *  \param timestamp_arg: frame timestamp
+         *  \return 0 on success, -1 on error
+         * */
+        int
+        writeFrame (const PointCloudConstPtr& cloud_arg, uint64_t timestamp_arg);
+
+        /** \brief Encode a point cloud and append it to the container. The frame timestamp is taken from the header
+         *  of the point cloud.
+         *  \param cloud_arg: point cloud to be compressed
+         *  \return 0 on success, -1 on error
+         * */
+        inline int
+        writeFrame (const PointCloudConstPtr& cloud_arg)
+        {
+          return (writeFrame (cloud_arg, cloud_arg->header.stamp));
+        }
+
+        /** \brief Write frame index and keyframe table and close the container file.
+         *  \return 0 on success, -1 on error
+         * */
+        int
+        close ();
+
+        /** \brief Get the amount of frames written to the container.
+         *  \return amount of frames
+         * */
+        inline std::size_t
+        getFrameCount () const
+        {
+          return (frameIndex_.size ());
+        }
+
+      protected:
+
+        /** \brief Frame encoder */
+        Encoder encoder_;
+
+        /** \brief Container file */
+        std::ofstream file_;
+
+        /** \brief Index of all frames written so far */
+        std::vector<CompressedFrameInfo> frameIndex_;
+
+      private:
+
+        // disable copy constructor and assignment
+        CompressedPointCloudWriter (const CompressedPointCloudWriter&);
+        CompressedPointCloudWriter& operator = (const CompressedPointCloudWriter&);
+      };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /** \brief @b Compressed point cloud container reader
+     *  \note Reads containers written by CompressedPointCloudWriter. Any frame can be decoded by seeking to the nearest
+     *  preceding I-frame and decoding forward from there. Sequential reads continue from the current decoder state.
+     *  \note Groups of pictures (an I-frame and its following P-frames) are independent of each other, readFrames ()
+     *  decodes them in parallel using the number of threads given by setNumberOfThreads ().
+     *  \note typename: PointT: type of point used in pointcloud
+     *  \ingroup io
+     */
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      class CompressedPointCloudReader
+      {
+      public:
+
+        typedef pcl::PointCloud<PointT> PointCloud;
+        typedef typename PointCloud::Ptr PointCloudPtr;
+
+        typedef PointCloudCompression<PointT> Decoder;
+
+        /** \brief Empty constructor. */
+        CompressedPointCloudReader () :
+          fileName_ (), file_ (), frameIndex_ (), keyFrames_ (), decoder_ (), nextFrame_ (0), decoderValid_ (false),
+          threads_ (1)
+        {
+        }
+
+        /** \brief Empty deconstructor. */
+        virtual
+        ~CompressedPointCloudReader ()
+        {
+        }
+
+        /** \brief Open a container file and read its frame index and keyframe table.
+         *  \param fileName_arg: name of the container file
+         *  \return 0 on success, -1 on error
+         * */
+        int
+        open (const std::string& fileName_arg);
+
+        /** \brief Close the container file. */
+        void
+        close ();
+
+        /** \brief Set the number of threads used by readFrames ().
+         *  \param threads_arg: amount of threads
+         * */
+        inline void
+        setNumberOfThreads (unsigned int threads_arg)
+        {
+          if (threads_arg == 0)
+            threads_arg = 1;
+          threads_ = threads_arg;
+        }
+
+        /** \brief Get the amount of frames stored in the container.
+         *  \return amount of frames
+         * */
+        inline std::size_t
+        getFrameCount () const
+        {
+          return (frameIndex_.size ());
+        }
+
+        /** \brief Get the frame index of the container.
+         *  \return index entries of all frames
+         * */
+        inline const std::vector<CompressedFrameInfo>&
+        getFrameIndex () const
+        {
+          return (frameIndex_);
+        }
+
+        /** \brief Get the keyframe table of the container.
+         *  \return frame numbers of all I-frames in ascending order
+         * */
+        inline const std::vector<std::size_t>&
+        getKeyFrames () const
+        {
+          return (keyFrames_);
+        }
+
+        /** \brief Find the nearest I-frame at or before a frame.
+         *  \param frame_arg: frame number
+         *  \return frame number of the I-frame
+         * */
+        std::size_t
+        getKeyFrame (std::size_t frame_arg) const;
+
+        /** \brief Find the last frame with a timestamp not later than the given timestamp. Timestamps are expected to
+         *  be ascending.
+         *  \param timestamp_arg: timestamp
+         *  \return frame number, 0 if all frames are later than \a timestamp_arg
+         * */
+        std::size_t
+        findFrame (uint64_t timestamp_arg) const;
+
+        /** \brief Decode a single frame. The decoder seeks to the nearest I-frame unless the frame can be reached by
+         *  decoding forward from the previously read frame.
+         *  \param frame_arg: frame number
+         *  \param cloud_arg: decoded point cloud, allocated if empty
+         *  \return 0 on success, -1 on error
+         * */
+        int
+        readFrame (std::size_t frame_arg, PointCloudPtr& cloud_arg);
+
+        /** \brief Decode a range of frames. Groups of pictures are decoded in parallel.
+         *  \param frameBegin_arg: first frame number
+         *  \param frameEnd_arg: frame number after the last decoded frame
+         *  \param clouds_arg: decoded point clouds, one per frame
+         *  \return 0 on success, -1 on error
+         * */
+        int
+        readFrames (std::size_t frameBegin_arg, std::size_t frameEnd_arg, std::vector<PointCloudPtr>& clouds_arg);
+
+      protected:
+
+        /** \brief Read the encoded data of a frame.
+         *  \param file_arg: container file
+         *  \param frame_arg: frame number
+         *  \param frameData_arg: encoded frame
+         *  \return 0 on success, -1 on error
+         * */
+        int
+        readFrameData (std::ifstream& file_arg, std::size_t frame_arg, std::string& frameData_arg) const;
+
+        /** \brief Name of the container file */
+        std::string fileName_;
+
+        /** \brief Container file */
+        std::ifstream file_;
+
+        /** \brief Index of all frames */
+        std::vector<CompressedFrameInfo> frameIndex_;
+
+        /** \brief Frame numbers of all I-frames */
+        std::vector<std::size_t> keyFrames_;
+
+        /** \brief Decoder used by readFrame () */
+        Decoder decoder_;
+
+        /** \brief Frame number following the frame last decoded by decoder_ */
+        std::size_t nextFrame_;
+
+        /** \brief decoder_ holds the state of frame nextFrame_ - 1 */
+        bool decoderValid_;
+
+        /** \brief Amount of threads used by readFrames () */
+        unsigned int threads_;
+
+      private:
+
+        // disable copy constructor and assignment
+        CompressedPointCloudReader (const CompressedPointCloudReader&);
+        CompressedPointCloudReader& operator = (const CompressedPointCloudReader&);
+      };
+
+    /** \brief Identifier at the beginning of a compressed point cloud container */
+    const char* const compressedContainerIdentifier_ = "<PCL-COMPRESSED-CONTAINER>";
+
+    /** \brief Identifier preceding the frame index of a compressed point cloud container */
+    const char* const compressedContainerIndexIdentifier_ = "<PCL-FRAME-INDEX>";
+
+    /** \brief Version of the compressed point cloud container format */
+    const unsigned int compressedContainerVersion_ = 1;
+  }
+}
+
+#endif
@@ -75,6 +75,9 @@ namespace pcl
       unsigned int iFrameRate;
       const unsigned char colorBitResolution;
       bool doColorEncoding;
+      // rANS entropy coding is opt-in (PointCloudCompression::setRansEntropyCoding), all predefined profiles use
+      // the static range coder
+      bool doRansEntropyCoding;
     };
 
     // predefined configuration parameters
@@ -86,7 +89,8 @@ namespace pcl
        true, /* doVoxelGridDownDownSampling = */
        50, /* iFrameRate = */
        4, /* colorBitResolution = */
-       false /* doColorEncoding = */
+       false, /* doColorEncoding = */
+       false /* doRansEntropyCoding = */
     }, {
     // PROFILE: LOW_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.01, /* pointResolution = */
@@ -94,7 +98,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         50, /* iFrameRate = */
         4, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: MED_RES_ONLINE_COMPRESSION_WITHOUT_COLOR
         0.005, /* pointResolution = */
@@ -102,7 +107,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         40, /* iFrameRate = */
         5, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: MED_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.005, /* pointResolution = */
@@ -110,7 +116,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         40, /* iFrameRate = */
         5, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: HIGH_RES_ONLINE_COMPRESSION_WITHOUT_COLOR
         0.0001, /* pointResolution = */
@@ -118,7 +125,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         30, /* iFrameRate = */
         7, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: HIGH_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.0001, /* pointResolution = */
@@ -126,7 +134,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         30, /* iFrameRate = */
         7, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: LOW_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.01, /* pointResolution = */
@@ -134,7 +143,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         4, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: LOW_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.01, /* pointResolution = */
@@ -142,7 +152,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         4, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: MED_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.005, /* pointResolution = */
@@ -150,7 +161,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         5, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: MED_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.005, /* pointResolution = */
@@ -158,7 +170,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         5, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: HIGH_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.0001, /* pointResolution = */
@@ -166,7 +179,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         8, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }, {
     // PROFILE: HIGH_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.0001, /* pointResolution = */
@@ -174,7 +188,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         8, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        false /* doRansEntropyCoding = */
     }};
 
   }
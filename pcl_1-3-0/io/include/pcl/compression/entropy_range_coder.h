@@ -54,6 +54,7 @@ namespace pcl
 {
 
   using boost::uint8_t;
+  using boost::uint16_t;
   using boost::uint32_t;
   using boost::uint64_t;
 
@@ -141,7 +142,7 @@ namespace pcl
      * \return amount of bytes written to output stream
      */
     unsigned long
-    encodeIntVectorToStream (std::vector<unsigned int>& inputIntVector_arg, std::ostream& outputByterStream_arg);
+    encodeIntVectorToStream (const std::vector<unsigned int>& inputIntVector_arg, std::ostream& outputByterStream_arg);
 
     /** \brief Decode stream to output integer vector
      * \param inputByteStream_arg input stream of compressed data
@@ -190,6 +191,108 @@ namespace pcl
     std::vector<char> outputCharVector_;
 
   };
+
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief @b StaticRansCoder compression class
+   *  \note This class provides static range asymmetric numeral system (rANS) coding functionality.
+   *  \note Symbol frequencies are normalized to a fixed total and encoded to the output data. Four interleaved coder
+   *  states are used, decoding uses a symbol lookup table instead of searching the cumulative frequency table.
+   *  \note The coder works on raw buffers, the stream interface reads and writes each coded block at once.
+   *  \note PointCloudCompression uses it only when enabled through setRansEntropyCoding (), none of the predefined
+   *  compression profiles selects it.
+   */
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  class StaticRansCoder
+  {
+
+  public:
+
+    /** \brief Empty constructor. */
+    StaticRansCoder ()
+    {
+
+    }
+
+    /** \brief Empty deconstructor. */
+    virtual
+    ~StaticRansCoder ()
+    {
+
+    }
+
+    /** \brief Encode char buffer to a coded block
+     * \param input_arg input data
+     * \param inputSize_arg amount of input bytes
+     * \param output_arg vector receiving the coded block
+     * \return amount of bytes of the coded block
+     */
+    unsigned long
+    encodeCharBuffer (const char* input_arg, std::size_t inputSize_arg, std::vector<char>& output_arg);
+
+    /** \brief Decode coded block to char buffer
+     * \param input_arg coded block
+     * \param inputSize_arg amount of bytes available at \a input_arg
+     * \param output_arg output buffer
+     * \param outputSize_arg amount of bytes to be decoded
+     * \return amount of bytes read from the coded block
+     */
+    unsigned long
+    decodeCharBuffer (const char* input_arg, std::size_t inputSize_arg, char* output_arg, std::size_t outputSize_arg);
+
+    /** \brief Encode integer vector to output stream
+     * \param inputIntVector_arg input vector
+     * \param outputByterStream_arg output stream containing compressed data
+     * \return amount of bytes written to output stream
+     */
+    unsigned long
+    encodeIntVectorToStream (const std::vector<unsigned int>& inputIntVector_arg, std::ostream& outputByterStream_arg);
+
+    /** \brief Decode stream to output integer vector
+     * \param inputByteStream_arg input stream of compressed data
+     * \param outputIntVector_arg decompressed output vector
+     * \return amount of bytes read from input stream
+     */
+    unsigned long
+    decodeStreamToIntVector (std::istream& inputByteStream_arg, std::vector<unsigned int>& outputIntVector_arg);
+
+    /** \brief Encode char vector to output stream
+     * \param inputByteVector_arg input vector
+     * \param outputByteStream_arg output stream containing compressed data
+     * \return amount of bytes written to output stream
+     */
+    unsigned long
+    encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg, std::ostream& outputByteStream_arg);
+
+    /** \brief Decode char stream to output vector
+     * \param inputByteStream_arg input stream of compressed data
+     * \param outputByteVector_arg decompressed output vector
+     * \return amount of bytes read from input stream
+     */
+    unsigned long
+    decodeStreamToCharVector (std::istream& inputByteStream_arg, std::vector<char>& outputByteVector_arg);
+
+  protected:
+    typedef boost::uint32_t DWord; // 4 bytes
+
+    /** \brief Amount of interleaved coder states */
+    static const unsigned int STATE_COUNT = 4;
+
+    /** \brief Precision of normalized symbol frequencies in bits */
+    static const unsigned int FREQUENCY_BITS = 12;
+
+    /** \brief Lower bound of the normalized coder state interval */
+    static const DWord STATE_LOWER_BOUND = (DWord)1 << 23;
+
+  private:
+    /** vector containing compressed data
+     */
+    std::vector<char> outputCharVector_;
+
+    /** vector containing variable length coded integer data
+     */
+    std::vector<char> intByteVector_;
+
+  };
 }
 
 
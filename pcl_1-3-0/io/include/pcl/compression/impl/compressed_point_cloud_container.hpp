@@ -0,0 +1,431 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#ifndef PCL_COMPRESSED_POINT_CLOUD_CONTAINER_HPP
+#define PCL_COMPRESSED_POINT_CLOUD_CONTAINER_HPP
+
+#include "pcl/compression/compressed_point_cloud_container.h"
+#include "pcl/console/print.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string.h>
+
+namespace pcl
+{
+  namespace octree
+  {
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      int
+      CompressedPointCloudWriter<PointT>::open (const std::string& fileName_arg)
+      {
+        close ();
+
+        file_.open (fileName_arg.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file_.is_open ())
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudWriter::open] Could not open file %s!\n",
+                     fileName_arg.c_str ());
+          return (-1);
+        }
+
+        // write container header
+        unsigned int version = compressedContainerVersion_;
+        file_.write (compressedContainerIdentifier_, strlen (compressedContainerIdentifier_));
+        file_.write ((const char*)&version, sizeof(version));
+
+        frameIndex_.clear ();
+
+        return (file_.good () ? 0 : -1);
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      int
+      CompressedPointCloudWriter<PointT>::writeFrame (const PointCloudConstPtr& cloud_arg, uint64_t timestamp_arg)
+      {
+        if (!file_.is_open ())
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudWriter::writeFrame] No container file opened!\n");
+          return (-1);
+        }
+
+        CompressedFrameInfo frameInfo;
+        frameInfo.offset = (uint64_t)file_.tellp ();
+        frameInfo.timestamp = timestamp_arg;
+
+        // encode frame directly to the container file
+        encoder_.encodePointCloud (cloud_arg, file_);
+
+        frameInfo.size = (uint64_t)file_.tellp () - frameInfo.offset;
+        frameInfo.iFrame = encoder_.isIFrame ();
+
+        if (!file_.good ())
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudWriter::writeFrame] Error writing frame %lu!\n",
+                     (unsigned long)frameIndex_.size ());
+          return (-1);
+        }
+
+        frameIndex_.push_back (frameInfo);
+
+        return (0);
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      int
+      CompressedPointCloudWriter<PointT>::close ()
+      {
+        if (!file_.is_open ())
+          return (0);
+
+        uint64_t indexOffset = (uint64_t)file_.tellp ();
+        uint64_t frameCount = frameIndex_.size ();
+        std::vector<CompressedFrameInfo>::const_iterator it;
+
+        // write frame index
+        file_.write (compressedContainerIndexIdentifier_, strlen (compressedContainerIndexIdentifier_));
+        file_.write ((const char*)&frameCount, sizeof(frameCount));
+        for (it = frameIndex_.begin (); it != frameIndex_.end (); ++it)
+        {
+          unsigned char iFrame = it->iFrame ? 1 : 0;
+          file_.write ((const char*)&it->offset, sizeof(it->offset));
+          file_.write ((const char*)&it->size, sizeof(it->size));
+          file_.write ((const char*)&it->timestamp, sizeof(it->timestamp));
+          file_.write ((const char*)&iFrame, sizeof(iFrame));
+        }
+
+        // write keyframe table
+        std::vector<uint64_t> keyFrames;
+        for (std::size_t i = 0; i < frameIndex_.size (); i++)
+          if (frameIndex_[i].iFrame)
+            keyFrames.push_back (i);
+
+        uint64_t keyFrameCount = keyFrames.size ();
+        file_.write ((const char*)&keyFrameCount, sizeof(keyFrameCount));
+        if (keyFrameCount > 0)
+          file_.write ((const char*)&keyFrames[0], keyFrameCount * sizeof(keyFrames[0]));
+
+        // trailer points to the frame index
+        file_.write ((const char*)&indexOffset, sizeof(indexOffset));
+
+        bool success = file_.good ();
+        file_.close ();
+
+        if (!success)
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudWriter::close] Error writing frame index!\n");
+          return (-1);
+        }
+
+        return (0);
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      int
+      CompressedPointCloudReader<PointT>::open (const std::string& fileName_arg)
+      {
+        const std::size_t identifierLen = strlen (compressedContainerIdentifier_);
+        const std::size_t indexIdentifierLen = strlen (compressedContainerIndexIdentifier_);
+
+        std::string identifier;
+        unsigned int version;
+        uint64_t indexOffset, frameCount, keyFrameCount, fileSize;
+
+        close ();
+
+        file_.open (fileName_arg.c_str (), std::ios::in | std::ios::binary);
+        if (!file_.is_open ())
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudReader::open] Could not open file %s!\n",
+                     fileName_arg.c_str ());
+          return (-1);
+        }
+
+        // check container header
+        identifier.resize (identifierLen);
+        file_.read (&identifier[0], identifierLen);
+        file_.read ((char*)&version, sizeof(version));
+        if (!file_.good () || (identifier != compressedContainerIdentifier_)
+            || (version != compressedContainerVersion_))
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudReader::open] %s is not a compressed point cloud container!\n",
+                     fileName_arg.c_str ());
+          close ();
+          return (-1);
+        }
+
+        // read trailer
+        file_.seekg (0, std::ios::end);
+        fileSize = (uint64_t)file_.tellg ();
+        file_.seekg (fileSize - sizeof(indexOffset), std::ios::beg);
+        file_.read ((char*)&indexOffset, sizeof(indexOffset));
+
+        // read frame index
+        identifier.resize (indexIdentifierLen);
+        if (file_.good () && (indexOffset + indexIdentifierLen < fileSize))
+        {
+          file_.seekg (indexOffset, std::ios::beg);
+          file_.read (&identifier[0], indexIdentifierLen);
+        }
+        if (!file_.good () || (identifier != compressedContainerIndexIdentifier_))
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudReader::open] Frame index of %s not found!\n",
+                     fileName_arg.c_str ());
+          close ();
+          return (-1);
+        }
+
+        file_.read ((char*)&frameCount, sizeof(frameCount));
+        frameIndex_.resize (file_.good () ? frameCount : 0);
+        for (std::size_t i = 0; (i < frameIndex_.size ()) && file_.good (); i++)
+        {
+          unsigned char iFrame;
+          file_.read ((char*)&frameIndex_[i].offset, sizeof(frameIndex_[i].offset));
+          file_.read ((char*)&frameIndex_[i].size, sizeof(frameIndex_[i].size));
+          file_.read ((char*)&frameIndex_[i].timestamp, sizeof(frameIndex_[i].timestamp));
+          file_.read ((char*)&iFrame, sizeof(iFrame));
+          frameIndex_[i].iFrame = (iFrame != 0);
+        }
+
+        // read keyframe table
+        file_.read ((char*)&keyFrameCount, sizeof(keyFrameCount));
+        keyFrames_.resize (file_.good () ? keyFrameCount : 0);
+        for (std::size_t i = 0; (i < keyFrames_.size ()) && file_.good (); i++)
+        {
+          uint64_t keyFrame;
+          file_.read ((char*)&keyFrame, sizeof(keyFrame));
+          keyFrames_[i] = keyFrame;
+        }
+
+        if (!file_.good () || (keyFrames_.empty () && !frameIndex_.empty ()) || (!keyFrames_.empty () && keyFrames_[0]))
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudReader::open] Frame index of %s is corrupt!\n",
+                     fileName_arg.c_str ());
+          close ();
+          return (-1);
+        }
+
+        fileName_ = fileName_arg;
+
+        return (0);
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      void
+      CompressedPointCloudReader<PointT>::close ()
+      {
+        if (file_.is_open ())
+          file_.close ();
+        file_.clear ();
+
+        fileName_.clear ();
+        frameIndex_.clear ();
+        keyFrames_.clear ();
+        nextFrame_ = 0;
+        decoderValid_ = false;
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      std::size_t
+      CompressedPointCloudReader<PointT>::getKeyFrame (std::size_t frame_arg) const
+      {
+        std::vector<std::size_t>::const_iterator it;
+
+        // first keyframe after frame_arg
+        it = std::upper_bound (keyFrames_.begin (), keyFrames_.end (), frame_arg);
+        if (it == keyFrames_.begin ())
+          return (0);
+
+        return (*(it - 1));
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      std::size_t
+      CompressedPointCloudReader<PointT>::findFrame (uint64_t timestamp_arg) const
+      {
+        std::size_t low = 0;
+        std::size_t high = frameIndex_.size ();
+
+        // binary search for the first frame later than timestamp_arg
+        while (low < high)
+        {
+          const std::size_t mid = (low + high) / 2;
+          if (frameIndex_[mid].timestamp <= timestamp_arg)
+            low = mid + 1;
+          else
+            high = mid;
+        }
+
+        return (low > 0 ? low - 1 : 0);
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      int
+      CompressedPointCloudReader<PointT>::readFrameData (std::ifstream& file_arg, std::size_t frame_arg,
+                                                         std::string& frameData_arg) const
+      {
+        const CompressedFrameInfo& frameInfo = frameIndex_[frame_arg];
+
+        frameData_arg.resize (frameInfo.size);
+        file_arg.clear ();
+        file_arg.seekg (frameInfo.offset, std::ios::beg);
+        if (frameInfo.size > 0)
+          file_arg.read (&frameData_arg[0], frameInfo.size);
+
+        if (!file_arg.good ())
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudReader::readFrameData] Error reading frame %lu!\n",
+                     (unsigned long)frame_arg);
+          return (-1);
+        }
+
+        return (0);
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      int
+      CompressedPointCloudReader<PointT>::readFrame (std::size_t frame_arg, PointCloudPtr& cloud_arg)
+      {
+        std::string frameData;
+        std::size_t frame, startFrame;
+
+        if (frame_arg >= frameIndex_.size ())
+        {
+          PCL_ERROR ("[pcl::octree::CompressedPointCloudReader::readFrame] Frame %lu out of range!\n",
+                     (unsigned long)frame_arg);
+          return (-1);
+        }
+
+        if (!cloud_arg)
+          cloud_arg.reset (new PointCloud);
+
+        // continue decoding from the previous frame if no I-frame lies in between, otherwise seek to the I-frame
+        startFrame = getKeyFrame (frame_arg);
+        if (decoderValid_ && (nextFrame_ > startFrame) && (nextFrame_ <= frame_arg))
+          startFrame = nextFrame_;
+
+        decoderValid_ = false;
+
+        PointCloudPtr skippedCloud (new PointCloud);
+        for (frame = startFrame; frame <= frame_arg; frame++)
+        {
+          if (readFrameData (file_, frame, frameData))
+            return (-1);
+
+          std::istringstream frameDataIn (frameData);
+          decoder_.decodePointCloud (frameDataIn, (frame == frame_arg) ? cloud_arg : skippedCloud);
+        }
+
+        nextFrame_ = frame_arg + 1;
+        decoderValid_ = true;
+
+        return (0);
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+      int
+      CompressedPointCloudReader<PointT>::readFrames (std::size_t frameBegin_arg, std::size_t frameEnd_arg,
+                                                      std::vector<PointCloudPtr>& clouds_arg)
+      {
+        std::vector<std::size_t> groupBegin;
+        std::size_t frame;
+        int result = 0;
+
+        frameEnd_arg = std::min (frameEnd_arg, frameIndex_.size ());
+        if (frameBegin_arg >= frameEnd_arg)
+        {
+          clouds_arg.clear ();
+          return (0);
+        }
+
+        clouds_arg.resize (frameEnd_arg - frameBegin_arg);
+
+        // groups of pictures overlapping the requested range
+        groupBegin.push_back (getKeyFrame (frameBegin_arg));
+        for (frame = frameBegin_arg + 1; frame < frameEnd_arg; frame++)
+          if (frameIndex_[frame].iFrame)
+            groupBegin.push_back (frame);
+        groupBegin.push_back (frameEnd_arg);
+
+        // decode groups of pictures in parallel - each task uses its own decoder and file stream
+#pragma omp parallel for schedule (dynamic, 1) num_threads (threads_)
+        for (int group = 0; group < (int)groupBegin.size () - 1; group++)
+        {
+          std::ifstream file (fileName_.c_str (), std::ios::in | std::ios::binary);
+          Decoder decoder;
+          std::string frameData;
+          PointCloudPtr skippedCloud (new PointCloud);
+
+          for (std::size_t f = groupBegin[group]; f < groupBegin[group + 1]; f++)
+          {
+            if (readFrameData (file, f, frameData))
+            {
+#pragma omp critical
+              result = -1;
+              break;
+            }
+
+            PointCloudPtr cloud = skippedCloud;
+            if (f >= frameBegin_arg)
+            {
+              clouds_arg[f - frameBegin_arg].reset (new PointCloud);
+              cloud = clouds_arg[f - frameBegin_arg];
+            }
+
+            std::istringstream frameDataIn (frameData);
+            decoder.decodePointCloud (frameDataIn, cloud);
+          }
+        }
+
+        return (result);
+      }
+  }
+}
+
+#endif
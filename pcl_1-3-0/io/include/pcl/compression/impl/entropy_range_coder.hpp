@@ -244,7 +244,7 @@ namespace pcl
 
   //////////////////////////////////////////////////////////////////////////////////////////////
   unsigned long
-  StaticRangeCoder::encodeIntVectorToStream (std::vector<unsigned int>& inputIntVector_arg,
+  StaticRangeCoder::encodeIntVectorToStream (const std::vector<unsigned int>& inputIntVector_arg,
                                              std::ostream& outputByteStream_arg)
   {
 
@@ -687,6 +687,345 @@ namespace pcl
 
   }
 
+  //////////////////////////////////////////////////////////////////////////////////////////////
+  unsigned long
+  StaticRansCoder::encodeCharBuffer (const char* input_arg, std::size_t inputSize_arg, std::vector<char>& output_arg)
+  {
+    const DWord totalFreq = (DWord)1 << FREQUENCY_BITS;
+
+    uint64_t freqHist[256];
+    DWord freq[256];
+    DWord cFreq[256];
+    DWord state[STATE_COUNT];
+    unsigned int symbolCount;
+    std::size_t i;
+    int f;
+
+    // calculate frequency table
+    memset (freqHist, 0, sizeof(freqHist));
+    for (i = 0; i < inputSize_arg; i++)
+      freqHist[(uint8_t)input_arg[i]]++;
+
+    // normalize frequencies to totalFreq - every occuring symbol keeps a non-zero frequency
+    DWord freqSum = 0;
+    symbolCount = 0;
+    for (f = 0; f < 256; f++)
+    {
+      freq[f] = 0;
+      if (freqHist[f])
+      {
+        freq[f] = std::max<DWord> (1, (DWord)((freqHist[f] * totalFreq) / inputSize_arg));
+        freqSum += freq[f];
+        symbolCount++;
+      }
+    }
+
+    // correct rounding errors at the most frequent symbols
+    while (symbolCount && (freqSum != totalFreq))
+    {
+      int maxSymbol = 0;
+      for (f = 1; f < 256; f++)
+        if (freq[f] > freq[maxSymbol])
+          maxSymbol = f;
+
+      if (freqSum < totalFreq)
+      {
+        freq[maxSymbol] += totalFreq - freqSum;
+        freqSum = totalFreq;
+      }
+      else
+      {
+        DWord reduction = std::min<DWord> (freqSum - totalFreq, freq[maxSymbol] - 1);
+        if (reduction == 0)
+          reduction = 1;
+        freq[maxSymbol] -= reduction;
+        freqSum -= reduction;
+      }
+    }
+
+    // convert to cumulative frequency table
+    cFreq[0] = 0;
+    for (f = 1; f < 256; f++)
+      cFreq[f] = cFreq[f - 1] + freq[f - 1];
+
+    // worst case output size: block header, frequency table, coder states and FREQUENCY_BITS per symbol
+    outputCharVector_.resize (2 * sizeof(DWord) + 256 * 3 + STATE_COUNT * sizeof(DWord) + inputSize_arg * 2);
+
+    uint8_t* const bufferEnd = (uint8_t*)&outputCharVector_[0] + outputCharVector_.size ();
+    uint8_t* ptr = bufferEnd;
+
+    for (i = 0; i < STATE_COUNT; i++)
+      state[i] = STATE_LOWER_BOUND;
+
+    // encode symbols in reverse order, the decoder reads the output front to back
+    for (i = inputSize_arg; i > 0; i--)
+    {
+      const uint8_t symbol = (uint8_t)input_arg[i - 1];
+      const DWord symbolFreq = freq[symbol];
+      DWord& x = state[(i - 1) % STATE_COUNT];
+
+      // renormalize
+      const DWord xMax = ((STATE_LOWER_BOUND >> FREQUENCY_BITS) << 8) * symbolFreq;
+      while (x >= xMax)
+      {
+        *--ptr = (uint8_t)(x & 0xFF);
+        x >>= 8;
+      }
+
+      // encode symbol
+      x = ((x / symbolFreq) << FREQUENCY_BITS) + (x % symbolFreq) + cFreq[symbol];
+    }
+
+    // flush coder states - state 0 is read first
+    for (i = STATE_COUNT; i > 0; i--)
+    {
+      ptr -= 4;
+      ptr[0] = (uint8_t)(state[i - 1] >> 0);
+      ptr[1] = (uint8_t)(state[i - 1] >> 8);
+      ptr[2] = (uint8_t)(state[i - 1] >> 16);
+      ptr[3] = (uint8_t)(state[i - 1] >> 24);
+    }
+
+    const std::size_t payloadSize = bufferEnd - ptr;
+
+    // assemble coded block: block size, frequency table and payload
+    output_arg.clear ();
+    output_arg.reserve (sizeof(DWord) + sizeof(uint16_t) + 256 * 3 + payloadSize);
+    output_arg.resize (sizeof(DWord));
+
+    uint16_t symbolCount16 = (uint16_t)symbolCount;
+    output_arg.insert (output_arg.end (), (const char*)&symbolCount16,
+                       (const char*)&symbolCount16 + sizeof(symbolCount16));
+
+    if (symbolCount <= 128)
+    {
+      // sparse frequency table
+      for (f = 0; f < 256; f++)
+        if (freq[f])
+        {
+          uint16_t symbolFreq = (uint16_t)freq[f];
+          output_arg.push_back ((char)f);
+          output_arg.insert (output_arg.end (), (const char*)&symbolFreq,
+                             (const char*)&symbolFreq + sizeof(symbolFreq));
+        }
+    }
+    else
+    {
+      // dense frequency table
+      for (f = 0; f < 256; f++)
+      {
+        uint16_t symbolFreq = (uint16_t)freq[f];
+        output_arg.insert (output_arg.end (), (const char*)&symbolFreq, (const char*)&symbolFreq + sizeof(symbolFreq));
+      }
+    }
+
+    output_arg.insert (output_arg.end (), (const char*)ptr, (const char*)bufferEnd);
+
+    DWord blockSize = (DWord)(output_arg.size () - sizeof(DWord));
+    memcpy (&output_arg[0], &blockSize, sizeof(blockSize));
+
+    return (unsigned long)output_arg.size ();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////////////////////
+  unsigned long
+  StaticRansCoder::decodeCharBuffer (const char* input_arg, std::size_t inputSize_arg, char* output_arg,
+                                     std::size_t outputSize_arg)
+  {
+    const DWord totalFreq = (DWord)1 << FREQUENCY_BITS;
+
+    DWord freq[256];
+    DWord cFreq[256];
+    DWord state[STATE_COUNT];
+    uint8_t symbolLookup[1 << FREQUENCY_BITS];
+    DWord blockSize;
+    uint16_t symbolCount;
+    std::size_t i;
+    int f;
+
+    if (inputSize_arg < sizeof(blockSize) + sizeof(symbolCount))
+      return (0);
+
+    const uint8_t* ptr = (const uint8_t*)input_arg;
+
+    memcpy (&blockSize, ptr, sizeof(blockSize));
+    ptr += sizeof(blockSize);
+
+    const uint8_t* const blockEnd = (const uint8_t*)input_arg
+        + std::min<std::size_t> (inputSize_arg, sizeof(blockSize) + blockSize);
+
+    // read frequency table
+    memcpy (&symbolCount, ptr, sizeof(symbolCount));
+    ptr += sizeof(symbolCount);
+
+    memset (freq, 0, sizeof(freq));
+    if (symbolCount <= 128)
+    {
+      for (i = 0; (i < symbolCount) && (ptr + 3 <= blockEnd); i++)
+      {
+        uint16_t symbolFreq;
+        const uint8_t symbol = *ptr++;
+        memcpy (&symbolFreq, ptr, sizeof(symbolFreq));
+        ptr += sizeof(symbolFreq);
+        freq[symbol] = symbolFreq;
+      }
+    }
+    else
+    {
+      for (f = 0; (f < 256) && (ptr + 2 <= blockEnd); f++)
+      {
+        uint16_t symbolFreq;
+        memcpy (&symbolFreq, ptr, sizeof(symbolFreq));
+        ptr += sizeof(symbolFreq);
+        freq[f] = symbolFreq;
+      }
+    }
+
+    // build cumulative frequency table and symbol lookup table
+    cFreq[0] = 0;
+    for (f = 1; f < 256; f++)
+      cFreq[f] = cFreq[f - 1] + freq[f - 1];
+
+    memset (symbolLookup, 0, sizeof(symbolLookup));
+    for (f = 0; f < 256; f++)
+      for (DWord slot = cFreq[f]; (slot < cFreq[f] + freq[f]) && (slot < totalFreq); slot++)
+        symbolLookup[slot] = (uint8_t)f;
+
+    // initialize coder states
+    for (i = 0; i < STATE_COUNT; i++)
+    {
+      state[i] = 0;
+      if (ptr + 4 <= blockEnd)
+      {
+        state[i] = (DWord)ptr[0] | ((DWord)ptr[1] << 8) | ((DWord)ptr[2] << 16) | ((DWord)ptr[3] << 24);
+        ptr += 4;
+      }
+    }
+
+    // decoding
+    for (i = 0; i < outputSize_arg; i++)
+    {
+      DWord& x = state[i % STATE_COUNT];
+
+      // symbol lookup
+      const DWord slot = x & (totalFreq - 1);
+      const uint8_t symbol = symbolLookup[slot];
+
+      output_arg[i] = (char)symbol;
+
+      // decode symbol
+      x = freq[symbol] * (x >> FREQUENCY_BITS) + slot - cFreq[symbol];
+
+      // renormalize
+      while ((x < STATE_LOWER_BOUND) && (ptr < blockEnd))
+        x = (x << 8) | *ptr++;
+    }
+
+    return (unsigned long)(blockEnd - (const uint8_t*)input_arg);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////////////////////
+  unsigned long
+  StaticRansCoder::encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg,
+                                             std::ostream& outputByteStream_arg)
+  {
+    std::vector<char> codedBlock;
+
+    encodeCharBuffer (inputByteVector_arg.empty () ? 0 : &inputByteVector_arg[0], inputByteVector_arg.size (),
+                      codedBlock);
+
+    // write coded block to stream
+    outputByteStream_arg.write (&codedBlock[0], codedBlock.size ());
+
+    return (unsigned long)codedBlock.size ();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////////////////////
+  unsigned long
+  StaticRansCoder::decodeStreamToCharVector (std::istream& inputByteStream_arg,
+                                             std::vector<char>& outputByteVector_arg)
+  {
+    DWord blockSize;
+
+    // read coded block from stream
+    inputByteStream_arg.read ((char*)&blockSize, sizeof(blockSize));
+    if (!inputByteStream_arg.good ())
+      return (0);
+
+    outputCharVector_.resize (sizeof(blockSize) + blockSize);
+    memcpy (&outputCharVector_[0], &blockSize, sizeof(blockSize));
+    if (blockSize > 0)
+      inputByteStream_arg.read (&outputCharVector_[sizeof(blockSize)], blockSize);
+
+    decodeCharBuffer (&outputCharVector_[0], outputCharVector_.size (),
+                      outputByteVector_arg.empty () ? 0 : &outputByteVector_arg[0], outputByteVector_arg.size ());
+
+    return (unsigned long)outputCharVector_.size ();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////////////////////
+  unsigned long
+  StaticRansCoder::encodeIntVectorToStream (const std::vector<unsigned int>& inputIntVector_arg,
+                                            std::ostream& outputByteStream_arg)
+  {
+    std::size_t i;
+
+    // variable length coding - 7 bits per byte, most significant bit indicates following bytes
+    intByteVector_.clear ();
+    intByteVector_.reserve (inputIntVector_arg.size ());
+    for (i = 0; i < inputIntVector_arg.size (); i++)
+    {
+      unsigned int value = inputIntVector_arg[i];
+      while (value >= 0x80)
+      {
+        intByteVector_.push_back ((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+      }
+      intByteVector_.push_back ((char)value);
+    }
+
+    DWord byteCount = (DWord)intByteVector_.size ();
+    outputByteStream_arg.write ((const char*)&byteCount, sizeof(byteCount));
+
+    return (unsigned long)(sizeof(byteCount) + encodeCharVectorToStream (intByteVector_, outputByteStream_arg));
+  }
+
+  //////////////////////////////////////////////////////////////////////////////////////////////
+  unsigned long
+  StaticRansCoder::decodeStreamToIntVector (std::istream& inputByteStream_arg,
+                                            std::vector<unsigned int>& outputIntVector_arg)
+  {
+    DWord byteCount;
+    std::size_t i, readPos;
+    unsigned long streamByteCount;
+
+    inputByteStream_arg.read ((char*)&byteCount, sizeof(byteCount));
+    if (!inputByteStream_arg.good ())
+      return (0);
+
+    intByteVector_.resize (byteCount);
+    streamByteCount = sizeof(byteCount) + decodeStreamToCharVector (inputByteStream_arg, intByteVector_);
+
+    // decode variable length integers
+    readPos = 0;
+    for (i = 0; i < outputIntVector_arg.size (); i++)
+    {
+      unsigned int value = 0;
+      unsigned int shift = 0;
+      while (readPos < intByteVector_.size ())
+      {
+        const uint8_t byte = (uint8_t)intByteVector_[readPos++];
+        value |= (unsigned int)(byte & 0x7F) << shift;
+        shift += 7;
+        if (!(byte & 0x80))
+          break;
+      }
+      outputIntVector_arg[i] = value;
+    }
+
+    return (streamByteCount);
+  }
+
 }
 
 #endif
@@ -46,6 +46,7 @@
 #include <string.h>
 #include <iostream>
 #include <stdio.h>
+#include <sstream>
 
 
 namespace pcl
@@ -116,6 +117,12 @@ namespace pcl
         pointCoder_.initializeEncoding ();
         pointCoder_.setPointCount (cloud_arg->points.size ());
 
+        // partitioned encoding collects the leaf nodes during serialization
+        partitionedFrame_ = (partitionCount_ > 1);
+        ransCodedFrame_ = doRansEntropyCoding_;
+        leafNodes_.clear ();
+        leafKeys_.clear ();
+
         // serialize octree
         if (iFrame_) {
           // i-frame encoding - encode tree structure without referencing previous buffer
@@ -129,7 +136,10 @@ namespace pcl
         this->writeFrameHeader (compressedTreeDataOut_arg);
 
         // apply entropy coding to the content of all data vectors and send data to output stream
-        this->entropyEncoding (compressedTreeDataOut_arg);
+        if (partitionedFrame_)
+          this->entropyEncodingPartitioned (compressedTreeDataOut_arg);
+        else
+          this->entropyEncoding (compressedTreeDataOut_arg);
 
         if (bShowStatistics)
         {
@@ -200,7 +210,10 @@ namespace pcl
         this->readFrameHeader (compressedTreeDataIn_arg);
 
         // decode data vectors from stream
-        this->entropyDecoding (compressedTreeDataIn_arg);
+        if (partitionedFrame_)
+          this->entropyDecodingPartitioned (compressedTreeDataIn_arg);
+        else
+          this->entropyDecoding (compressedTreeDataIn_arg);
 
         // initialize color and point encoding
         colorCoder_.initializeDecoding ();
@@ -210,6 +223,9 @@ namespace pcl
         output_->points.clear ();
         output_->points.reserve (pointCount_);
 
+        // partitioned decoding collects the leaf node keys during deserialization
+        leafKeys_.clear ();
+
         if (iFrame_)
           // i-frame decoding - decode tree structure without referencing previous buffer
           this->deserializeTree (binaryTreeDataVector_, false);
@@ -217,6 +233,9 @@ namespace pcl
           // p-frame decoding - decode XOR encoded tree structure
           this->deserializeTree (binaryTreeDataVector_, true);
 
+        if (partitionedFrame_)
+          this->decodePartitions ();
+
         // assign point cloud properties
         output_->height = 1;
         output_->width = cloud_arg->points.size ();
@@ -271,8 +290,8 @@ namespace pcl
         // encode binary octree structure
         binaryTreeDataVector_size = binaryTreeDataVector_.size ();
         compressedTreeDataOut_arg.write ((const char*)&binaryTreeDataVector_size, sizeof(binaryTreeDataVector_size));
-        compressedPointDataLen_ += entropyCoder_.encodeCharVectorToStream (binaryTreeDataVector_,
-                                                                           compressedTreeDataOut_arg);
+        compressedPointDataLen_ += entropyEncodeCharVector (entropyCoder_, binaryTreeDataVector_,
+                                                            compressedTreeDataOut_arg);
 
         if (cloudWithColor_)
         {
@@ -281,8 +300,8 @@ namespace pcl
           pointAvgColorDataVector_size = pointAvgColorDataVector.size ();
           compressedTreeDataOut_arg.write ((const char*)&pointAvgColorDataVector_size,
                                            sizeof(pointAvgColorDataVector_size));
-          compressedColorDataLen_ += entropyCoder_.encodeCharVectorToStream (pointAvgColorDataVector,
-                                                                             compressedTreeDataOut_arg);
+          compressedColorDataLen_ += entropyEncodeCharVector (entropyCoder_, pointAvgColorDataVector,
+                                                              compressedTreeDataOut_arg);
         }
 
 
@@ -295,15 +314,15 @@ namespace pcl
           // encode amount of points per voxel
           pointCountDataVector_size = pointCountDataVector_.size ();
           compressedTreeDataOut_arg.write ((const char*)&pointCountDataVector_size, sizeof(pointCountDataVector_size));
-          compressedPointDataLen_ += entropyCoder_.encodeIntVectorToStream (pointCountDataVector_,
-                                                                            compressedTreeDataOut_arg);
+          compressedPointDataLen_ += entropyEncodeIntVector (entropyCoder_, pointCountDataVector_,
+                                                             compressedTreeDataOut_arg);
 
           // encode differential point information
           std::vector<char>& pointDiffDataVector = pointCoder_.getDifferentialDataVector ();
           pointDiffDataVector_size = pointDiffDataVector.size ();
           compressedTreeDataOut_arg.write ((const char*)&pointDiffDataVector_size, sizeof(pointDiffDataVector_size));
-          compressedPointDataLen_ += entropyCoder_.encodeCharVectorToStream (pointDiffDataVector,
-                                                                             compressedTreeDataOut_arg);
+          compressedPointDataLen_ += entropyEncodeCharVector (entropyCoder_, pointDiffDataVector,
+                                                              compressedTreeDataOut_arg);
           if (cloudWithColor_)
           {
             // encode differential color information
@@ -311,8 +330,8 @@ namespace pcl
             pointDiffColorDataVector_size = pointDiffColorDataVector.size ();
             compressedTreeDataOut_arg.write ((const char*)&pointDiffColorDataVector_size,
                                              sizeof(pointDiffColorDataVector_size));
-            compressedColorDataLen_ += entropyCoder_.encodeCharVectorToStream (pointDiffColorDataVector,
-                                                                               compressedTreeDataOut_arg);
+            compressedColorDataLen_ += entropyEncodeCharVector (entropyCoder_, pointDiffColorDataVector,
+                                                                compressedTreeDataOut_arg);
           }
 
         }
@@ -335,8 +354,8 @@ namespace pcl
         // decode binary octree structure
         compressedTreeDataIn_arg.read ((char*)&binaryTreeDataVector_size, sizeof(binaryTreeDataVector_size));
         binaryTreeDataVector_.resize (binaryTreeDataVector_size);
-        compressedPointDataLen_ += entropyCoder_.decodeStreamToCharVector (compressedTreeDataIn_arg,
-                                                                           binaryTreeDataVector_);
+        compressedPointDataLen_ += entropyDecodeCharVector (entropyCoder_, compressedTreeDataIn_arg,
+                                                            binaryTreeDataVector_);
 
         if (dataWithColor_)
         {
@@ -344,8 +363,8 @@ namespace pcl
           std::vector<char>& pointAvgColorDataVector = colorCoder_.getAverageDataVector ();
           compressedTreeDataIn_arg.read ((char*)&pointAvgColorDataVector_size, sizeof(pointAvgColorDataVector_size));
           pointAvgColorDataVector.resize (pointAvgColorDataVector_size);
-          compressedColorDataLen_ += entropyCoder_.decodeStreamToCharVector (compressedTreeDataIn_arg,
-                                                                             pointAvgColorDataVector);
+          compressedColorDataLen_ += entropyDecodeCharVector (entropyCoder_, compressedTreeDataIn_arg,
+                                                              pointAvgColorDataVector);
         }
 
         if (!doVoxelGridEnDecoding_)
@@ -357,15 +376,16 @@ namespace pcl
           // decode amount of points per voxel
           compressedTreeDataIn_arg.read ((char*)&pointCountDataVector_size, sizeof(pointCountDataVector_size));
           pointCountDataVector_.resize (pointCountDataVector_size);
-          compressedPointDataLen_ += entropyCoder_.decodeStreamToIntVector (compressedTreeDataIn_arg, pointCountDataVector_);
+          compressedPointDataLen_ += entropyDecodeIntVector (entropyCoder_, compressedTreeDataIn_arg,
+                                                             pointCountDataVector_);
           pointCountDataVectorIterator_ = pointCountDataVector_.begin ();
 
           // decode differential point information
           std::vector<char>& pointDiffDataVector = pointCoder_.getDifferentialDataVector ();
           compressedTreeDataIn_arg.read ((char*)&pointDiffDataVector_size, sizeof(pointDiffDataVector_size));
           pointDiffDataVector.resize (pointDiffDataVector_size);
-          compressedPointDataLen_ += entropyCoder_.decodeStreamToCharVector (compressedTreeDataIn_arg,
-                                                                             pointDiffDataVector);
+          compressedPointDataLen_ += entropyDecodeCharVector (entropyCoder_, compressedTreeDataIn_arg,
+                                                              pointDiffDataVector);
 
           if (dataWithColor_)
           {
@@ -373,14 +393,78 @@ namespace pcl
             std::vector<char>& pointDiffColorDataVector = colorCoder_.getDifferentialDataVector ();
             compressedTreeDataIn_arg.read ((char*)&pointDiffColorDataVector_size, sizeof(pointDiffColorDataVector_size));
             pointDiffColorDataVector.resize (pointDiffColorDataVector_size);
-            compressedColorDataLen_ += entropyCoder_.decodeStreamToCharVector (compressedTreeDataIn_arg,
-                                                                               pointDiffColorDataVector);
+            compressedColorDataLen_ += entropyDecodeCharVector (entropyCoder_, compressedTreeDataIn_arg,
+                                                                pointDiffColorDataVector);
           }
 
         }
 
       }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      unsigned long
+      PointCloudCompression<PointT, LeafT, OctreeT>::entropyEncodeCharVector (
+          StaticRangeCoder& rangeCoder_arg, const std::vector<char>& inputByteVector_arg,
+          std::ostream& outputByteStream_arg)
+      {
+        if (ransCodedFrame_)
+        {
+          StaticRansCoder ransCoder;
+          return (ransCoder.encodeCharVectorToStream (inputByteVector_arg, outputByteStream_arg));
+        }
+
+        return (rangeCoder_arg.encodeCharVectorToStream (inputByteVector_arg, outputByteStream_arg));
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      unsigned long
+      PointCloudCompression<PointT, LeafT, OctreeT>::entropyEncodeIntVector (
+          StaticRangeCoder& rangeCoder_arg, const std::vector<unsigned int>& inputIntVector_arg,
+          std::ostream& outputByteStream_arg)
+      {
+        if (ransCodedFrame_)
+        {
+          StaticRansCoder ransCoder;
+          return (ransCoder.encodeIntVectorToStream (inputIntVector_arg, outputByteStream_arg));
+        }
+
+        return (rangeCoder_arg.encodeIntVectorToStream (inputIntVector_arg, outputByteStream_arg));
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      unsigned long
+      PointCloudCompression<PointT, LeafT, OctreeT>::entropyDecodeCharVector (
+          StaticRangeCoder& rangeCoder_arg, std::istream& inputByteStream_arg,
+          std::vector<char>& outputByteVector_arg)
+      {
+        if (ransCodedFrame_)
+        {
+          StaticRansCoder ransCoder;
+          return (ransCoder.decodeStreamToCharVector (inputByteStream_arg, outputByteVector_arg));
+        }
+
+        return (rangeCoder_arg.decodeStreamToCharVector (inputByteStream_arg, outputByteVector_arg));
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      unsigned long
+      PointCloudCompression<PointT, LeafT, OctreeT>::entropyDecodeIntVector (
+          StaticRangeCoder& rangeCoder_arg, std::istream& inputByteStream_arg,
+          std::vector<unsigned int>& outputIntVector_arg)
+      {
+        if (ransCodedFrame_)
+        {
+          StaticRansCoder ransCoder;
+          return (ransCoder.decodeStreamToIntVector (inputByteStream_arg, outputIntVector_arg));
+        }
+
+        return (rangeCoder_arg.decodeStreamToIntVector (inputByteStream_arg, outputIntVector_arg));
+      }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename PointT, typename LeafT, typename OctreeT>
       void
@@ -388,7 +472,20 @@ namespace pcl
       {
 
         // encode header identifier
-        compressedTreeDataOut_arg.write ((const char*)frameHeaderIdentifier_, strlen(frameHeaderIdentifier_));
+        if (partitionedFrame_ || ransCodedFrame_)
+        {
+          unsigned char frameCodingFlags = 0;
+          if (partitionedFrame_)
+            frameCodingFlags |= PARTITIONED_FRAME_FLAG;
+          if (ransCodedFrame_)
+            frameCodingFlags |= RANS_CODED_FRAME_FLAG;
+
+          compressedTreeDataOut_arg.write ((const char*)frameHeaderIdentifierExtended_,
+                                           strlen(frameHeaderIdentifierExtended_));
+          compressedTreeDataOut_arg.write ((const char*)&frameCodingFlags, sizeof(frameCodingFlags));
+        }
+        else
+          compressedTreeDataOut_arg.write ((const char*)frameHeaderIdentifier_, strlen(frameHeaderIdentifier_));
 
         // encode point cloud header id
         compressedTreeDataOut_arg.write ((const char*)&frameID_, sizeof(frameID_));
@@ -441,15 +538,53 @@ namespace pcl
       PointCloudCompression<PointT, LeafT, OctreeT>::readFrameHeader ( std::istream& compressedTreeDataIn_arg)
       {
 
-      // sync to frame header
-        unsigned int headerIdPos = 0;
-        while (headerIdPos < strlen(frameHeaderIdentifier_))
+        // both frame header identifiers share all but the last character of the single stream identifier
+        const unsigned int headerPrefixLen = strlen(frameHeaderIdentifier_) - 1;
+        bool headerFound = false;
+
+        while (!headerFound && compressedTreeDataIn_arg.good ())
         {
-          char readChar;
-          compressedTreeDataIn_arg.read ((char*)&readChar, sizeof(readChar));
-          if (readChar != frameHeaderIdentifier_[headerIdPos++])
+          // sync to frame header
+          unsigned int headerIdPos = 0;
+          while ((headerIdPos < headerPrefixLen) && compressedTreeDataIn_arg.good ())
           {
-            headerIdPos = (frameHeaderIdentifier_[0]==readChar)?1:0;
+            char readChar;
+            compressedTreeDataIn_arg.read ((char*)&readChar, sizeof(readChar));
+            if (readChar != frameHeaderIdentifier_[headerIdPos++])
+            {
+              headerIdPos = (frameHeaderIdentifier_[0]==readChar)?1:0;
+            }
+          }
+
+          // identify frame format
+          headerIdPos = headerPrefixLen;
+          partitionedFrame_ = false;
+          ransCodedFrame_ = false;
+          while (headerIdPos < strlen(frameHeaderIdentifierExtended_) && compressedTreeDataIn_arg.good ())
+          {
+            char readChar;
+            compressedTreeDataIn_arg.read ((char*)&readChar, sizeof(readChar));
+
+            if ((headerIdPos == headerPrefixLen) && (readChar == frameHeaderIdentifier_[headerPrefixLen]))
+            {
+              // single stream frame
+              headerFound = true;
+              break;
+            }
+
+            if (readChar != frameHeaderIdentifierExtended_[headerIdPos++])
+              break;
+
+            if (headerIdPos == strlen(frameHeaderIdentifierExtended_))
+            {
+              // extended frame - read frame coding flags
+              unsigned char frameCodingFlags = 0;
+              compressedTreeDataIn_arg.read ((char*)&frameCodingFlags, sizeof(frameCodingFlags));
+
+              partitionedFrame_ = (frameCodingFlags & PARTITIONED_FRAME_FLAG) != 0;
+              ransCodedFrame_ = (frameCodingFlags & RANS_CODED_FRAME_FLAG) != 0;
+              headerFound = true;
+            }
           }
         }
 
@@ -499,15 +634,35 @@ namespace pcl
       PointCloudCompression<PointT, LeafT, OctreeT>::serializeLeafCallback (OctreeLeaf& leaf_arg, const OctreeKey& key_arg)
       {
 
-      // reference to point indices vector stored within octree leaf
-      const std::vector<int>& leafIdx = leaf_arg.getIdxVector ();
+        if (partitionedFrame_)
+        {
+          // leaf nodes are encoded per partition after serialization
+          leafNodes_.push_back (&leaf_arg);
+          leafKeys_.push_back (key_arg);
+          return;
+        }
 
+        // reference to point indices vector stored within octree leaf
+        const std::vector<int>& leafIdx = leaf_arg.getIdxVector ();
+
+        encodeLeaf (leafIdx, key_arg, pointCoder_, colorCoder_, pointCountDataVector_);
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      void
+      PointCloudCompression<PointT, LeafT, OctreeT>::encodeLeaf (const std::vector<int>& leafIdx_arg,
+                                                                 const OctreeKey& key_arg,
+                                                                 PointCoding<PointT>& pointCoder_arg,
+                                                                 ColorCoding<PointT>& colorCoder_arg,
+                                                                 std::vector<unsigned int>& pointCountDataVector_arg)
+      {
         if (!doVoxelGridEnDecoding_)
         {
           double lowerVoxelCorner[3];
 
           // encode amount of points within voxel
-          pointCountDataVector_.push_back ((int)leafIdx.size ());
+          pointCountDataVector_arg.push_back ((int)leafIdx_arg.size ());
 
           // calculate lower voxel corner based on octree key
           lowerVoxelCorner[0] = ((double)key_arg.x) * this->resolution_ + this->minX_;
@@ -515,12 +670,12 @@ namespace pcl
           lowerVoxelCorner[2] = ((double)key_arg.z) * this->resolution_ + this->minZ_;
 
           // differentially encode points to lower voxel corner
-          pointCoder_.encodePoints (leafIdx, lowerVoxelCorner, this->input_);
+          pointCoder_arg.encodePoints (leafIdx_arg, lowerVoxelCorner, this->input_);
 
           if (cloudWithColor_)
           {
             // encode color of points
-            colorCoder_.encodePoints (leafIdx, pointColorOffset_, this->input_);
+            colorCoder_arg.encodePoints (leafIdx_arg, pointColorOffset_, this->input_);
           }
 
         }
@@ -529,7 +684,7 @@ namespace pcl
           if (cloudWithColor_)
           {
             // encode average color of all points within voxel
-            colorCoder_.encodeAverageOfPoints (leafIdx, pointColorOffset_, this->input_);
+            colorCoder_arg.encodeAverageOfPoints (leafIdx_arg, pointColorOffset_, this->input_);
           }
         }
 
@@ -540,46 +695,66 @@ namespace pcl
       void
       PointCloudCompression<PointT, LeafT, OctreeT>::deserializeLeafCallback (OctreeLeaf& leaf_arg, const OctreeKey& key_arg)
       {
-        double lowerVoxelCorner[3];
         std::size_t pointCount, i, cloudSize;
         PointT newPoint;
 
+        if (partitionedFrame_)
+        {
+          // leaf nodes are decoded per partition after deserialization
+          leafKeys_.push_back (key_arg);
+          return;
+        }
+
         pointCount = 1;
 
+        // get current cloud size
+        cloudSize = this->output_->points.size ();
+
         if (!doVoxelGridEnDecoding_)
         {
-          // get current cloud size
-          cloudSize = this->output_->points.size ();
-
           // get amount of point to be decoded
           pointCount = *pointCountDataVectorIterator_;
           pointCountDataVectorIterator_++;
+        }
 
-          // increase point cloud by amount of voxel points
-          for (i = 0; i < pointCount; i++)
-          {
-            this->output_->points.push_back (newPoint);
-          }
+        // increase point cloud by amount of voxel points
+        for (i = 0; i < pointCount; i++)
+        {
+          this->output_->points.push_back (newPoint);
+        }
+
+        decodeLeaf (key_arg, pointCount, cloudSize, pointCoder_, colorCoder_);
+      }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      void
+      PointCloudCompression<PointT, LeafT, OctreeT>::decodeLeaf (const OctreeKey& key_arg, std::size_t pointCount_arg,
+                                                                 std::size_t beginIdx_arg,
+                                                                 PointCoding<PointT>& pointCoder_arg,
+                                                                 ColorCoding<PointT>& colorCoder_arg)
+      {
+        double lowerVoxelCorner[3];
+
+        if (!doVoxelGridEnDecoding_)
+        {
           // calculcate position of lower voxel corner
           lowerVoxelCorner[0] = ((double)key_arg.x) * this->resolution_ + this->minX_;
           lowerVoxelCorner[1] = ((double)key_arg.y) * this->resolution_ + this->minY_;
           lowerVoxelCorner[2] = ((double)key_arg.z) * this->resolution_ + this->minZ_;
 
           // decode differentially encoded points
-          pointCoder_.decodePoints (this->output_, lowerVoxelCorner, cloudSize, cloudSize + pointCount);
+          pointCoder_arg.decodePoints (this->output_, lowerVoxelCorner, beginIdx_arg, beginIdx_arg + pointCount_arg);
 
         }
         else
         {
+          PointT& newPoint = this->output_->points[beginIdx_arg];
+
           // calculcate center of lower voxel corner
           newPoint.x = ((double)key_arg.x + 0.5) * this->resolution_ + this->minX_;
           newPoint.y = ((double)key_arg.y + 0.5) * this->resolution_ + this->minY_;
           newPoint.z = ((double)key_arg.z + 0.5) * this->resolution_ + this->minZ_;
-
-          // add point to point cloud
-          this->output_->points.push_back (newPoint);
-
         }
 
         if (cloudWithColor_)
@@ -587,17 +762,301 @@ namespace pcl
           if (dataWithColor_)
           {
             // decode color information
-            colorCoder_.decodePoints (this->output_, this->output_->points.size () - pointCount,
-                                      this->output_->points.size (), pointColorOffset_);
+            colorCoder_arg.decodePoints (this->output_, beginIdx_arg, beginIdx_arg + pointCount_arg, pointColorOffset_);
           }
           else
           {
             // set default color information
-            colorCoder_.setDefaultColor (this->output_, this->output_->points.size () - pointCount,
-                                         this->output_->points.size (), pointColorOffset_);
+            colorCoder_arg.setDefaultColor (this->output_, beginIdx_arg, beginIdx_arg + pointCount_arg,
+                                            pointColorOffset_);
+          }
+        }
+
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      void
+      PointCloudCompression<PointT, LeafT, OctreeT>::entropyEncodingPartitioned (std::ostream& compressedTreeDataOut_arg)
+      {
+        const std::size_t leafCount = leafNodes_.size ();
+        const int partitionCount = (int)std::min<std::size_t> (partitionCount_, std::max<std::size_t> (leafCount, 1));
+        std::size_t totalPoints, accumulatedPoints, leafIdx;
+        int p;
+
+        // split leaf nodes into partitions holding a similar amount of points
+        totalPoints = 0;
+        for (leafIdx = 0; leafIdx < leafCount; leafIdx++)
+          totalPoints += leafNodes_[leafIdx]->getIdxVector ().size ();
+
+        partitions_.resize (partitionCount);
+
+        accumulatedPoints = 0;
+        leafIdx = 0;
+        for (p = 0; p < partitionCount; p++)
+        {
+          const std::size_t partitionEnd = (totalPoints * (p + 1)) / partitionCount;
+
+          partitions_[p].leafBegin = leafIdx;
+          while ((leafIdx < leafCount) && ((accumulatedPoints < partitionEnd) || (p == partitionCount - 1)))
+            accumulatedPoints += leafNodes_[leafIdx++]->getIdxVector ().size ();
+          partitions_[p].leafCount = leafIdx - partitions_[p].leafBegin;
+        }
+
+        // encode partitions and octree structure in parallel - the last task handles the octree structure
+#pragma omp parallel for schedule (dynamic, 1) num_threads (this->threads_)
+        for (int task = 0; task <= partitionCount; task++)
+        {
+          StaticRangeCoder entropyCoder;
+          std::ostringstream compressedDataOut;
+
+          if (task == partitionCount)
+          {
+            entropyEncodeCharVector (entropyCoder, binaryTreeDataVector_, compressedDataOut);
+            compressedTreeData_ = compressedDataOut.str ();
+            continue;
           }
+
+          CompressionPartition& partition = partitions_[task];
+
+          // copy coder configuration
+          partition.pointCoder = pointCoder_;
+          partition.colorCoder = colorCoder_;
+          partition.pointCoder.initializeEncoding ();
+          partition.colorCoder.initializeEncoding ();
+          partition.pointCountDataVector.clear ();
+          partition.compressedPointDataLen = 0;
+          partition.compressedColorDataLen = 0;
+
+          // encode leaf nodes of partition
+          for (std::size_t i = partition.leafBegin; i < partition.leafBegin + partition.leafCount; i++)
+            encodeLeaf (leafNodes_[i]->getIdxVector (), leafKeys_[i], partition.pointCoder, partition.colorCoder,
+                        partition.pointCountDataVector);
+
+          // entropy coding - same data layout as the single stream format
+          if (cloudWithColor_)
+          {
+            std::vector<char>& pointAvgColorDataVector = partition.colorCoder.getAverageDataVector ();
+            unsigned long pointAvgColorDataVector_size = pointAvgColorDataVector.size ();
+            compressedDataOut.write ((const char*)&pointAvgColorDataVector_size, sizeof(pointAvgColorDataVector_size));
+            partition.compressedColorDataLen += entropyEncodeCharVector (entropyCoder, pointAvgColorDataVector,
+                                                                         compressedDataOut);
+          }
+
+          if (!doVoxelGridEnDecoding_)
+          {
+            unsigned long pointCountDataVector_size = partition.pointCountDataVector.size ();
+            compressedDataOut.write ((const char*)&pointCountDataVector_size, sizeof(pointCountDataVector_size));
+            partition.compressedPointDataLen += entropyEncodeIntVector (entropyCoder, partition.pointCountDataVector,
+                                                                        compressedDataOut);
+
+            std::vector<char>& pointDiffDataVector = partition.pointCoder.getDifferentialDataVector ();
+            unsigned long pointDiffDataVector_size = pointDiffDataVector.size ();
+            compressedDataOut.write ((const char*)&pointDiffDataVector_size, sizeof(pointDiffDataVector_size));
+            partition.compressedPointDataLen += entropyEncodeCharVector (entropyCoder, pointDiffDataVector,
+                                                                         compressedDataOut);
+
+            if (cloudWithColor_)
+            {
+              std::vector<char>& pointDiffColorDataVector = partition.colorCoder.getDifferentialDataVector ();
+              unsigned long pointDiffColorDataVector_size = pointDiffColorDataVector.size ();
+              compressedDataOut.write ((const char*)&pointDiffColorDataVector_size,
+                                       sizeof(pointDiffColorDataVector_size));
+              partition.compressedColorDataLen += entropyEncodeCharVector (entropyCoder, pointDiffColorDataVector,
+                                                                           compressedDataOut);
+            }
+          }
+
+          partition.compressedData = compressedDataOut.str ();
+        }
+
+        // write octree structure
+        unsigned long binaryTreeDataVector_size = binaryTreeDataVector_.size ();
+        unsigned long compressedTreeData_size = compressedTreeData_.size ();
+        compressedTreeDataOut_arg.write ((const char*)&binaryTreeDataVector_size, sizeof(binaryTreeDataVector_size));
+        compressedTreeDataOut_arg.write ((const char*)&compressedTreeData_size, sizeof(compressedTreeData_size));
+        compressedTreeDataOut_arg.write (compressedTreeData_.data (), compressedTreeData_.size ());
+
+        compressedPointDataLen_ = compressedTreeData_.size ();
+        compressedColorDataLen_ = 0;
+
+        // write partitions
+        unsigned int partitionCount_out = partitionCount;
+        compressedTreeDataOut_arg.write ((const char*)&partitionCount_out, sizeof(partitionCount_out));
+
+        for (p = 0; p < partitionCount; p++)
+        {
+          unsigned long partitionLeafCount = partitions_[p].leafCount;
+          unsigned long partitionData_size = partitions_[p].compressedData.size ();
+
+          compressedTreeDataOut_arg.write ((const char*)&partitionLeafCount, sizeof(partitionLeafCount));
+          compressedTreeDataOut_arg.write ((const char*)&partitionData_size, sizeof(partitionData_size));
+          compressedTreeDataOut_arg.write (partitions_[p].compressedData.data (), partitions_[p].compressedData.size ());
+
+          compressedPointDataLen_ += partitions_[p].compressedPointDataLen;
+          compressedColorDataLen_ += partitions_[p].compressedColorDataLen;
         }
 
+        // flush output stream
+        compressedTreeDataOut_arg.flush ();
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      void
+      PointCloudCompression<PointT, LeafT, OctreeT>::entropyDecodingPartitioned (std::istream& compressedTreeDataIn_arg)
+      {
+        unsigned long binaryTreeDataVector_size;
+        unsigned long compressedTreeData_size;
+        unsigned int partitionCount;
+        std::size_t leafBegin;
+
+        // read octree structure
+        compressedTreeDataIn_arg.read ((char*)&binaryTreeDataVector_size, sizeof(binaryTreeDataVector_size));
+        compressedTreeDataIn_arg.read ((char*)&compressedTreeData_size, sizeof(compressedTreeData_size));
+        compressedTreeData_.resize (compressedTreeData_size);
+        if (compressedTreeData_size > 0)
+          compressedTreeDataIn_arg.read (&compressedTreeData_[0], compressedTreeData_size);
+
+        // read partitions
+        compressedTreeDataIn_arg.read ((char*)&partitionCount, sizeof(partitionCount));
+        partitions_.resize (partitionCount);
+
+        leafBegin = 0;
+        for (unsigned int p = 0; p < partitionCount; p++)
+        {
+          unsigned long partitionLeafCount;
+          unsigned long partitionData_size;
+
+          compressedTreeDataIn_arg.read ((char*)&partitionLeafCount, sizeof(partitionLeafCount));
+          compressedTreeDataIn_arg.read ((char*)&partitionData_size, sizeof(partitionData_size));
+
+          partitions_[p].leafBegin = leafBegin;
+          partitions_[p].leafCount = partitionLeafCount;
+          partitions_[p].compressedData.resize (partitionData_size);
+          if (partitionData_size > 0)
+            compressedTreeDataIn_arg.read (&partitions_[p].compressedData[0], partitionData_size);
+
+          leafBegin += partitionLeafCount;
+        }
+
+        binaryTreeDataVector_.resize (binaryTreeDataVector_size);
+
+        // decode partitions and octree structure in parallel - the last task handles the octree structure
+#pragma omp parallel for schedule (dynamic, 1) num_threads (this->threads_)
+        for (int task = 0; task <= (int)partitionCount; task++)
+        {
+          StaticRangeCoder entropyCoder;
+
+          if (task == (int)partitionCount)
+          {
+            std::istringstream compressedDataIn (compressedTreeData_);
+            entropyDecodeCharVector (entropyCoder, compressedDataIn, binaryTreeDataVector_);
+            continue;
+          }
+
+          CompressionPartition& partition = partitions_[task];
+          std::istringstream compressedDataIn (partition.compressedData);
+
+          // copy coder configuration
+          partition.pointCoder = pointCoder_;
+          partition.colorCoder = colorCoder_;
+          partition.compressedPointDataLen = 0;
+          partition.compressedColorDataLen = 0;
+
+          if (dataWithColor_)
+          {
+            std::vector<char>& pointAvgColorDataVector = partition.colorCoder.getAverageDataVector ();
+            unsigned long pointAvgColorDataVector_size;
+            compressedDataIn.read ((char*)&pointAvgColorDataVector_size, sizeof(pointAvgColorDataVector_size));
+            pointAvgColorDataVector.resize (pointAvgColorDataVector_size);
+            partition.compressedColorDataLen += entropyDecodeCharVector (entropyCoder, compressedDataIn,
+                                                                         pointAvgColorDataVector);
+          }
+
+          if (!doVoxelGridEnDecoding_)
+          {
+            unsigned long pointCountDataVector_size;
+            compressedDataIn.read ((char*)&pointCountDataVector_size, sizeof(pointCountDataVector_size));
+            partition.pointCountDataVector.resize (pointCountDataVector_size);
+            partition.compressedPointDataLen += entropyDecodeIntVector (entropyCoder, compressedDataIn,
+                                                                        partition.pointCountDataVector);
+
+            std::vector<char>& pointDiffDataVector = partition.pointCoder.getDifferentialDataVector ();
+            unsigned long pointDiffDataVector_size;
+            compressedDataIn.read ((char*)&pointDiffDataVector_size, sizeof(pointDiffDataVector_size));
+            pointDiffDataVector.resize (pointDiffDataVector_size);
+            partition.compressedPointDataLen += entropyDecodeCharVector (entropyCoder, compressedDataIn,
+                                                                         pointDiffDataVector);
+
+            if (dataWithColor_)
+            {
+              std::vector<char>& pointDiffColorDataVector = partition.colorCoder.getDifferentialDataVector ();
+              unsigned long pointDiffColorDataVector_size;
+              compressedDataIn.read ((char*)&pointDiffColorDataVector_size, sizeof(pointDiffColorDataVector_size));
+              pointDiffColorDataVector.resize (pointDiffColorDataVector_size);
+              partition.compressedColorDataLen += entropyDecodeCharVector (entropyCoder, compressedDataIn,
+                                                                           pointDiffColorDataVector);
+            }
+          }
+
+          partition.pointCoder.initializeDecoding ();
+          partition.colorCoder.initializeDecoding ();
+        }
+
+        compressedPointDataLen_ = compressedTreeData_.size ();
+        compressedColorDataLen_ = 0;
+        for (unsigned int p = 0; p < partitionCount; p++)
+        {
+          compressedPointDataLen_ += partitions_[p].compressedPointDataLen;
+          compressedColorDataLen_ += partitions_[p].compressedColorDataLen;
+        }
+      }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename OctreeT>
+      void
+      PointCloudCompression<PointT, LeafT, OctreeT>::decodePartitions ()
+      {
+        const int partitionCount = (int)partitions_.size ();
+        std::vector<std::size_t> partitionPointBegin (partitionCount + 1, 0);
+        int p;
+
+        // calculate position of the points of each partition within the output cloud
+        for (p = 0; p < partitionCount; p++)
+        {
+          std::size_t partitionPoints = partitions_[p].leafCount;
+
+          if (!doVoxelGridEnDecoding_)
+          {
+            partitionPoints = 0;
+            for (std::size_t i = 0; i < partitions_[p].pointCountDataVector.size (); i++)
+              partitionPoints += partitions_[p].pointCountDataVector[i];
+          }
+
+          partitionPointBegin[p + 1] = partitionPointBegin[p] + partitionPoints;
+        }
+
+        assert (leafKeys_.size () == (partitionCount ? partitions_.back ().leafBegin + partitions_.back ().leafCount : 0));
+
+        output_->points.resize (partitionPointBegin[partitionCount]);
+
+#pragma omp parallel for schedule (dynamic, 1) num_threads (this->threads_)
+        for (p = 0; p < partitionCount; p++)
+        {
+          CompressionPartition& partition = partitions_[p];
+          std::size_t pointIdx = partitionPointBegin[p];
+
+          for (std::size_t i = 0; i < partition.leafCount; i++)
+          {
+            const std::size_t pointCount = doVoxelGridEnDecoding_ ? 1 : partition.pointCountDataVector[i];
+
+            decodeLeaf (leafKeys_[partition.leafBegin + i], pointCount, pointIdx, partition.pointCoder,
+                        partition.colorCoder);
+
+            pointIdx += pointCount;
+          }
+        }
       }
 
   }
@@ -53,6 +53,7 @@
 #include <iostream>
 #include <stdio.h>
 #include <string.h>
+#include <string>
 
 namespace pcl
 {
@@ -110,7 +111,8 @@ namespace pcl
               doVoxelGridEnDecoding_ (doVoxelGridDownDownSampling_arg), iFrameRate_ (iFrameRate_arg),
               iFrameCounter_ (0), frameID_ (0), pointCount_ (0), iFrame_ (true),
               doColorEncoding_ (doColorEncoding_arg), cloudWithColor_ (false), dataWithColor_ (false),
-              pointColorOffset_ (0), bShowStatistics (showStatistics_arg)
+              pointColorOffset_ (0), bShowStatistics (showStatistics_arg), partitionCount_ (1),
+              partitionedFrame_ (false), doRansEntropyCoding_ (false), ransCodedFrame_ (false)
 
         {
           output_ = PointCloudPtr ();
@@ -129,6 +131,7 @@ namespace pcl
             pointCoder_.setPrecision (selectedProfile.pointResolution);
             doColorEncoding_ = selectedProfile.doColorEncoding;
             colorCoder_.setBitDepth (selectedProfile.colorBitResolution);
+            doRansEntropyCoding_ = selectedProfile.doRansEntropyCoding;
 
           } else {
             // configure point & color coder
@@ -171,6 +174,76 @@ namespace pcl
           return (output_);
         }
 
+        /** \brief Set the amount of partitions the encoded frames are split into. Each partition holds a contiguous
+         *  range of octree leaf nodes (in depth-first order) whose point, color and point count information is encoded
+         *  and entropy coded independently. Partitions are processed in parallel using the number of threads given by
+         *  setNumberOfThreads (). A value of 1 (default) produces the single stream bitstream format.
+         *  \note The decoder detects the bitstream format automatically, the amount of partitions is stored per frame.
+         *  \param partitionCount_arg: amount of partitions per frame
+         * */
+        inline void
+        setPartitionCount (unsigned int partitionCount_arg)
+        {
+          partitionCount_ = partitionCount_arg > 0 ? partitionCount_arg : 1;
+        }
+
+        /** \brief Get the amount of partitions the encoded frames are split into.
+         *  \return amount of partitions per frame
+         * */
+        inline unsigned int
+        getPartitionCount () const
+        {
+          return (partitionCount_);
+        }
+
+        /** \brief Select the entropy coder used for encoding. The rANS coder trades a slightly lower compression ratio
+         *  for faster entropy coding. The decoder detects the coder from the frame header. StaticRangeCoder is used
+         *  by default and by all predefined compression profiles, so rANS coding has to be enabled explicitly.
+         *  \param doRansEntropyCoding_arg: use StaticRansCoder instead of StaticRangeCoder
+         * */
+        inline void
+        setRansEntropyCoding (bool doRansEntropyCoding_arg)
+        {
+          doRansEntropyCoding_ = doRansEntropyCoding_arg;
+        }
+
+        /** \brief Check if the rANS entropy coder is used for encoding.
+         *  \return true if StaticRansCoder is selected
+         * */
+        inline bool
+        getRansEntropyCoding () const
+        {
+          return (doRansEntropyCoding_);
+        }
+
+        /** \brief Set the I-frame rate. Every iFrameRate_arg + 1-th encoded frame is an I-frame.
+         *  \param iFrameRate_arg: i-frame encoding rate
+         * */
+        inline void
+        setIFrameRate (unsigned int iFrameRate_arg)
+        {
+          iFrameRate_ = iFrameRate_arg;
+        }
+
+        /** \brief Get the I-frame rate.
+         *  \return i-frame encoding rate
+         * */
+        inline unsigned int
+        getIFrameRate () const
+        {
+          return (iFrameRate_);
+        }
+
+        /** \brief Check if the most recently encoded or decoded frame is an intra frame (I-frame). I-frames do not
+         *  reference previous frames and can be decoded by a newly constructed decoder.
+         *  \return true if the last frame was an I-frame
+         * */
+        inline bool
+        isIFrame () const
+        {
+          return (iFrame_);
+        }
+
         /** \brief Encode point cloud to output stream
          *  \param cloud_arg:  point cloud to be compressed
          *  \param compressedTreeDataOut_arg:  binary output stream containing compressed data
@@ -211,6 +284,86 @@ namespace pcl
         void
         entropyDecoding (std::istream& compressedTreeDataIn_arg);
 
+        /** \brief Entropy encode char vector with the entropy coder of the current frame
+         *  \param rangeCoder_arg: range coder instance used if the frame is not rANS coded
+         *  \param inputByteVector_arg: input vector
+         *  \param outputByteStream_arg: binary output stream
+         *  \return amount of bytes written to output stream
+         * */
+        unsigned long
+        entropyEncodeCharVector (StaticRangeCoder& rangeCoder_arg, const std::vector<char>& inputByteVector_arg,
+                                 std::ostream& outputByteStream_arg);
+
+        /** \brief Entropy encode integer vector with the entropy coder of the current frame
+         *  \param rangeCoder_arg: range coder instance used if the frame is not rANS coded
+         *  \param inputIntVector_arg: input vector
+         *  \param outputByteStream_arg: binary output stream
+         *  \return amount of bytes written to output stream
+         * */
+        unsigned long
+        entropyEncodeIntVector (StaticRangeCoder& rangeCoder_arg, const std::vector<unsigned int>& inputIntVector_arg,
+                                std::ostream& outputByteStream_arg);
+
+        /** \brief Entropy decode char vector with the entropy coder of the current frame
+         *  \param rangeCoder_arg: range coder instance used if the frame is not rANS coded
+         *  \param inputByteStream_arg: binary input stream
+         *  \param outputByteVector_arg: output vector, its size defines the amount of decoded symbols
+         *  \return amount of bytes read from input stream
+         * */
+        unsigned long
+        entropyDecodeCharVector (StaticRangeCoder& rangeCoder_arg, std::istream& inputByteStream_arg,
+                                 std::vector<char>& outputByteVector_arg);
+
+        /** \brief Entropy decode integer vector with the entropy coder of the current frame
+         *  \param rangeCoder_arg: range coder instance used if the frame is not rANS coded
+         *  \param inputByteStream_arg: binary input stream
+         *  \param outputIntVector_arg: output vector, its size defines the amount of decoded symbols
+         *  \return amount of bytes read from input stream
+         * */
+        unsigned long
+        entropyDecodeIntVector (StaticRangeCoder& rangeCoder_arg, std::istream& inputByteStream_arg,
+                                std::vector<unsigned int>& outputIntVector_arg);
+
+        /** \brief Split the collected leaf nodes into partitions, encode and entropy code them in parallel and output
+         *  them to binary stream
+         *  \param compressedTreeDataOut_arg: binary output stream
+         * */
+        void
+        entropyEncodingPartitioned (std::ostream& compressedTreeDataOut_arg);
+
+        /** \brief Read all partitions of a frame from input binary stream and entropy decode them in parallel
+         *  \param compressedTreeDataIn_arg: binary input stream
+         * */
+        void
+        entropyDecodingPartitioned (std::istream& compressedTreeDataIn_arg);
+
+        /** \brief Decode the points of all partitions in parallel. The octree structure must have been decoded before.
+         * */
+        void
+        decodePartitions ();
+
+        /** \brief Encode point and color information of a leaf node
+         *  \param leafIdx_arg: point indices stored within leaf node
+         *  \param key_arg: octree key of leaf node
+         *  \param pointCoder_arg: point coder receiving the differential point information
+         *  \param colorCoder_arg: color coder receiving the color information
+         *  \param pointCountDataVector_arg: vector receiving the amount of points within the leaf node
+         **/
+        void
+        encodeLeaf (const std::vector<int>& leafIdx_arg, const OctreeKey& key_arg, PointCoding<PointT>& pointCoder_arg,
+                    ColorCoding<PointT>& colorCoder_arg, std::vector<unsigned int>& pointCountDataVector_arg);
+
+        /** \brief Decode point and color information of a leaf node into the output point cloud
+         *  \param key_arg: octree key of leaf node
+         *  \param pointCount_arg: amount of points within leaf node
+         *  \param beginIdx_arg: index of first point of the leaf node in the output point cloud
+         *  \param pointCoder_arg: point coder providing the differential point information
+         *  \param colorCoder_arg: color coder providing the color information
+         **/
+        void
+        decodeLeaf (const OctreeKey& key_arg, std::size_t pointCount_arg, std::size_t beginIdx_arg,
+                    PointCoding<PointT>& pointCoder_arg, ColorCoding<PointT>& colorCoder_arg);
+
         /** \brief Encode leaf node information during serialization
          *  \param leaf_arg: reference to new leaf node
          *  \param key_arg: octree key of new leaf node
@@ -266,14 +419,77 @@ namespace pcl
         unsigned long compressedPointDataLen_;
         unsigned long compressedColorDataLen_;
 
+        /** \brief Independently coded part of a partitioned frame */
+        struct CompressionPartition
+        {
+          /** \brief Index of first leaf node of the partition in depth-first order */
+          std::size_t leafBegin;
+
+          /** \brief Amount of leaf nodes within the partition */
+          std::size_t leafCount;
+
+          /** \brief Amount of points per voxel */
+          std::vector<unsigned int> pointCountDataVector;
+
+          /** \brief Point coding instance of the partition */
+          PointCoding<PointT> pointCoder;
+
+          /** \brief Color coding instance of the partition */
+          ColorCoding<PointT> colorCoder;
+
+          /** \brief Entropy coded partition data */
+          std::string compressedData;
+
+          /** \brief Compressed size of point and color information */
+          unsigned long compressedPointDataLen;
+          unsigned long compressedColorDataLen;
+        };
+
+        /** \brief Amount of partitions per encoded frame */
+        unsigned int partitionCount_;
+
+        /** \brief Indicates that the frame being decoded uses the partitioned bitstream format */
+        bool partitionedFrame_;
+
+        /** \brief Use the rANS entropy coder for encoding */
+        bool doRansEntropyCoding_;
+
+        /** \brief Indicates that the current frame is entropy coded with the rANS coder */
+        bool ransCodedFrame_;
+
+        /** \brief Flags following the extended frame header identifier */
+        enum frameCodingFlags_e
+        {
+          PARTITIONED_FRAME_FLAG = 0x01,
+          RANS_CODED_FRAME_FLAG = 0x02
+        };
+
+        /** \brief Partitions of the current frame */
+        std::vector<CompressionPartition> partitions_;
+
+        /** \brief Leaf nodes of the current frame in depth-first order (partitioned encoding) */
+        std::vector<OctreeLeaf*> leafNodes_;
+
+        /** \brief Octree keys of the leaf nodes of the current frame in depth-first order (partitioned coding) */
+        std::vector<OctreeKey> leafKeys_;
+
+        /** \brief Compressed octree structure (partitioned coding) */
+        std::string compressedTreeData_;
+
         // frame header identifier
         static const char* frameHeaderIdentifier_;
 
+        // frame header identifier of frames using partitioning or rANS coding, followed by frame coding flags
+        static const char* frameHeaderIdentifierExtended_;
+
       };
 
     // define frame header initialization
     template<typename PointT, typename LeafT, typename OctreeT>
       const char* PointCloudCompression<PointT, LeafT, OctreeT>::frameHeaderIdentifier_ = "<PCL-COMPRESSED>";
+
+    template<typename PointT, typename LeafT, typename OctreeT>
+      const char* PointCloudCompression<PointT, LeafT, OctreeT>::frameHeaderIdentifierExtended_ = "<PCL-COMPRESSED-X>";
   }
 
 }
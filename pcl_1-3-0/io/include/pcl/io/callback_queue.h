@@ -0,0 +1,230 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_CALLBACK_QUEUE_H_
+#define PCL_IO_CALLBACK_QUEUE_H_
+
+#include <cstddef>
+#include <deque>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/condition.hpp>
+
+#include <pcl/pcl_macros.h>
+
+namespace pcl
+{
+  /** \brief Bounded queue of callbacks that are invoked in order on a worker thread owned by the queue. Grabbers
+    * use it to deliver frames to a slow consumer without stalling the driver thread.
+    * \ingroup io
+    */
+  class PCL_EXPORTS CallbackQueue
+  {
+    public:
+      /** \brief What push () does if the queue is full. */
+      enum DeliveryPolicy
+      {
+        /** \brief Drop the oldest queued callback, so the consumer always gets the latest frames. */
+        LATEST_ONLY,
+        /** \brief Block the caller until the worker thread made room, so no frame is lost. */
+        BLOCK
+      };
+
+      /** \brief Constructor, starts the worker thread.
+        * \param[in] policy what push () does if the queue is full
+        * \param[in] size the maximum number of queued callbacks, 0 is treated as 1
+        */
+      CallbackQueue (DeliveryPolicy policy = LATEST_ONLY, size_t size = 1);
+
+      /** \brief Destructor, invokes the queued callbacks and joins the worker thread. */
+      ~CallbackQueue ();
+
+      /** \brief Queue a callback for the worker thread.
+        * \param[in] callback the callback
+        */
+      void
+      push (const boost::function<void ()> &callback);
+
+      /** \brief Invoke the queued callbacks and join the worker thread. Callbacks pushed afterwards are dropped. */
+      void
+      stop ();
+
+      /** \brief Get the delivery policy of the queue. */
+      inline DeliveryPolicy
+      getDeliveryPolicy () const
+      {
+        return (policy_);
+      }
+
+      /** \brief Get the number of callbacks dropped because the queue was full or stopped. */
+      size_t
+      getDroppedCount () const;
+
+    private:
+      /** \brief Worker thread main loop. */
+      void
+      run ();
+
+      // disable copy constructor and assignment
+      CallbackQueue (const CallbackQueue&);
+      CallbackQueue& operator = (const CallbackQueue&);
+
+      DeliveryPolicy policy_;
+      size_t size_;
+      std::deque<boost::function<void ()> > callbacks_;
+      size_t dropped_;
+      bool quit_;
+
+      mutable boost::mutex mutex_;
+      boost::condition_variable not_empty_;
+      boost::condition_variable not_full_;
+      boost::thread thread_;
+  };
+
+  /** \brief Slot that forwards its arguments to a callback invoked on the worker thread of a CallbackQueue. The
+    * arguments are copied, so shared pointers to frames are passed on without copying the frames.
+    * \ingroup io
+    */
+  template <typename T> class QueuedCallback;
+
+  template <>
+  class QueuedCallback<void ()>
+  {
+    public:
+      QueuedCallback (const boost::shared_ptr<CallbackQueue> &queue, const boost::function<void ()> &callback)
+        : queue_ (queue), callback_ (callback)
+      {
+      }
+
+      void
+      operator () () const
+      {
+        queue_->push (callback_);
+      }
+
+    private:
+      boost::shared_ptr<CallbackQueue> queue_;
+      boost::function<void ()> callback_;
+  };
+
+  template <typename A1>
+  class QueuedCallback<void (A1)>
+  {
+    public:
+      QueuedCallback (const boost::shared_ptr<CallbackQueue> &queue, const boost::function<void (A1)> &callback)
+        : queue_ (queue), callback_ (callback)
+      {
+      }
+
+      void
+      operator () (A1 a1) const
+      {
+        queue_->push (boost::bind (callback_, a1));
+      }
+
+    private:
+      boost::shared_ptr<CallbackQueue> queue_;
+      boost::function<void (A1)> callback_;
+  };
+
+  template <typename A1, typename A2>
+  class QueuedCallback<void (A1, A2)>
+  {
+    public:
+      QueuedCallback (const boost::shared_ptr<CallbackQueue> &queue, const boost::function<void (A1, A2)> &callback)
+        : queue_ (queue), callback_ (callback)
+      {
+      }
+
+      void
+      operator () (A1 a1, A2 a2) const
+      {
+        queue_->push (boost::bind (callback_, a1, a2));
+      }
+
+    private:
+      boost::shared_ptr<CallbackQueue> queue_;
+      boost::function<void (A1, A2)> callback_;
+  };
+
+  template <typename A1, typename A2, typename A3>
+  class QueuedCallback<void (A1, A2, A3)>
+  {
+    public:
+      QueuedCallback (const boost::shared_ptr<CallbackQueue> &queue, const boost::function<void (A1, A2, A3)> &callback)
+        : queue_ (queue), callback_ (callback)
+      {
+      }
+
+      void
+      operator () (A1 a1, A2 a2, A3 a3) const
+      {
+        queue_->push (boost::bind (callback_, a1, a2, a3));
+      }
+
+    private:
+      boost::shared_ptr<CallbackQueue> queue_;
+      boost::function<void (A1, A2, A3)> callback_;
+  };
+
+  template <typename A1, typename A2, typename A3, typename A4>
+  class QueuedCallback<void (A1, A2, A3, A4)>
+  {
+    public:
+      QueuedCallback (const boost::shared_ptr<CallbackQueue> &queue,
+                      const boost::function<void (A1, A2, A3, A4)> &callback)
+        : queue_ (queue), callback_ (callback)
+      {
+      }
+
+      void
+      operator () (A1 a1, A2 a2, A3 a3, A4 a4) const
+      {
+        queue_->push (boost::bind (callback_, a1, a2, a3, a4));
+      }
+
+    private:
+      boost::shared_ptr<CallbackQueue> queue_;
+      boost::function<void (A1, A2, A3, A4)> callback_;
+  };
+}
+
+#endif  //#ifndef PCL_IO_CALLBACK_QUEUE_H_
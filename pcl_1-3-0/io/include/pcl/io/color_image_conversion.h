@@ -0,0 +1,91 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_COLOR_IMAGE_CONVERSION_H_
+#define PCL_IO_COLOR_IMAGE_CONVERSION_H_
+
+#include <pcl/pcl_macros.h>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Interpolation methods for debayering. The values match openni_wrapper::ImageBayerGRBG::DebayeringMethod.
+      * \ingroup io
+      */
+    enum DebayeringMethod
+    {
+      DEBAYERING_BILINEAR = 0,
+      DEBAYERING_EDGE_AWARE,
+      DEBAYERING_EDGE_AWARE_WEIGHTED
+    };
+
+    /** \brief Debayer a GRBG Bayer pattern image into a RGB image of the same size. The image rows are processed in
+      * pairs, which are split across the given number of threads.
+      * \param[in] bayer the Bayer pattern image, width * height bytes starting with a green pixel
+      * \param[in] width the width of the image, has to be even
+      * \param[in] height the height of the image, has to be even
+      * \param[out] rgb the resultant RGB image, 3 bytes (red, green, blue) per pixel
+      * \param[in] rgb_line_step the number of bytes per row of the RGB image, 0 for width * 3
+      * \param[in] method the interpolation method for the missing color channels
+      * \param[in] threads the number of threads the image rows are split across
+      * \ingroup io
+      */
+    PCL_EXPORTS void
+    debayerGRBGToRGB (const unsigned char *bayer, unsigned width, unsigned height,
+                      unsigned char *rgb, unsigned rgb_line_step = 0,
+                      DebayeringMethod method = DEBAYERING_EDGE_AWARE, unsigned threads = 1);
+
+    /** \brief Convert a YUV422 image (u, y1, v, y2 byte order) into a RGB image of the same size. The image rows are
+      * split across the given number of threads.
+      * \param[in] yuv the YUV422 image, width * height * 2 bytes
+      * \param[in] width the width of the image, has to be even
+      * \param[in] height the height of the image
+      * \param[out] rgb the resultant RGB image, 3 bytes (red, green, blue) per pixel
+      * \param[in] rgb_line_step the number of bytes per row of the RGB image, 0 for width * 3
+      * \param[in] threads the number of threads the image rows are split across
+      * \ingroup io
+      */
+    PCL_EXPORTS void
+    convertYUV422ToRGB (const unsigned char *yuv, unsigned width, unsigned height,
+                        unsigned char *rgb, unsigned rgb_line_step = 0, unsigned threads = 1);
+  }
+}
+
+#endif  //#ifndef PCL_IO_COLOR_IMAGE_CONVERSION_H_
@@ -0,0 +1,114 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_DEPTH_IMAGE_CONVERSION_H_
+#define PCL_IO_DEPTH_IMAGE_CONVERSION_H_
+
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Intrinsics and invalid depth values of a depth camera, used to convert depth images into organized
+      * point clouds. The principal point is assumed to be the image center.
+      * \ingroup io
+      */
+    struct DepthConversionParameters
+    {
+      DepthConversionParameters () :
+        width (0), height (0), focal_length (1.0f), no_sample_value (0), shadow_value (0), threads (1)
+      {}
+
+      /** \brief Width of the depth image in pixels. */
+      unsigned width;
+      /** \brief Height of the depth image in pixels. */
+      unsigned height;
+      /** \brief Focal length of the depth camera in pixels. */
+      float focal_length;
+      /** \brief Depth value marking pixels without a measurement. */
+      unsigned short no_sample_value;
+      /** \brief Depth value marking shadowed pixels. */
+      unsigned short shadow_value;
+      /** \brief Number of threads the image rows are split across. */
+      unsigned threads;
+    };
+
+    /** \brief Convert a depth image into an organized point cloud. Pixels with a depth of 0, the no sample value or
+      * the shadow value are set to NaN. The output cloud is only reallocated if its size does not match the image.
+      * \param[in] parameters the depth camera parameters
+      * \param[in] depth the depth image in millimeters, parameters.width * parameters.height values
+      * \param[out] cloud the resultant point cloud
+      * \ingroup io
+      */
+    PCL_EXPORTS void
+    convertDepthToPointCloud (const DepthConversionParameters &parameters, const unsigned short *depth,
+                              pcl::PointCloud<pcl::PointXYZ> &cloud);
+
+    /** \brief Convert a depth image and a registered color image into an organized point cloud. Pixels with a depth
+      * of 0, the no sample value or the shadow value are set to NaN. The output cloud is only reallocated if its size
+      * does not match the image.
+      * \param[in] parameters the depth camera parameters
+      * \param[in] depth the depth image in millimeters, parameters.width * parameters.height values
+      * \param[in] rgb the color image registered to the depth image, 3 bytes (red, green, blue) per pixel
+      * \param[out] cloud the resultant point cloud
+      * \ingroup io
+      */
+    PCL_EXPORTS void
+    convertDepthToPointCloud (const DepthConversionParameters &parameters, const unsigned short *depth,
+                              const unsigned char *rgb, pcl::PointCloud<pcl::PointXYZRGB> &cloud);
+
+    /** \brief Convert a depth image and an infrared image into an organized point cloud. Pixels with a depth of 0,
+      * the no sample value or the shadow value are set to NaN. The output cloud is only reallocated if its size does
+      * not match the image.
+      * \param[in] parameters the depth camera parameters
+      * \param[in] depth the depth image in millimeters, parameters.width * parameters.height values
+      * \param[in] ir the infrared image, parameters.width * parameters.height values
+      * \param[out] cloud the resultant point cloud
+      * \ingroup io
+      */
+    PCL_EXPORTS void
+    convertDepthToPointCloud (const DepthConversionParameters &parameters, const unsigned short *depth,
+                              const unsigned short *ir, pcl::PointCloud<pcl::PointXYZI> &cloud);
+  }
+}
+
+#endif  //#ifndef PCL_IO_DEPTH_IMAGE_CONVERSION_H_
@@ -0,0 +1,171 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_FRAME_POOL_H_
+#define PCL_IO_FRAME_POOL_H_
+
+#include <cstddef>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace pcl
+{
+  /** \brief Pool of recycled frames for grabbers. Frames are handed out as shared pointers, which return the frame
+    * to the pool instead of deleting it once the last reference is released. A recycled frame keeps its content and
+    * memory, so resizing it to the size of the previous frame does not allocate.
+    *
+    * The pool keeps at most capacity released frames, further frames are deleted. Frames may outlive the pool.
+    * acquire () may be called from any thread.
+    * \ingroup io
+    */
+  template <typename T>
+  class FramePool
+  {
+    public:
+      typedef boost::shared_ptr<T> Ptr;
+
+      /** \brief Constructor.
+        * \param[in] capacity the maximum number of released frames kept for reuse
+        */
+      FramePool (size_t capacity = 4) : storage_ (new Storage (capacity))
+      {
+      }
+
+      /** \brief Get a recycled frame, or a new one if no released frame is available.
+        * \return the frame, which returns to the pool when the last reference to it is released
+        */
+      Ptr
+      acquire ()
+      {
+        T* frame = NULL;
+        {
+          boost::mutex::scoped_lock lock (storage_->mutex_);
+          if (!storage_->frames_.empty ())
+          {
+            frame = storage_->frames_.back ();
+            storage_->frames_.pop_back ();
+          }
+        }
+
+        if (!frame)
+          frame = new T ();
+
+        return (Ptr (frame, Recycler (storage_)));
+      }
+
+      /** \brief Set the maximum number of released frames kept for reuse. Surplus frames are deleted.
+        * \param[in] capacity the maximum number of released frames
+        */
+      void
+      setCapacity (size_t capacity)
+      {
+        boost::mutex::scoped_lock lock (storage_->mutex_);
+        storage_->capacity_ = capacity;
+        while (storage_->frames_.size () > capacity)
+        {
+          delete storage_->frames_.back ();
+          storage_->frames_.pop_back ();
+        }
+      }
+
+      /** \brief Get the maximum number of released frames kept for reuse. */
+      size_t
+      getCapacity () const
+      {
+        boost::mutex::scoped_lock lock (storage_->mutex_);
+        return (storage_->capacity_);
+      }
+
+      /** \brief Get the number of released frames that are currently available for reuse. */
+      size_t
+      getAvailable () const
+      {
+        boost::mutex::scoped_lock lock (storage_->mutex_);
+        return (storage_->frames_.size ());
+      }
+
+    private:
+      /** \brief Released frames, shared with the frames handed out so that they can outlive the pool. */
+      struct Storage
+      {
+        Storage (size_t capacity) : mutex_ (), frames_ (), capacity_ (capacity)
+        {
+        }
+
+        ~Storage ()
+        {
+          for (size_t i = 0; i < frames_.size (); ++i)
+            delete frames_[i];
+        }
+
+        boost::mutex mutex_;
+        std::vector<T*> frames_;
+        size_t capacity_;
+      };
+
+      /** \brief Deleter of the frames handed out, returns the frame to the pool if there is room. */
+      struct Recycler
+      {
+        Recycler (const boost::shared_ptr<Storage> &storage) : storage_ (storage)
+        {
+        }
+
+        void
+        operator () (T* frame) const
+        {
+          {
+            boost::mutex::scoped_lock lock (storage_->mutex_);
+            if (storage_->frames_.size () < storage_->capacity_)
+            {
+              storage_->frames_.push_back (frame);
+              return;
+            }
+          }
+          delete frame;
+        }
+
+        boost::shared_ptr<Storage> storage_;
+      };
+
+      boost::shared_ptr<Storage> storage_;
+  };
+}
+
+#endif  //#ifndef PCL_IO_FRAME_POOL_H_
@@ -46,10 +46,13 @@
 #include <string>
 #include <boost/signals2.hpp>
 #include <boost/signals2/slot.hpp>
+#include <boost/weak_ptr.hpp>
 #include <typeinfo>
+#include <utility>
 #include <vector>
 #include <sstream>
 #include <pcl/io/pcl_io_exception.h>
+#include <pcl/io/callback_queue.h>
 
 namespace pcl
 {
@@ -74,6 +77,21 @@ class Grabber
      */
     template<typename T> boost::signals2::connection registerCallback (const boost::function<T>& callback);
 
+    /**
+     * @brief registers a callback function/method to a signal with the corresponding signature. The callback is
+     *        invoked on a worker thread of its own instead of the thread of the driver, so a slow callback does not
+     *        stall the acquisition. Frames are queued until the worker thread is ready for them.
+     * @param callback: the callback function/method
+     * @param policy: whether to drop the oldest queued frame or to block the driver if the queue is full
+     * @param queue_size: the maximum number of queued frames
+     * @return Connection object, that can be used to disconnect the callback method from the signal again. The worker
+     *         thread is stopped once the slot is released after disconnecting, at the latest on the next call to
+     *         registerCallback or when the grabber is destroyed.
+     */
+    template<typename T> boost::signals2::connection registerCallback (const boost::function<T>& callback,
+                                                                       CallbackQueue::DeliveryPolicy policy,
+                                                                       size_t queue_size = 1);
+
     /**
      * @brief indicates whether a signal with given parameter-type exists or not
      * @return true if signal exists, false otherwise
@@ -116,15 +134,26 @@ class Grabber
     template<typename T> void unblock_signal ();
     inline void block_signals ();
     inline void unblock_signals ();
+    inline void stopDisconnectedCallbackQueues ();
 
     template<typename T> boost::signals2::signal<T>* createSignal ();
     std::map<std::string, boost::signals2::signal_base*> signals_;
     std::map<std::string, std::vector<boost::signals2::connection> > connections_;
     std::map<std::string, std::vector<boost::signals2::shared_connection_block> > shared_connections_;
+    // the queues are owned by their slots, so they go away with the slot
+    std::vector<std::pair<boost::signals2::connection, boost::weak_ptr<CallbackQueue> > > callback_queues_;
 };
 
 Grabber::~Grabber () throw ()
 {
+  // deliver the queued frames before the signals go away
+  for (size_t i = 0; i < callback_queues_.size (); ++i)
+  {
+    boost::shared_ptr<CallbackQueue> queue = callback_queues_[i].second.lock ();
+    if (queue)
+      queue->stop ();
+  }
+
   for (std::map<std::string, boost::signals2::signal_base*>::iterator signal_it = signals_.begin (); signal_it != signals_.end (); ++signal_it)
     delete signal_it->second;
 }
@@ -179,6 +208,25 @@ void Grabber::unblock_signals ()
       cIt->unblock ();    
 }
 
+void Grabber::stopDisconnectedCallbackQueues ()
+{
+  // signals release disconnected slots lazily, stop their worker threads right away
+  size_t kept = 0;
+  for (size_t i = 0; i < callback_queues_.size (); ++i)
+  {
+    boost::shared_ptr<CallbackQueue> queue = callback_queues_[i].second.lock ();
+    if (!queue)
+      continue;
+    if (!callback_queues_[i].first.connected ())
+    {
+      queue->stop ();
+      continue;
+    }
+    callback_queues_[kept++] = callback_queues_[i];
+  }
+  callback_queues_.resize (kept);
+}
+
 template<typename T> int Grabber::num_slots () const
 {
   typedef boost::signals2::signal<T> Signal;
@@ -234,6 +282,19 @@ template<typename T> boost::signals2::connection Grabber::registerCallback (cons
   return (ret);
 }
 
+template<typename T> boost::signals2::connection Grabber::registerCallback (const boost::function<T> & callback,
+                                                                           CallbackQueue::DeliveryPolicy policy,
+                                                                           size_t queue_size)
+{
+  stopDisconnectedCallbackQueues ();
+
+  boost::shared_ptr<CallbackQueue> queue (new CallbackQueue (policy, queue_size));
+  boost::signals2::connection ret = registerCallback (boost::function<T> (QueuedCallback<T> (queue, callback)));
+
+  callback_queues_.push_back (std::make_pair (ret, boost::weak_ptr<CallbackQueue> (queue)));
+  return (ret);
+}
+
 template<typename T> bool Grabber::providesCallback () const
 {
   if (signals_.find (typeid(T).name()) == signals_.end ())
@@ -51,6 +51,7 @@
 #include <deque>
 #include <boost/thread/mutex.hpp>
 #include <pcl/common/synchronizer.h>
+#include <pcl/io/frame_pool.h>
 
 
 namespace pcl
@@ -162,6 +163,11 @@ namespace pcl
     boost::signals2::signal<sig_cb_openni_point_cloud_i >*    point_cloud_i_signal_;
     boost::signals2::signal<sig_cb_openni_point_cloud_rgb >*  point_cloud_rgb_signal_;
 
+    /** \brief Output clouds, recycled once all slots released them. */
+    mutable FramePool<pcl::PointCloud<pcl::PointXYZ> > xyz_cloud_pool_;
+    mutable FramePool<pcl::PointCloud<pcl::PointXYZRGB> > xyzrgb_cloud_pool_;
+    mutable FramePool<pcl::PointCloud<pcl::PointXYZI> > xyzi_cloud_pool_;
+
   public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
   };
@@ -92,12 +92,33 @@ public:
   inline unsigned long getTimeStamp () const throw ();
   inline const xn::ImageMetaData& getMetaData () const throw ();
 
+  /**
+   * @brief Set the number of threads the image rows are split across by fillRGB at full resolution.
+   * @param threads the number of threads, 0 is treated as 1
+   */
+  inline void
+  setNumberOfThreads (unsigned threads) throw ()
+  {
+    threads_ = threads > 0 ? threads : 1;
+  }
+
+  /**
+   * @brief Get the number of threads used by fillRGB at full resolution.
+   */
+  inline unsigned
+  getNumberOfThreads () const throw ()
+  {
+    return (threads_);
+  }
+
 protected:
   boost::shared_ptr<xn::ImageMetaData> image_md_;
+  unsigned threads_;
 };
 
 Image::Image (boost::shared_ptr<xn::ImageMetaData> image_meta_data) throw ()
 : image_md_ (image_meta_data)
+, threads_ (1)
 {
 }
 
@@ -51,6 +51,8 @@
 #include <deque>
 #include <boost/thread/mutex.hpp>
 #include <pcl/common/synchronizer.h>
+#include <pcl/io/depth_image_conversion.h>
+#include <pcl/io/frame_pool.h>
 
 namespace pcl
 {
@@ -132,6 +134,17 @@ namespace pcl
       std::vector<std::pair<int, XnMapOutputMode> >
       getAvailableImageModes () const;
 
+      /** \brief Set the number of threads used to convert depth and color images into point clouds.
+        * \param[in] nr_threads the number of threads the image rows are split across
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        conversion_threads_ = nr_threads;
+      }
+
       void setPrincipalPoint (float cx, float cy);
 
       void setAspectRatio (float aspect_ratio);
@@ -213,18 +226,36 @@ namespace pcl
       virtual inline void
       checkIRStreamRequired();
 
+      /** \brief Fill the conversion parameters for the current depth stream.
+        * \param[in] depth_image the depth image to be converted
+        * \param[in] focal_length the focal length in pixels
+        * \param[out] parameters the conversion parameters
+        */
+      void
+      getConversionParameters (const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image, float focal_length,
+                               pcl::io::DepthConversionParameters &parameters) const;
+
+      /** \brief Get the depth map of a depth image at the depth stream resolution.
+        * \param[in] depth_image the depth image
+        * \param[in] buffer scratch buffer used if the depth image has to be resampled
+        * \return pointer to the depth map
+        */
+      const unsigned short*
+      getDepthMap (const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image,
+                   std::vector<unsigned short> &buffer) const;
+
       /** \brief ... */
       boost::shared_ptr<pcl::PointCloud<pcl::PointXYZ> >
-      convertToXYZPointCloud (const boost::shared_ptr<openni_wrapper::DepthImage> &depth) const;
+      convertToXYZPointCloud (const boost::shared_ptr<openni_wrapper::DepthImage> &depth);
 
       /** \brief ... */
       boost::shared_ptr<pcl::PointCloud<pcl::PointXYZRGB> >
       convertToXYZRGBPointCloud (const boost::shared_ptr<openni_wrapper::Image> &image,
-                                 const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image) const;
+                                 const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image);
       /** \brief ... */
       boost::shared_ptr<pcl::PointCloud<pcl::PointXYZI> >
       convertToXYZIPointCloud (const boost::shared_ptr<openni_wrapper::IRImage> &image,
-                               const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image) const;
+                               const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image);
 
       Synchronizer<boost::shared_ptr<openni_wrapper::Image>, boost::shared_ptr<openni_wrapper::DepthImage> > rgb_sync_;
       Synchronizer<boost::shared_ptr<openni_wrapper::IRImage>, boost::shared_ptr<openni_wrapper::DepthImage> > ir_sync_;
@@ -279,6 +310,21 @@ namespace pcl
       openni_wrapper::OpenNIDevice::CallbackHandle ir_callback_handle;
       bool running_;
 
+      /** \brief Number of threads used for the point cloud conversion. */
+      unsigned conversion_threads_;
+
+      /** \brief Output clouds, recycled once all slots released them. */
+      FramePool<pcl::PointCloud<pcl::PointXYZ> > xyz_cloud_pool_;
+      FramePool<pcl::PointCloud<pcl::PointXYZRGB> > xyzrgb_cloud_pool_;
+      FramePool<pcl::PointCloud<pcl::PointXYZI> > xyzi_cloud_pool_;
+
+      /** \brief Scratch buffers of the point cloud conversions. */
+      std::vector<unsigned short> xyz_depth_buffer_;
+      std::vector<unsigned short> xyzrgb_depth_buffer_;
+      std::vector<unsigned char> xyzrgb_rgb_buffer_;
+      std::vector<unsigned short> xyzi_depth_buffer_;
+      std::vector<unsigned short> xyzi_ir_buffer_;
+
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
   } ;
@@ -41,6 +41,7 @@
 #define __PCL_IO_PCD_GRABBER__
 
 #include <pcl/io/grabber.h>
+#include <pcl/io/frame_pool.h>
 #include <pcl/common/time_trigger.h>
 #include <string>
 #include <vector>
@@ -59,6 +60,7 @@ namespace pcl
        * @brief Constuctor taking just one PCD file.
        * @param pcd_file path to the PCD file
        * @param frames_per_second frames per second. If 0, start() functions like a trigger, publishing the next PCD in the list.
+       *        If < 0, start() plays the PCD files as fast as possible.
        * @param repeat wheter to play PCD file in an endless lopp or not.
        */
       PCDGrabberBase (const std::string& pcd_file, float frames_per_second, bool repeat);
@@ -66,6 +68,7 @@ namespace pcl
        * @brief Constuctor taking a list of paths to PCD files, that are played in the order the appear in the list.
        * @param pcd_files vector of paths to PCD files.
        * @param frames_per_second frames per second. If 0, start() functions like a trigger, publishing the next PCD in the list.
+       *        If < 0, start() plays the PCD files as fast as possible.
        * @param repeat wheter to play PCD file in an endless lopp or not.
        */
       PCDGrabberBase (const std::vector<std::string>& pcd_files, float frames_per_second, bool repeat);
@@ -74,11 +77,11 @@ namespace pcl
        */
       virtual ~PCDGrabberBase () throw ();
       /**
-       * @brief starts playing the list of PCD files if frames_per_second is > 0. Otherwise it works as a trigger: publishes only the next PCD file in the list.
+       * @brief starts playing the list of PCD files if frames_per_second is != 0. Otherwise it works as a trigger: publishes only the next PCD file in the list.
        */
       virtual void start ();
       /**
-       * @brief stops playing the list of PCD files if frames_per_second is > 0. Otherwise the method has no effect.
+       * @brief stops playing the list of PCD files if frames_per_second is != 0. Otherwise the method has no effect.
        */
       virtual void stop ();
       /**
@@ -95,8 +98,47 @@ namespace pcl
        * @brief rewinds to the first PCD file in the list.
        */
       virtual void rewind ();
+      /**
+       * @brief sets the number of PCD files that are loaded ahead of the one being published.
+       * @param depth number of files loaded ahead, 0 is treated as 1.
+       */
+      void setReadAheadDepth (size_t depth);
+      /**
+       * @return number of PCD files that are loaded ahead of the one being published.
+       */
+      size_t getReadAheadDepth () const;
+      /**
+       * @brief sets the number of threads that load the upcoming PCD files in parallel. With 0 threads, the next file
+       *        is loaded by the publishing thread right after the current one was published.
+       * @param threads number of loader threads.
+       */
+      void setNumberOfLoaderThreads (unsigned threads);
+      /**
+       * @return number of threads that load the upcoming PCD files.
+       */
+      unsigned getNumberOfLoaderThreads () const;
+      /**
+       * @brief enables playback of uncompressed binary PCD files straight from the mapped file. The points are copied
+       *        only once, into the published cloud. Other PCD files are read as usual. Has no effect on Windows.
+       * @param memory_mapping whether to map binary PCD files or not.
+       */
+      void setMemoryMapping (bool memory_mapping);
+      /**
+       * @return whether binary PCD files are played from the mapped file.
+       */
+      bool getMemoryMapping () const;
+      /**
+       * @return number of PCD files published per second since playback was started.
+       */
+      double getThroughput () const;
     private:
       virtual void publish (const sensor_msgs::PointCloud2& blob) const = 0;
+      /**
+       * @brief publishes a PCD file whose points are not stored in the data field of blob.
+       * @param blob the header of the PCD file, its data field is empty.
+       * @param data the point data, row_step * height bytes.
+       */
+      virtual void publish (const sensor_msgs::PointCloud2& blob, const unsigned char* data) const;
 
       // to seperate and hide the implementation from interface: PIMPL
       struct PCDGrabberImpl;
@@ -115,7 +157,10 @@ namespace pcl
       PCDGrabber (const std::vector<std::string>& pcd_files, float frames_per_second = 0, bool repeat = false);
     protected:
       virtual void publish (const sensor_msgs::PointCloud2& blob) const;
+      virtual void publish (const sensor_msgs::PointCloud2& blob, const unsigned char* data) const;
       boost::signals2::signal<void (const boost::shared_ptr<const pcl::PointCloud<PointT> >&)>* signal_;
+      /** \brief Published clouds, recycled once all slots released them. */
+      mutable FramePool<pcl::PointCloud<PointT> > cloud_pool_;
   };
 
   template<typename PointT>
@@ -135,11 +180,22 @@ namespace pcl
   template<typename PointT>
   void PCDGrabber<PointT>::publish (const sensor_msgs::PointCloud2& blob) const
   {
-    typename pcl::PointCloud<PointT>::Ptr cloud( new pcl::PointCloud<PointT> () );
+    typename pcl::PointCloud<PointT>::Ptr cloud = cloud_pool_.acquire ();
     pcl::fromROSMsg (blob, *cloud);
 
     signal_->operator () (cloud);
   }
+
+  template<typename PointT>
+  void PCDGrabber<PointT>::publish (const sensor_msgs::PointCloud2& blob, const unsigned char* data) const
+  {
+    typename pcl::PointCloud<PointT>::Ptr cloud = cloud_pool_.acquire ();
+    pcl::MsgFieldMap field_map;
+    pcl::createMapping<PointT> (blob.fields, field_map);
+    pcl::fromROSMsg (blob, data, *cloud, field_map);
+
+    signal_->operator () (cloud);
+  }
 }
 #endif
 #endif
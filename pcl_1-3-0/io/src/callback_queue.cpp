@@ -0,0 +1,133 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/io/callback_queue.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::CallbackQueue::CallbackQueue (DeliveryPolicy policy, size_t size)
+: policy_ (policy)
+, size_ (size > 0 ? size : 1)
+, callbacks_ ()
+, dropped_ (0)
+, quit_ (false)
+, thread_ (boost::bind (&CallbackQueue::run, this))
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::CallbackQueue::~CallbackQueue ()
+{
+  stop ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::CallbackQueue::push (const boost::function<void ()> &callback)
+{
+  boost::unique_lock<boost::mutex> lock (mutex_);
+
+  if (policy_ == BLOCK)
+  {
+    while (!quit_ && callbacks_.size () >= size_)
+      not_full_.wait (lock);
+  }
+  else if (callbacks_.size () >= size_)
+  {
+    callbacks_.pop_front ();
+    ++dropped_;
+  }
+
+  if (quit_)
+  {
+    ++dropped_;
+    return;
+  }
+
+  callbacks_.push_back (callback);
+  not_empty_.notify_one ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::CallbackQueue::stop ()
+{
+  {
+    boost::unique_lock<boost::mutex> lock (mutex_);
+    quit_ = true;
+    not_empty_.notify_all ();
+    not_full_.notify_all ();
+  }
+
+  if (thread_.joinable ())
+    thread_.join ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::CallbackQueue::getDroppedCount () const
+{
+  boost::unique_lock<boost::mutex> lock (mutex_);
+  return (dropped_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::CallbackQueue::run ()
+{
+  while (true)
+  {
+    boost::function<void ()> callback;
+    {
+      boost::unique_lock<boost::mutex> lock (mutex_);
+      while (!quit_ && callbacks_.empty ())
+        not_empty_.wait (lock);
+
+      // the queued callbacks are still invoked after stop ()
+      if (callbacks_.empty ())
+        return;
+
+      callback.swap (callbacks_.front ());
+      callbacks_.pop_front ();
+      not_full_.notify_one ();
+    }
+
+    // invoked without holding the lock, so the driver thread can queue the next frame meanwhile
+    callback ();
+  }
+}
@@ -0,0 +1,758 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/io/color_image_conversion.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define AVG(a,b) (((int)(a) + (int)(b)) >> 1)
+#define AVG3(a,b,c) (((int)(a) + (int)(b) + (int)(c)) / 3)
+#define AVG4(a,b,c,d) (((int)(a) + (int)(b) + (int)(c) + (int)(d)) >> 2)
+#define WAVG4(a,b,c,d,x,y)  ( ( ((int)(a) + (int)(b)) * (int)(x) + ((int)(c) + (int)(d)) * (int)(y) ) / ( ((int)(x) + (int(y))) << 1 ) )
+#define CLIP_CHAR(c) ((c)>255?255:(c)<0?0:(c))
+
+namespace
+{
+#if defined(__SSE2__)
+  /** \brief Absolute difference of 16 bit lanes holding values in [0, 255]. */
+  inline __m128i
+  absDiff (const __m128i &a, const __m128i &b)
+  {
+    return (_mm_or_si128 (_mm_subs_epu16 (a, b), _mm_subs_epu16 (b, a)));
+  }
+
+  /** \brief Split 16 bytes of a Bayer row into the pixels at even and odd offsets, widened to 16 bit lanes. */
+  inline void
+  loadEvenOdd (const unsigned char *bayer, __m128i &even, __m128i &odd)
+  {
+    const __m128i pixels = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (bayer));
+    even = _mm_and_si128 (pixels, _mm_set1_epi16 (0x00FF));
+    odd = _mm_srli_epi16 (pixels, 8);
+  }
+
+  /** \brief Merge the 16 bit lanes of the even and odd pixels of a row back into 16 bytes. */
+  inline __m128i
+  mergeEvenOdd (const __m128i &even, const __m128i &odd)
+  {
+    return (_mm_or_si128 (even, _mm_slli_epi16 (odd, 8)));
+  }
+
+  /** \brief Write 16 pixels given as one vector per color channel to an interleaved RGB buffer. The 2 bytes after
+    * the 48 bytes of the pixels are overwritten as well, callers have to write the following pixels afterwards.
+    */
+  inline void
+  storeRGB (const __m128i &red, const __m128i &green, const __m128i &blue, unsigned char *rgb_buffer)
+  {
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i first_pixel = _mm_set_epi32 (0, 0x00FFFFFF, 0, 0x00FFFFFF);
+    const __m128i second_pixel = _mm_set_epi32 (0x0000FFFF, static_cast<int> (0xFF000000u),
+                                                0x0000FFFF, static_cast<int> (0xFF000000u));
+    const __m128i red_green[2] = { _mm_unpacklo_epi8 (red, green), _mm_unpackhi_epi8 (red, green) };
+    const __m128i blue_zero[2] = { _mm_unpacklo_epi8 (blue, zero), _mm_unpackhi_epi8 (blue, zero) };
+
+    for (int i = 0; i < 4; ++i, rgb_buffer += 12)
+    {
+      // 4 pixels as RGB0, then the two pixels of each 64 bit lane are moved into its lower 6 bytes
+      const __m128i rgb0 = (i & 1) ? _mm_unpackhi_epi16 (red_green[i >> 1], blue_zero[i >> 1])
+                                   : _mm_unpacklo_epi16 (red_green[i >> 1], blue_zero[i >> 1]);
+      const __m128i rgb = _mm_or_si128 (_mm_and_si128 (rgb0, first_pixel),
+                                        _mm_and_si128 (_mm_srli_epi64 (rgb0, 8), second_pixel));
+      _mm_storel_epi64 (reinterpret_cast<__m128i*> (rgb_buffer), rgb);
+      _mm_storel_epi64 (reinterpret_cast<__m128i*> (rgb_buffer + 6), _mm_srli_si128 (rgb, 8));
+    }
+  }
+#endif
+
+  /** \brief Green value of a red or blue pixel as the average of its four green neighbors. */
+  struct BilinearGreen
+  {
+    inline int
+    operator () (int h1, int h2, int v1, int v2) const
+    {
+      return (AVG4 (h1, h2, v1, v2));
+    }
+
+#if defined(__SSE2__)
+    inline __m128i
+    operator () (const __m128i &h1, const __m128i &h2, const __m128i &v1, const __m128i &v2) const
+    {
+      return (_mm_srli_epi16 (_mm_add_epi16 (_mm_add_epi16 (h1, h2), _mm_add_epi16 (v1, v2)), 2));
+    }
+#endif
+  };
+
+  /** \brief Green value of a red or blue pixel interpolated along the direction of the smaller gradient. */
+  struct EdgeAwareGreen
+  {
+    inline int
+    operator () (int h1, int h2, int v1, int v2) const
+    {
+      const int dh = abs (h1 - h2);
+      const int dv = abs (v1 - v2);
+
+      if (dh > dv)
+        return (AVG (v1, v2));
+      else if (dv > dh)
+        return (AVG (h1, h2));
+      else
+        return (AVG4 (v1, v2, h1, h2));
+    }
+
+#if defined(__SSE2__)
+    inline __m128i
+    operator () (const __m128i &h1, const __m128i &h2, const __m128i &v1, const __m128i &v2) const
+    {
+      const __m128i sum_h = _mm_add_epi16 (h1, h2);
+      const __m128i sum_v = _mm_add_epi16 (v1, v2);
+      const __m128i dh = absDiff (h1, h2);
+      const __m128i dv = absDiff (v1, v2);
+      const __m128i vertical = _mm_cmpgt_epi16 (dh, dv);
+      const __m128i horizontal = _mm_cmpgt_epi16 (dv, dh);
+
+      __m128i result = _mm_andnot_si128 (_mm_or_si128 (vertical, horizontal),
+                                         _mm_srli_epi16 (_mm_add_epi16 (sum_h, sum_v), 2));
+      result = _mm_or_si128 (result, _mm_and_si128 (vertical, _mm_srli_epi16 (sum_v, 1)));
+      result = _mm_or_si128 (result, _mm_and_si128 (horizontal, _mm_srli_epi16 (sum_h, 1)));
+      return (result);
+    }
+#endif
+  };
+
+  /** \brief Green value of a red or blue pixel as the average of its four green neighbors, where each direction is
+    * weighted by the gradient of the other one.
+    */
+  struct EdgeAwareWeightedGreen
+  {
+    inline int
+    operator () (int h1, int h2, int v1, int v2) const
+    {
+      const int dh = abs (h1 - h2);
+      const int dv = abs (v1 - v2);
+
+      if (dv == 0 && dh == 0)
+        return (AVG4 (v1, v2, h1, h2));
+      else
+        return (WAVG4 (v1, v2, h1, h2, dh, dv));
+    }
+
+#if defined(__SSE2__)
+    inline __m128i
+    operator () (const __m128i &h1, const __m128i &h2, const __m128i &v1, const __m128i &v2) const
+    {
+      const __m128i zero = _mm_setzero_si128 ();
+      const __m128i sum_h = _mm_add_epi16 (h1, h2);
+      const __m128i sum_v = _mm_add_epi16 (v1, v2);
+      const __m128i dh = absDiff (h1, h2);
+      const __m128i dv = absDiff (v1, v2);
+      const __m128i flat = _mm_cmpeq_epi16 (_mm_or_si128 (dh, dv), zero);
+
+      // The weighted sum is below 2^18 and the divisor below 2^10. Both are exact in single precision and the quotient
+      // is at least 1/1020 away from the next integer, so truncating it reproduces the integer division.
+      __m128i weighted[2];
+      for (int half = 0; half < 2; ++half)
+      {
+        const __m128 sum_hf = _mm_cvtepi32_ps (half ? _mm_unpackhi_epi16 (sum_h, zero) : _mm_unpacklo_epi16 (sum_h, zero));
+        const __m128 sum_vf = _mm_cvtepi32_ps (half ? _mm_unpackhi_epi16 (sum_v, zero) : _mm_unpacklo_epi16 (sum_v, zero));
+        const __m128 dhf = _mm_cvtepi32_ps (half ? _mm_unpackhi_epi16 (dh, zero) : _mm_unpacklo_epi16 (dh, zero));
+        const __m128 dvf = _mm_cvtepi32_ps (half ? _mm_unpackhi_epi16 (dv, zero) : _mm_unpacklo_epi16 (dv, zero));
+        const __m128 numerator = _mm_add_ps (_mm_mul_ps (sum_vf, dhf), _mm_mul_ps (sum_hf, dvf));
+        const __m128 denominator = _mm_add_ps (_mm_add_ps (dhf, dvf), _mm_add_ps (dhf, dvf));
+        // flat lanes are divided by 1, their result is replaced below
+        weighted[half] = _mm_cvttps_epi32 (_mm_div_ps (numerator, _mm_max_ps (denominator, _mm_set1_ps (1.0f))));
+      }
+
+      return (_mm_or_si128 (_mm_and_si128 (flat, _mm_srli_epi16 (_mm_add_epi16 (sum_h, sum_v), 2)),
+                            _mm_andnot_si128 (flat, _mm_packs_epi32 (weighted[0], weighted[1]))));
+    }
+#endif
+  };
+
+#if defined(__SSE2__)
+  /** \brief Debayer 8 blocks of 2 x 2 pixels of an inner row pair.
+    * \param[in] bayer_pixel the green pixel of the first block in the GRGR row
+    * \param[out] rgb_buffer the RGB pixel of the first block in the GRGR row
+    * \param[in] bayer_line_step the number of bytes per row of the Bayer image
+    * \param[in] rgb_line_step the number of bytes per row of the RGB image
+    * \param[in] green the green interpolation of the red and blue pixels
+    */
+  template <typename GreenT> inline void
+  debayerBlocks (const unsigned char *bayer_pixel, unsigned char *rgb_buffer, int bayer_line_step,
+                 unsigned rgb_line_step, const GreenT &green)
+  {
+    // rows above (BGBG), at (GRGR), below (BGBG) and two below (GRGR) the block, each at offset 0, -2 and +2
+    __m128i above_even, above_odd, above_even_next, unused;
+    __m128i at_even, at_odd, at_even_next, at_odd_prev;
+    __m128i below_even, below_odd, below_even_next, below_odd_prev;
+    __m128i below2_even, below2_odd, below2_odd_prev;
+
+    loadEvenOdd (bayer_pixel - bayer_line_step, above_even, above_odd);
+    loadEvenOdd (bayer_pixel - bayer_line_step + 2, above_even_next, unused);
+    loadEvenOdd (bayer_pixel, at_even, at_odd);
+    loadEvenOdd (bayer_pixel + 2, at_even_next, unused);
+    loadEvenOdd (bayer_pixel - 2, unused, at_odd_prev);
+    loadEvenOdd (bayer_pixel + bayer_line_step, below_even, below_odd);
+    loadEvenOdd (bayer_pixel + bayer_line_step + 2, below_even_next, unused);
+    loadEvenOdd (bayer_pixel + bayer_line_step - 2, unused, below_odd_prev);
+    loadEvenOdd (bayer_pixel + 2 * bayer_line_step, below2_even, below2_odd);
+    loadEvenOdd (bayer_pixel + 2 * bayer_line_step - 2, unused, below2_odd_prev);
+
+    // GRGR row: green pixels at even, red pixels at odd offsets
+    const __m128i red_green = _mm_srli_epi16 (_mm_add_epi16 (at_odd, at_odd_prev), 1);
+    const __m128i blue_green = _mm_srli_epi16 (_mm_add_epi16 (below_even, above_even), 1);
+    const __m128i green_red = green (at_even, at_even_next, above_odd, below_odd);
+    const __m128i blue_red = _mm_srli_epi16 (_mm_add_epi16 (_mm_add_epi16 (above_even, above_even_next),
+                                                            _mm_add_epi16 (below_even, below_even_next)), 2);
+
+    storeRGB (mergeEvenOdd (red_green, at_odd), mergeEvenOdd (at_even, green_red),
+              mergeEvenOdd (blue_green, blue_red), rgb_buffer);
+
+    // BGBG row: blue pixels at even, green pixels at odd offsets
+    const __m128i red_blue = _mm_srli_epi16 (_mm_add_epi16 (_mm_add_epi16 (at_odd, below2_odd),
+                                                            _mm_add_epi16 (at_odd_prev, below2_odd_prev)), 2);
+    const __m128i green_blue = green (below_odd_prev, below_odd, at_even, below2_even);
+    const __m128i red_green2 = _mm_srli_epi16 (_mm_add_epi16 (at_odd, below2_odd), 1);
+    const __m128i blue_green2 = _mm_srli_epi16 (_mm_add_epi16 (below_even, below_even_next), 1);
+
+    storeRGB (mergeEvenOdd (red_blue, red_green2), mergeEvenOdd (green_blue, below_odd),
+              mergeEvenOdd (below_even, blue_green2), rgb_buffer + rgb_line_step);
+  }
+#endif
+
+  /** \brief Debayer an inner row pair, i.e. a GRGR row and the BGBG row below it, that has rows above and below.
+    * \param[in] bayer_pixel the first pixel of the GRGR row
+    * \param[out] rgb_buffer the first pixel of the RGB row corresponding to the GRGR row
+    * \param[in] width the width of the image
+    * \param[in] rgb_line_step the number of bytes per row of the RGB image
+    * \param[in] green the green interpolation of the red and blue pixels
+    */
+  template <typename GreenT> void
+  debayerRowPair (const unsigned char *bayer_pixel, unsigned char *rgb_buffer, unsigned width,
+                  unsigned rgb_line_step, const GreenT &green)
+  {
+    const int bayer_line_step = width;
+    const int bayer_line_step2 = width << 1;
+    unsigned xIdx = 2;
+
+    // first two pixel values
+    // Bayer         0 1 2
+    //        -1     b g b
+    //         0     G r g
+    // line_step     b g b
+    // line_step2    g r g
+
+    rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
+    rgb_buffer[1] = bayer_pixel[0]; // green pixel
+    rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]); // blue;
+
+    // Bayer         0 1 2
+    //        -1     b g b
+    //         0     g R g
+    // line_step     b g b
+    // line_step2    g r g
+    //rgb_pixel[3] = bayer_pixel[1];
+    rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
+    rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step]);
+
+    // BGBG line
+    // Bayer         0 1 2
+    //         0     g r g
+    // line_step     B g b
+    // line_step2    g r g
+    rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
+    rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[bayer_line_step2]);
+    rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
+
+    // pixel (1, 1)  0 1 2
+    //         0     g r g
+    // line_step     b G b
+    // line_step2    g r g
+    //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
+    rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+    rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
+
+    rgb_buffer += 6;
+    bayer_pixel += 2;
+
+#if defined(__SSE2__)
+    // 16 pixels per step, the loads and storeRGB reach 2 pixels beyond the block, which the scalar code covers
+    for (; xIdx + 16 <= width - 2; xIdx += 16, rgb_buffer += 48, bayer_pixel += 16)
+      debayerBlocks (bayer_pixel, rgb_buffer, bayer_line_step, rgb_line_step, green);
+#endif
+
+    // continue with rest of the line
+    for (; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
+    {
+      // GRGR line
+      // Bayer        -1 0 1 2
+      //          -1   g b g b
+      //           0   r G r g
+      //   line_step   g b g b
+      // line_step2    r g r g
+      rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
+      rgb_buffer[1] = bayer_pixel[0];
+      rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
+
+      // Bayer        -1 0 1 2
+      //          -1   g b g b
+      //          0    r g R g
+      //  line_step    g b g b
+      // line_step2    r g r g
+      rgb_buffer[3] = bayer_pixel[1];
+      rgb_buffer[4] = green (bayer_pixel[0], bayer_pixel[2], bayer_pixel[-bayer_line_step + 1], bayer_pixel[bayer_line_step + 1]);
+      rgb_buffer[5] = AVG4 (bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step], bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
+
+      // BGBG line
+      // Bayer         -1 0 1 2
+      //         -1     g b g b
+      //          0     r g r g
+      // line_step      g B g b
+      // line_step2     r g r g
+      rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
+      rgb_buffer[rgb_line_step + 1] = green (bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1], bayer_pixel[0], bayer_pixel[bayer_line_step2]);
+      rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
+
+      // Bayer         -1 0 1 2
+      //         -1     g b g b
+      //          0     r g r g
+      // line_step      g b G b
+      // line_step2     r g r g
+      rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
+      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+      rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
+    }
+
+    // last two pixels of the line
+    // last two pixel values for first two lines
+    // GRGR line
+    // Bayer        -1 0 1
+    //           0   r G r
+    //   line_step   g b g
+    // line_step2    r g r
+    rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
+    rgb_buffer[1] = bayer_pixel[0];
+    rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = rgb_buffer[5] = rgb_buffer[2] = bayer_pixel[bayer_line_step];
+
+    // Bayer        -1 0 1
+    //          0    r g R
+    //  line_step    g b g
+    // line_step2    r g r
+    rgb_buffer[3] = bayer_pixel[1];
+    rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
+    //rgb_pixel[5] = bayer_pixel[line_step];
+
+    // BGBG line
+    // Bayer        -1 0 1
+    //          0    r g r
+    //  line_step    g B g
+    // line_step2    r g r
+    rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
+    rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
+    //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
+
+    // Bayer         -1 0 1
+    //         0      r g r
+    // line_step      g b G
+    // line_step2     r g r
+    rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
+    rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+    //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
+  }
+
+  /** \brief Debayer the inner row pairs of an image in parallel.
+    * \param[in] bayer the Bayer pattern image
+    * \param[in] width the width of the image
+    * \param[out] rgb the RGB image
+    * \param[in] rgb_line_step the number of bytes per row of the RGB image
+    * \param[in] row_pairs the number of row pairs starting at row 2
+    * \param[in] green the green interpolation of the red and blue pixels
+    * \param[in] threads the number of threads the row pairs are split across
+    */
+  template <typename GreenT> void
+  debayerInnerRows (const unsigned char *bayer, unsigned width, unsigned char *rgb, unsigned rgb_line_step,
+                    int row_pairs, const GreenT &green, unsigned threads)
+  {
+#pragma omp parallel for schedule (static) num_threads (threads)
+    for (int pair = 0; pair < row_pairs; ++pair)
+    {
+      const unsigned yIdx = 2 + 2 * pair;
+      debayerRowPair (bayer + yIdx * width, rgb + yIdx * rgb_line_step, width, rgb_line_step, green);
+    }
+  }
+
+  /** \brief Convert a row of a YUV422 image into RGB.
+    * \param[in] yuv_buffer the YUV422 row
+    * \param[in] width the width of the image
+    * \param[out] rgb_buffer the RGB row
+    */
+  inline void
+  convertYUV422Row (const unsigned char *yuv_buffer, unsigned width, unsigned char *rgb_buffer)
+  {
+    unsigned xIdx = 0;
+
+#if defined(__SSE2__)
+    // (u - 128, v - 128) pairs are multiplied with the coefficients by _mm_madd_epi16. The blue coefficient 33292
+    // does not fit into 16 bits and is applied as 2 * 16646.
+    const __m128i red_coefficients = _mm_setr_epi16 (0, 18678, 0, 18678, 0, 18678, 0, 18678);
+    const __m128i green_coefficients = _mm_setr_epi16 (-6472, -9519, -6472, -9519, -6472, -9519, -6472, -9519);
+    const __m128i blue_coefficients = _mm_setr_epi16 (16646, 0, 16646, 0, 16646, 0, 16646, 0);
+    const __m128i rounding = _mm_set1_epi32 (8192);
+
+    // 16 pixels per step, at least 2 pixels are left for the scalar loop as storeRGB writes beyond the 16 pixels
+    for (; xIdx + 18 <= width; xIdx += 16, rgb_buffer += 48, yuv_buffer += 32)
+    {
+      __m128i channels[3][2];
+      for (int half = 0; half < 2; ++half)
+      {
+        // 4 groups of u y1 v y2 per 32 bit lane
+        const __m128i yuv = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (yuv_buffer + (half << 4)));
+        const __m128i uv = _mm_sub_epi16 (_mm_and_si128 (yuv, _mm_set1_epi16 (0x00FF)), _mm_set1_epi16 (128));
+        const __m128i y1 = _mm_and_si128 (_mm_srli_epi32 (yuv, 8), _mm_set1_epi32 (0xFF));
+        const __m128i y2 = _mm_srli_epi32 (yuv, 24);
+
+        const __m128i offsets[3] = {
+          _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (uv, red_coefficients), rounding), 14),
+          _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (uv, green_coefficients), rounding), 14),
+          _mm_srai_epi32 (_mm_add_epi32 (_mm_slli_epi32 (_mm_madd_epi16 (uv, blue_coefficients), 1), rounding), 14)
+        };
+
+        for (int channel = 0; channel < 3; ++channel)
+        {
+          const __m128i first = _mm_add_epi32 (y1, offsets[channel]);
+          const __m128i second = _mm_add_epi32 (y2, offsets[channel]);
+          channels[channel][half] = _mm_packs_epi32 (_mm_unpacklo_epi32 (first, second),
+                                                     _mm_unpackhi_epi32 (first, second));
+        }
+      }
+
+      storeRGB (_mm_packus_epi16 (channels[0][0], channels[0][1]),
+                _mm_packus_epi16 (channels[1][0], channels[1][1]),
+                _mm_packus_epi16 (channels[2][0], channels[2][1]), rgb_buffer);
+    }
+#endif
+
+    for (; xIdx < width; xIdx += 2, rgb_buffer += 6, yuv_buffer += 4)
+    {
+      int v = yuv_buffer[2] - 128;
+      int u = yuv_buffer[0] - 128;
+
+      rgb_buffer[0] =  CLIP_CHAR (yuv_buffer[1] + ((v * 18678 + 8192 ) >> 14));
+      rgb_buffer[1] =  CLIP_CHAR (yuv_buffer[1] + ((v * -9519 - u * 6472 + 8192 ) >> 14));
+      rgb_buffer[2] =  CLIP_CHAR (yuv_buffer[1] + ((u * 33292 + 8192 ) >> 14));
+
+      rgb_buffer[3] =  CLIP_CHAR (yuv_buffer[3] + ((v * 18678 + 8192 ) >> 14));
+      rgb_buffer[4] =  CLIP_CHAR (yuv_buffer[3] + ((v * -9519 - u * 6472 + 8192 ) >> 14));
+      rgb_buffer[5] =  CLIP_CHAR (yuv_buffer[3] + ((u * 33292 + 8192 ) >> 14));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::debayerGRBGToRGB (const unsigned char *bayer, unsigned width, unsigned height,
+                           unsigned char *rgb, unsigned rgb_line_step, DebayeringMethod method, unsigned threads)
+{
+  if (rgb_line_step == 0)
+    rgb_line_step = width * 3;
+  if (threads == 0)
+    threads = 1;
+
+  const int bayer_line_step = width;
+  const int bayer_line_step2 = width << 1;
+
+  const unsigned char *bayer_pixel = bayer;
+  unsigned char *rgb_buffer = rgb;
+  unsigned xIdx;
+
+  // first two pixel values for first two lines
+  // Bayer         0 1 2
+  //         0     G r g
+  // line_step     b g b
+  // line_step2    g r g
+
+  rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
+  rgb_buffer[1] = bayer_pixel[0]; // green pixel
+  rgb_buffer[rgb_line_step + 2] = rgb_buffer[2] = bayer_pixel[bayer_line_step]; // blue;
+
+  // Bayer         0 1 2
+  //         0     g R g
+  // line_step     b g b
+  // line_step2    g r g
+  //rgb_pixel[3] = bayer_pixel[1];
+  rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1]);
+  rgb_buffer[rgb_line_step + 5] = rgb_buffer[5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
+
+  // BGBG line
+  // Bayer         0 1 2
+  //         0     g r g
+  // line_step     B g b
+  // line_step2    g r g
+  rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
+  rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[bayer_line_step2]);
+  //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
+
+  // pixel (1, 1)  0 1 2
+  //         0     g r g
+  // line_step     b G b
+  // line_step2    g r g
+  //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
+  rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+  //rgb_pixel[rgb_line_step + 5] = AVG( bayer_pixel[line_step] , bayer_pixel[line_step+2] );
+
+  rgb_buffer += 6;
+  bayer_pixel += 2;
+  // rest of the first two lines
+
+  for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
+  {
+    // GRGR line
+    // Bayer        -1 0 1 2
+    //           0   r G r g
+    //   line_step   g b g b
+    // line_step2    r g r g
+    rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
+    rgb_buffer[1] = bayer_pixel[0];
+    rgb_buffer[2] = bayer_pixel[bayer_line_step + 1];
+
+    // Bayer        -1 0 1 2
+    //          0    r g R g
+    //  line_step    g b g b
+    // line_step2    r g r g
+    rgb_buffer[3] = bayer_pixel[1];
+    rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1]);
+    rgb_buffer[rgb_line_step + 5] = rgb_buffer[5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
+
+    // BGBG line
+    // Bayer         -1 0 1 2
+    //         0      r g r g
+    // line_step      g B g b
+    // line_step2     r g r g
+    rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
+    rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
+    rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
+
+    // Bayer         -1 0 1 2
+    //         0      r g r g
+    // line_step      g b G b
+    // line_step2     r g r g
+    rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
+    rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+    //rgb_pixel[rgb_line_step + 5] = AVG( bayer_pixel[line_step] , bayer_pixel[line_step+2] );
+  }
+
+  // last two pixel values for first two lines
+  // GRGR line
+  // Bayer        -1 0 1
+  //           0   r G r
+  //   line_step   g b g
+  // line_step2    r g r
+  rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
+  rgb_buffer[1] = bayer_pixel[0];
+  rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = rgb_buffer[5] = rgb_buffer[2] = bayer_pixel[bayer_line_step];
+
+  // Bayer        -1 0 1
+  //          0    r g R
+  //  line_step    g b g
+  // line_step2    r g r
+  rgb_buffer[3] = bayer_pixel[1];
+  rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
+  //rgb_pixel[5] = bayer_pixel[line_step];
+
+  // BGBG line
+  // Bayer        -1 0 1
+  //          0    r g r
+  //  line_step    g B g
+  // line_step2    r g r
+  rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
+  rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
+  //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
+
+  // Bayer         -1 0 1
+  //         0      r g r
+  // line_step      g b G
+  // line_step2     r g r
+  rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
+  rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+  //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
+
+  // main processing, only rows that have neighbors above and below use the selected interpolation
+  const int row_pairs = height > 4 ? (static_cast<int> (height) - 3) / 2 : 0;
+  switch (method)
+  {
+    case DEBAYERING_EDGE_AWARE:
+      debayerInnerRows (bayer, width, rgb, rgb_line_step, row_pairs, EdgeAwareGreen (), threads);
+      break;
+    case DEBAYERING_EDGE_AWARE_WEIGHTED:
+      debayerInnerRows (bayer, width, rgb, rgb_line_step, row_pairs, EdgeAwareWeightedGreen (), threads);
+      break;
+    case DEBAYERING_BILINEAR:
+    default:
+      debayerInnerRows (bayer, width, rgb, rgb_line_step, row_pairs, BilinearGreen (), threads);
+      break;
+  }
+
+  bayer_pixel = bayer + (2 + 2 * row_pairs) * bayer_line_step;
+  rgb_buffer = rgb + (2 + 2 * row_pairs) * rgb_line_step;
+
+  //last two lines
+  // Bayer         0 1 2
+  //        -1     b g b
+  //         0     G r g
+  // line_step     b g b
+
+  rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
+  rgb_buffer[1] = bayer_pixel[0]; // green pixel
+  rgb_buffer[rgb_line_step + 2] = rgb_buffer[2] = bayer_pixel[bayer_line_step]; // blue;
+
+  // Bayer         0 1 2
+  //        -1     b g b
+  //         0     g R g
+  // line_step     b g b
+  //rgb_pixel[3] = bayer_pixel[1];
+  rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
+  rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step]);
+
+  // BGBG line
+  // Bayer         0 1 2
+  //        -1     b g b
+  //         0     g r g
+  // line_step     B g b
+  //rgb_pixel[rgb_line_step    ] = bayer_pixel[1];
+  rgb_buffer[rgb_line_step + 1] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
+  rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
+
+  // Bayer         0 1 2
+  //        -1     b g b
+  //         0     g r g
+  // line_step     b G b
+  //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
+  rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+  rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
+
+  rgb_buffer += 6;
+  bayer_pixel += 2;
+  // rest of the last two lines
+  for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
+  {
+    // GRGR line
+    // Bayer       -1 0 1 2
+    //        -1    g b g b
+    //         0    r G r g
+    // line_step    g b g b
+    rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
+    rgb_buffer[1] = bayer_pixel[0];
+    rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
+
+    // Bayer       -1 0 1 2
+    //        -1    g b g b
+    //         0    r g R g
+    // line_step    g b g b
+    rgb_buffer[rgb_line_step + 3] = rgb_buffer[3] = bayer_pixel[1];
+    rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
+    rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[-bayer_line_step + 2]);
+
+    // BGBG line
+    // Bayer       -1 0 1 2
+    //        -1    g b g b
+    //         0    r g r g
+    // line_step    g B g b
+    rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[-1], bayer_pixel[1]);
+    rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
+    rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
+
+
+    // Bayer       -1 0 1 2
+    //        -1    g b g b
+    //         0    r g r g
+    // line_step    g b G b
+    //rgb_pixel[rgb_line_step + 3] = bayer_pixel[1];
+    rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+    rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
+  }
+
+  // last two pixel values for first two lines
+  // GRGR line
+  // Bayer       -1 0 1
+  //        -1    g b g
+  //         0    r G r
+  // line_step    g b g
+  rgb_buffer[rgb_line_step ] = rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
+  rgb_buffer[1] = bayer_pixel[0];
+  rgb_buffer[5] = rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
+
+  // Bayer       -1 0 1
+  //        -1    g b g
+  //         0    r g R
+  // line_step    g b g
+  rgb_buffer[rgb_line_step + 3] = rgb_buffer[3] = bayer_pixel[1];
+  rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[-bayer_line_step + 1]);
+  //rgb_pixel[5] = AVG( bayer_pixel[line_step], bayer_pixel[-line_step] );
+
+  // BGBG line
+  // Bayer       -1 0 1
+  //        -1    g b g
+  //         0    r g r
+  // line_step    g B g
+  //rgb_pixel[rgb_line_step    ] = AVG2( bayer_pixel[-1], bayer_pixel[1] );
+  rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
+  rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
+
+  // Bayer       -1 0 1
+  //        -1    g b g
+  //         0    r g r
+  // line_step    g b G
+  //rgb_pixel[rgb_line_step + 3] = bayer_pixel[1];
+  rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
+  //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::convertYUV422ToRGB (const unsigned char *yuv, unsigned width, unsigned height,
+                             unsigned char *rgb, unsigned rgb_line_step, unsigned threads)
+{
+  if (rgb_line_step == 0)
+    rgb_line_step = width * 3;
+  if (threads == 0)
+    threads = 1;
+
+#pragma omp parallel for schedule (static) num_threads (threads)
+  for (int yIdx = 0; yIdx < static_cast<int> (height); ++yIdx)
+    convertYUV422Row (yuv + yIdx * (width << 1), width, rgb + yIdx * rgb_line_step);
+}
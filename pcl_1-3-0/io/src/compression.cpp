@@ -50,3 +50,11 @@
 
 template class PCL_EXPORTS pcl::octree::PointCloudCompression<pcl::PointXYZ>;
 template class PCL_EXPORTS pcl::octree::PointCloudCompression<pcl::PointXYZRGB>;
+
+#include "pcl/compression/compressed_point_cloud_container.h"
+#include "pcl/compression/impl/compressed_point_cloud_container.hpp"
+
+template class PCL_EXPORTS pcl::octree::CompressedPointCloudWriter<pcl::PointXYZ>;
+template class PCL_EXPORTS pcl::octree::CompressedPointCloudWriter<pcl::PointXYZRGB>;
+template class PCL_EXPORTS pcl::octree::CompressedPointCloudReader<pcl::PointXYZ>;
+template class PCL_EXPORTS pcl::octree::CompressedPointCloudReader<pcl::PointXYZRGB>;
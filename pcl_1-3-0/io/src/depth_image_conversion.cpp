@@ -0,0 +1,211 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/io/depth_image_conversion.h>
+#include <limits>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+  /** \brief Resize an output cloud to the depth image size, keeping its memory if the size matches. */
+  template <typename PointT> inline void
+  resizeCloud (const pcl::io::DepthConversionParameters &parameters, pcl::PointCloud<PointT> &cloud)
+  {
+    const size_t size = static_cast<size_t> (parameters.width) * parameters.height;
+    if (cloud.points.size () != size)
+      cloud.points.resize (size);
+
+    cloud.width = parameters.width;
+    cloud.height = parameters.height;
+    cloud.is_dense = false;
+  }
+
+  /** \brief Convert a row of a depth image into the x, y, z coordinates of a row of points. Invalid pixels become
+    * NaN, the fourth coordinate is set to 1.
+    * \param[in] parameters the depth camera parameters
+    * \param[in] depth the depth image row
+    * \param[in] v the row offset from the image center
+    * \param[out] points the point cloud row
+    */
+  template <typename PointT> inline void
+  convertDepthRow (const pcl::io::DepthConversionParameters &parameters, const unsigned short *depth, int v,
+                   PointT *points)
+  {
+    const int width = static_cast<int> (parameters.width);
+    const int center_x = width >> 1;
+    const float constant = 1.0f / parameters.focal_length;
+    const float y_factor = static_cast<float> (v) * constant;
+    const float bad_point = std::numeric_limits<float>::quiet_NaN ();
+    int u = 0;
+
+#if defined(__SSE2__)
+    // four pixels at a time - each point starts with x, y, z and the fourth coordinate
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i no_sample = _mm_set1_epi32 (parameters.no_sample_value);
+    const __m128i shadow = _mm_set1_epi32 (parameters.shadow_value);
+    const __m128 scale = _mm_set1_ps (0.001f);
+    const __m128 constant4 = _mm_set1_ps (constant);
+    const __m128 y_factor4 = _mm_set1_ps (y_factor);
+    const __m128 nan4 = _mm_set1_ps (bad_point);
+    const __m128i u_step = _mm_set1_epi32 (4);
+    __m128i u4 = _mm_setr_epi32 (-center_x, 1 - center_x, 2 - center_x, 3 - center_x);
+
+    for (; u + 4 <= width; u += 4, u4 = _mm_add_epi32 (u4, u_step))
+    {
+      const __m128i d = _mm_unpacklo_epi16 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (depth + u)), zero);
+      const __m128 invalid = _mm_castsi128_ps (_mm_or_si128 (_mm_cmpeq_epi32 (d, zero),
+                                               _mm_or_si128 (_mm_cmpeq_epi32 (d, no_sample),
+                                                             _mm_cmpeq_epi32 (d, shadow))));
+
+      __m128 z = _mm_mul_ps (_mm_cvtepi32_ps (d), scale);
+      __m128 x = _mm_mul_ps (z, _mm_mul_ps (_mm_cvtepi32_ps (u4), constant4));
+      __m128 y = _mm_mul_ps (z, y_factor4);
+      __m128 w = _mm_set1_ps (1.0f);
+
+      x = _mm_or_ps (_mm_andnot_ps (invalid, x), _mm_and_ps (invalid, nan4));
+      y = _mm_or_ps (_mm_andnot_ps (invalid, y), _mm_and_ps (invalid, nan4));
+      z = _mm_or_ps (_mm_andnot_ps (invalid, z), _mm_and_ps (invalid, nan4));
+
+      _MM_TRANSPOSE4_PS (x, y, z, w);
+      _mm_storeu_ps (points[u].data, x);
+      _mm_storeu_ps (points[u + 1].data, y);
+      _mm_storeu_ps (points[u + 2].data, z);
+      _mm_storeu_ps (points[u + 3].data, w);
+    }
+#endif
+
+    for (; u < width; ++u)
+    {
+      PointT &pt = points[u];
+      const unsigned short d = depth[u];
+
+      // Check for invalid measurements
+      if (d == 0 || d == parameters.no_sample_value || d == parameters.shadow_value)
+      {
+        pt.x = pt.y = pt.z = bad_point;
+      }
+      else
+      {
+        pt.z = d * 0.001f;
+        pt.x = pt.z * (static_cast<float> (u - center_x) * constant);
+        pt.y = pt.z * y_factor;
+      }
+      pt.data[3] = 1.0f;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::convertDepthToPointCloud (const DepthConversionParameters &parameters, const unsigned short *depth,
+                                   pcl::PointCloud<pcl::PointXYZ> &cloud)
+{
+  resizeCloud (parameters, cloud);
+
+  const int width = static_cast<int> (parameters.width);
+  const int height = static_cast<int> (parameters.height);
+  const int center_y = height >> 1;
+  const unsigned threads = parameters.threads > 0 ? parameters.threads : 1;
+
+#pragma omp parallel for schedule (static) num_threads (threads)
+  for (int row = 0; row < height; ++row)
+    convertDepthRow (parameters, depth + row * width, row - center_y, &cloud.points[row * width]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::convertDepthToPointCloud (const DepthConversionParameters &parameters, const unsigned short *depth,
+                                   const unsigned char *rgb, pcl::PointCloud<pcl::PointXYZRGB> &cloud)
+{
+  resizeCloud (parameters, cloud);
+
+  const int width = static_cast<int> (parameters.width);
+  const int height = static_cast<int> (parameters.height);
+  const int center_y = height >> 1;
+  const unsigned threads = parameters.threads > 0 ? parameters.threads : 1;
+
+#pragma omp parallel for schedule (static) num_threads (threads)
+  for (int row = 0; row < height; ++row)
+  {
+    pcl::PointXYZRGB *points = &cloud.points[row * width];
+    const unsigned char *rgb_row = rgb + row * width * 3;
+
+    convertDepthRow (parameters, depth + row * width, row - center_y, points);
+
+    // Fill in color
+    for (int u = 0; u < width; ++u, rgb_row += 3)
+    {
+      const pcl::uint32_t color = (static_cast<pcl::uint32_t> (rgb_row[0]) << 16) |
+                                  (static_cast<pcl::uint32_t> (rgb_row[1]) << 8) |
+                                   static_cast<pcl::uint32_t> (rgb_row[2]);
+      memcpy (&points[u].rgb, &color, sizeof (color));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::convertDepthToPointCloud (const DepthConversionParameters &parameters, const unsigned short *depth,
+                                   const unsigned short *ir, pcl::PointCloud<pcl::PointXYZI> &cloud)
+{
+  resizeCloud (parameters, cloud);
+
+  const int width = static_cast<int> (parameters.width);
+  const int height = static_cast<int> (parameters.height);
+  const int center_y = height >> 1;
+  const unsigned threads = parameters.threads > 0 ? parameters.threads : 1;
+
+#pragma omp parallel for schedule (static) num_threads (threads)
+  for (int row = 0; row < height; ++row)
+  {
+    pcl::PointXYZI *points = &cloud.points[row * width];
+    const unsigned short *ir_row = ir + row * width;
+
+    convertDepthRow (parameters, depth + row * width, row - center_y, points);
+
+    for (int u = 0; u < width; ++u)
+    {
+      points[u].data_c[0] = points[u].data_c[1] = points[u].data_c[2] = points[u].data_c[3] = 0;
+      points[u].intensity = static_cast<float> (ir_row[u]);
+    }
+  }
+}
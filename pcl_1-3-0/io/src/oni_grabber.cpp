@@ -249,7 +249,7 @@ void ONIGrabber::irDepthImageCallback(const boost::shared_ptr<openni_wrapper::IR
 
 pcl::PointCloud<pcl::PointXYZ>::Ptr ONIGrabber::convertToXYZPointCloud(const boost::shared_ptr<openni_wrapper::DepthImage>& depth_image) const
 {
-  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud <pcl::PointXYZ>);
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud = xyz_cloud_pool_.acquire();
 
   // TODO cloud->header.stamp = time;
   cloud->height = depth_height_;
@@ -316,7 +316,7 @@ pcl::PointCloud<pcl::PointXYZRGB>::Ptr ONIGrabber::convertToXYZRGBPointCloud(con
   static boost::shared_array<unsigned char> rgb_array(0);
   static unsigned char* rgb_buffer = 0;
 
-  boost::shared_ptr<pcl::PointCloud<pcl::PointXYZRGB> > cloud(new pcl::PointCloud<pcl::PointXYZRGB > ());
+  boost::shared_ptr<pcl::PointCloud<pcl::PointXYZRGB> > cloud = xyzrgb_cloud_pool_.acquire();
 
   cloud->header.frame_id = rgb_frame_id_;
   cloud->height = depth_height_;
@@ -394,7 +394,7 @@ pcl::PointCloud<pcl::PointXYZRGB>::Ptr ONIGrabber::convertToXYZRGBPointCloud(con
 pcl::PointCloud<pcl::PointXYZI>::Ptr ONIGrabber::convertToXYZIPointCloud(const boost::shared_ptr<openni_wrapper::IRImage> &ir_image,
   const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image) const
 {
-  boost::shared_ptr<pcl::PointCloud<pcl::PointXYZI> > cloud(new pcl::PointCloud<pcl::PointXYZI > ());
+  boost::shared_ptr<pcl::PointCloud<pcl::PointXYZI> > cloud = xyzi_cloud_pool_.acquire();
 
   cloud->header.frame_id = rgb_frame_id_;
   cloud->height = depth_height_;
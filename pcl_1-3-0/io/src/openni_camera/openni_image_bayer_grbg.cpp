@@ -38,6 +38,7 @@
 #ifdef HAVE_OPENNI
 
 #include <pcl/io/openni_camera/openni_image_bayer_grbg.h>
+#include <pcl/io/color_image_conversion.h>
 #include <sstream>
 #include <iostream>
 
@@ -301,1101 +302,11 @@ void ImageBayerGRBG::fillRGB (unsigned width, unsigned height, unsigned char* rg
 
   if (image_md_->XRes () == width && image_md_->YRes () == height)
   {
-    register const XnUInt8 *bayer_pixel = image_md_->Data ();
-    register unsigned yIdx, xIdx;
-
-    int bayer_line_step = image_md_->XRes ();
-    int bayer_line_step2 = image_md_->XRes () << 1;
-
-    if (debayering_method_ == Bilinear)
-    {
-      // first two pixel values for first two lines
-      // Bayer         0 1 2
-      //         0     G r g
-      // line_step     b g b
-      // line_step2    g r g
-
-      rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-      rgb_buffer[1] = bayer_pixel[0]; // green pixel
-      rgb_buffer[rgb_line_step + 2] = rgb_buffer[2] = bayer_pixel[bayer_line_step]; // blue;
-
-      // Bayer         0 1 2
-      //         0     g R g
-      // line_step     b g b
-      // line_step2    g r g
-      //rgb_pixel[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-      // BGBG line
-      // Bayer         0 1 2
-      //         0     g r g
-      // line_step     B g b
-      // line_step2    g r g
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-      rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[bayer_line_step2]);
-      //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-      // pixel (1, 1)  0 1 2
-      //         0     g r g
-      // line_step     b G b
-      // line_step2    g r g
-      //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = AVG( bayer_pixel[line_step] , bayer_pixel[line_step+2] );
-
-      rgb_buffer += 6;
-      bayer_pixel += 2;
-      // rest of the first two lines
-
-      for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-      {
-        // GRGR line
-        // Bayer        -1 0 1 2
-        //           0   r G r g
-        //   line_step   g b g b
-        // line_step2    r g r g
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[2] = bayer_pixel[bayer_line_step + 1];
-
-        // Bayer        -1 0 1 2
-        //          0    r g R g
-        //  line_step    g b g b
-        // line_step2    r g r g
-        rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 5] = rgb_buffer[5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-        // BGBG line
-        // Bayer         -1 0 1 2
-        //         0      r g r g
-        // line_step      g B g b
-        // line_step2     r g r g
-        rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-        // Bayer         -1 0 1 2
-        //         0      r g r g
-        // line_step      g b G b
-        // line_step2     r g r g
-        rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        //rgb_pixel[rgb_line_step + 5] = AVG( bayer_pixel[line_step] , bayer_pixel[line_step+2] );
-      }
-
-      // last two pixel values for first two lines
-      // GRGR line
-      // Bayer        -1 0 1
-      //           0   r G r
-      //   line_step   g b g
-      // line_step2    r g r
-      rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-      rgb_buffer[1] = bayer_pixel[0];
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = rgb_buffer[5] = rgb_buffer[2] = bayer_pixel[bayer_line_step];
-
-      // Bayer        -1 0 1
-      //          0    r g R
-      //  line_step    g b g
-      // line_step2    r g r
-      rgb_buffer[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-      //rgb_pixel[5] = bayer_pixel[line_step];
-
-      // BGBG line
-      // Bayer        -1 0 1
-      //          0    r g r
-      //  line_step    g B g
-      // line_step2    r g r
-      rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-      rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-      //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-      // Bayer         -1 0 1
-      //         0      r g r
-      // line_step      g b G
-      // line_step2     r g r
-      rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-
-      bayer_pixel += bayer_line_step + 2;
-      rgb_buffer += rgb_line_step + 6 + rgb_line_skip;
-
-      // main processing
-
-      for (yIdx = 2; yIdx < height - 2; yIdx += 2)
-      {
-        // first two pixel values
-        // Bayer         0 1 2
-        //        -1     b g b
-        //         0     G r g
-        // line_step     b g b
-        // line_step2    g r g
-
-        rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-        rgb_buffer[1] = bayer_pixel[0]; // green pixel
-        rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]); // blue;
-
-        // Bayer         0 1 2
-        //        -1     b g b
-        //         0     g R g
-        // line_step     b g b
-        // line_step2    g r g
-        //rgb_pixel[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-        rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step]);
-
-        // BGBG line
-        // Bayer         0 1 2
-        //         0     g r g
-        // line_step     B g b
-        // line_step2    g r g
-        rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[bayer_line_step2]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-        // pixel (1, 1)  0 1 2
-        //         0     g r g
-        // line_step     b G b
-        // line_step2    g r g
-        //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-        rgb_buffer += 6;
-        bayer_pixel += 2;
-        // continue with rest of the line
-        for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-        {
-          // GRGR line
-          // Bayer        -1 0 1 2
-          //          -1   g b g b
-          //           0   r G r g
-          //   line_step   g b g b
-          // line_step2    r g r g
-          rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-          rgb_buffer[1] = bayer_pixel[0];
-          rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-          // Bayer        -1 0 1 2
-          //          -1   g b g b
-          //          0    r g R g
-          //  line_step    g b g b
-          // line_step2    r g r g
-          rgb_buffer[3] = bayer_pixel[1];
-          rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-          rgb_buffer[5] = AVG4 (bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step], bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-          // BGBG line
-          // Bayer         -1 0 1 2
-          //         -1     g b g b
-          //          0     r g r g
-          // line_step      g B g b
-          // line_step2     r g r g
-          rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-          rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-          rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-          // Bayer         -1 0 1 2
-          //         -1     g b g b
-          //          0     r g r g
-          // line_step      g b G b
-          // line_step2     r g r g
-          rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-          rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-          rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-        }
-
-        // last two pixels of the line
-        // last two pixel values for first two lines
-        // GRGR line
-        // Bayer        -1 0 1
-        //           0   r G r
-        //   line_step   g b g
-        // line_step2    r g r
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = rgb_buffer[5] = rgb_buffer[2] = bayer_pixel[bayer_line_step];
-
-        // Bayer        -1 0 1
-        //          0    r g R
-        //  line_step    g b g
-        // line_step2    r g r
-        rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-        //rgb_pixel[5] = bayer_pixel[line_step];
-
-        // BGBG line
-        // Bayer        -1 0 1
-        //          0    r g r
-        //  line_step    g B g
-        // line_step2    r g r
-        rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-        // Bayer         -1 0 1
-        //         0      r g r
-        // line_step      g b G
-        // line_step2     r g r
-        rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-
-        bayer_pixel += bayer_line_step + 2;
-        rgb_buffer += rgb_line_step + 6 + rgb_line_skip;
-      }
-
-      //last two lines
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     G r g
-      // line_step     b g b
-
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-      rgb_buffer[1] = bayer_pixel[0]; // green pixel
-      rgb_buffer[rgb_line_step + 2] = rgb_buffer[2] = bayer_pixel[bayer_line_step]; // blue;
-
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g R g
-      // line_step     b g b
-      //rgb_pixel[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-      rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step]);
-
-      // BGBG line
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g r g
-      // line_step     B g b
-      //rgb_pixel[rgb_line_step    ] = bayer_pixel[1];
-      rgb_buffer[rgb_line_step + 1] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g r g
-      // line_step     b G b
-      //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-      rgb_buffer += 6;
-      bayer_pixel += 2;
-      // rest of the last two lines
-      for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-      {
-        // GRGR line
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r G r g
-        // line_step    g b g b
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g R g
-        // line_step    g b g b
-        rgb_buffer[rgb_line_step + 3] = rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-        rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[-bayer_line_step + 2]);
-
-        // BGBG line
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g r g
-        // line_step    g B g b
-        rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[-1], bayer_pixel[1]);
-        rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g r g
-        // line_step    g b G b
-        //rgb_pixel[rgb_line_step + 3] = bayer_pixel[1];
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-      }
-
-      // last two pixel values for first two lines
-      // GRGR line
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r G r
-      // line_step    g b g
-      rgb_buffer[rgb_line_step ] = rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-      rgb_buffer[1] = bayer_pixel[0];
-      rgb_buffer[5] = rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g R
-      // line_step    g b g
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[-bayer_line_step + 1]);
-      //rgb_pixel[5] = AVG( bayer_pixel[line_step], bayer_pixel[-line_step] );
-
-      // BGBG line
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g r
-      // line_step    g B g
-      //rgb_pixel[rgb_line_step    ] = AVG2( bayer_pixel[-1], bayer_pixel[1] );
-      rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g r
-      // line_step    g b G
-      //rgb_pixel[rgb_line_step + 3] = bayer_pixel[1];
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-    }
-    else if (debayering_method_ == EdgeAware)
-    {
-      int dh, dv;
-
-      // first two pixel values for first two lines
-      // Bayer         0 1 2
-      //         0     G r g
-      // line_step     b g b
-      // line_step2    g r g
-
-      rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-      rgb_buffer[1] = bayer_pixel[0]; // green pixel
-      rgb_buffer[rgb_line_step + 2] = rgb_buffer[2] = bayer_pixel[bayer_line_step]; // blue;
-
-      // Bayer         0 1 2
-      //         0     g R g
-      // line_step     b g b
-      // line_step2    g r g
-      //rgb_pixel[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-      // BGBG line
-      // Bayer         0 1 2
-      //         0     g r g
-      // line_step     B g b
-      // line_step2    g r g
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-      rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[bayer_line_step2]);
-      //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-      // pixel (1, 1)  0 1 2
-      //         0     g r g
-      // line_step     b G b
-      // line_step2    g r g
-      //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = AVG( bayer_pixel[line_step] , bayer_pixel[line_step+2] );
-
-      rgb_buffer += 6;
-      bayer_pixel += 2;
-      // rest of the first two lines
-      for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-      {
-        // GRGR line
-        // Bayer        -1 0 1 2
-        //           0   r G r g
-        //   line_step   g b g b
-        // line_step2    r g r g
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[2] = bayer_pixel[bayer_line_step + 1];
-
-        // Bayer        -1 0 1 2
-        //          0    r g R g
-        //  line_step    g b g b
-        // line_step2    r g r g
-        rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 5] = rgb_buffer[5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-        // BGBG line
-        // Bayer         -1 0 1 2
-        //         0      r g r g
-        // line_step      g B g b
-        // line_step2     r g r g
-        rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-        // Bayer         -1 0 1 2
-        //         0      r g r g
-        // line_step      g b G b
-        // line_step2     r g r g
-        rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        //rgb_pixel[rgb_line_step + 5] = AVG( bayer_pixel[line_step] , bayer_pixel[line_step+2] );
-      }
-
-      // last two pixel values for first two lines
-      // GRGR line
-      // Bayer        -1 0 1
-      //           0   r G r
-      //   line_step   g b g
-      // line_step2    r g r
-      rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-      rgb_buffer[1] = bayer_pixel[0];
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = rgb_buffer[5] = rgb_buffer[2] = bayer_pixel[bayer_line_step];
-
-      // Bayer        -1 0 1
-      //          0    r g R
-      //  line_step    g b g
-      // line_step2    r g r
-      rgb_buffer[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-      //rgb_pixel[5] = bayer_pixel[line_step];
-
-      // BGBG line
-      // Bayer        -1 0 1
-      //          0    r g r
-      //  line_step    g B g
-      // line_step2    r g r
-      rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-      rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-      //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-      // Bayer         -1 0 1
-      //         0      r g r
-      // line_step      g b G
-      // line_step2     r g r
-      rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-
-      bayer_pixel += bayer_line_step + 2;
-      rgb_buffer += rgb_line_step + 6 + rgb_line_skip;
-      // main processing
-      for (yIdx = 2; yIdx < height - 2; yIdx += 2)
-      {
-        // first two pixel values
-        // Bayer         0 1 2
-        //        -1     b g b
-        //         0     G r g
-        // line_step     b g b
-        // line_step2    g r g
-
-        rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-        rgb_buffer[1] = bayer_pixel[0]; // green pixel
-        rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]); // blue;
-
-        // Bayer         0 1 2
-        //        -1     b g b
-        //         0     g R g
-        // line_step     b g b
-        // line_step2    g r g
-        //rgb_pixel[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-        rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step]);
-
-        // BGBG line
-        // Bayer         0 1 2
-        //         0     g r g
-        // line_step     B g b
-        // line_step2    g r g
-        rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[bayer_line_step2]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-        // pixel (1, 1)  0 1 2
-        //         0     g r g
-        // line_step     b G b
-        // line_step2    g r g
-        //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-        rgb_buffer += 6;
-        bayer_pixel += 2;
-        // continue with rest of the line
-        for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-        {
-          // GRGR line
-          // Bayer        -1 0 1 2
-          //          -1   g b g b
-          //           0   r G r g
-          //   line_step   g b g b
-          // line_step2    r g r g
-          rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-          rgb_buffer[1] = bayer_pixel[0];
-          rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-          // Bayer        -1 0 1 2
-          //          -1   g b g b
-          //          0    r g R g
-          //  line_step    g b g b
-          // line_step2    r g r g
-
-          dh = abs (bayer_pixel[0] - bayer_pixel[2]);
-          dv = abs (bayer_pixel[-bayer_line_step + 1] - bayer_pixel[bayer_line_step + 1]);
-
-          if (dh > dv)
-            rgb_buffer[4] = AVG (bayer_pixel[-bayer_line_step + 1], bayer_pixel[bayer_line_step + 1]);
-          else if (dv > dh)
-            rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[2]);
-          else
-            rgb_buffer[4] = AVG4 (bayer_pixel[-bayer_line_step + 1], bayer_pixel[bayer_line_step + 1], bayer_pixel[0], bayer_pixel[2]);
-
-          rgb_buffer[3] = bayer_pixel[1];
-          rgb_buffer[5] = AVG4 (bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step], bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-          // BGBG line
-          // Bayer         -1 0 1 2
-          //         -1     g b g b
-          //          0     r g r g
-          // line_step      g B g b
-          // line_step2     r g r g
-          rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-          rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-          dv = abs (bayer_pixel[0] - bayer_pixel[bayer_line_step2]);
-          dh = abs (bayer_pixel[bayer_line_step - 1] - bayer_pixel[bayer_line_step + 1]);
-
-          if (dv > dh)
-            rgb_buffer[rgb_line_step + 1] = AVG (bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-          else if (dh > dv)
-            rgb_buffer[rgb_line_step + 1] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step2]);
-          else
-            rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-
-          // Bayer         -1 0 1 2
-          //         -1     g b g b
-          //          0     r g r g
-          // line_step      g b G b
-          // line_step2     r g r g
-          rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-          rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-          rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-        }
-
-        // last two pixels of the line
-        // last two pixel values for first two lines
-        // GRGR line
-        // Bayer        -1 0 1
-        //           0   r G r
-        //   line_step   g b g
-        // line_step2    r g r
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = rgb_buffer[5] = rgb_buffer[2] = bayer_pixel[bayer_line_step];
-
-        // Bayer        -1 0 1
-        //          0    r g R
-        //  line_step    g b g
-        // line_step2    r g r
-        rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-        //rgb_pixel[5] = bayer_pixel[line_step];
-
-        // BGBG line
-        // Bayer        -1 0 1
-        //          0    r g r
-        //  line_step    g B g
-        // line_step2    r g r
-        rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-        // Bayer         -1 0 1
-        //         0      r g r
-        // line_step      g b G
-        // line_step2     r g r
-        rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-
-        bayer_pixel += bayer_line_step + 2;
-        rgb_buffer += rgb_line_step + 6 + rgb_line_skip;
-      }
-
-      //last two lines
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     G r g
-      // line_step     b g b
-
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-      rgb_buffer[1] = bayer_pixel[0]; // green pixel
-      rgb_buffer[rgb_line_step + 2] = rgb_buffer[2] = bayer_pixel[bayer_line_step]; // blue;
-
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g R g
-      // line_step     b g b
-      //rgb_pixel[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-      rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step]);
-
-      // BGBG line
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g r g
-      // line_step     B g b
-      //rgb_pixel[rgb_line_step    ] = bayer_pixel[1];
-      rgb_buffer[rgb_line_step + 1] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g r g
-      // line_step     b G b
-      //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-      rgb_buffer += 6;
-      bayer_pixel += 2;
-      // rest of the last two lines
-      for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-      {
-        // GRGR line
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r G r g
-        // line_step    g b g b
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g R g
-        // line_step    g b g b
-        rgb_buffer[rgb_line_step + 3] = rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-        rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[-bayer_line_step + 2]);
-
-        // BGBG line
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g r g
-        // line_step    g B g b
-        rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[-1], bayer_pixel[1]);
-        rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g r g
-        // line_step    g b G b
-        //rgb_pixel[rgb_line_step + 3] = bayer_pixel[1];
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-      }
-
-      // last two pixel values for first two lines
-      // GRGR line
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r G r
-      // line_step    g b g
-      rgb_buffer[rgb_line_step ] = rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-      rgb_buffer[1] = bayer_pixel[0];
-      rgb_buffer[5] = rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g R
-      // line_step    g b g
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[-bayer_line_step + 1]);
-      //rgb_pixel[5] = AVG( bayer_pixel[line_step], bayer_pixel[-line_step] );
-
-      // BGBG line
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g r
-      // line_step    g B g
-      //rgb_pixel[rgb_line_step    ] = AVG2( bayer_pixel[-1], bayer_pixel[1] );
-      rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g r
-      // line_step    g b G
-      //rgb_pixel[rgb_line_step + 3] = bayer_pixel[1];
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-    }
-    else if (debayering_method_ == EdgeAwareWeighted)
-    {
-      int dh, dv;
-
-      // first two pixel values for first two lines
-      // Bayer         0 1 2
-      //         0     G r g
-      // line_step     b g b
-      // line_step2    g r g
-
-      rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-      rgb_buffer[1] = bayer_pixel[0]; // green pixel
-      rgb_buffer[rgb_line_step + 2] = rgb_buffer[2] = bayer_pixel[bayer_line_step]; // blue;
-
-      // Bayer         0 1 2
-      //         0     g R g
-      // line_step     b g b
-      // line_step2    g r g
-      //rgb_pixel[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-      // BGBG line
-      // Bayer         0 1 2
-      //         0     g r g
-      // line_step     B g b
-      // line_step2    g r g
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-      rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[bayer_line_step2]);
-      //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-      // pixel (1, 1)  0 1 2
-      //         0     g r g
-      // line_step     b G b
-      // line_step2    g r g
-      //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = AVG( bayer_pixel[line_step] , bayer_pixel[line_step+2] );
-
-      rgb_buffer += 6;
-      bayer_pixel += 2;
-      // rest of the first two lines
-      for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-      {
-        // GRGR line
-        // Bayer        -1 0 1 2
-        //           0   r G r g
-        //   line_step   g b g b
-        // line_step2    r g r g
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[2] = bayer_pixel[bayer_line_step + 1];
-
-        // Bayer        -1 0 1 2
-        //          0    r g R g
-        //  line_step    g b g b
-        // line_step2    r g r g
-        rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 5] = rgb_buffer[5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-        // BGBG line
-        // Bayer         -1 0 1 2
-        //         0      r g r g
-        // line_step      g B g b
-        // line_step2     r g r g
-        rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-        // Bayer         -1 0 1 2
-        //         0      r g r g
-        // line_step      g b G b
-        // line_step2     r g r g
-        rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        //rgb_pixel[rgb_line_step + 5] = AVG( bayer_pixel[line_step] , bayer_pixel[line_step+2] );
-      }
-
-      // last two pixel values for first two lines
-      // GRGR line
-      // Bayer        -1 0 1
-      //           0   r G r
-      //   line_step   g b g
-      // line_step2    r g r
-      rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-      rgb_buffer[1] = bayer_pixel[0];
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = rgb_buffer[5] = rgb_buffer[2] = bayer_pixel[bayer_line_step];
-
-      // Bayer        -1 0 1
-      //          0    r g R
-      //  line_step    g b g
-      // line_step2    r g r
-      rgb_buffer[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-      //rgb_pixel[5] = bayer_pixel[line_step];
-
-      // BGBG line
-      // Bayer        -1 0 1
-      //          0    r g r
-      //  line_step    g B g
-      // line_step2    r g r
-      rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-      rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-      //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-      // Bayer         -1 0 1
-      //         0      r g r
-      // line_step      g b G
-      // line_step2     r g r
-      rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-
-      bayer_pixel += bayer_line_step + 2;
-      rgb_buffer += rgb_line_step + 6 + rgb_line_skip;
-      // main processing
-      for (yIdx = 2; yIdx < height - 2; yIdx += 2)
-      {
-        // first two pixel values
-        // Bayer         0 1 2
-        //        -1     b g b
-        //         0     G r g
-        // line_step     b g b
-        // line_step2    g r g
-
-        rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-        rgb_buffer[1] = bayer_pixel[0]; // green pixel
-        rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]); // blue;
-
-        // Bayer         0 1 2
-        //        -1     b g b
-        //         0     g R g
-        // line_step     b g b
-        // line_step2    g r g
-        //rgb_pixel[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-        rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step]);
-
-        // BGBG line
-        // Bayer         0 1 2
-        //         0     g r g
-        // line_step     B g b
-        // line_step2    g r g
-        rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[bayer_line_step2]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-        // pixel (1, 1)  0 1 2
-        //         0     g r g
-        // line_step     b G b
-        // line_step2    g r g
-        //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-        rgb_buffer += 6;
-        bayer_pixel += 2;
-        // continue with rest of the line
-        for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-        {
-          // GRGR line
-          // Bayer        -1 0 1 2
-          //          -1   g b g b
-          //           0   r G r g
-          //   line_step   g b g b
-          // line_step2    r g r g
-          rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-          rgb_buffer[1] = bayer_pixel[0];
-          rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-          // Bayer        -1 0 1 2
-          //          -1   g b g b
-          //          0    r g R g
-          //  line_step    g b g b
-          // line_step2    r g r g
-
-          dh = abs (bayer_pixel[0] - bayer_pixel[2]);
-          dv = abs (bayer_pixel[-bayer_line_step + 1] - bayer_pixel[bayer_line_step + 1]);
-
-          if (dv == 0 && dh == 0)
-            rgb_buffer[4] = AVG4 (bayer_pixel[1 - bayer_line_step], bayer_pixel[1 + bayer_line_step], bayer_pixel[0], bayer_pixel[2]);
-          else
-            rgb_buffer[4] = WAVG4 (bayer_pixel[1 - bayer_line_step], bayer_pixel[1 + bayer_line_step], bayer_pixel[0], bayer_pixel[2], dh, dv);
-          rgb_buffer[3] = bayer_pixel[1];
-          rgb_buffer[5] = AVG4 (bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step], bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-          // BGBG line
-          // Bayer         -1 0 1 2
-          //         -1     g b g b
-          //          0     r g r g
-          // line_step      g B g b
-          // line_step2     r g r g
-          rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-          rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-          dv = abs (bayer_pixel[0] - bayer_pixel[bayer_line_step2]);
-          dh = abs (bayer_pixel[bayer_line_step - 1] - bayer_pixel[bayer_line_step + 1]);
-
-          if (dv == 0 && dh == 0)
-            rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-          else
-            rgb_buffer[rgb_line_step + 1] = WAVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1], dh, dv);
-
-          // Bayer         -1 0 1 2
-          //         -1     g b g b
-          //          0     r g r g
-          // line_step      g b G b
-          // line_step2     r g r g
-          rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-          rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-          rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-        }
-
-        // last two pixels of the line
-        // last two pixel values for first two lines
-        // GRGR line
-        // Bayer        -1 0 1
-        //           0   r G r
-        //   line_step   g b g
-        // line_step2    r g r
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = rgb_buffer[5] = rgb_buffer[2] = bayer_pixel[bayer_line_step];
-
-        // Bayer        -1 0 1
-        //          0    r g R
-        //  line_step    g b g
-        // line_step2    r g r
-        rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-        //rgb_pixel[5] = bayer_pixel[line_step];
-
-        // BGBG line
-        // Bayer        -1 0 1
-        //          0    r g r
-        //  line_step    g B g
-        // line_step2    r g r
-        rgb_buffer[rgb_line_step ] = AVG4 (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1], bayer_pixel[-1], bayer_pixel[bayer_line_step2 - 1]);
-        rgb_buffer[rgb_line_step + 1] = AVG4 (bayer_pixel[0], bayer_pixel[bayer_line_step2], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        //rgb_pixel[rgb_line_step + 2] = bayer_pixel[line_step];
-
-        // Bayer         -1 0 1
-        //         0      r g r
-        // line_step      g b G
-        // line_step2     r g r
-        rgb_buffer[rgb_line_step + 3] = AVG (bayer_pixel[1], bayer_pixel[bayer_line_step2 + 1]);
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-
-        bayer_pixel += bayer_line_step + 2;
-        rgb_buffer += rgb_line_step + 6 + rgb_line_skip;
-      }
-
-      //last two lines
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     G r g
-      // line_step     b g b
-
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[rgb_line_step ] = rgb_buffer[3] = rgb_buffer[0] = bayer_pixel[1]; // red pixel
-      rgb_buffer[1] = bayer_pixel[0]; // green pixel
-      rgb_buffer[rgb_line_step + 2] = rgb_buffer[2] = bayer_pixel[bayer_line_step]; // blue;
-
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g R g
-      // line_step     b g b
-      //rgb_pixel[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-      rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[2 - bayer_line_step]);
-
-      // BGBG line
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g r g
-      // line_step     B g b
-      //rgb_pixel[rgb_line_step    ] = bayer_pixel[1];
-      rgb_buffer[rgb_line_step + 1] = AVG (bayer_pixel[0], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-      // Bayer         0 1 2
-      //        -1     b g b
-      //         0     g r g
-      // line_step     b G b
-      //rgb_pixel[rgb_line_step + 3] = AVG( bayer_pixel[1] , bayer_pixel[line_step2+1] );
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-
-      rgb_buffer += 6;
-      bayer_pixel += 2;
-      // rest of the last two lines
-      for (xIdx = 2; xIdx < width - 2; xIdx += 2, rgb_buffer += 6, bayer_pixel += 2)
-      {
-        // GRGR line
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r G r g
-        // line_step    g b g b
-        rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-        rgb_buffer[1] = bayer_pixel[0];
-        rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g R g
-        // line_step    g b g b
-        rgb_buffer[rgb_line_step + 3] = rgb_buffer[3] = bayer_pixel[1];
-        rgb_buffer[4] = AVG4 (bayer_pixel[0], bayer_pixel[2], bayer_pixel[bayer_line_step + 1], bayer_pixel[1 - bayer_line_step]);
-        rgb_buffer[5] = AVG4 (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2], bayer_pixel[-bayer_line_step], bayer_pixel[-bayer_line_step + 2]);
-
-        // BGBG line
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g r g
-        // line_step    g B g b
-        rgb_buffer[rgb_line_step ] = AVG (bayer_pixel[-1], bayer_pixel[1]);
-        rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-        rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-
-        // Bayer       -1 0 1 2
-        //        -1    g b g b
-        //         0    r g r g
-        // line_step    g b G b
-        //rgb_pixel[rgb_line_step + 3] = bayer_pixel[1];
-        rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-        rgb_buffer[rgb_line_step + 5] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[bayer_line_step + 2]);
-      }
-
-      // last two pixel values for first two lines
-      // GRGR line
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r G r
-      // line_step    g b g
-      rgb_buffer[rgb_line_step ] = rgb_buffer[0] = AVG (bayer_pixel[1], bayer_pixel[-1]);
-      rgb_buffer[1] = bayer_pixel[0];
-      rgb_buffer[5] = rgb_buffer[2] = AVG (bayer_pixel[bayer_line_step], bayer_pixel[-bayer_line_step]);
-
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g R
-      // line_step    g b g
-      rgb_buffer[rgb_line_step + 3] = rgb_buffer[3] = bayer_pixel[1];
-      rgb_buffer[4] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step + 1], bayer_pixel[-bayer_line_step + 1]);
-      //rgb_pixel[5] = AVG( bayer_pixel[line_step], bayer_pixel[-line_step] );
-
-      // BGBG line
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g r
-      // line_step    g B g
-      //rgb_pixel[rgb_line_step    ] = AVG2( bayer_pixel[-1], bayer_pixel[1] );
-      rgb_buffer[rgb_line_step + 1] = AVG3 (bayer_pixel[0], bayer_pixel[bayer_line_step - 1], bayer_pixel[bayer_line_step + 1]);
-      rgb_buffer[rgb_line_step + 5] = rgb_buffer[rgb_line_step + 2] = bayer_pixel[bayer_line_step];
-
-      // Bayer       -1 0 1
-      //        -1    g b g
-      //         0    r g r
-      // line_step    g b G
-      //rgb_pixel[rgb_line_step + 3] = bayer_pixel[1];
-      rgb_buffer[rgb_line_step + 4] = bayer_pixel[bayer_line_step + 1];
-      //rgb_pixel[rgb_line_step + 5] = bayer_pixel[line_step];
-    }
-    else
+    if (debayering_method_ != Bilinear && debayering_method_ != EdgeAware && debayering_method_ != EdgeAwareWeighted)
       THROW_OPENNI_EXCEPTION ("Unknwon debayering method: %d", (int)debayering_method_);
+
+    pcl::io::debayerGRBGToRGB (image_md_->Data (), width, height, rgb_buffer, rgb_line_step,
+                               static_cast<pcl::io::DebayeringMethod> (debayering_method_), threads_);
   }
   else
   {
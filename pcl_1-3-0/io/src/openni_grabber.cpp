@@ -68,6 +68,7 @@ OpenNIGrabber::OpenNIGrabber(const std::string& device_id, const Mode& depth_mod
 , depth_required_(false)
 , sync_required_(false)
 , running_(false)
+, conversion_threads_(1)
 {
   // initialize driver
   onInit(device_id, depth_mode, image_mode);
@@ -475,217 +476,93 @@ void OpenNIGrabber::irDepthImageCallback(const boost::shared_ptr<openni_wrapper:
   }
 }
 
-pcl::PointCloud<pcl::PointXYZ>::Ptr OpenNIGrabber::convertToXYZPointCloud(const boost::shared_ptr<openni_wrapper::DepthImage>& depth_image) const
+void OpenNIGrabber::getConversionParameters(const boost::shared_ptr<openni_wrapper::DepthImage>& depth_image, float focal_length,
+  pcl::io::DepthConversionParameters& parameters) const
 {
-  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud <pcl::PointXYZ>);
+  parameters.width = depth_width_;
+  parameters.height = depth_height_;
+  parameters.focal_length = focal_length;
+  // values outside the depth range never match a depth pixel, 0 is invalid anyway
+  parameters.no_sample_value = depth_image->getNoSampleValue() <= 0xFFFF ? (unsigned short)depth_image->getNoSampleValue() : 0;
+  parameters.shadow_value = depth_image->getShadowValue() <= 0xFFFF ? (unsigned short)depth_image->getShadowValue() : 0;
+  parameters.threads = conversion_threads_;
+}
 
-  // TODO cloud->header.stamp = time;
-  cloud->height = depth_height_;
-  cloud->width = depth_width_;
-  cloud->is_dense = false;
+const unsigned short* OpenNIGrabber::getDepthMap(const boost::shared_ptr<openni_wrapper::DepthImage>& depth_image,
+  std::vector<unsigned short>& buffer) const
+{
+  // we have to use Data, since operator[] uses assert -> Debug-mode very slow!
+  if (depth_image->getWidth() == depth_width_ && depth_image->getHeight() == depth_height_)
+    return depth_image->getDepthMetaData().Data();
 
-  cloud->points.resize(cloud->height * cloud->width);
+  buffer.resize(depth_width_ * depth_height_);
+  depth_image->fillDepthImageRaw(depth_width_, depth_height_, &buffer[0]);
+  return &buffer[0];
+}
 
-  register float constant = 1.0f / device_->getDepthFocalLength(depth_width_);
+pcl::PointCloud<pcl::PointXYZ>::Ptr OpenNIGrabber::convertToXYZPointCloud(const boost::shared_ptr<openni_wrapper::DepthImage>& depth_image)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud = xyz_cloud_pool_.acquire();
 
+  // TODO cloud->header.stamp = time;
   if (device_->isDepthRegistered())
     cloud->header.frame_id = rgb_frame_id_;
   else
     cloud->header.frame_id = depth_frame_id_;
 
-  register int centerX = (cloud->width >> 1);
-  int centerY = (cloud->height >> 1);
-
-  float bad_point = std::numeric_limits<float>::quiet_NaN();
+  pcl::io::DepthConversionParameters parameters;
+  getConversionParameters(depth_image, device_->getDepthFocalLength(depth_width_), parameters);
 
-  // we have to use Data, since operator[] uses assert -> Debug-mode very slow!
-  register const unsigned short* depth_map = depth_image->getDepthMetaData().Data();
-  if (depth_image->getWidth() != depth_width_ || depth_image->getHeight() != depth_height_)
-  {
-    static unsigned buffer_size = 0;
-    static boost::shared_array<unsigned short> depth_buffer(0);
-
-    if (buffer_size < depth_width_ * depth_height_)
-    {
-      buffer_size = depth_width_ * depth_height_;
-      depth_buffer.reset(new unsigned short [buffer_size]);
-    }
-    depth_image->fillDepthImageRaw(depth_width_, depth_height_, depth_buffer.get());
-    depth_map = depth_buffer.get();
-  }
+  pcl::io::convertDepthToPointCloud(parameters, getDepthMap(depth_image, xyz_depth_buffer_), *cloud);
 
-  register int depth_idx = 0;
-  for (int v = -centerY; v < centerY; ++v)
-  {
-    for (register int u = -centerX; u < centerX; ++u, ++depth_idx)
-    {
-      pcl::PointXYZ& pt = cloud->points[depth_idx];
-      // Check for invalid measurements
-      if (depth_map[depth_idx] == 0 ||
-          depth_map[depth_idx] == depth_image->getNoSampleValue() ||
-          depth_map[depth_idx] == depth_image->getShadowValue())
-      {
-        // not valid
-        pt.x = pt.y = pt.z = bad_point;
-        continue;
-      }
-      pt.z = depth_map[depth_idx] * 0.001;
-      pt.x = u * pt.z * constant;
-      pt.y = v * pt.z * constant;
-    }
-  }
   return cloud;
 }
 
 pcl::PointCloud<pcl::PointXYZRGB>::Ptr OpenNIGrabber::convertToXYZRGBPointCloud(const boost::shared_ptr<openni_wrapper::Image> &image,
-  const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image) const
+  const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image)
 {
-  static unsigned rgb_array_size = 0;
-  static boost::shared_array<unsigned char> rgb_array(0);
-  static unsigned char* rgb_buffer = 0;
-
-  boost::shared_ptr<pcl::PointCloud<pcl::PointXYZRGB> > cloud(new pcl::PointCloud<pcl::PointXYZRGB > ());
+  pcl::PointCloud<pcl::PointXYZRGB>::Ptr cloud = xyzrgb_cloud_pool_.acquire();
 
   cloud->header.frame_id = rgb_frame_id_;
-  cloud->height = depth_height_;
-  cloud->width = depth_width_;
-  cloud->is_dense = false;
-
-  cloud->points.resize(cloud->height * cloud->width);
 
-  float constant = 1.0f / device_->getImageFocalLength(cloud->width);
-  register int centerX = (cloud->width >> 1);
-  int centerY = (cloud->height >> 1);
+  pcl::io::DepthConversionParameters parameters;
+  getConversionParameters(depth_image, device_->getImageFocalLength(depth_width_), parameters);
 
-  register const XnDepthPixel* depth_map = depth_image->getDepthMetaData().Data();
-  if (depth_image->getWidth() != depth_width_ || depth_image->getHeight() != depth_height_)
-  {
-    static unsigned buffer_size = 0;
-    static boost::shared_array<unsigned short> depth_buffer(0);
-
-    if (buffer_size < depth_width_ * depth_height_)
-    {
-      buffer_size = depth_width_ * depth_height_;
-      depth_buffer.reset(new unsigned short [buffer_size]);
-    }
-
-    depth_image->fillDepthImageRaw(depth_width_, depth_height_, depth_buffer.get());
-    depth_map = depth_buffer.get();
-  }
+  const unsigned short* depth_map = getDepthMap(depth_image, xyzrgb_depth_buffer_);
 
   // here we need exact the size of the point cloud for a one-one correspondence!
-  if (rgb_array_size < image_width_ * image_height_ * 3)
-  {
-    rgb_array_size = image_width_ * image_height_ * 3;
-    rgb_array.reset(new unsigned char [rgb_array_size]);
-    rgb_buffer = rgb_array.get();
-  }
-  image->fillRGB(image_width_, image_height_, rgb_buffer, image_width_ * 3);
+  xyzrgb_rgb_buffer_.resize(depth_width_ * depth_height_ * 3);
+  image->setNumberOfThreads(conversion_threads_);
+  image->fillRGB(depth_width_, depth_height_, &xyzrgb_rgb_buffer_[0], depth_width_ * 3);
 
-  // depth_image already has the desired dimensions, but rgb_msg may be higher res.
-  register int color_idx = 0, depth_idx = 0;
-  RGBValue color;
-  color.Alpha = 0;
+  pcl::io::convertDepthToPointCloud(parameters, depth_map, &xyzrgb_rgb_buffer_[0], *cloud);
 
-  float bad_point = std::numeric_limits<float>::quiet_NaN();
-
-  for (int v = -centerY; v < centerY; ++v)
-  {
-    for (register int u = -centerX; u < centerX; ++u, color_idx += 3, ++depth_idx)
-    {
-      pcl::PointXYZRGB& pt = cloud->points[depth_idx];
-      /// @todo Different values for these cases
-      // Check for invalid measurements
-      if (depth_map[depth_idx] == 0 ||
-          depth_map[depth_idx] == depth_image->getNoSampleValue() ||
-          depth_map[depth_idx] == depth_image->getShadowValue())
-      {
-        pt.x = pt.y = pt.z = bad_point;
-      }
-      else
-      {
-        pt.z = depth_map[depth_idx] * 0.001f;
-        pt.x = u * pt.z * constant;
-        pt.y = v * pt.z * constant;
-      }
-
-      // Fill in color
-      color.Red = rgb_buffer[color_idx];
-      color.Green = rgb_buffer[color_idx + 1];
-      color.Blue = rgb_buffer[color_idx + 2];
-      pt.rgb = color.float_value;
-    }
-  }
-  return (cloud);
+  return cloud;
 }
 
 pcl::PointCloud<pcl::PointXYZI>::Ptr OpenNIGrabber::convertToXYZIPointCloud(const boost::shared_ptr<openni_wrapper::IRImage> &ir_image,
-  const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image) const
+  const boost::shared_ptr<openni_wrapper::DepthImage> &depth_image)
 {
-  boost::shared_ptr<pcl::PointCloud<pcl::PointXYZI> > cloud(new pcl::PointCloud<pcl::PointXYZI > ());
+  pcl::PointCloud<pcl::PointXYZI>::Ptr cloud = xyzi_cloud_pool_.acquire();
 
   cloud->header.frame_id = rgb_frame_id_;
-  cloud->height = depth_height_;
-  cloud->width = depth_width_;
-  cloud->is_dense = false;
-
-  cloud->points.resize(cloud->height * cloud->width);
 
-  float constant = 1.0f / device_->getImageFocalLength(cloud->width);
-  register int centerX = (cloud->width >> 1);
-  int centerY = (cloud->height >> 1);
+  pcl::io::DepthConversionParameters parameters;
+  getConversionParameters(depth_image, device_->getImageFocalLength(depth_width_), parameters);
 
-  register const XnDepthPixel* depth_map = depth_image->getDepthMetaData().Data();
-  register const XnIRPixel* ir_map = ir_image->getMetaData().Data();
+  const unsigned short* depth_map = getDepthMap(depth_image, xyzi_depth_buffer_);
 
+  const XnIRPixel* ir_map = ir_image->getMetaData().Data();
   if (depth_image->getWidth() != depth_width_ || depth_image->getHeight() != depth_height_)
   {
-    static unsigned buffer_size = 0;
-    static boost::shared_array<unsigned short> depth_buffer(0);
-    static boost::shared_array<unsigned short> ir_buffer(0);
-
-    if (buffer_size < depth_width_ * depth_height_)
-    {
-      buffer_size = depth_width_ * depth_height_;
-      depth_buffer.reset(new unsigned short [buffer_size]);
-      ir_buffer.reset(new unsigned short [buffer_size]);
-    }
-
-    depth_image->fillDepthImageRaw(depth_width_, depth_height_, depth_buffer.get());
-    depth_map = depth_buffer.get();
-
-    ir_image->fillRaw(depth_width_, depth_height_, ir_buffer.get());
-    ir_map = ir_buffer.get ();
+    xyzi_ir_buffer_.resize(depth_width_ * depth_height_);
+    ir_image->fillRaw(depth_width_, depth_height_, &xyzi_ir_buffer_[0]);
+    ir_map = &xyzi_ir_buffer_[0];
   }
 
-  register int depth_idx = 0;
-  float bad_point = std::numeric_limits<float>::quiet_NaN();
-
-  for (int v = -centerY; v < centerY; ++v)
-  {
-    for (register int u = -centerX; u < centerX; ++u, ++depth_idx)
-    {
-      pcl::PointXYZI& pt = cloud->points[depth_idx];
-      /// @todo Different values for these cases
-      // Check for invalid measurements
-      if (depth_map[depth_idx] == 0 ||
-          depth_map[depth_idx] == depth_image->getNoSampleValue() ||
-          depth_map[depth_idx] == depth_image->getShadowValue())
-      {
-        pt.x = pt.y = pt.z = bad_point;
-      }
-      else
-      {
-        pt.z = depth_map[depth_idx] * 0.001f;
-        pt.x = u * pt.z * constant;
-        pt.y = v * pt.z * constant;
-      }
+  pcl::io::convertDepthToPointCloud(parameters, depth_map, ir_map, *cloud);
 
-      pt.data_c[0] = pt.data_c[1] = pt.data_c[2] = pt.data_c[3] = 0;
-      pt.intensity = (float) ir_map[depth_idx];
-    }
-  }
-  return (cloud);
+  return cloud;
 }
 // TODO: delete me?
 
@@ -41,14 +41,50 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 #include <pcl/io/pcd_io.h>
+#include <pcl/console/print.h>
+#include <algorithm>
+#include <deque>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
 
 //////////////////////// GrabberImplementation //////////////////////
 struct pcl::PCDGrabberBase::PCDGrabberImpl
 {
+  // a PCD file in the read-ahead queue
+  struct Frame
+  {
+    Frame () : file (), cloud (), map (NULL), map_size (0), started (false), loaded (false), valid (false) {}
+    ~Frame () { unmap (); }
+    void unmap ();
+
+    std::string file;
+    sensor_msgs::PointCloud2 cloud;
+    // mapped file, the points are at map + map_size - cloud.row_step * cloud.height
+    char* map;
+    size_t map_size;
+    bool started;
+    bool loaded;
+    bool valid;
+  };
+  typedef boost::shared_ptr<Frame> FramePtr;
+
   PCDGrabberImpl (pcl::PCDGrabberBase& grabber, const std::string& pcd_path, float frames_per_second, bool repeat);
   PCDGrabberImpl (pcl::PCDGrabberBase& grabber, const std::vector<std::string>& pcd_files, float frames_per_second, bool repeat);
-  void trigger ();
-  void readAhead ();
+  ~PCDGrabberImpl ();
+  bool trigger ();
+  void replay ();
+  void fillQueue ();
+  void load (Frame& frame) const;
+  bool loadMapped (Frame& frame) const;
+  void loadSynchronously (boost::unique_lock<boost::mutex>& lock, const FramePtr& frame);
+  void loaderThread ();
+  void startLoaders (unsigned threads);
+  void stopLoaders ();
   pcl::PCDGrabberBase& grabber_;
   float frames_per_second_;
   bool repeat_;
@@ -57,8 +93,25 @@ struct pcl::PCDGrabberBase::PCDGrabberImpl
   std::vector<std::string>::iterator pcd_iterator_;
   TimeTrigger time_trigger_;
 
-  sensor_msgs::PointCloud2 next_cloud_;
-  bool valid_;
+  size_t read_ahead_depth_;
+  unsigned loader_threads_;
+  bool memory_mapping_;
+  // files to be published next, in order
+  std::deque<FramePtr> frames_;
+  // published frames, kept to reuse their buffers
+  std::vector<FramePtr> recycled_;
+  boost::mutex mutex_;
+  boost::condition_variable frame_queued_;
+  boost::condition_variable frame_loaded_;
+  boost::thread_group loaders_;
+  bool quit_;
+  // serializes trigger () calls of the different playback modes
+  boost::mutex trigger_mutex_;
+  boost::thread replay_thread_;
+
+  unsigned published_;
+  boost::posix_time::ptime start_time_;
+  boost::posix_time::ptime last_publish_time_;
 };
 
 pcl::PCDGrabberBase::PCDGrabberImpl::PCDGrabberImpl (pcl::PCDGrabberBase& grabber, const std::string& pcd_path, float frames_per_second, bool repeat)
@@ -67,7 +120,11 @@ pcl::PCDGrabberBase::PCDGrabberImpl::PCDGrabberImpl (pcl::PCDGrabberBase& grabbe
 , repeat_ (repeat)
 , running_ (false)
 , time_trigger_ (1.0 / (double) std::max(frames_per_second, 0.001f), boost::bind (&PCDGrabberImpl::trigger, this))
-, valid_ (false)
+, read_ahead_depth_ (1)
+, loader_threads_ (0)
+, memory_mapping_ (false)
+, quit_ (false)
+, published_ (0)
 {
   pcd_files_.push_back (pcd_path);
   pcd_iterator_ = pcd_files_.begin ();
@@ -79,36 +136,233 @@ pcl::PCDGrabberBase::PCDGrabberImpl::PCDGrabberImpl (pcl::PCDGrabberBase& grabbe
 , repeat_ (repeat)
 , running_ (false)
 , time_trigger_ (1.0 / (double) std::max(frames_per_second, 0.001f), boost::bind (&PCDGrabberImpl::trigger, this))
-, valid_ (false)
+, read_ahead_depth_ (1)
+, loader_threads_ (0)
+, memory_mapping_ (false)
+, quit_ (false)
+, published_ (0)
 {
   pcd_files_ = pcd_files;
   pcd_iterator_ = pcd_files_.begin ();
 }
 
-void pcl::PCDGrabberBase::PCDGrabberImpl::readAhead ()
+pcl::PCDGrabberBase::PCDGrabberImpl::~PCDGrabberImpl ()
+{
+  stopLoaders ();
+}
+
+void pcl::PCDGrabberBase::PCDGrabberImpl::Frame::unmap ()
+{
+#ifndef _WIN32
+  if (map)
+    munmap (map, map_size);
+#endif
+  map = NULL;
+  map_size = 0;
+}
+
+bool pcl::PCDGrabberBase::PCDGrabberImpl::loadMapped (Frame& frame) const
+{
+#ifdef _WIN32
+  return (false);
+#else
+  PCDReader reader;
+  int pcd_version, data_type, data_idx;
+  Eigen::Vector4f origin;
+  Eigen::Quaternionf orientation;
+  if (reader.readHeader (frame.file, frame.cloud, origin, orientation, pcd_version, data_type, data_idx) < 0 || data_type != 1)
+    return (false);
+
+  // the points are read from the mapped file instead
+  size_t data_size = frame.cloud.data.size ();
+  frame.cloud.data.clear ();
+  frame.cloud.is_dense = false;
+  frame.cloud.row_step = frame.cloud.point_step * frame.cloud.width;
+
+  int fd = open (frame.file.c_str (), O_RDONLY);
+  if (fd == -1)
+    return (false);
+
+  struct stat file_stat;
+  if (fstat (fd, &file_stat) == -1 || (size_t) file_stat.st_size < data_idx + data_size)
+  {
+    close (fd);
+    return (false);
+  }
+
+  int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+  // page the file in on the loader thread rather than on the publishing one
+  flags |= MAP_POPULATE;
+#endif
+  void* map = mmap (0, data_idx + data_size, PROT_READ, flags, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    return (false);
+
+  frame.map = static_cast<char*> (map);
+  frame.map_size = data_idx + data_size;
+  return (true);
+#endif
+}
+
+void pcl::PCDGrabberBase::PCDGrabberImpl::load (Frame& frame) const
 {
-  if (pcd_iterator_ != pcd_files_.end ())
+  frame.unmap ();
+  if (memory_mapping_ && loadMapped (frame))
   {
-    PCDReader reader;
-    int pcd_version;
-    Eigen::Vector4f origin;
-    Eigen::Quaternionf orientation;
-    valid_ = (reader.read (*pcd_iterator_, next_cloud_, origin, orientation, pcd_version) == 0);
+    frame.valid = true;
+    return;
+  }
+  frame.unmap ();
+
+  PCDReader reader;
+  int pcd_version;
+  Eigen::Vector4f origin;
+  Eigen::Quaternionf orientation;
+  frame.valid = (reader.read (frame.file, frame.cloud, origin, orientation, pcd_version) == 0);
+}
+
+void pcl::PCDGrabberBase::PCDGrabberImpl::fillQueue ()
+{
+  while (frames_.size () < read_ahead_depth_ && pcd_iterator_ != pcd_files_.end ())
+  {
+    FramePtr frame;
+    if (recycled_.empty ())
+      frame.reset (new Frame);
+    else
+    {
+      frame = recycled_.back ();
+      recycled_.pop_back ();
+    }
+    frame->file = *pcd_iterator_;
+    frame->started = frame->loaded = frame->valid = false;
+    frames_.push_back (frame);
 
     if (++pcd_iterator_ == pcd_files_.end () && repeat_)
       pcd_iterator_ = pcd_files_.begin ();
   }
-  else
-    valid_ = false;
+  frame_queued_.notify_all ();
+}
+
+void pcl::PCDGrabberBase::PCDGrabberImpl::loadSynchronously (boost::unique_lock<boost::mutex>& lock, const FramePtr& frame)
+{
+  frame->started = true;
+  lock.unlock ();
+  load (*frame);
+  lock.lock ();
+  frame->loaded = true;
+  frame_loaded_.notify_all ();
+}
+
+void pcl::PCDGrabberBase::PCDGrabberImpl::loaderThread ()
+{
+  boost::unique_lock<boost::mutex> lock (mutex_);
+  while (!quit_)
+  {
+    FramePtr frame;
+    for (std::deque<FramePtr>::iterator frame_it = frames_.begin (); frame_it != frames_.end () && !frame; ++frame_it)
+      if (!(*frame_it)->started)
+        frame = *frame_it;
+
+    if (frame)
+      loadSynchronously (lock, frame);
+    else
+      frame_queued_.wait (lock);
+  }
+}
+
+void pcl::PCDGrabberBase::PCDGrabberImpl::startLoaders (unsigned threads)
+{
+  stopLoaders ();
+
+  boost::unique_lock<boost::mutex> lock (mutex_);
+  loader_threads_ = threads;
+  quit_ = false;
+  for (unsigned i = 0; i < threads; ++i)
+    loaders_.create_thread (boost::bind (&PCDGrabberImpl::loaderThread, this));
 }
 
-void pcl::PCDGrabberBase::PCDGrabberImpl::trigger ()
+void pcl::PCDGrabberBase::PCDGrabberImpl::stopLoaders ()
 {
-  if (valid_)
-    grabber_.publish (next_cloud_);
+  {
+    boost::unique_lock<boost::mutex> lock (mutex_);
+    quit_ = true;
+    frame_queued_.notify_all ();
+  }
+  loaders_.join_all ();
 
+  boost::unique_lock<boost::mutex> lock (mutex_);
+  loader_threads_ = 0;
+  // frames that were not picked up are loaded by the next trigger
+  for (std::deque<FramePtr>::iterator frame_it = frames_.begin (); frame_it != frames_.end (); ++frame_it)
+    if (!(*frame_it)->loaded)
+      (*frame_it)->started = false;
+}
+
+bool pcl::PCDGrabberBase::PCDGrabberImpl::trigger ()
+{
+  boost::unique_lock<boost::mutex> trigger_lock (trigger_mutex_);
+  FramePtr frame;
+  {
+    boost::unique_lock<boost::mutex> lock (mutex_);
+    fillQueue ();
+    if (frames_.empty ())
+      return (false);
+
+    frame = frames_.front ();
+    if (!frame->started)
+      loadSynchronously (lock, frame);
+    while (!frame->loaded)
+      frame_loaded_.wait (lock);
+    // unless rewind () dropped it meanwhile
+    if (!frames_.empty () && frames_.front () == frame)
+      frames_.pop_front ();
+  }
+
+  if (frame->valid)
+  {
+    if (frame->map)
+      grabber_.publish (frame->cloud, reinterpret_cast<const unsigned char*> (frame->map + frame->map_size - frame->cloud.row_step * frame->cloud.height));
+    else
+      grabber_.publish (frame->cloud);
+  }
+
+  boost::unique_lock<boost::mutex> lock (mutex_);
+  if (frame->valid)
+  {
+    last_publish_time_ = boost::posix_time::microsec_clock::local_time ();
+    if (published_++ == 0 && start_time_.is_not_a_date_time ())
+      start_time_ = last_publish_time_;
+  }
+  frame->unmap ();
+  recycled_.push_back (frame);
+
+  fillQueue ();
   // use remaining time, if there is time left!
-  readAhead ();
+  if (loader_threads_ == 0 && !frames_.empty () && !frames_.front ()->started)
+    loadSynchronously (lock, frames_.front ());
+  return (true);
+}
+
+void pcl::PCDGrabberBase::PCDGrabberImpl::replay ()
+{
+  while (true)
+  {
+    {
+      boost::unique_lock<boost::mutex> lock (mutex_);
+      if (!running_)
+        return;
+    }
+
+    if (!trigger ())
+      break;
+  }
+
+  double throughput = grabber_.getThroughput ();
+  boost::unique_lock<boost::mutex> lock (mutex_);
+  PCL_DEBUG ("[pcl::PCDGrabber] Replayed %u PCD files at %f files per second.\n", published_, throughput);
+  running_ = false;
 }
 
 //////////////////////// GrabberBase //////////////////////
@@ -130,10 +384,29 @@ pcl::PCDGrabberBase::~PCDGrabberBase () throw ()
 
 void pcl::PCDGrabberBase::start ()
 {
-  if (impl_->frames_per_second_ > 0)
+  // connections are blocked when registered
+  unblock_signals ();
+
+  if (impl_->frames_per_second_ != 0)
   {
-    impl_->running_ = true;
-    impl_->time_trigger_.start ();
+    {
+      boost::unique_lock<boost::mutex> lock (impl_->mutex_);
+      if (impl_->running_)
+        return;
+      impl_->running_ = true;
+      impl_->published_ = 0;
+      impl_->start_time_ = boost::posix_time::microsec_clock::local_time ();
+    }
+
+    if (impl_->frames_per_second_ > 0)
+      impl_->time_trigger_.start ();
+    else
+    {
+      // join a replay thread that finished on its own
+      if (impl_->replay_thread_.joinable ())
+        impl_->replay_thread_.join ();
+      impl_->replay_thread_ = boost::thread (boost::bind (&PCDGrabberImpl::replay, impl_));
+    }
   }
   else // manual trigger
   {
@@ -148,10 +421,20 @@ void pcl::PCDGrabberBase::stop ()
     impl_->time_trigger_.stop ();
     impl_->running_ = false;
   }
+  else if (impl_->frames_per_second_ < 0)
+  {
+    {
+      boost::unique_lock<boost::mutex> lock (impl_->mutex_);
+      impl_->running_ = false;
+    }
+    if (impl_->replay_thread_.joinable ())
+      impl_->replay_thread_.join ();
+  }
 }
 
 bool pcl::PCDGrabberBase::isRunning () const
 {
+  boost::unique_lock<boost::mutex> lock (impl_->mutex_);
   return impl_->running_;
 }
 
@@ -162,7 +445,65 @@ std::string pcl::PCDGrabberBase::getName () const
 
 void pcl::PCDGrabberBase::rewind ()
 {
+  boost::unique_lock<boost::mutex> lock (impl_->mutex_);
   impl_->pcd_iterator_ = impl_->pcd_files_.begin ();
+  // frames being loaded are released by their loader thread
+  impl_->frames_.clear ();
+}
+
+void pcl::PCDGrabberBase::setReadAheadDepth (size_t depth)
+{
+  boost::unique_lock<boost::mutex> lock (impl_->mutex_);
+  impl_->read_ahead_depth_ = std::max<size_t> (depth, 1);
+  impl_->fillQueue ();
+}
+
+size_t pcl::PCDGrabberBase::getReadAheadDepth () const
+{
+  boost::unique_lock<boost::mutex> lock (impl_->mutex_);
+  return impl_->read_ahead_depth_;
+}
+
+void pcl::PCDGrabberBase::setNumberOfLoaderThreads (unsigned threads)
+{
+  impl_->startLoaders (threads);
+}
+
+unsigned pcl::PCDGrabberBase::getNumberOfLoaderThreads () const
+{
+  boost::unique_lock<boost::mutex> lock (impl_->mutex_);
+  return impl_->loader_threads_;
+}
+
+void pcl::PCDGrabberBase::setMemoryMapping (bool memory_mapping)
+{
+  boost::unique_lock<boost::mutex> lock (impl_->mutex_);
+  impl_->memory_mapping_ = memory_mapping;
+}
+
+bool pcl::PCDGrabberBase::getMemoryMapping () const
+{
+  boost::unique_lock<boost::mutex> lock (impl_->mutex_);
+  return impl_->memory_mapping_;
+}
+
+double pcl::PCDGrabberBase::getThroughput () const
+{
+  boost::unique_lock<boost::mutex> lock (impl_->mutex_);
+  if (impl_->published_ == 0 || impl_->start_time_.is_not_a_date_time ())
+    return 0.0;
+
+  boost::posix_time::time_duration elapsed = impl_->last_publish_time_ - impl_->start_time_;
+  if (elapsed.total_microseconds () <= 0)
+    return 0.0;
+  return impl_->published_ * 1e6 / (double) elapsed.total_microseconds ();
+}
+
+void pcl::PCDGrabberBase::publish (const sensor_msgs::PointCloud2& blob, const unsigned char* data) const
+{
+  sensor_msgs::PointCloud2 cloud = blob;
+  cloud.data.assign (data, data + blob.row_step * blob.height);
+  publish (cloud);
 }
 
 #endif
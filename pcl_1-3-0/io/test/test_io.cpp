@@ -43,8 +43,19 @@
 #include "pcl/common/io.h"
 #include "pcl/io/pcd_io.h"
 #include "pcl/io/ply_io.h"
+#include "pcl/compression/compressed_point_cloud_container.h"
+#include "pcl/io/depth_image_conversion.h"
+#include "pcl/io/color_image_conversion.h"
+#include "pcl/io/frame_pool.h"
+#include "pcl/io/callback_queue.h"
+#include "pcl/pcl_config.h"
+#ifdef HAVE_OPENNI
+#include "pcl/io/pcd_grabber.h"
+#endif
+#include <algorithm>
 #include <fstream>
 #include <locale>
+#include <sstream>
 #include <stdexcept>
 
 using namespace pcl;
@@ -1012,6 +1023,536 @@ TEST (PCL, Locale)
 #endif
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, CompressedPointCloudContainer)
+{
+  typedef pcl::octree::CompressedPointCloudWriter<PointXYZ> Writer;
+  typedef pcl::octree::CompressedPointCloudReader<PointXYZ> Reader;
+
+  const size_t frameCount = 10;
+  Writer writer (pcl::octree::LOW_RES_ONLINE_COMPRESSION_WITHOUT_COLOR);
+  writer.getEncoder ().setIFrameRate (2);
+
+  EXPECT_EQ (writer.open ("test_container.pcc"), 0);
+  srand (0);
+  for (size_t f = 0; f < frameCount; ++f)
+  {
+    PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+    for (int i = 0; i < 2000; ++i)
+      cloud->points.push_back (PointXYZ (rand () / (float)RAND_MAX, rand () / (float)RAND_MAX,
+                                         rand () / (float)RAND_MAX + 0.01f * f));
+    cloud->width = cloud->points.size ();
+    cloud->height = 1;
+    EXPECT_EQ (writer.writeFrame (cloud, 1000 + 10 * f), 0);
+  }
+  EXPECT_EQ (writer.getFrameCount (), frameCount);
+  EXPECT_EQ (writer.close (), 0);
+
+  Reader reader;
+  EXPECT_EQ (reader.open ("test_container.pcc"), 0);
+  ASSERT_EQ (reader.getFrameCount (), frameCount);
+
+  // keyframe table lists all I-frames, the first frame is always an I-frame
+  ASSERT_GT (reader.getKeyFrames ().size (), 2);
+  EXPECT_EQ (reader.getKeyFrames ()[0], 0);
+  for (size_t f = 0; f < frameCount; ++f)
+  {
+    const size_t keyFrame = reader.getKeyFrame (f);
+    EXPECT_TRUE (reader.getFrameIndex ()[keyFrame].iFrame);
+    for (size_t i = keyFrame + 1; i <= f; ++i)
+      EXPECT_FALSE (reader.getFrameIndex ()[i].iFrame);
+  }
+  EXPECT_EQ (reader.findFrame (1045), 4);
+  EXPECT_EQ (reader.findFrame (0), 0);
+
+  // sequential decoding
+  std::vector<PointCloud<PointXYZ>::Ptr> sequential (frameCount);
+  for (size_t f = 0; f < frameCount; ++f)
+  {
+    EXPECT_EQ (reader.readFrame (f, sequential[f]), 0);
+    EXPECT_GT (sequential[f]->points.size (), 0);
+  }
+
+  // parallel decoding of groups of pictures
+  std::vector<PointCloud<PointXYZ>::Ptr> range;
+  reader.setNumberOfThreads (2);
+  EXPECT_EQ (reader.readFrames (1, frameCount, range), 0);
+  ASSERT_EQ (range.size (), frameCount - 1);
+
+  // random access
+  const size_t seekFrames[] = {8, 2, 5, 9, 0};
+  for (size_t s = 0; s < sizeof(seekFrames) / sizeof(seekFrames[0]); ++s)
+  {
+    const size_t f = seekFrames[s];
+    PointCloud<PointXYZ>::Ptr cloud;
+    EXPECT_EQ (reader.readFrame (f, cloud), 0);
+
+    ASSERT_EQ (cloud->points.size (), sequential[f]->points.size ());
+    for (size_t i = 0; i < cloud->points.size (); ++i)
+    {
+      EXPECT_EQ (cloud->points[i].x, sequential[f]->points[i].x);
+      EXPECT_EQ (cloud->points[i].y, sequential[f]->points[i].y);
+      EXPECT_EQ (cloud->points[i].z, sequential[f]->points[i].z);
+    }
+
+    if (f == 0)
+      continue;
+
+    ASSERT_EQ (range[f - 1]->points.size (), sequential[f]->points.size ());
+    for (size_t i = 0; i < range[f - 1]->points.size (); ++i)
+    {
+      EXPECT_EQ (range[f - 1]->points[i].x, sequential[f]->points[i].x);
+      EXPECT_EQ (range[f - 1]->points[i].y, sequential[f]->points[i].y);
+      EXPECT_EQ (range[f - 1]->points[i].z, sequential[f]->points[i].z);
+    }
+  }
+
+  reader.close ();
+  remove ("test_container.pcc");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PartitionedPointCloudCompression)
+{
+  typedef pcl::octree::PointCloudCompression<PointXYZRGB> Compression;
+
+  // voxel grid (centroid) coding and detail point coding, both with color
+  const pcl::octree::compression_Profiles_e profiles[] = {pcl::octree::LOW_RES_ONLINE_COMPRESSION_WITH_COLOR,
+                                                          pcl::octree::MED_RES_ONLINE_COMPRESSION_WITH_COLOR};
+  srand (0);
+  for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); ++p)
+  {
+    Compression serialEncoder (profiles[p]), serialDecoder (profiles[p]);
+    Compression partitionedEncoder (profiles[p]), partitionedDecoder (profiles[p]);
+    partitionedEncoder.setPartitionCount (4);
+    partitionedEncoder.setNumberOfThreads (2);
+    partitionedDecoder.setNumberOfThreads (2);
+
+    // the first frame is an I-frame, the following ones are P-frames
+    for (int f = 0; f < 3; ++f)
+    {
+      PointCloud<PointXYZRGB>::Ptr cloud (new PointCloud<PointXYZRGB>);
+      for (int i = 0; i < 5000; ++i)
+      {
+        PointXYZRGB point;
+        point.x = rand () / (float)RAND_MAX;
+        point.y = rand () / (float)RAND_MAX;
+        point.z = rand () / (float)RAND_MAX + 0.001f * f;
+        point.r = rand () % 256;
+        point.g = rand () % 256;
+        point.b = rand () % 256;
+        cloud->points.push_back (point);
+      }
+      cloud->width = cloud->points.size ();
+      cloud->height = 1;
+
+      std::stringstream serialStream, partitionedStream;
+      serialEncoder.encodePointCloud (cloud, serialStream);
+      partitionedEncoder.encodePointCloud (cloud, partitionedStream);
+
+      PointCloud<PointXYZRGB>::Ptr serial (new PointCloud<PointXYZRGB>);
+      PointCloud<PointXYZRGB>::Ptr partitioned (new PointCloud<PointXYZRGB>);
+      serialDecoder.decodePointCloud (serialStream, serial);
+      partitionedDecoder.decodePointCloud (partitionedStream, partitioned);
+
+      ASSERT_GT (serial->points.size (), 0);
+      ASSERT_EQ (partitioned->points.size (), serial->points.size ());
+      for (size_t i = 0; i < serial->points.size (); ++i)
+      {
+        EXPECT_EQ (partitioned->points[i].x, serial->points[i].x);
+        EXPECT_EQ (partitioned->points[i].y, serial->points[i].y);
+        EXPECT_EQ (partitioned->points[i].z, serial->points[i].z);
+        EXPECT_EQ (partitioned->points[i].rgb, serial->points[i].rgb);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, DepthImageConversion)
+{
+  pcl::io::DepthConversionParameters parameters;
+  parameters.width = 37;
+  parameters.height = 6;
+  parameters.focal_length = 525.0f;
+  parameters.no_sample_value = 2047;
+  parameters.shadow_value = 2046;
+  parameters.threads = 2;
+
+  const size_t size = parameters.width * parameters.height;
+  std::vector<unsigned short> depth (size), ir (size);
+  std::vector<unsigned char> rgb (size * 3);
+  srand (0);
+  for (size_t i = 0; i < size; ++i)
+  {
+    depth[i] = static_cast<unsigned short> (500 + rand () % 1500);
+    if (i % 7 == 0)
+      depth[i] = 0;
+    if (i % 11 == 0)
+      depth[i] = parameters.no_sample_value;
+    if (i % 13 == 0)
+      depth[i] = parameters.shadow_value;
+    ir[i] = static_cast<unsigned short> (rand () % 1024);
+    rgb[i * 3] = static_cast<unsigned char> (rand () % 256);
+    rgb[i * 3 + 1] = static_cast<unsigned char> (rand () % 256);
+    rgb[i * 3 + 2] = static_cast<unsigned char> (rand () % 256);
+  }
+
+  PointCloud<PointXYZ> cloud_xyz;
+  PointCloud<PointXYZRGB> cloud_xyzrgb;
+  PointCloud<PointXYZI> cloud_xyzi;
+  pcl::io::convertDepthToPointCloud (parameters, &depth[0], cloud_xyz);
+  pcl::io::convertDepthToPointCloud (parameters, &depth[0], &rgb[0], cloud_xyzrgb);
+  pcl::io::convertDepthToPointCloud (parameters, &depth[0], &ir[0], cloud_xyzi);
+
+  EXPECT_EQ (cloud_xyz.width, parameters.width);
+  EXPECT_EQ (cloud_xyz.height, parameters.height);
+  EXPECT_EQ (cloud_xyz.points.size (), size);
+  EXPECT_EQ (cloud_xyzrgb.points.size (), size);
+  EXPECT_EQ (cloud_xyzi.points.size (), size);
+
+  const int center_x = parameters.width / 2;
+  const int center_y = parameters.height / 2;
+  for (size_t i = 0; i < size; ++i)
+  {
+    const int u = static_cast<int> (i % parameters.width) - center_x;
+    const int v = static_cast<int> (i / parameters.width) - center_y;
+
+    if (depth[i] == 0 || depth[i] == parameters.no_sample_value || depth[i] == parameters.shadow_value)
+    {
+      EXPECT_TRUE (pcl_isnan (cloud_xyz.points[i].x));
+      EXPECT_TRUE (pcl_isnan (cloud_xyz.points[i].y));
+      EXPECT_TRUE (pcl_isnan (cloud_xyz.points[i].z));
+      EXPECT_TRUE (pcl_isnan (cloud_xyzrgb.points[i].z));
+      EXPECT_TRUE (pcl_isnan (cloud_xyzi.points[i].z));
+    }
+    else
+    {
+      const float z = depth[i] * 0.001f;
+      EXPECT_FLOAT_EQ (cloud_xyz.points[i].z, z);
+      EXPECT_NEAR (cloud_xyz.points[i].x, u * z / parameters.focal_length, 1e-5);
+      EXPECT_NEAR (cloud_xyz.points[i].y, v * z / parameters.focal_length, 1e-5);
+      EXPECT_EQ (cloud_xyzrgb.points[i].x, cloud_xyz.points[i].x);
+      EXPECT_EQ (cloud_xyzrgb.points[i].y, cloud_xyz.points[i].y);
+      EXPECT_EQ (cloud_xyzrgb.points[i].z, cloud_xyz.points[i].z);
+      EXPECT_EQ (cloud_xyzi.points[i].x, cloud_xyz.points[i].x);
+    }
+
+    EXPECT_EQ (cloud_xyzrgb.points[i].r, rgb[i * 3]);
+    EXPECT_EQ (cloud_xyzrgb.points[i].g, rgb[i * 3 + 1]);
+    EXPECT_EQ (cloud_xyzrgb.points[i].b, rgb[i * 3 + 2]);
+    EXPECT_EQ (cloud_xyzi.points[i].intensity, ir[i]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+interpolateGreen (pcl::io::DebayeringMethod method, int h1, int h2, int v1, int v2)
+{
+  const int dh = abs (h1 - h2);
+  const int dv = abs (v1 - v2);
+  if (method == pcl::io::DEBAYERING_EDGE_AWARE && dh != dv)
+    return (dh > dv ? (v1 + v2) >> 1 : (h1 + h2) >> 1);
+  if (method == pcl::io::DEBAYERING_EDGE_AWARE_WEIGHTED && (dh != 0 || dv != 0))
+    return (((v1 + v2) * dh + (h1 + h2) * dv) / ((dh + dv) << 1));
+  return ((h1 + h2 + v1 + v2) >> 2);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ColorImageConversion)
+{
+  // odd number of 16 pixel blocks plus scalar remainder per row, padded RGB rows
+  const int width = 38, height = 8;
+  const unsigned rgb_line_step = width * 3 + 5;
+  std::vector<unsigned char> bayer (width * height), yuv (width * height * 2);
+  srand (0);
+  for (size_t i = 0; i < bayer.size (); ++i)
+    // few distinct values to hit equal gradients
+    bayer[i] = static_cast<unsigned char> (i % 3 == 0 ? (rand () % 3) * 100 : rand () % 256);
+  for (size_t i = 0; i < yuv.size (); ++i)
+    yuv[i] = static_cast<unsigned char> (rand () % 256);
+
+  const pcl::io::DebayeringMethod methods[] = {pcl::io::DEBAYERING_BILINEAR, pcl::io::DEBAYERING_EDGE_AWARE,
+                                               pcl::io::DEBAYERING_EDGE_AWARE_WEIGHTED};
+  for (int m = 0; m < 3; ++m)
+  {
+    std::vector<unsigned char> rgb (rgb_line_step * height, 7), rgb_threaded (rgb_line_step * height, 7);
+    pcl::io::debayerGRBGToRGB (&bayer[0], width, height, &rgb[0], rgb_line_step, methods[m], 1);
+    pcl::io::debayerGRBGToRGB (&bayer[0], width, height, &rgb_threaded[0], rgb_line_step, methods[m], 3);
+    EXPECT_TRUE (rgb == rgb_threaded);
+
+    // padding is left untouched
+    for (int y = 0; y < height; ++y)
+      for (unsigned i = width * 3; i < rgb_line_step; ++i)
+        EXPECT_EQ (rgb[y * rgb_line_step + i], 7);
+
+    // pixels with neighbors in all directions, GRGR rows are even, BGBG rows odd
+    for (int y = 2; y < height - 2; ++y)
+    {
+      for (int x = 2; x < width - 2; ++x)
+      {
+        const unsigned char *b = &bayer[y * width + x];
+        const unsigned char *pixel = &rgb[y * rgb_line_step + x * 3];
+        const int diagonal = (b[-width - 1] + b[-width + 1] + b[width - 1] + b[width + 1]) >> 2;
+        const int green = interpolateGreen (methods[m], b[-1], b[1], b[-width], b[width]);
+        int expected[3];
+        if (y % 2 == 0 && x % 2 == 0)
+        {
+          expected[0] = (b[-1] + b[1]) >> 1;
+          expected[1] = b[0];
+          expected[2] = (b[-width] + b[width]) >> 1;
+        }
+        else if (y % 2 == 0)
+        {
+          expected[0] = b[0];
+          expected[1] = green;
+          expected[2] = diagonal;
+        }
+        else if (x % 2 == 0)
+        {
+          expected[0] = diagonal;
+          expected[1] = green;
+          expected[2] = b[0];
+        }
+        else
+        {
+          expected[0] = (b[-width] + b[width]) >> 1;
+          expected[1] = b[0];
+          expected[2] = (b[-1] + b[1]) >> 1;
+        }
+        EXPECT_EQ (pixel[0], expected[0]);
+        EXPECT_EQ (pixel[1], expected[1]);
+        EXPECT_EQ (pixel[2], expected[2]);
+      }
+    }
+  }
+
+  std::vector<unsigned char> rgb (rgb_line_step * height, 7);
+  pcl::io::convertYUV422ToRGB (&yuv[0], width, height, &rgb[0], rgb_line_step, 2);
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      const unsigned char *group = &yuv[(y * width + (x & ~1)) * 2];
+      const int luma = group[1 + ((x & 1) << 1)];
+      const int u = group[0] - 128;
+      const int v = group[2] - 128;
+      const unsigned char *pixel = &rgb[y * rgb_line_step + x * 3];
+      EXPECT_EQ (pixel[0], std::max (0, std::min (255, luma + ((v * 18678 + 8192) >> 14))));
+      EXPECT_EQ (pixel[1], std::max (0, std::min (255, luma + ((v * -9519 - u * 6472 + 8192) >> 14))));
+      EXPECT_EQ (pixel[2], std::max (0, std::min (255, luma + ((u * 33292 + 8192) >> 14))));
+    }
+    EXPECT_EQ (rgb[y * rgb_line_step + width * 3], 7);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, FramePool)
+{
+  pcl::PointCloud<pcl::PointXYZ>* first;
+  pcl::FramePool<pcl::PointCloud<pcl::PointXYZ> >::Ptr outliving;
+  {
+    pcl::FramePool<pcl::PointCloud<pcl::PointXYZ> > pool (1);
+    EXPECT_EQ (pool.getCapacity (), 1u);
+
+    pcl::FramePool<pcl::PointCloud<pcl::PointXYZ> >::Ptr a = pool.acquire ();
+    a->points.resize (640 * 480);
+    first = a.get ();
+    a.reset ();
+    EXPECT_EQ (pool.getAvailable (), 1u);
+
+    // released frame is handed out again with its memory
+    a = pool.acquire ();
+    EXPECT_EQ (a.get (), first);
+    EXPECT_EQ (a->points.size (), 640u * 480u);
+    EXPECT_EQ (pool.getAvailable (), 0u);
+
+    // only capacity frames are kept
+    pcl::FramePool<pcl::PointCloud<pcl::PointXYZ> >::Ptr b = pool.acquire ();
+    EXPECT_NE (a.get (), b.get ());
+    a.reset ();
+    b.reset ();
+    EXPECT_EQ (pool.getAvailable (), 1u);
+
+    pool.setCapacity (0);
+    EXPECT_EQ (pool.getAvailable (), 0u);
+    pool.setCapacity (2);
+    outliving = pool.acquire ();
+  }
+  // frames may outlive the pool
+  outliving->points.resize (10);
+  outliving.reset ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct FrameRecorder
+{
+  FrameRecorder () : gate (false), frames (), busy_ (false), mutex_ (), cond_ () {}
+
+  void
+  record (const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud, int index)
+  {
+    boost::unique_lock<boost::mutex> lock (mutex_);
+    busy_ = true;
+    cond_.notify_all ();
+    while (gate)
+      cond_.wait (lock);
+    frames.push_back (std::make_pair (cloud, index));
+  }
+
+  void
+  waitUntilBusy ()
+  {
+    boost::unique_lock<boost::mutex> lock (mutex_);
+    while (!busy_)
+      cond_.wait (lock);
+  }
+
+  void
+  release ()
+  {
+    boost::unique_lock<boost::mutex> lock (mutex_);
+    gate = false;
+    cond_.notify_all ();
+  }
+
+  bool gate;
+  std::vector<std::pair<pcl::PointCloud<pcl::PointXYZ>::ConstPtr, int> > frames;
+  bool busy_;
+  boost::mutex mutex_;
+  boost::condition_variable cond_;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, CallbackQueue)
+{
+  typedef void (sig_cb) (const pcl::PointCloud<pcl::PointXYZ>::ConstPtr&, int);
+  pcl::FramePool<pcl::PointCloud<pcl::PointXYZ> > pool;
+  std::vector<pcl::PointCloud<pcl::PointXYZ>::Ptr> sent;
+  for (int i = 0; i < 6; ++i)
+    sent.push_back (pool.acquire ());
+
+  // blocking queue delivers every frame in order, without copying it
+  {
+    FrameRecorder recorder;
+    {
+      boost::shared_ptr<pcl::CallbackQueue> queue (new pcl::CallbackQueue (pcl::CallbackQueue::BLOCK, 2));
+      EXPECT_EQ (queue->getDeliveryPolicy (), pcl::CallbackQueue::BLOCK);
+      boost::function<sig_cb> slot = pcl::QueuedCallback<sig_cb> (queue, boost::bind (&FrameRecorder::record, &recorder, _1, _2));
+      for (int i = 0; i < 6; ++i)
+        slot (sent[i], i);
+      queue->stop ();
+      EXPECT_EQ (queue->getDroppedCount (), 0u);
+    }
+    ASSERT_EQ (recorder.frames.size (), 6u);
+    for (int i = 0; i < 6; ++i)
+    {
+      EXPECT_EQ (recorder.frames[i].first.get (), sent[i].get ());
+      EXPECT_EQ (recorder.frames[i].second, i);
+    }
+  }
+
+  // latest-only queue drops the oldest frames while the consumer is busy
+  {
+    FrameRecorder recorder;
+    recorder.gate = true;
+    pcl::CallbackQueue queue (pcl::CallbackQueue::LATEST_ONLY, 1);
+    queue.push (boost::bind (&FrameRecorder::record, &recorder, sent[0], 0));
+    recorder.waitUntilBusy ();
+    for (int i = 1; i < 6; ++i)
+      queue.push (boost::bind (&FrameRecorder::record, &recorder, sent[i], i));
+    EXPECT_EQ (queue.getDroppedCount (), 4u);
+    recorder.release ();
+    queue.stop ();
+
+    ASSERT_EQ (recorder.frames.size (), 2u);
+    EXPECT_EQ (recorder.frames[0].second, 0);
+    EXPECT_EQ (recorder.frames[1].second, 5);
+
+    // stopped queue drops further callbacks
+    queue.push (boost::bind (&FrameRecorder::record, &recorder, sent[0], 0));
+    EXPECT_EQ (queue.getDroppedCount (), 5u);
+    EXPECT_EQ (recorder.frames.size (), 2u);
+  }
+}
+
+#ifdef HAVE_OPENNI
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+recordCloud (const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &cloud, std::vector<float> *first_x)
+{
+  first_x->push_back (cloud->points[0].x);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCDGrabber)
+{
+  // binary, ASCII and compressed files, plus one that does not exist
+  std::vector<std::string> files;
+  PCDWriter writer;
+  for (int i = 0; i < 6; ++i)
+  {
+    PointCloud<PointXYZ> cloud;
+    cloud.width = 10;
+    cloud.height = 2;
+    cloud.points.resize (cloud.width * cloud.height);
+    for (size_t j = 0; j < cloud.points.size (); ++j)
+      cloud.points[j].x = cloud.points[j].y = cloud.points[j].z = static_cast<float> (i * 100 + j);
+
+    std::stringstream file_name;
+    file_name << "test_pcl_io_grabber_" << i << ".pcd";
+    files.push_back (file_name.str ());
+    if (i % 3 == 0)
+      writer.writeBinary (files.back (), cloud);
+    else if (i % 3 == 1)
+      writer.writeASCII (files.back (), cloud);
+    else
+      writer.writeBinaryCompressed (files.back (), cloud);
+  }
+  files.insert (files.begin () + 3, "test_pcl_io_grabber_missing.pcd");
+
+  for (int mode = 0; mode < 3; ++mode)
+  {
+    std::vector<float> first_x;
+    PCDGrabber<PointXYZ> grabber (files, mode == 2 ? -1.0f : 0.0f, false);
+    grabber.setNumberOfLoaderThreads (mode);
+    grabber.setReadAheadDepth (mode * 3);
+    grabber.setMemoryMapping (mode > 0);
+    boost::function<void (const PointCloud<PointXYZ>::ConstPtr&)> callback = boost::bind (&recordCloud, _1, &first_x);
+    grabber.registerCallback (callback);
+
+    if (mode == 2)
+    {
+      // as fast as possible, stops at the end of the list
+      grabber.start ();
+      while (grabber.isRunning ())
+        boost::this_thread::sleep (boost::posix_time::milliseconds (1));
+      EXPECT_GT (grabber.getThroughput (), 0.0);
+    }
+    else
+    {
+      for (int i = 0; i < 8; ++i)
+        grabber.start ();
+    }
+
+    // files that fail to load are skipped
+    ASSERT_EQ (first_x.size (), 6u);
+    for (int i = 0; i < 6; ++i)
+      EXPECT_EQ (first_x[i], i * 100);
+
+    grabber.rewind ();
+    grabber.start ();
+    while (grabber.isRunning ())
+      boost::this_thread::sleep (boost::posix_time::milliseconds (1));
+    EXPECT_EQ (first_x.size (), mode == 2 ? 12u : 7u);
+    EXPECT_EQ (first_x[6], 0);
+  }
+
+  for (size_t i = 0; i < files.size (); ++i)
+    remove (files[i].c_str ());
+}
+#endif
+
 /* ---[ */
 int
   main (int argc, char** argv)
@@ -168,6 +168,102 @@ TEST (PCL, Static_Range_Coder_Test)
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, Static_Rans_Coder_Test)
+{
+  size_t i;
+  std::stringstream sstream;
+  std::vector<char> inputCharData;
+  std::vector<char> outputCharData;
+
+  std::vector<unsigned int> inputIntData;
+  std::vector<unsigned int> outputIntData;
+
+  std::vector<char> codedBlock;
+
+  unsigned long writeByteLen;
+  unsigned long readByteLen;
+
+  // vector size
+  const unsigned int vectorSize = 1000;
+
+  inputCharData.resize(vectorSize);
+  outputCharData.resize(vectorSize);
+
+  inputIntData.resize(vectorSize);
+  outputIntData.resize(vectorSize);
+
+  // fill vectors with random data
+  for (i=0; i<vectorSize; i++)
+  {
+    inputCharData[i] = (char)rand() & 0xFF;
+    inputIntData[i]  = (unsigned int)rand() & 0xFFFF;
+  }
+
+  // initialize static rANS coder
+  pcl::StaticRansCoder ransCoder;
+
+  // encode char vector to stringstream
+  writeByteLen = ransCoder.encodeCharVectorToStream(inputCharData, sstream);
+
+  // decode stringstream to char vector
+  readByteLen = ransCoder.decodeStreamToCharVector(sstream, outputCharData);
+
+  // compare amount of bytes that are read and written to/from stream
+  EXPECT_EQ (writeByteLen, readByteLen);
+  EXPECT_EQ (writeByteLen, sstream.str().length());
+
+  // compare input and output vector - should be identical
+  EXPECT_EQ (inputCharData.size(), outputCharData.size());
+  EXPECT_EQ (inputCharData.size(), vectorSize);
+
+  for (i=0; i<vectorSize; i++)
+  {
+    EXPECT_EQ (inputCharData[i], outputCharData[i]);
+  }
+
+  // encode integer vector to stringstream
+  writeByteLen = ransCoder.encodeIntVectorToStream(inputIntData, sstream);
+
+  // decode stringstream to integer vector
+  readByteLen = ransCoder.decodeStreamToIntVector(sstream, outputIntData);
+
+  // compare amount of bytes that are read and written to/from stream
+  EXPECT_EQ (writeByteLen, readByteLen);
+
+  // compare input and output vector - should be identical
+  EXPECT_EQ (inputIntData.size(), outputIntData.size());
+  EXPECT_EQ (inputIntData.size(), vectorSize);
+
+  for (i=0; i<vectorSize; i++)
+  {
+    EXPECT_EQ (inputIntData[i], outputIntData[i]);
+  }
+
+  // fill char vector with skewed random data
+  for (i=0; i<vectorSize; i++)
+  {
+    inputCharData[i] = (rand() % 10) ? 0 : (char)(rand() % 8);
+  }
+
+  // encode char data to raw buffer
+  writeByteLen = ransCoder.encodeCharBuffer(&inputCharData[0], vectorSize, codedBlock);
+
+  // decode raw buffer to char data
+  readByteLen = ransCoder.decodeCharBuffer(&codedBlock[0], codedBlock.size(), &outputCharData[0], vectorSize);
+
+  // compare amount of bytes that are read and written to/from buffer
+  EXPECT_EQ (writeByteLen, readByteLen);
+  EXPECT_EQ (writeByteLen, codedBlock.size());
+  EXPECT_LT (writeByteLen, vectorSize / 2);
+
+  for (i=0; i<vectorSize; i++)
+  {
+    EXPECT_EQ (inputCharData[i], outputCharData[i]);
+  }
+
+}
+
 
 
 /* ---[ */
@@ -39,6 +39,38 @@
 #include "pcl/kdtree/kdtree_flann.h"
 #include <pcl/console/print.h>
 #include <flann/flann.hpp>
+#include <typeinfo>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Helper returning the coordinate columns of a structure-of-arrays cloud. Point types without a static
+      * xyz representation have no such columns.
+      */
+    template <typename PointT, bool xyz = StaticPointRepresentation<PointT>::value &&
+                                         StaticPointRepresentation<PointT>::dimensions == 3>
+    struct SoACoordinates
+    {
+      static inline bool
+      get (const PointCloudSoA<PointT> &cloud, const float *&x, const float *&y, const float *&z)
+      {
+        x = cloud.x (); y = cloud.y (); z = cloud.z ();
+        return (true);
+      }
+    };
+
+    template <typename PointT>
+    struct SoACoordinates<PointT, false>
+    {
+      static inline bool
+      get (const PointCloudSoA<PointT> &, const float *&, const float *&, const float *&)
+      {
+        return (false);
+      }
+    };
+  }
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Dist> void 
@@ -71,13 +103,40 @@ pcl::KdTreeFLANN<PointT, Dist>::setInputCloud (const PointCloudConstPtr &cloud,
   m_lock_.unlock ();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> void 
+pcl::KdTreeFLANN<PointT, Dist>::setInputCloudSoA (const PointCloudSoA<PointT> &cloud, const IndicesConstPtr &indices)
+{
+  cleanup ();   // Perform an automatic cleanup of structures
+
+  if (!initParameters())
+    return;
+
+  input_.reset ();
+  indices_ = indices;
+
+  // The columns hold the coordinates only, so they can stand in for the default xyz representation alone
+  if (!static_representation_ || dim_ != 3)
+  {
+    PCL_ERROR ("[pcl::KdTreeFLANN::setInputCloudSoA] Structure-of-arrays input requires the default xyz point representation!\n");
+    return;
+  }
+
+  m_lock_.lock ();
+  convertColumnsToArray (cloud, indices_);
+
+  initData ();
+  m_lock_.unlock ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Dist> int 
 pcl::KdTreeFLANN<PointT, Dist>::nearestKSearch (const PointT &point, int k, 
                                                 std::vector<int> &k_indices, 
                                                 std::vector<float> &k_distances)
 {
-  if (!point_representation_->isValid (point))
+  std::vector<float> tmp (dim_);
+  if (!vectorizePoint (point, &tmp[0]))
   {
     //PCL_ERROR_STREAM ("[pcl::KdTreeFLANN::nearestKSearch] Invalid query point given!" << point);
     return (0);
@@ -88,9 +147,6 @@ pcl::KdTreeFLANN<PointT, Dist>::nearestKSearch (const PointT &point, int k,
   if (k_distances.size () < (size_t)k) 
     k_distances.resize (k);
 
-  std::vector<float> tmp (dim_);
-  point_representation_->vectorize ((PointT)point, tmp);
-
   flann::Matrix<int> k_indices_mat (&k_indices[0], 1, k);
   flann::Matrix<float> k_distances_mat (&k_distances[0], 1, k);
   flann_index_->knnSearch (flann::Matrix<float>(&tmp[0], 1, dim_), k_indices_mat, k_distances_mat, k, flann::SearchParams (-1 ,epsilon_));
@@ -116,14 +172,12 @@ pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius
   static flann::Matrix<int> indices_empty;
   static flann::Matrix<float> dists_empty;
 
-  if (!point_representation_->isValid (point))
+  std::vector<float> tmp(dim_);
+  if (!vectorizePoint (point, &tmp[0]))
   {
     //PCL_ERROR_STREAM ("[pcl::KdTreeFLANN::radiusSearch] Invalid query point given!" << point);
     return 0;
   }
-
-  std::vector<float> tmp(dim_);
-  point_representation_->vectorize ((PointT)point, tmp);
   radius *= radius; // flann uses squared radius
 
   size_t size;
@@ -200,6 +254,11 @@ pcl::KdTreeFLANN<PointT, Dist>::initParameters ()
 {
   epsilon_ = 0.0;   // default error bound value
   dim_ = point_representation_->getNumberOfDimensions (); // Number of dimensions - default is 3 = xyz
+  // Subclasses of the default representation may override its methods, so the exact type is checked
+  static_representation_ = StaticPointRepresentation<PointT>::value &&
+                           typeid (*point_representation_) == typeid (DefaultPointRepresentation<PointT>) &&
+                           !point_representation_->isRescaled () &&
+                           dim_ == StaticPointRepresentation<PointT>::dimensions;
   // Create the kd_tree representation
   return (true);
 }
@@ -233,17 +292,14 @@ pcl::KdTreeFLANN<PointT, Dist>::convertCloudToArray (const PointCloud &cloud)
 
   for (int cloud_index = 0; cloud_index < original_no_of_points; ++cloud_index)
   {
-    const PointT point = cloud.points[cloud_index];
     // Check if the point is invalid
-    if (!point_representation_->isValid (point))
+    if (!vectorizePoint (cloud.points[cloud_index], cloud_ptr))
     {
       identity_mapping_ = false;
       continue;
     }
 
     index_mapping_.push_back(cloud_index);
-
-    point_representation_->vectorize(point, cloud_ptr);
     cloud_ptr += dim_;
   }
 }
@@ -269,9 +325,8 @@ pcl::KdTreeFLANN<PointT, Dist>::convertCloudToArray (const PointCloud &cloud, co
   for (int indices_index = 0; indices_index < original_no_of_points; ++indices_index)
   {
     int cloud_index = indices[indices_index];
-    const PointT point = cloud.points[cloud_index];
     // Check if the point is invalid
-    if (!point_representation_->isValid(point)) {
+    if (!vectorizePoint (cloud.points[cloud_index], cloud_ptr)) {
       identity_mapping_ = false;
       continue;
     }
@@ -279,7 +334,45 @@ pcl::KdTreeFLANN<PointT, Dist>::convertCloudToArray (const PointCloud &cloud, co
     index_mapping_.push_back(indices_index);  // If the returned index should be for the indices vector
     //index_mapping_.push_back(cloud_index);  // If the returned index should be for the ros cloud
     
-    point_representation_->vectorize(point, cloud_ptr);
+    cloud_ptr += dim_;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> void 
+pcl::KdTreeFLANN<PointT, Dist>::convertColumnsToArray (const PointCloudSoA<PointT> &cloud, const IndicesConstPtr &indices)
+{
+  const float *x, *y, *z;
+
+  // No point in doing anything if the array is empty
+  if (cloud.empty () || !detail::SoACoordinates<PointT>::get (cloud, x, y, z))
+  {
+    cloud_ = NULL;
+    return;
+  }
+
+  int original_no_of_points = indices ? (int)indices->size () : (int)cloud.size ();
+
+  cloud_ = (float*)malloc (original_no_of_points * dim_ * sizeof (float));
+  float* cloud_ptr = cloud_;
+  index_mapping_.reserve(original_no_of_points);
+  identity_mapping_ = true;
+
+  for (int indices_index = 0; indices_index < original_no_of_points; ++indices_index)
+  {
+    int cloud_index = indices ? (*indices)[indices_index] : indices_index;
+    // Check if the point is invalid
+    if (!pcl_isfinite (x[cloud_index]) || !pcl_isfinite (y[cloud_index]) || !pcl_isfinite (z[cloud_index]))
+    {
+      identity_mapping_ = false;
+      continue;
+    }
+
+    cloud_ptr[0] = x[cloud_index];
+    cloud_ptr[1] = y[cloud_index];
+    cloud_ptr[2] = z[cloud_index];
+
+    index_mapping_.push_back(indices_index);
     cloud_ptr += dim_;
   }
 }
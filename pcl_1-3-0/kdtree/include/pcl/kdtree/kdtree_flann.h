@@ -42,6 +42,7 @@
 
 #include <cstdio>
 #include <pcl/kdtree/kdtree.h>
+#include <pcl/point_cloud_soa.h>
 #include <boost/thread/mutex.hpp>
 
 namespace flann
@@ -88,7 +89,8 @@ namespace pcl
         *
         * By setting sorted to false, the \ref radiusSearch operations will be faster.
         */
-      KdTreeFLANN (bool sorted = true) : pcl::KdTree<PointT> (sorted), flann_index_(NULL), cloud_(NULL)
+      KdTreeFLANN (bool sorted = true) : pcl::KdTree<PointT> (sorted), flann_index_(NULL), cloud_(NULL),
+                                         static_representation_ (false)
       {
         cleanup ();
       }
@@ -129,6 +131,7 @@ namespace pcl
         index_mapping_ = tree.index_mapping_;
         dim_ = tree.dim_;
         sorted_ = tree.sorted_;
+        static_representation_ = tree.static_representation_;
       }
 
 
@@ -147,6 +150,15 @@ namespace pcl
       void 
       setInputCloud (const PointCloudConstPtr &cloud, const IndicesConstPtr &indices = IndicesConstPtr ());
 
+      /** \brief Build the tree from the x, y and z columns of a structure-of-arrays dataset.
+        * \param[in] cloud the structure-of-arrays input dataset
+        * \param[in] indices the point indices subset that is to be used from \a cloud - if NULL the whole cloud is used
+        * \note Only available with the default xyz point representation. No PointCloud is stored, so the zero-copy
+        * searches by index return 0 neighbors.
+        */
+      void 
+      setInputCloudSoA (const PointCloudSoA<PointT> &cloud, const IndicesConstPtr &indices = IndicesConstPtr ());
+
       /** \brief Search for k-nearest neighbors for the given query point.
         * \param[in] point the given query point
         * \param[in[ k the number of neighbors to search for
@@ -190,6 +202,8 @@ namespace pcl
       nearestKSearch (int index, int k, 
                       std::vector<int> &k_indices, std::vector<float> &k_distances)
       {
+        if (!input_)
+          return (0);
         if (indices_ == NULL)
         {
           if (index >= (int)input_->points.size ())
@@ -248,6 +262,8 @@ namespace pcl
       radiusSearch (int index, double radius, std::vector<int> &k_indices,
                     std::vector<float> &k_distances, int max_nn = -1) const
       {
+        if (!input_)
+          return (0);
         if (indices_ == NULL)
         {
           if (index >= (int)input_->points.size ())
@@ -272,6 +288,23 @@ namespace pcl
       /** \brief Simple initialization method for internal data buffers. */
       void initData ();
 
+      /** \brief Convert a point into its k-D vector, applying the point representation statically if possible.
+        * \param[in] point the input point
+        * \param[out] out the output vector, dim_ long
+        * \return false if the point is not valid
+        */
+      inline bool
+      vectorizePoint (const PointT &point, float *out) const
+      {
+        if (StaticPointRepresentation<PointT>::value && static_representation_)
+          return (vectorizeStatic (point, out));
+
+        if (!point_representation_->isValid (point))
+          return (false);
+        point_representation_->vectorize (point, out);
+        return (true);
+      }
+
       /** \brief Converts a ROS PointCloud message to the internal FLANN point array representation. Returns the number
         * of points.
         * \param ros_cloud the ROS PointCloud message
@@ -287,6 +320,14 @@ namespace pcl
       void 
       convertCloudToArray (const PointCloud &cloud, const std::vector<int> &indices);
 
+      /** \brief Converts the coordinate columns of a structure-of-arrays dataset to the internal FLANN point array
+        * representation.
+        * \param cloud the structure-of-arrays dataset
+        * \param indices the point indices to use from \a cloud - if NULL the whole cloud is used
+        */
+      void 
+      convertColumnsToArray (const PointCloudSoA<PointT> &cloud, const IndicesConstPtr &indices);
+
     private:
       /** \brief Class getName method. */
       virtual std::string 
@@ -308,6 +349,10 @@ namespace pcl
 
       /** \brief Tree dimensionality (i.e. the number of dimensions per point). */
       int dim_;
+
+      /** \brief Whether the point representation is the default one of PointT, which is then applied by
+        * StaticPointRepresentation instead of the virtual interface. */
+      bool static_representation_;
   };
 }
 
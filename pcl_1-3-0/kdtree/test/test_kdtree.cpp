@@ -38,6 +38,7 @@
 #include <gtest/gtest.h>
 
 #include <iostream>  // For debug
+#include <limits>
 #include <map>
 using namespace std;
 
@@ -45,6 +46,7 @@ using namespace std;
 #include <pcl/kdtree/kdtree_flann.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
+#include <boost/make_shared.hpp>
 using namespace pcl;
 
 struct MyPoint : public PointXYZ 
@@ -270,6 +272,131 @@ TEST (PCL, KdTreeFLANN_setPointRepresentation)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, KdTreeFLANN_staticPointRepresentation)
+{
+  PointCloud<PointXYZ>::Ptr xyz_cloud (new PointCloud<PointXYZ> ());
+  for (size_t i = 0; i < cloud_big.points.size (); i += 97)
+  {
+    PointXYZ point;
+    point.x = cloud_big.points[i].x;
+    point.y = cloud_big.points[i].y;
+    point.z = (i % 5 == 0) ? std::numeric_limits<float>::quiet_NaN () : cloud_big.points[i].z;
+    xyz_cloud->points.push_back (point);
+  }
+  xyz_cloud->width = xyz_cloud->points.size ();
+  xyz_cloud->height = 1;
+
+  // the default representation is applied statically, the others through the virtual interface
+  KdTreeFLANN<PointXYZ> static_tree, custom_tree, rescaled_tree;
+  static_tree.setInputCloud (xyz_cloud);
+  custom_tree.setPointRepresentation (CustomPointRepresentation<PointXYZ> (3).makeShared ());
+  custom_tree.setInputCloud (xyz_cloud);
+  DefaultPointRepresentation<PointXYZ> rescaled;
+  float alpha[3] = {1.0f, 1.0f, 1.0f};
+  rescaled.setRescaleValues (alpha);
+  EXPECT_TRUE (rescaled.isRescaled ());
+  EXPECT_FALSE (DefaultPointRepresentation<PointXYZ> ().isRescaled ());
+  rescaled_tree.setPointRepresentation (boost::make_shared<DefaultPointRepresentation<PointXYZ> > (rescaled));
+  rescaled_tree.setInputCloud (xyz_cloud);
+
+  const int k = 8;
+  for (size_t i = 0; i < xyz_cloud->points.size (); i += 13)
+  {
+    const PointXYZ &query = xyz_cloud->points[i];
+    vector<int> static_indices, custom_indices, rescaled_indices;
+    vector<float> static_distances, custom_distances, rescaled_distances;
+
+    int found = static_tree.nearestKSearch (query, k, static_indices, static_distances);
+    EXPECT_EQ (found, custom_tree.nearestKSearch (query, k, custom_indices, custom_distances));
+    EXPECT_EQ (found, rescaled_tree.nearestKSearch (query, k, rescaled_indices, rescaled_distances));
+    EXPECT_EQ (found, pcl_isfinite (query.z) ? k : 0);
+    for (int j = 0; j < found; ++j)
+    {
+      EXPECT_EQ (static_indices[j], custom_indices[j]);
+      EXPECT_EQ (static_indices[j], rescaled_indices[j]);
+      EXPECT_TRUE (pcl_isfinite (xyz_cloud->points[static_indices[j]].z));
+    }
+
+    found = static_tree.radiusSearch (query, 64.0, static_indices, static_distances);
+    EXPECT_EQ (found, custom_tree.radiusSearch (query, 64.0, custom_indices, custom_distances));
+    for (int j = 0; j < found; ++j)
+    {
+      EXPECT_EQ (static_indices[j], custom_indices[j]);
+      EXPECT_EQ (static_distances[j], custom_distances[j]);
+    }
+  }
+
+  // feature histograms are copied field by field
+  FPFHSignature33 feature;
+  for (int i = 0; i < 33; ++i)
+    feature.histogram[i] = static_cast<float> (i);
+  float vector_static[33], vector_virtual[33];
+  EXPECT_TRUE (vectorizeStatic (feature, vector_static));
+  DefaultPointRepresentation<FPFHSignature33> ().vectorize (feature, vector_virtual);
+  EXPECT_EQ (static_cast<int> (StaticPointRepresentation<FPFHSignature33>::dimensions),
+             DefaultPointRepresentation<FPFHSignature33> ().getNumberOfDimensions ());
+  for (int i = 0; i < 33; ++i)
+    EXPECT_EQ (vector_static[i], vector_virtual[i]);
+  feature.histogram[7] = std::numeric_limits<float>::quiet_NaN ();
+  EXPECT_FALSE (vectorizeStatic (feature, vector_static));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, KdTreeFLANN_structureOfArrays)
+{
+  PointCloud<PointXYZ>::Ptr xyz_cloud (new PointCloud<PointXYZ> ());
+  for (size_t i = 0; i < cloud_big.points.size (); i += 97)
+  {
+    PointXYZ point;
+    point.x = cloud_big.points[i].x;
+    point.y = (i % 7 == 0) ? std::numeric_limits<float>::quiet_NaN () : cloud_big.points[i].y;
+    point.z = cloud_big.points[i].z;
+    xyz_cloud->points.push_back (point);
+  }
+  xyz_cloud->width = xyz_cloud->points.size ();
+  xyz_cloud->height = 1;
+  xyz_cloud->is_dense = false;
+
+  boost::shared_ptr<vector<int> > indices (new vector<int> ());
+  for (int i = 0; i < (int)xyz_cloud->points.size (); i += 3)
+    indices->push_back (i);
+
+  // the tree built from the coordinate columns has to match the one built from the points
+  PointCloudSoA<PointXYZ> soa_cloud (*xyz_cloud);
+  KdTreeFLANN<PointXYZ> aos_tree, soa_tree, aos_indices_tree, soa_indices_tree;
+  aos_tree.setInputCloud (xyz_cloud);
+  soa_tree.setInputCloudSoA (soa_cloud);
+  aos_indices_tree.setInputCloud (xyz_cloud, indices);
+  soa_indices_tree.setInputCloudSoA (soa_cloud, indices);
+
+  const int k = 8;
+  for (size_t i = 0; i < xyz_cloud->points.size (); i += 11)
+  {
+    const PointXYZ &query = xyz_cloud->points[i];
+    vector<int> aos_indices, soa_indices;
+    vector<float> aos_distances, soa_distances;
+
+    int found = aos_tree.nearestKSearch (query, k, aos_indices, aos_distances);
+    EXPECT_EQ (found, soa_tree.nearestKSearch (query, k, soa_indices, soa_distances));
+    for (int j = 0; j < found; ++j)
+    {
+      EXPECT_EQ (aos_indices[j], soa_indices[j]);
+      EXPECT_EQ (aos_distances[j], soa_distances[j]);
+    }
+
+    found = aos_indices_tree.radiusSearch (query, 64.0, aos_indices, aos_distances);
+    EXPECT_EQ (found, soa_indices_tree.radiusSearch (query, 64.0, soa_indices, soa_distances));
+    for (int j = 0; j < found; ++j)
+      EXPECT_EQ (aos_indices[j], soa_indices[j]);
+  }
+
+  // no PointCloud is stored, so there is no query point for a search by index
+  vector<int> k_indices;
+  vector<float> k_distances;
+  EXPECT_EQ (soa_tree.nearestKSearch (0, k, k_indices, k_distances), 0);
+}
+
 /* ---[ */
 int
   main (int argc, char** argv)
@@ -52,7 +52,7 @@ namespace pcl
       {
 
         // Initialization of globals
-        rootNode_ = new OctreeBranch ();
+        createBranch (rootNode_);
         leafCount_ = 0;
         branchCount_ = 1;
         objectCount_ = 0;
@@ -68,9 +68,7 @@ namespace pcl
       Octree2BufBase<DataT, LeafT>::~Octree2BufBase ()
       {
 
-        // deallocate tree structure
-        deleteTree ();
-        delete (rootNode_);
+        // deallocate tree structure and node pools
         poolCleanUp ();
       }
 
@@ -186,24 +184,25 @@ namespace pcl
       Octree2BufBase<DataT, LeafT>::deleteTree ( bool freeMemory_arg )
       {
 
-        if (rootNode_)
-        {
-          // reset octree
-          deleteBranch (*rootNode_);
-          leafCount_ = 0;
-          branchCount_ = 1;
-          objectCount_ = 0;
-
-          resetTree_ = false;
-          treeDirtyFlag_ = false;
-          depthMask_ = 0;
-          octreeDepth_ = 0;
-        }
+        // return all nodes of both buffers to the node pools
+        branchPool_.reset ();
+        leafPool_.reset ();
 
         // delete node pool
         if (freeMemory_arg)
           poolCleanUp ();
 
+        // reset octree
+        createBranch (rootNode_);
+        leafCount_ = 0;
+        branchCount_ = 1;
+        objectCount_ = 0;
+
+        resetTree_ = false;
+        treeDirtyFlag_ = false;
+        depthMask_ = 0;
+        octreeDepth_ = 0;
+
       }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
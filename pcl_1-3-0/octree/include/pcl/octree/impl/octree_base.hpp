@@ -58,7 +58,7 @@ namespace pcl
       {
 
         // Initialization of globals
-        rootNode_ = new OctreeBranch ();
+        createBranch (rootNode_);
         leafCount_ = 0;
         depthMask_ = 0;
         branchCount_ = 1;
@@ -72,9 +72,7 @@ namespace pcl
       OctreeBase<DataT, LeafT>::~OctreeBase ()
       {
 
-        // deallocate tree structure
-        deleteTree ();
-        delete (rootNode_);
+        // deallocate tree structure and node pools
         poolCleanUp ();
       }
 
@@ -195,20 +193,20 @@ namespace pcl
       OctreeBase<DataT, LeafT>::deleteTree (  bool freeMemory_arg )
       {
 
-        if (rootNode_)
-        {
-          // reset octree
-          deleteBranch (*rootNode_);
-          leafCount_ = 0;
-          branchCount_ = 1;
-          objectCount_ = 0;
-
-        }
+        // return all nodes to the node pools
+        branchPool_.reset ();
+        leafPool_.reset ();
 
         // delete node pool
         if (freeMemory_arg)
           poolCleanUp ();
 
+        // reset octree
+        createBranch (rootNode_);
+        leafCount_ = 0;
+        branchCount_ = 1;
+        objectCount_ = 0;
+
       }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -478,8 +476,7 @@ namespace pcl
             if (!bBranchOccupied)
             {
               // child branch does not own any sub-child nodes anymore -> delete child branch
-              delete (childBranch);
-              setBranchChild (*branch_arg, childIdx, 0);
+              deleteBranchChild (*branch_arg, childIdx);
               branchCount_--;
             }
           }
@@ -54,11 +54,12 @@ namespace pcl
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename DataT, typename LeafT>
-      OctreeLowMemBase<DataT, LeafT>::OctreeLowMemBase ()
+      OctreeLowMemBase<DataT, LeafT>::OctreeLowMemBase () :
+        branchPool_ (1, FREE_RELEASED_NODES), leafPool_ (1, FREE_RELEASED_NODES)
       {
 
         // Initialization of globals
-        rootNode_ = new OctreeBranch ();
+        createBranch (rootNode_);
         leafCount_ = 0;
         depthMask_ = 0;
         branchCount_ = 1;
@@ -74,7 +75,7 @@ namespace pcl
 
         // deallocate tree structure
         deleteTree ();
-        delete (rootNode_);
+        branchPool_.pushNode (rootNode_);
       }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -194,15 +195,13 @@ namespace pcl
       OctreeLowMemBase<DataT, LeafT>::deleteTree ( )
       {
 
-        if (rootNode_)
-        {
-          // reset octree
-          deleteBranch (*rootNode_);
-          leafCount_ = 0;
-          branchCount_ = 1;
-          objectCount_ = 0;
+        // free all nodes below the root - the node pools release them immediately
+        deleteBranch (*rootNode_);
 
-        }
+        // reset octree
+        leafCount_ = 0;
+        branchCount_ = 1;
+        objectCount_ = 0;
 
       }
 
@@ -477,8 +476,7 @@ namespace pcl
             if (!bBranchOccupied)
             {
               // child branch does not own any sub-child nodes anymore -> delete child branch
-              delete (childBranch);
-              setBranchChild (*branch_arg, childIdx, 0);
+              deleteBranchChild (*branch_arg, childIdx);
               branchCount_--;
             }
           }
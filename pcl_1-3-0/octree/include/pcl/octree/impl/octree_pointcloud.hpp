@@ -41,6 +41,9 @@
 
 #include <vector>
 #include <assert.h>
+#include <string.h>
+
+#include <boost/cstdint.hpp>
 
 #include "pcl/common/common.h"
 
@@ -55,7 +58,7 @@ namespace pcl
     template<typename PointT, typename LeafT, typename OctreeT>
       OctreePointCloud<PointT, LeafT, OctreeT>::OctreePointCloud (const double resolution) :
         OctreeT (), epsilon_ (0), resolution_ (resolution), minX_ (0.0f), maxX_ (resolution), minY_ (0.0f),
-            maxY_ (resolution), minZ_ (0.0f), maxZ_ (resolution), maxKeys_ (1), boundingBoxDefined_ (false)
+            maxY_ (resolution), minZ_ (0.0f), maxZ_ (resolution), maxKeys_ (1), boundingBoxDefined_ (false), threads_ (1)
       {
         assert ( resolution > 0.0f );
         input_ = PointCloudConstPtr ();
@@ -68,6 +71,54 @@ namespace pcl
 
       }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /** \brief Spread the lower 21 bits of a value to every third bit of a 64 bit Morton code. */
+    inline boost::uint64_t
+    expandMortonBits (unsigned int value_arg)
+    {
+      boost::uint64_t x = value_arg & 0x1fffff;
+
+      x = (x | (x << 32)) & 0x1f00000000ffffULL;
+      x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+      x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+      x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+      x = (x | (x << 2)) & 0x1249249249249249ULL;
+
+      return (x);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /** \brief Compare two octree keys in Morton (depth-first octree) order. The x axis is the most significant one,
+     *  matching the child index (x << 2 | y << 1 | z) of octree branches.
+     */
+    template<typename OctreeKeyT>
+      struct MortonKeyLess
+      {
+        MortonKeyLess (const std::vector<OctreeKeyT>& keys_arg) : keys_ (keys_arg)
+        {
+        }
+
+        inline bool
+        operator () (unsigned int a_arg, unsigned int b_arg) const
+        {
+          const OctreeKeyT& a = keys_[a_arg];
+          const OctreeKeyT& b = keys_[b_arg];
+
+          unsigned int diffX = a.x ^ b.x;
+          unsigned int diffY = a.y ^ b.y;
+          unsigned int diffZ = a.z ^ b.z;
+
+          // select the axis holding the most significant differing bit
+          if ((diffX >= diffY || diffX >= (diffX ^ diffY)) && (diffX >= diffZ || diffX >= (diffX ^ diffZ)))
+            return (a.x < b.x);
+          if (diffY >= diffZ || diffY >= (diffY ^ diffZ))
+            return (a.y < b.y);
+          return (a.z < b.z);
+        }
+
+        const std::vector<OctreeKeyT>& keys_;
+      };
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename PointT, typename LeafT, typename OctreeT>
       void
@@ -77,34 +128,152 @@ namespace pcl
 
         assert (this->leafCount_==0);
 
+        // collect indices of all valid points in insertion order
+        std::vector<int> pointIndices;
+        if (indices_)
         {
-          if (indices_)
+          pointIndices.reserve (indices_->size ());
+          for (i = 0; i < indices_->size (); i++)
           {
-            std::vector<int>::const_iterator current = indices_->begin ();
-            while (current != indices_->end ())
-            {
-              if ((input_->points[*current].x == input_->points[*current].x) && (input_->points[*current].y
-                  == input_->points[*current].y) && (input_->points[*current].z == input_->points[*current].z))
-              {
-                // add points to octree
-                this->addPointIdx (*current);
-                ++current;
-              }
-            }
+            const PointT& point = input_->points[(*indices_)[i]];
+            if ((point.x == point.x) && (point.y == point.y) && (point.z == point.z))
+              pointIndices.push_back ((*indices_)[i]);
           }
-          else
+        }
+        else
+        {
+          pointIndices.reserve (input_->points.size ());
+          for (i = 0; i < input_->points.size (); i++)
           {
-            for (i = 0; i < input_->points.size (); i++)
-            {
-              if ((input_->points[i].x == input_->points[i].x) && (input_->points[i].y == input_->points[i].y)
-                  && (input_->points[i].z == input_->points[i].z))
-              {
-                // add points to octree
-                this->addPointIdx ((unsigned int)i);
-              }
-            }
+            const PointT& point = input_->points[i];
+            if ((point.x == point.x) && (point.y == point.y) && (point.z == point.z))
+              pointIndices.push_back ((int)i);
           }
+        }
+
+        if (pointIndices.empty ())
+          return;
+
+        const int pointCount = (int)pointIndices.size ();
+
+        // The first point defines the bounding box. All following points only grow the bounding box (and add levels
+        // on top of the root node) - this is done in input order, so the octree ends up with the same bounding box
+        // and depth as if the points were added one by one. Each growth starts a new epoch of points whose keys are
+        // generated against the bounding box of that epoch and are shifted afterwards into the final key space.
+        addPointIdx (pointIndices[0]);
+
+        std::vector<int> epochBegin;
+        std::vector<double> epochMin;
+        std::vector<unsigned int> epochShift;
+
+        epochBegin.push_back (0);
+        epochMin.push_back (minX_); epochMin.push_back (minY_); epochMin.push_back (minZ_);
+        epochShift.push_back (0); epochShift.push_back (0); epochShift.push_back (0);
+
+        for (int p = 1; p < pointCount; p++)
+        {
+          const PointT& point = input_->points[pointIndices[p]];
+          if (isPointWithinBoundingBox (point))
+            continue;
+
+          double prevMin[3] = {minX_, minY_, minZ_};
 
+          adoptBoundingBoxToPoint (point);
+
+          // the previous tree ends up in the upper half of the new root if the lower bound was moved
+          unsigned int shift[3];
+          shift[0] = (unsigned int)floor ((prevMin[0] - minX_) / resolution_ + 0.5);
+          shift[1] = (unsigned int)floor ((prevMin[1] - minY_) / resolution_ + 0.5);
+          shift[2] = (unsigned int)floor ((prevMin[2] - minZ_) / resolution_ + 0.5);
+
+          for (size_t e = 0; e < epochShift.size (); e++)
+            epochShift[e] += shift[e % 3];
+
+          epochBegin.push_back (p);
+          epochMin.push_back (minX_); epochMin.push_back (minY_); epochMin.push_back (minZ_);
+          epochShift.push_back (0); epochShift.push_back (0); epochShift.push_back (0);
+        }
+        epochBegin.push_back (pointCount);
+
+        // generate octree keys in parallel
+        std::vector<OctreeKey> keys (pointCount);
+        const bool useMortonCodes = (this->octreeDepth_ <= 21);
+        std::vector<boost::uint64_t> codes (useMortonCodes ? pointCount : 0);
+
+        for (size_t e = 0; e + 1 < epochBegin.size (); e++)
+        {
+          const double minX = epochMin[e * 3 + 0];
+          const double minY = epochMin[e * 3 + 1];
+          const double minZ = epochMin[e * 3 + 2];
+
+          const unsigned int shiftX = epochShift[e * 3 + 0];
+          const unsigned int shiftY = epochShift[e * 3 + 1];
+          const unsigned int shiftZ = epochShift[e * 3 + 2];
+
+#pragma omp parallel for schedule (static) num_threads (threads_)
+          for (int p = epochBegin[e]; p < epochBegin[e + 1]; p++)
+          {
+            const PointT& point = input_->points[pointIndices[p]];
+            OctreeKey& key = keys[p];
+
+            key.x = (unsigned int)((point.x - minX) / resolution_) + shiftX;
+            key.y = (unsigned int)((point.y - minY) / resolution_) + shiftY;
+            key.z = (unsigned int)((point.z - minZ) / resolution_) + shiftZ;
+
+            if (useMortonCodes)
+              codes[p] = (expandMortonBits (key.x) << 2) | (expandMortonBits (key.y) << 1) | expandMortonBits (key.z);
+          }
+        }
+
+        // sort points in Morton order - stable, so points within a voxel keep their input order
+        std::vector<unsigned int> order (pointCount);
+        for (int p = 0; p < pointCount; p++)
+          order[p] = p;
+
+        if (useMortonCodes)
+        {
+          // least significant digit radix sort with 8 bit digits
+          std::vector<unsigned int> orderBuffer (pointCount);
+          const unsigned int codeBits = 3 * this->octreeDepth_;
+
+          for (unsigned int shift = 0; shift < codeBits; shift += 8)
+          {
+            size_t histogram[257];
+            memset (histogram, 0, sizeof(histogram));
+
+            for (int p = 0; p < pointCount; p++)
+              histogram[((codes[order[p]] >> shift) & 0xff) + 1]++;
+
+            for (unsigned int d = 0; d < 256; d++)
+              histogram[d + 1] += histogram[d];
+
+            for (int p = 0; p < pointCount; p++)
+              orderBuffer[histogram[(codes[order[p]] >> shift) & 0xff]++] = order[p];
+
+            order.swap (orderBuffer);
+          }
+        }
+        else
+        {
+          std::stable_sort (order.begin (), order.end (), MortonKeyLess<OctreeKey> (keys));
+        }
+
+        // add points voxel by voxel - the first point is already part of the octree
+        int p = 0;
+        while (p < pointCount)
+        {
+          const OctreeKey& key = keys[order[p]];
+          LeafT* leaf = this->getLeaf (key);
+
+          do
+          {
+            if (order[p] != 0)
+            {
+              leaf->setData (pointIndices[order[p]]);
+              this->objectCount_++;
+            }
+            p++;
+          } while ((p < pointCount) && (keys[order[p]] == key));
         }
       }
 
@@ -41,6 +41,7 @@
 
 #include <pcl/common/common.h>
 #include <assert.h>
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafT, typename OctreeT> bool
@@ -78,39 +79,16 @@ template<typename PointT, typename LeafT, typename OctreeT> int
 pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::nearestKSearch (
     const PointT &p_q, int k, std::vector<int> &k_indices, std::vector<float> &k_sqr_distances)
 {
-  unsigned int i;
-  unsigned int resultCount;
-
-  prioPointQueueEntry pointEntry;
-  std::vector<prioPointQueueEntry> pointCandidates;
-
   assert (this->leafCount_>0);
 
-  OctreeKey key;
-  key.x = key.y = key.z = 0;
-
-  // initalize smallest point distance in search with high value
-  double smallestDist = numeric_limits<double>::max ();
-
-  k_indices.clear ();
-  k_sqr_distances.clear ();
-
-  getKNearestNeighborRecursive (p_q, k, this->rootNode_, key, 1, smallestDist, pointCandidates);
-
-  resultCount = pointCandidates.size ();
-
-  for (i = 0; i < resultCount; i++)
+  if (k <= 0)
   {
-    pointEntry = pointCandidates.back ();
-
-    k_indices.push_back (pointEntry.pointIdx_);
-    k_sqr_distances.push_back (pointEntry.pointDistance_);
-
-    pointCandidates.pop_back ();
+    k_indices.clear ();
+    k_sqr_distances.clear ();
+    return (0);
   }
 
-  return k_indices.size ();
-
+  return (getKNearestNeighbors (p_q, k, k_indices, k_sqr_distances));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -151,16 +129,7 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::radiusSearch (
     const PointT &p_q, const double radius, std::vector<int> &k_indices, 
     std::vector<float> &k_sqr_distances, int max_nn) const
 {
-  OctreeKey key;
-  key.x = key.y = key.z = 0;
-
-  k_indices.clear ();
-  k_sqr_distances.clear ();
-
-  getNeighborsWithinRadiusRecursive (p_q, radius * radius, this->rootNode_, key, 1, k_indices,
-                                     k_sqr_distances, max_nn);
-
-  return (k_indices.size ());
+  return (getNeighborsWithinRadius (p_q, (float)(radius * radius), k_indices, k_sqr_distances, max_nn));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -175,201 +144,717 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::radiusSearch (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT, typename LeafT, typename OctreeT> double
-pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::getKNearestNeighborRecursive (
-    const PointT & point, unsigned int K, const OctreeBranch* node, const OctreeKey& key,
-    unsigned int treeDepth, const double squaredSearchRadius, 
-    std::vector<prioPointQueueEntry>& pointCandidates) const
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::nearestKSearch (
+    const PointCloud &cloud, const std::vector<int> &indices, int k,
+    std::vector<std::vector<int> > &k_indices, std::vector<std::vector<float> > &k_sqr_distances) const
 {
-  std::vector<prioBranchQueueEntry> searchEntryHeap;
-  searchEntryHeap.resize (8);
+  std::vector<int> order;
+  sortQueriesInMortonOrder (cloud, indices, order);
 
-  unsigned char childIdx;
+  const int queryCount = (int)order.size ();
 
-  OctreeKey newKey;
+  k_indices.resize (queryCount);
+  k_sqr_distances.resize (queryCount);
 
-  double smallestSquaredDist = squaredSearchRadius;
+#pragma omp parallel for schedule (dynamic, 64) num_threads (this->threads_)
+  for (int i = 0; i < queryCount; i++)
+  {
+    const int pos = order[i];
+    const PointT& query = indices.empty () ? cloud.points[pos] : cloud.points[indices[pos]];
 
-  // get spatial voxel information
-  double voxelSquaredDiameter = this->getVoxelSquaredDiameter (treeDepth);
+    if ((k <= 0) || (this->leafCount_ == 0))
+    {
+      k_indices[pos].clear ();
+      k_sqr_distances[pos].clear ();
+      continue;
+    }
 
-  // iterate over all children
-  for (childIdx = 0; childIdx < 8; childIdx++)
+    getKNearestNeighbors (query, k, k_indices[pos], k_sqr_distances[pos]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::radiusSearch (
+    const PointCloud &cloud, const std::vector<int> &indices, double radius,
+    std::vector<std::vector<int> > &k_indices, std::vector<std::vector<float> > &k_sqr_distances,
+    int max_nn) const
+{
+  std::vector<int> order;
+  sortQueriesInMortonOrder (cloud, indices, order);
+
+  const int queryCount = (int)order.size ();
+  const float radiusSquared = (float)(radius * radius);
+
+  k_indices.resize (queryCount);
+  k_sqr_distances.resize (queryCount);
+
+#pragma omp parallel for schedule (dynamic, 64) num_threads (this->threads_)
+  for (int i = 0; i < queryCount; i++)
+  {
+    const int pos = order[i];
+    const PointT& query = indices.empty () ? cloud.points[pos] : cloud.points[indices[pos]];
+
+    getNeighborsWithinRadius (query, radiusSquared, k_indices[pos], k_sqr_distances[pos], max_nn);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::enableDynamicUpdates ()
+{
+  if (dynamicCloud_)
+    return;
+
+  dynamicCloud_.reset (new PointCloud ());
+
+  if (this->input_)
   {
-    if (branchHasChild (*node, childIdx))
+    // copy referenced points - point indices of the octree address positions in the indices vector, if given
+    const size_t pointCount = this->indices_ ? this->indices_->size () : this->input_->points.size ();
+
+    dynamicCloud_->header = this->input_->header;
+    dynamicCloud_->points.resize (pointCount);
+    for (size_t i = 0; i < pointCount; i++)
+      dynamicCloud_->points[i] = this->getPointByIndex ((unsigned int)i);
+  }
+
+  dynamicCloud_->width = (uint32_t)dynamicCloud_->points.size ();
+  dynamicCloud_->height = 1;
+  dynamicCloud_->is_dense = false;
+
+  this->input_ = dynamicCloud_;
+  this->indices_ = IndicesConstPtr ();
+
+  // find the leaf node of every point in the octree
+  pointLeaves_.assign (dynamicCloud_->points.size (), 0);
+  collectPointLeavesRecursive (this->rootNode_, 1);
+
+  // points that are not part of the octree are unused slots
+  freePointSlots_.clear ();
+  for (int i = (int)pointLeaves_.size () - 1; i >= 0; i--)
+    if (!pointLeaves_[i])
+      freePointSlots_.push_back (i);
+
+  emptyLeafCount_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> int
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::insertPoint (const PointT& point_arg)
+{
+  assert (dynamicCloud_);
+
+  if (!pcl_isfinite (point_arg.x) || !pcl_isfinite (point_arg.y) || !pcl_isfinite (point_arg.z))
+    return (-1);
+
+  int pointIdx;
+
+  // reuse slot of a removed point
+  if (!freePointSlots_.empty ())
+  {
+    pointIdx = freePointSlots_.back ();
+    freePointSlots_.pop_back ();
+    dynamicCloud_->points[pointIdx] = point_arg;
+  }
+  else
+  {
+    pointIdx = (int)dynamicCloud_->points.size ();
+    dynamicCloud_->points.push_back (point_arg);
+    dynamicCloud_->width = (uint32_t)dynamicCloud_->points.size ();
+    pointLeaves_.push_back (0);
+  }
+
+  // make sure bounding box is big enough - existing leaf nodes are kept when the octree grows
+  this->adoptBoundingBoxToPoint (point_arg);
+
+  OctreeKey key;
+  this->genOctreeKeyforPoint (point_arg, key);
+
+  const unsigned int leafCount = this->leafCount_;
+  OctreeLeaf* leaf = this->getLeaf (key);
+
+  if ((leafCount == this->leafCount_) && (emptyLeafCount_ > 0))
+  {
+    // check if an empty leaf node that has not been pruned yet is filled again
+    size_t pointCount;
+    std::vector<int> leafBuffer;
+    getLeafIndices (*leaf, pointCount, leafBuffer);
+    if (pointCount == 0)
+      emptyLeafCount_--;
+  }
+
+  leaf->setData (pointIdx);
+  this->objectCount_++;
+
+  pointLeaves_[pointIdx] = leaf;
+
+  return (pointIdx);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> bool
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::removePoint (const int pointIdx_arg)
+{
+  assert (dynamicCloud_);
+
+  if ((pointIdx_arg < 0) || (pointIdx_arg >= (int)pointLeaves_.size ()) || (!pointLeaves_[pointIdx_arg]))
+    return (false);
+
+  detachPointFromLeaf (pointIdx_arg);
+  freePointSlots_.push_back (pointIdx_arg);
+  this->objectCount_--;
+
+  pruneEmptyVoxelsLazily ();
+
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> bool
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::movePoint (const int pointIdx_arg, const PointT& point_arg)
+{
+  assert (dynamicCloud_);
+
+  if ((pointIdx_arg < 0) || (pointIdx_arg >= (int)pointLeaves_.size ()) || (!pointLeaves_[pointIdx_arg]))
+    return (false);
+
+  if (!pcl_isfinite (point_arg.x) || !pcl_isfinite (point_arg.y) || !pcl_isfinite (point_arg.z))
+    return (false);
+
+  if (this->isPointWithinBoundingBox (point_arg))
+  {
+    OctreeKey key;
+    this->genOctreeKeyforPoint (point_arg, key);
+
+    if (this->findLeaf (key) == pointLeaves_[pointIdx_arg])
     {
-      PointT voxelCenter;
+      // point stays within its voxel
+      dynamicCloud_->points[pointIdx_arg] = point_arg;
+      return (true);
+    }
+  }
+
+  // point changes its voxel
+  detachPointFromLeaf (pointIdx_arg);
+  this->objectCount_--;
+
+  // insert point at its former index
+  freePointSlots_.push_back (pointIdx_arg);
+  insertPoint (point_arg);
+
+  pruneEmptyVoxelsLazily ();
+
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::detachPointFromLeaf (const int pointIdx_arg)
+{
+  OctreeLeaf* leaf = pointLeaves_[pointIdx_arg];
+  pointLeaves_[pointIdx_arg] = 0;
+
+  if (!removeLeafIndex (*leaf, pointIdx_arg))
+    return;
+
+  if (keepsEmptyLeaf (*leaf))
+  {
+    emptyLeafCount_++;
+    return;
+  }
+
+  // the leaf node cannot report that it is empty - delete it together with its empty parent branches
+  OctreeKey key;
+  this->genOctreeKeyforPoint (dynamicCloud_->points[pointIdx_arg], key);
+  assert (this->findLeaf (key) == leaf);
+  this->removeLeaf (key);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::pruneEmptyVoxels ()
+{
+  pruneEmptyVoxelsRecursive (this->rootNode_, 1);
+  emptyLeafCount_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::pruneEmptyVoxelsLazily ()
+{
+  if ((emptyLeafCount_ > 0) && ((double)emptyLeafCount_ > pruneRatio_ * (double)this->leafCount_))
+    pruneEmptyVoxels ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::compactPointStorage (std::vector<int>& indexMap_arg)
+{
+  assert (dynamicCloud_);
+
+  const size_t pointCount = pointLeaves_.size ();
+  size_t i;
+  int newIdx;
+
+  pruneEmptyVoxels ();
 
-      searchEntryHeap[childIdx].key.x = (key.x << 1) + (!!(childIdx & (1 << 2)));
-      searchEntryHeap[childIdx].key.y = (key.y << 1) + (!!(childIdx & (1 << 1)));
-      searchEntryHeap[childIdx].key.z = (key.z << 1) + (!!(childIdx & (1 << 0)));
+  indexMap_arg.assign (pointCount, -1);
 
-      // generate voxel center point for voxel at key
-      genVoxelCenterFromOctreeKey (searchEntryHeap[childIdx].key, treeDepth, voxelCenter);
+  // clear all leaf nodes that hold points - every remaining leaf node holds at least one point
+  for (i = 0; i < pointCount; i++)
+    if (pointLeaves_[i])
+      pointLeaves_[i]->reset ();
 
-      // generate new priority queue element
-      searchEntryHeap[childIdx].node = getBranchChild (*node, childIdx);
-      searchEntryHeap[childIdx].pointDistance = pointSquaredDist (voxelCenter, point);
+  // move remaining points to the front of the point cloud and refill their leaf nodes
+  newIdx = 0;
+  for (i = 0; i < pointCount; i++)
+  {
+    if (!pointLeaves_[i])
+      continue;
+
+    indexMap_arg[i] = newIdx;
+
+    dynamicCloud_->points[newIdx] = dynamicCloud_->points[i];
+    pointLeaves_[newIdx] = pointLeaves_[i];
+    pointLeaves_[newIdx]->setData (newIdx);
+
+    newIdx++;
+  }
+
+  dynamicCloud_->points.resize (newIdx);
+  dynamicCloud_->width = (uint32_t)newIdx;
+  dynamicCloud_->height = 1;
+
+  pointLeaves_.resize (newIdx);
+  freePointSlots_.clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::collectPointLeavesRecursive (
+    const OctreeBranch* branch_arg, unsigned int treeDepth_arg)
+{
+  unsigned char childIdx;
+  std::vector<int> leafBuffer;
+
+  for (childIdx = 0; childIdx < 8; childIdx++)
+  {
+    if (!branchHasChild (*branch_arg, childIdx))
+      continue;
+
+    const OctreeNode* childNode = getBranchChild (*branch_arg, childIdx);
+
+    if (treeDepth_arg < this->octreeDepth_)
+    {
+      // we have not reached maximum tree depth
+      collectPointLeavesRecursive ((const OctreeBranch*)childNode, treeDepth_arg + 1);
     }
     else
     {
-      searchEntryHeap[childIdx].pointDistance = numeric_limits<double>::infinity ();
+      // we reached leaf node level
+      OctreeLeaf* childLeaf = (OctreeLeaf*)childNode;
+      size_t pointCount;
+      const int* pointIndices = getLeafIndices (*childLeaf, pointCount, leafBuffer);
+
+      for (size_t i = 0; i < pointCount; i++)
+        if ((pointIndices[i] >= 0) && (pointIndices[i] < (int)pointLeaves_.size ()))
+          pointLeaves_[pointIndices[i]] = childLeaf;
     }
   }
+}
 
-  std::sort (searchEntryHeap.begin (), searchEntryHeap.end ());
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> bool
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::pruneEmptyVoxelsRecursive (
+    OctreeBranch* branch_arg, unsigned int treeDepth_arg)
+{
+  unsigned char childIdx;
+  bool bOccupied = false;
+  std::vector<int> leafBuffer;
 
-  // iterate over all children in priority queue
-  // check if the distance to seach candidate is smaller than the best point distance (smallestSquaredDist)
-  while ((!searchEntryHeap.empty ()) && (searchEntryHeap.back ().pointDistance < smallestSquaredDist
-      + voxelSquaredDiameter / 4.0 + sqrt (smallestSquaredDist * voxelSquaredDiameter) - this->epsilon_))
+  for (childIdx = 0; childIdx < 8; childIdx++)
   {
-    const OctreeNode* childNode;
+    if (!branchHasChild (*branch_arg, childIdx))
+      continue;
 
-    // read from priority queue element
-    childNode = searchEntryHeap.back ().node;
-    newKey = searchEntryHeap.back ().key;
+    const OctreeNode* childNode = getBranchChild (*branch_arg, childIdx);
 
-    if (treeDepth < this->octreeDepth_)
+    if (treeDepth_arg < this->octreeDepth_)
     {
       // we have not reached maximum tree depth
-      smallestSquaredDist = getKNearestNeighborRecursive (point, K, (OctreeBranch*)childNode, newKey,
-                                                          treeDepth + 1, smallestSquaredDist,
-                                                          pointCandidates);
+      if (pruneEmptyVoxelsRecursive ((OctreeBranch*)childNode, treeDepth_arg + 1))
+      {
+        bOccupied = true;
+      }
+      else
+      {
+        // child branch does not own any sub-child nodes anymore -> delete child branch
+        this->deleteBranchChild (*branch_arg, childIdx);
+        this->branchCount_--;
+      }
     }
     else
     {
       // we reached leaf node level
+      size_t pointCount;
+      getLeafIndices (*(OctreeLeaf*)childNode, pointCount, leafBuffer);
 
-      double squaredDist;
-      size_t i;
-      vector<int> decodedPointVector;
+      if (pointCount > 0)
+      {
+        bOccupied = true;
+      }
+      else
+      {
+        this->deleteBranchChild (*branch_arg, childIdx);
+        this->leafCount_--;
+      }
+    }
+  }
 
-      OctreeLeaf* childLeaf = (OctreeLeaf*)childNode;
+  return (bOccupied);
+}
 
-      // decode leaf node into decodedPointVector
-      childLeaf->getData (decodedPointVector);
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> float
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::voxelSquaredDist (
+    const PointT & point, const OctreeKey& key, unsigned int treeDepth) const
+{
+  // calculate voxel size of current tree depth
+  const double voxelSideLen = this->resolution_ * (double)(1 << (this->octreeDepth_ - treeDepth));
+
+  // voxel bounds are computed in double precision to match the key generation
+  const float minX = (float)((double)key.x * voxelSideLen + this->minX_);
+  const float minY = (float)((double)key.y * voxelSideLen + this->minY_);
+  const float minZ = (float)((double)key.z * voxelSideLen + this->minZ_);
+  const float maxX = (float)((double)(key.x + 1) * voxelSideLen + this->minX_);
+  const float maxY = (float)((double)(key.y + 1) * voxelSideLen + this->minY_);
+  const float maxZ = (float)((double)(key.z + 1) * voxelSideLen + this->minZ_);
+
+  float dx = 0.0f, dy = 0.0f, dz = 0.0f;
+
+  if (point.x < minX)
+    dx = minX - point.x;
+  else if (point.x > maxX)
+    dx = point.x - maxX;
+
+  if (point.y < minY)
+    dy = minY - point.y;
+  else if (point.y > maxY)
+    dy = point.y - maxY;
+
+  if (point.z < minZ)
+    dz = minZ - point.z;
+  else if (point.z > maxZ)
+    dz = point.z - maxZ;
+
+  return (dx * dx + dy * dy + dz * dz);
+}
 
-      // Linearly iterate over all decoded (unsorted) points
-      for (i = 0; i < decodedPointVector.size (); i++)
-      {
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> int
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::getKNearestNeighbors (
+    const PointT & point, unsigned int K, std::vector<int> &k_indices,
+    std::vector<float> &k_sqr_distances) const
+{
+  if (K == 0)
+  {
+    k_indices.clear ();
+    k_sqr_distances.clear ();
+    return (0);
+  }
 
-        const PointT& candidatePoint = this->getPointByIndex (decodedPointVector[i]);
+  SearchStackEntry searchStack[SEARCH_STACK_SIZE];
+  unsigned int stackSize = 0;
 
-        // calculate point distance to search point
-        squaredDist = pointSquaredDist (candidatePoint, point);
+  // leaf decoding buffer - only used for leaf types that do not expose their index storage
+  std::vector<int> leafBuffer;
 
-        // check if a closer match is found
-        if (squaredDist < smallestSquaredDist)
-        {
-          prioPointQueueEntry pointEntry;
+  // the output vectors hold a max-heap of the best candidates, worst candidate at position 0
+  k_indices.resize (K);
+  k_sqr_distances.resize (K);
 
-          pointEntry.pointDistance_ = squaredDist;
-          pointEntry.pointIdx_ = decodedPointVector[i];
-          pointCandidates.push_back (pointEntry);
+  int* heapIndices = &k_indices[0];
+  float* heapDistances = &k_sqr_distances[0];
+  unsigned int resultCount = 0;
+
+  const float epsilon = (float)this->epsilon_;
+
+  // push root node
+  searchStack[0].node = this->rootNode_;
+  searchStack[0].key.x = searchStack[0].key.y = searchStack[0].key.z = 0;
+  searchStack[0].depth = 0;
+  searchStack[0].sqrDistance = 0.0f;
+  stackSize = 1;
+
+  while (stackSize > 0)
+  {
+    const SearchStackEntry entry = searchStack[--stackSize];
+
+    // skip voxels that cannot contain a closer point than the current worst candidate
+    if ((resultCount == K) && (entry.sqrDistance + epsilon > heapDistances[0]))
+      continue;
+
+    if (entry.depth < this->octreeDepth_)
+    {
+      // branch node - sort existing children by their distance to the query point
+      const OctreeBranch* branch = (const OctreeBranch*)entry.node;
+      SearchStackEntry children[8];
+      unsigned int childCount = 0;
+      unsigned char childIdx;
+
+      for (childIdx = 0; childIdx < 8; childIdx++)
+      {
+        if (!branchHasChild (*branch, childIdx))
+          continue;
+
+        SearchStackEntry child;
+        child.node = getBranchChild (*branch, childIdx);
+        child.key.x = (entry.key.x << 1) + (!!(childIdx & (1 << 2)));
+        child.key.y = (entry.key.y << 1) + (!!(childIdx & (1 << 1)));
+        child.key.z = (entry.key.z << 1) + (!!(childIdx & (1 << 0)));
+        child.depth = entry.depth + 1;
+        child.sqrDistance = voxelSquaredDist (point, child.key, child.depth);
+
+        if ((resultCount == K) && (child.sqrDistance + epsilon > heapDistances[0]))
+          continue;
+
+        // insertion sort, farthest child first
+        unsigned int pos = childCount++;
+        while ((pos > 0) && (children[pos - 1].sqrDistance < child.sqrDistance))
+        {
+          children[pos] = children[pos - 1];
+          pos--;
         }
+        children[pos] = child;
       }
 
-      std::sort (pointCandidates.begin (), pointCandidates.end ());
-
-      if (pointCandidates.size () > K)
-        pointCandidates.resize (K);
+      // push farthest child first so that the nearest child is explored next
+      for (unsigned int c = 0; c < childCount; c++)
+        searchStack[stackSize++] = children[c];
+    }
+    else
+    {
+      // leaf node - test all points
+      size_t pointCount;
+      const int* pointIndices = getLeafIndices (*(OctreeLeaf*)entry.node, pointCount, leafBuffer);
 
-      if (pointCandidates.size () == K)
+      for (size_t i = 0; i < pointCount; i++)
       {
-        smallestSquaredDist = pointCandidates.back ().pointDistance_;
+        const PointT& candidatePoint = this->getPointByIndex (pointIndices[i]);
+
+        const float dx = candidatePoint.x - point.x;
+        const float dy = candidatePoint.y - point.y;
+        const float dz = candidatePoint.z - point.z;
+        const float squaredDist = dx * dx + dy * dy + dz * dz;
+
+        unsigned int pos;
+
+        if (resultCount < K)
+        {
+          // heap not yet full - sift new candidate up
+          pos = resultCount++;
+          while (pos > 0)
+          {
+            const unsigned int parent = (pos - 1) / 2;
+            if (heapDistances[parent] >= squaredDist)
+              break;
+            heapDistances[pos] = heapDistances[parent];
+            heapIndices[pos] = heapIndices[parent];
+            pos = parent;
+          }
+        }
+        else if (squaredDist < heapDistances[0])
+        {
+          // replace worst candidate and sift down
+          pos = 0;
+          for (;;)
+          {
+            unsigned int child = 2 * pos + 1;
+            if (child >= K)
+              break;
+            if ((child + 1 < K) && (heapDistances[child + 1] > heapDistances[child]))
+              child++;
+            if (heapDistances[child] <= squaredDist)
+              break;
+            heapDistances[pos] = heapDistances[child];
+            heapIndices[pos] = heapIndices[child];
+            pos = child;
+          }
+        }
+        else
+          continue;
+
+        heapDistances[pos] = squaredDist;
+        heapIndices[pos] = pointIndices[i];
       }
     }
-    // pop element from priority queue
-    searchEntryHeap.pop_back ();
   }
 
-  return (smallestSquaredDist);
+  // heap sort - extracting the maximum first yields decreasing distances
+  for (unsigned int heapSize = resultCount; heapSize > 1; heapSize--)
+  {
+    const unsigned int last = heapSize - 1;
+    const float lastDistance = heapDistances[last];
+    const int lastIndex = heapIndices[last];
+
+    heapDistances[last] = heapDistances[0];
+    heapIndices[last] = heapIndices[0];
+
+    unsigned int pos = 0;
+    for (;;)
+    {
+      unsigned int child = 2 * pos + 1;
+      if (child >= last)
+        break;
+      if ((child + 1 < last) && (heapDistances[child + 1] > heapDistances[child]))
+        child++;
+      if (heapDistances[child] <= lastDistance)
+        break;
+      heapDistances[pos] = heapDistances[child];
+      heapIndices[pos] = heapIndices[child];
+      pos = child;
+    }
+    heapDistances[pos] = lastDistance;
+    heapIndices[pos] = lastIndex;
+  }
+
+  // heap sort leaves increasing distances - the search interface returns the farthest neighbor first
+  std::reverse (heapDistances, heapDistances + resultCount);
+  std::reverse (heapIndices, heapIndices + resultCount);
+
+  k_indices.resize (resultCount);
+  k_sqr_distances.resize (resultCount);
+
+  return (resultCount);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT, typename LeafT, typename OctreeT> void
-pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::getNeighborsWithinRadiusRecursive (
-    const PointT & point, const double radiusSquared, const OctreeBranch* node,
-    const OctreeKey& key, unsigned int treeDepth, std::vector<int>& k_indices,
+template<typename PointT, typename LeafT, typename OctreeT> int
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::getNeighborsWithinRadius (
+    const PointT & point, const float radiusSquared, std::vector<int>& k_indices,
     std::vector<float>& k_sqr_distances, int max_nn) const
 {
-  // child iterator
-  unsigned char childIdx;
+  SearchStackEntry searchStack[SEARCH_STACK_SIZE];
+  unsigned int stackSize = 0;
 
-  // get spatial voxel information
-  double voxelSquaredDiameter = this->getVoxelSquaredDiameter (treeDepth);
+  // leaf decoding buffer - only used for leaf types that do not expose their index storage
+  std::vector<int> leafBuffer;
 
-  // iterate over all children
-  for (childIdx = 0; childIdx < 8; childIdx++)
-  {
-    if (!branchHasChild (*node, childIdx))
-      continue;
+  const float epsilon = (float)this->epsilon_;
 
-    const OctreeNode* childNode;
-    childNode = getBranchChild (*node, childIdx);
+  k_indices.clear ();
+  k_sqr_distances.clear ();
 
-    OctreeKey newKey;
-    PointT voxelCenter;
-    double squaredDist;
+  // push root node
+  searchStack[0].node = this->rootNode_;
+  searchStack[0].key.x = searchStack[0].key.y = searchStack[0].key.z = 0;
+  searchStack[0].depth = 0;
+  searchStack[0].sqrDistance = 0.0f;
+  stackSize = 1;
 
-    // generate new key for current branch voxel
-    newKey.x = (key.x << 1) + (!!(childIdx & (1 << 2)));
-    newKey.y = (key.y << 1) + (!!(childIdx & (1 << 1)));
-    newKey.z = (key.z << 1) + (!!(childIdx & (1 << 0)));
+  while (stackSize > 0)
+  {
+    const SearchStackEntry entry = searchStack[--stackSize];
 
-    // generate voxel center point for voxel at key
-    genVoxelCenterFromOctreeKey (newKey, treeDepth, voxelCenter);
+    if (entry.depth < this->octreeDepth_)
+    {
+      // branch node - push children intersecting the search sphere, last child first to keep the child order
+      const OctreeBranch* branch = (const OctreeBranch*)entry.node;
+      int childIdx;
+
+      for (childIdx = 7; childIdx >= 0; childIdx--)
+      {
+        if (!branchHasChild (*branch, childIdx))
+          continue;
 
-    // calculate distance to search point
-    squaredDist = pointSquaredDist ((const PointT &)voxelCenter, point);
+        SearchStackEntry& child = searchStack[stackSize];
+        child.key.x = (entry.key.x << 1) + (!!(childIdx & (1 << 2)));
+        child.key.y = (entry.key.y << 1) + (!!(childIdx & (1 << 1)));
+        child.key.z = (entry.key.z << 1) + (!!(childIdx & (1 << 0)));
+        child.depth = entry.depth + 1;
+        child.sqrDistance = voxelSquaredDist (point, child.key, child.depth);
 
-    // if distance is smaller than search radius
-    if (squaredDist + this->epsilon_ <= voxelSquaredDiameter / 4.0 + radiusSquared
-        + sqrt (voxelSquaredDiameter * radiusSquared))
+        if (child.sqrDistance + epsilon > radiusSquared)
+          continue;
+
+        child.node = getBranchChild (*branch, childIdx);
+        stackSize++;
+      }
+    }
+    else
     {
+      // leaf node - test all points
+      size_t pointCount;
+      const int* pointIndices = getLeafIndices (*(OctreeLeaf*)entry.node, pointCount, leafBuffer);
 
-      if (treeDepth < this->octreeDepth_)
+      for (size_t i = 0; i < pointCount; i++)
       {
-        // we have not reached maximum tree depth
-        getNeighborsWithinRadiusRecursive (point, radiusSquared, (OctreeBranch*)childNode, newKey,
-                                           treeDepth + 1, k_indices, k_sqr_distances, max_nn);
+        const PointT& candidatePoint = this->getPointByIndex (pointIndices[i]);
+
+        const float dx = candidatePoint.x - point.x;
+        const float dy = candidatePoint.y - point.y;
+        const float dz = candidatePoint.z - point.z;
+        const float squaredDist = dx * dx + dy * dy + dz * dz;
+
+        // check if a match is found
+        if (squaredDist > radiusSquared)
+          continue;
+
+        // add point to result vector
+        k_indices.push_back (pointIndices[i]);
+        k_sqr_distances.push_back (squaredDist);
+
         if (k_indices.size () == (unsigned int)max_nn)
-          return;
+          return (max_nn);
       }
-      else
-      {
-        // we reached leaf node level
+    }
+  }
 
-        size_t i;
-        OctreeLeaf* childLeaf = (OctreeLeaf*)childNode;
-        vector<int> decodedPointVector;
+  return (k_indices.size ());
+}
 
-        // decode leaf node into decodedPointVector
-        childLeaf->getData (decodedPointVector);
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafT, typename OctreeT> void
+pcl::octree::OctreePointCloudSearch<PointT, LeafT, OctreeT>::sortQueriesInMortonOrder (
+    const PointCloud &cloud, const std::vector<int> &indices, std::vector<int> &order) const
+{
+  const size_t queryCount = indices.empty () ? cloud.points.size () : indices.size ();
 
-        // Linearly iterate over all decoded (unsorted) points
-        for (i = 0; i < decodedPointVector.size (); i++)
-        {
-          const PointT& candidatePoint = this->getPointByIndex (decodedPointVector[i]);
+  // Morton codes are built from at most 21 bits per axis
+  const unsigned int keyShift = (this->octreeDepth_ > 21) ? this->octreeDepth_ - 21 : 0;
+  const double maxKey = (double)((1u << (this->octreeDepth_ - keyShift)) - 1u);
+  const double scale = 1.0 / (this->resolution_ * (double)(1u << keyShift));
 
-          // calculate point distance to search point
-          squaredDist = pointSquaredDist (candidatePoint, point);
+  std::vector<std::pair<boost::uint64_t, int> > codes (queryCount);
 
-          // check if a match is found
-          if (squaredDist > radiusSquared)
-            continue;
+  for (size_t i = 0; i < queryCount; i++)
+  {
+    const PointT& query = indices.empty () ? cloud.points[i] : cloud.points[indices[i]];
 
-          // add point to result vector
-          k_indices.push_back (decodedPointVector[i]);
-          k_sqr_distances.push_back (squaredDist);
+    // queries outside of the bounding box are clamped to the closest voxel
+    double k[3] = { (query.x - this->minX_) * scale, (query.y - this->minY_) * scale, (query.z - this->minZ_) * scale };
+    unsigned int key[3];
 
-          if (k_indices.size () == (unsigned int)max_nn)
-            return;
-        }
-      }
+    for (int d = 0; d < 3; d++)
+    {
+      if (!(k[d] > 0.0))
+        k[d] = 0.0;
+      else if (k[d] > maxKey)
+        k[d] = maxKey;
+      key[d] = (unsigned int)k[d];
     }
+
+    codes[i].first = (expandMortonBits (key[0]) << 2) | (expandMortonBits (key[1]) << 1) | expandMortonBits (key[2]);
+    codes[i].second = (int)i;
   }
+
+  std::sort (codes.begin (), codes.end ());
+
+  order.resize (queryCount);
+  for (size_t i = 0; i < queryCount; i++)
+    order[i] = codes[i].second;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -43,6 +43,7 @@
 #include <pcl/octree/octree_base.h>
 #include <pcl/octree/octree2buf_base.h>
 #include <pcl/octree/octree_lowmemory_base.h>
+#include <pcl/octree/octree_compact_tree.h>
 
 #include <pcl/octree/octree_pointcloud.h>
 
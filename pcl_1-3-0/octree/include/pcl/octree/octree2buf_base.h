@@ -43,6 +43,7 @@
 #include <math.h>
 
 #include "octree_nodes.h"
+#include "octree_node_pool.h"
 
 #include "octree_iterator.h"
 
@@ -164,11 +165,31 @@ namespace pcl
         }
 
         /** \brief Delete the octree structure and its leaf nodes.
-         *  \param freeMemory_arg: if "true", allocated octree nodes are deleted, otherwise they are pushed to the octree node pool
+         *  \note All nodes of both buffers are returned to the node pools at once, the tree is not traversed.
+         *  \param freeMemory_arg: if "true", the node pools are freed, otherwise their memory is kept for rebuilding the tree
          * */
         void
         deleteTree ( bool freeMemory_arg = false );
 
+        /** \brief Set the amount of octree nodes that are allocated at once by the node pools.
+         *  \param slabSize_arg: amount of branch and leaf nodes per pool slab
+         * */
+        inline void
+        setNodePoolSlabSize (std::size_t slabSize_arg)
+        {
+          branchPool_.setSlabSize (slabSize_arg);
+          leafPool_.setSlabSize (slabSize_arg);
+        }
+
+        /** \brief Get the amount of octree nodes that are allocated at once by the node pools.
+         *  \return amount of branch and leaf nodes per pool slab
+         * */
+        inline std::size_t
+        getNodePoolSlabSize () const
+        {
+          return branchPool_.getSlabSize ();
+        }
+
         /** \brief Delete octree structure of previous buffer. */
         inline void
         deletePreviousBuffer ()
@@ -602,13 +623,13 @@ namespace pcl
                 deleteBranch (*(OctreeBranch*)branchChild);
 
                 // push unused branch to branch pool
-                unusedBranchesPool_.push_back ((OctreeBranch*)branchChild);
+                branchPool_.pushNode ((OctreeBranch*)branchChild);
                 break;
 
               case LEAF_NODE:
 
-                // push unused leaf to branch pool
-                unusedLeafsPool_.push_back ((OctreeLeaf*)branchChild);
+                // push unused leaf to leaf pool
+                leafPool_.pushNode ((OctreeLeaf*)branchChild);
                 break;
             }
 
@@ -638,13 +659,13 @@ namespace pcl
                 deleteBranch (*(OctreeBranch*)branchChild);
 
                 // push unused branch to branch pool
-                unusedBranchesPool_.push_back ((OctreeBranch*)branchChild);
+                branchPool_.pushNode ((OctreeBranch*)branchChild);
                 break;
 
               case LEAF_NODE:
 
-                // push unused leaf to branch pool
-                unusedLeafsPool_.push_back ((OctreeLeaf*)branchChild);
+                // push unused leaf to leaf pool
+                leafPool_.pushNode ((OctreeLeaf*)branchChild);
                 break;
             }
 
@@ -693,16 +714,7 @@ namespace pcl
         createBranchChild (OctreeBranch& branch_arg, const unsigned char childIdx_arg,
                            OctreeBranch*& newBranchChild_arg)
         {
-          if (!unusedBranchesPool_.size ())
-          {
-            newBranchChild_arg = (OctreeBranch*)new OctreeBranch ();
-          }
-          else
-          {
-            newBranchChild_arg = unusedBranchesPool_.back ();
-            unusedBranchesPool_.pop_back ();
-            branchReset (*newBranchChild_arg);
-          }
+          createBranch (newBranchChild_arg);
 
           setBranchChild (branch_arg, childIdx_arg, (OctreeNode*)newBranchChild_arg);
         }
@@ -713,20 +725,9 @@ namespace pcl
         inline void
         createBranch (OctreeBranch*& newBranchChild_arg)
         {
-
-          if (!unusedBranchesPool_.size ())
-          {
-            // branch pool is empty
-            // we need to create a new octree branch class
-            newBranchChild_arg = (OctreeBranch*)new OctreeBranch ();
-          }
-          else
-          {
-            // reuse branch from branch pool
-            newBranchChild_arg = unusedBranchesPool_.back ();
-            unusedBranchesPool_.pop_back ();
-            branchReset (*newBranchChild_arg);
-          }
+          // fetch branch from branch pool
+          newBranchChild_arg = branchPool_.popNode ();
+          branchReset (*newBranchChild_arg);
         }
 
         /** \brief Fetch and add a new leaf child to a branch class
@@ -737,19 +738,8 @@ namespace pcl
         inline void
         createLeafChild (OctreeBranch& branch_arg, const unsigned char childIdx_arg, OctreeLeaf*& newLeafChild_arg)
         {
-          if (!unusedLeafsPool_.size ())
-          {
-            // leaf pool is empty
-            // we need to create a new octree leaf class
-            newLeafChild_arg = (OctreeLeaf*)new OctreeLeaf ();
-          }
-          else
-          {
-            // reuse leaf node from branch pool
-            newLeafChild_arg = unusedLeafsPool_.back ();
-            unusedLeafsPool_.pop_back ();
-          }
-
+          // fetch leaf from leaf pool
+          newLeafChild_arg = leafPool_.popNode ();
           newLeafChild_arg->reset ();
 
           setBranchChild (branch_arg, childIdx_arg, (OctreeNode*)newLeafChild_arg);
@@ -764,24 +754,13 @@ namespace pcl
           memset (branch_arg.subNodes_, 0, sizeof(branch_arg.subNodes_));
         }
 
-        /** \brief Delete all branch nodes and leaf nodes from octree node pools
+        /** \brief Free the memory of the octree node pools. All branch and leaf nodes become invalid.
          * */
         inline void
         poolCleanUp ()
         {
-          // delete all branch instances from branch pool
-          while (!unusedBranchesPool_.empty ())
-          {
-            delete (unusedBranchesPool_.back ());
-            unusedBranchesPool_.pop_back ();
-          }
-
-          // delete all leaf instances from leaf pool
-          while (!unusedLeafsPool_.empty ())
-          {
-            delete (unusedLeafsPool_.back ());
-            unusedLeafsPool_.pop_back ();
-          }
+          branchPool_.clear ();
+          leafPool_.clear ();
         }
 
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1010,11 +989,11 @@ namespace pcl
         /** \brief Depth mask based on octree depth   **/
         unsigned int depthMask_;
 
-        /** \brief Vector pools of unused branch nodes   **/
-        std::vector<OctreeBranch*> unusedBranchesPool_;
+        /** \brief Slab pool of branch nodes   **/
+        OctreeNodePool<OctreeBranch> branchPool_;
 
-        /** \brief Vector pools of unused leaf nodes   **/
-        std::vector<LeafT*> unusedLeafsPool_;
+        /** \brief Slab pool of leaf nodes   **/
+        OctreeNodePool<LeafT> leafPool_;
 
         /** \brief Currently active octree buffer  **/
         unsigned char bufferSelector_;
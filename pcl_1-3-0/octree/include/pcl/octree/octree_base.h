@@ -39,11 +39,15 @@
 #ifndef OCTREE_TREE_BASE_H
 #define OCTREE_TREE_BASE_H
 
+#include <cassert>
 #include <cstddef>
 #include <vector>
 #include <math.h>
 
+#include <boost/cstdint.hpp>
+
 #include "octree_nodes.h"
+#include "octree_node_pool.h"
 
 #include "octree_iterator.h"
 
@@ -51,6 +55,9 @@ namespace pcl
 {
   namespace octree
   {
+    template<typename DataT, typename LeafT>
+      class OctreeCompactTree;
+
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /** \brief @b Octree class
      *  \note The tree depth defines the maximum amount of octree voxels / leaf nodes (should be initially defined).
@@ -66,6 +73,7 @@ namespace pcl
 
         friend class OctreeNodeIterator<DataT, LeafT, OctreeBase> ;
         friend class OctreeLeafNodeIterator<DataT, LeafT, OctreeBase> ;
+        friend class OctreeCompactTree<DataT, LeafT> ;
 
       public:
 
@@ -161,11 +169,31 @@ namespace pcl
         }
 
         /** \brief Delete the octree structure and its leaf nodes.
-         *  \param freeMemory_arg: if "true", allocated octree nodes are deleted, otherwise they are pushed to the octree node pool
+         *  \note All nodes are returned to the node pools at once, the tree is not traversed.
+         *  \param freeMemory_arg: if "true", the node pools are freed, otherwise their memory is kept for rebuilding the tree
          * */
         void
         deleteTree ( bool freeMemory_arg = false );
 
+        /** \brief Set the amount of octree nodes that are allocated at once by the node pools.
+         *  \param slabSize_arg: amount of branch and leaf nodes per pool slab
+         * */
+        inline void
+        setNodePoolSlabSize (std::size_t slabSize_arg)
+        {
+          branchPool_.setSlabSize (slabSize_arg);
+          leafPool_.setSlabSize (slabSize_arg);
+        }
+
+        /** \brief Get the amount of octree nodes that are allocated at once by the node pools.
+         *  \return amount of branch and leaf nodes per pool slab
+         * */
+        inline std::size_t
+        getNodePoolSlabSize () const
+        {
+          return branchPool_.getSlabSize ();
+        }
+
         /** \brief Serialize octree into a binary output vector describing its branch node structure.
          *  \param binaryTreeOut_arg: reference to output vector for writing binary tree structure.
          * */
@@ -232,7 +260,7 @@ namespace pcl
 
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         /**\brief @b Octree branch class.
-         * \note It stores 8 pointers to its child nodes.
+         * \note It stores 8 32-bit handles of its child nodes in the branch and leaf node pools.
          * \author Julius Kammerl (julius@kammerl.de)
          */
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -266,8 +294,9 @@ namespace pcl
 
         private:
 
-          /** \brief Child node pointer array of size 8.  */
-          const OctreeNode * subNodes_[8];
+          /** \brief Child node handle array of size 8. 0 marks a missing child, otherwise the handle is the node pool
+           *  index + 1 and leafHandleFlag_ is set for leaf children. */
+          boost::uint32_t subNodes_[8];
 
         };
 
@@ -402,7 +431,15 @@ namespace pcl
         inline const OctreeNode*
         getBranchChild (const OctreeBranch& branch_arg, const unsigned char childIdx_arg) const
         {
-          return branch_arg.subNodes_[childIdx_arg];
+          const boost::uint32_t handle = branch_arg.subNodes_[childIdx_arg];
+
+          if (!handle)
+            return 0;
+
+          if (handle & leafHandleFlag_)
+            return leafPool_.getNode ((handle & ~leafHandleFlag_) - 1);
+
+          return branchPool_.getNode (handle - 1);
         }
 
         /** \brief Check if branch is pointing to a particular child node
@@ -444,7 +481,18 @@ namespace pcl
         inline void
         setBranchChild (OctreeBranch& branch_arg, const unsigned char childIdx_arg, const OctreeNode * newChild_arg)
         {
-          branch_arg.subNodes_[childIdx_arg] = newChild_arg;
+          boost::uint32_t handle = 0;
+
+          // look up the pool index of the child node
+          if (newChild_arg)
+          {
+            if (newChild_arg->getNodeType () == BRANCH_NODE)
+              handle = branchPool_.getNodeIndex ((const OctreeBranch*)newChild_arg) + 1;
+            else
+              handle = (leafPool_.getNodeIndex ((const OctreeLeaf*)newChild_arg) + 1) | leafHandleFlag_;
+          }
+
+          branch_arg.subNodes_[childIdx_arg] = handle;
         }
 
         /** \brief Delete child node and all its subchilds from octree
@@ -454,30 +502,26 @@ namespace pcl
         inline void
         deleteBranchChild (OctreeBranch& branch_arg, const unsigned char childIdx_arg)
         {
-          if (branchHasChild (branch_arg, childIdx_arg))
-          {
-            const OctreeNode* branchChild;
-            branchChild = getBranchChild (branch_arg, childIdx_arg);
+          const boost::uint32_t handle = branch_arg.subNodes_[childIdx_arg];
 
-            switch (branchChild->getNodeType ())
+          if (handle)
+          {
+            if (handle & leafHandleFlag_)
             {
-              case BRANCH_NODE:
-                // free child branch recursively
-                deleteBranch (*(OctreeBranch*)branchChild);
-
-                // push unused branch to branch pool
-                unusedBranchesPool_.push_back ((OctreeBranch*)branchChild);
-                break;
-
-              case LEAF_NODE:
+              // push unused leaf to leaf pool
+              leafPool_.pushNode ((handle & ~leafHandleFlag_) - 1);
+            }
+            else
+            {
+              // free child branch recursively
+              deleteBranch (*branchPool_.getNode (handle - 1));
 
-                // push unused leaf to branch pool
-                unusedLeafsPool_.push_back ((OctreeLeaf*)branchChild);
-                break;
+              // push unused branch to branch pool
+              branchPool_.pushNode (handle - 1);
             }
 
-            // set branch child pointer to 0
-            setBranchChild (branch_arg, childIdx_arg, 0);
+            // set branch child handle to 0
+            branch_arg.subNodes_[childIdx_arg] = 0;
           }
         }
 
@@ -502,19 +546,9 @@ namespace pcl
         inline void
         createBranch (OctreeBranch*& newBranchChild_arg)
         {
-          if (!unusedBranchesPool_.size ())
-          {
-            // branch pool is empty
-            // we need to create a new octree branch class
-            newBranchChild_arg = (OctreeBranch*)new OctreeBranch ();
-          }
-          else
-          {
-            // reuse branch from branch pool
-            newBranchChild_arg = unusedBranchesPool_.back ();
-            unusedBranchesPool_.pop_back ();
-            branchReset (*newBranchChild_arg);
-          }
+          // fetch branch from branch pool
+          newBranchChild_arg = branchPool_.popNode ();
+          branchReset (*newBranchChild_arg);
         }
 
         /** \brief Create and add a new branch child to a branch class
@@ -526,8 +560,14 @@ namespace pcl
         createBranchChild (OctreeBranch& branch_arg, const unsigned char childIdx_arg,
                            OctreeBranch*& newBranchChild_arg)
         {
-          createBranch ( newBranchChild_arg );
-          setBranchChild (branch_arg, childIdx_arg, (OctreeNode*)newBranchChild_arg);
+          boost::uint32_t index;
+
+          // fetch branch from branch pool
+          newBranchChild_arg = branchPool_.popNode (index);
+          branchReset (*newBranchChild_arg);
+
+          assert (index < leafHandleFlag_ - 1);
+          branch_arg.subNodes_[childIdx_arg] = index + 1;
         }
 
 
@@ -539,24 +579,14 @@ namespace pcl
         inline void
         createLeafChild (OctreeBranch& branch_arg, const unsigned char childIdx_arg, OctreeLeaf*& newLeafChild_arg)
         {
+          boost::uint32_t index;
 
-          if (!unusedLeafsPool_.size ())
-          {
-            // leaf pool is empty
-            // we need to create a new octree leaf class
-            newLeafChild_arg = (OctreeLeaf*)new OctreeLeaf ();
-          }
-          else
-          {
-            // reuse leaf node from branch pool
-            newLeafChild_arg = unusedLeafsPool_.back ();
-            unusedLeafsPool_.pop_back ();
-          }
-
+          // fetch leaf from leaf pool
+          newLeafChild_arg = leafPool_.popNode (index);
           newLeafChild_arg->reset ();
 
-          setBranchChild (branch_arg, childIdx_arg, (OctreeNode*)newLeafChild_arg);
-
+          assert (index < leafHandleFlag_ - 1);
+          branch_arg.subNodes_[childIdx_arg] = (index + 1) | leafHandleFlag_;
         }
 
         /** \brief Reset branch class
@@ -568,24 +598,13 @@ namespace pcl
           memset (branch_arg.subNodes_, 0, sizeof(branch_arg.subNodes_));
         }
 
-        /** \brief Delete all branch nodes and leaf nodes from octree node pools
+        /** \brief Free the memory of the octree node pools. All branch and leaf nodes become invalid.
          * */
         inline void
         poolCleanUp ()
         {
-          // delete all branch instances from branch pool
-          while (!unusedBranchesPool_.empty ())
-          {
-            delete (unusedBranchesPool_.back ());
-            unusedBranchesPool_.pop_back ();
-          }
-
-          // delete all leaf instances from leaf pool
-          while (!unusedLeafsPool_.empty ())
-          {
-            delete (unusedLeafsPool_.back ());
-            unusedLeafsPool_.pop_back ();
-          }
+          branchPool_.clear ();
+          leafPool_.clear ();
         }
 
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -776,11 +795,14 @@ namespace pcl
         /** \brief Octree depth */
         unsigned int octreeDepth_;
 
-        /** \brief Vector pools of unused branch nodes   **/
-        std::vector<OctreeBranch*> unusedBranchesPool_;
+        /** \brief Slab pool of branch nodes   **/
+        OctreeNodePool<OctreeBranch> branchPool_;
+
+        /** \brief Slab pool of leaf nodes   **/
+        OctreeNodePool<LeafT> leafPool_;
 
-        /** \brief Vector pools of unused leaf nodes   **/
-        std::vector<LeafT*> unusedLeafsPool_;
+        /** \brief Branch child handle flag marking leaf nodes   **/
+        static const boost::uint32_t leafHandleFlag_ = 0x80000000u;
 
       };
   }
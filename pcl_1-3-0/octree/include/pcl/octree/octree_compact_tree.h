@@ -0,0 +1,280 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#ifndef OCTREE_COMPACT_TREE_H
+#define OCTREE_COMPACT_TREE_H
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "octree_base.h"
+
+namespace pcl
+{
+  namespace octree
+  {
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /** \brief @b Compact read-only copy of an octree
+     *  \note The branch nodes are stored in a single array without any pointers. Each branch holds an 8-bit child mask
+     *  and the 32-bit array index of its first child - all children of a branch are stored next to each other, so the
+     *  index of a child is the first child index plus the amount of lower bits set in the child mask.
+     *  \note Leaf nodes are copied into a separate array in the same order.
+     *  \note The layout cannot be modified. Rebuild it with build () after the source octree has changed.
+     *  \ingroup octree
+     */
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename DataT, typename LeafT = OctreeLeafDataT<DataT> >
+      class OctreeCompactTree
+      {
+      public:
+
+        /** \brief Empty constructor. */
+        OctreeCompactTree () :
+          branches_ (), leafs_ (), depthMask_ (0)
+        {
+        }
+
+        /** \brief Copy the structure and the leaf nodes of an octree into the compact layout.
+         *  \param octree_arg: octree to be copied
+         * */
+        void
+        build (const OctreeBase<DataT, LeafT>& octree_arg)
+        {
+          branches_.clear ();
+          leafs_.clear ();
+
+          depthMask_ = octree_arg.depthMask_;
+          if (!depthMask_)
+            return;
+
+          branches_.reserve (octree_arg.branchCount_);
+          leafs_.reserve (octree_arg.leafCount_);
+
+          branches_.resize (1);
+          buildRecursive (octree_arg, *octree_arg.rootNode_, 0, depthMask_);
+        }
+
+        /** \brief Free the compact layout. */
+        void
+        clear ()
+        {
+          std::vector<CompactBranch> ().swap (branches_);
+          std::vector<LeafT> ().swap (leafs_);
+          depthMask_ = 0;
+        }
+
+        /** \brief Find leaf node at (idxX, idxY, idxZ).
+         *  \param idxX_arg: index of leaf node in the X axis.
+         *  \param idxY_arg: index of leaf node in the Y axis.
+         *  \param idxZ_arg: index of leaf node in the Z axis.
+         *  \return pointer to leaf node. If leaf node is not found, this pointer returns 0.
+         * */
+        const LeafT*
+        findLeaf (const unsigned int idxX_arg, const unsigned int idxY_arg, const unsigned int idxZ_arg) const
+        {
+          unsigned int depthMask;
+          boost::uint32_t nodeIdx;
+
+          if (branches_.empty ())
+            return 0;
+
+          // descend from the root branch
+          nodeIdx = 0;
+          for (depthMask = depthMask_; depthMask; depthMask >>= 1)
+          {
+            const CompactBranch& branch = branches_[nodeIdx];
+
+            unsigned char childIdx = ((!!(idxX_arg & depthMask)) << 2) | ((!!(idxY_arg & depthMask)) << 1)
+                | (!!(idxZ_arg & depthMask));
+
+            if (!(branch.childMask_ & (1 << childIdx)))
+              return 0;
+
+            nodeIdx = branch.firstChild_ + countBits (branch.childMask_ & ((1 << childIdx) - 1));
+          }
+
+          return &leafs_[nodeIdx];
+        }
+
+        /** \brief Check for the existence of leaf node at (idxX, idxY, idxZ).
+         *  \param idxX_arg: index of leaf node in the X axis.
+         *  \param idxY_arg: index of leaf node in the Y axis.
+         *  \param idxZ_arg: index of leaf node in the Z axis.
+         *  \return "true" if leaf node search is successful, otherwise it returns "false".
+         * */
+        bool
+        existLeaf (const unsigned int idxX_arg, const unsigned int idxY_arg, const unsigned int idxZ_arg) const
+        {
+          return (findLeaf (idxX_arg, idxY_arg, idxZ_arg) != 0);
+        }
+
+        /** \brief Retrieve a DataT element from leaf node at (idxX, idxY, idxZ). It returns false if leaf node does not exist.
+         *  \param idxX_arg: index of leaf node in the X axis.
+         *  \param idxY_arg: index of leaf node in the Y axis.
+         *  \param idxZ_arg: index of leaf node in the Z axis.
+         *  \param data_arg: reference to DataT object that contains content of leaf node if search was successful.
+         *  \return "true" if leaf node search is successful, otherwise it returns "false".
+         * */
+        bool
+        get (const unsigned int idxX_arg, const unsigned int idxY_arg, const unsigned int idxZ_arg, DataT& data_arg) const
+        {
+          const LeafT* leaf = findLeaf (idxX_arg, idxY_arg, idxZ_arg);
+          const DataT* dataPtr = 0;
+
+          if (leaf)
+            leaf->getData (dataPtr);
+
+          if (dataPtr)
+            data_arg = *dataPtr;
+
+          return (leaf != 0);
+        }
+
+        /** \brief Return the leaf nodes in the order of the compact layout.
+         *  \return reference to leaf node array
+         * */
+        inline const std::vector<LeafT>&
+        getLeafs () const
+        {
+          return leafs_;
+        }
+
+        /** \brief Return the amount of leaf nodes.
+         *  \return amount of leaf nodes.
+         * */
+        inline std::size_t
+        getLeafCount () const
+        {
+          return leafs_.size ();
+        }
+
+        /** \brief Return the amount of branch nodes.
+         *  \return amount of branch nodes.
+         * */
+        inline std::size_t
+        getBranchCount () const
+        {
+          return branches_.size ();
+        }
+
+      protected:
+
+        /** \brief Branch node of the compact layout. */
+        struct CompactBranch
+        {
+          /** \brief Array index of the first child in branches_ or, on the last tree level, in leafs_. */
+          boost::uint32_t firstChild_;
+
+          /** \brief Bit i is set if child i exists. */
+          unsigned char childMask_;
+        };
+
+        /** \brief Recursively copy a branch and its children. Children of a branch are appended as a contiguous block.
+         *  \param octree_arg: source octree
+         *  \param branch_arg: current branch node of source octree
+         *  \param branchIdx_arg: index of current branch node in branches_
+         *  \param depthMask_arg: depth mask of current branch node
+         **/
+        void
+        buildRecursive (const OctreeBase<DataT, LeafT>& octree_arg,
+                        const typename OctreeBase<DataT, LeafT>::OctreeBranch& branch_arg,
+                        const boost::uint32_t branchIdx_arg, const unsigned int depthMask_arg)
+        {
+          unsigned char childIdx;
+          unsigned char childMask = (unsigned char)octree_arg.getBranchBitPattern (branch_arg);
+
+          branches_[branchIdx_arg].childMask_ = childMask;
+
+          if (depthMask_arg > 1)
+          {
+            // children are branch nodes
+            boost::uint32_t childBranchIdx = (boost::uint32_t)branches_.size ();
+
+            branches_[branchIdx_arg].firstChild_ = childBranchIdx;
+            branches_.resize (branches_.size () + countBits (childMask));
+
+            for (childIdx = 0; childIdx < 8; childIdx++)
+            {
+              if (childMask & (1 << childIdx))
+              {
+                const typename OctreeBase<DataT, LeafT>::OctreeBranch* childBranch;
+                childBranch = (const typename OctreeBase<DataT, LeafT>::OctreeBranch*)octree_arg.getBranchChild (branch_arg, childIdx);
+
+                buildRecursive (octree_arg, *childBranch, childBranchIdx++, depthMask_arg / 2);
+              }
+            }
+          }
+          else
+          {
+            // children are leaf nodes
+            branches_[branchIdx_arg].firstChild_ = (boost::uint32_t)leafs_.size ();
+
+            for (childIdx = 0; childIdx < 8; childIdx++)
+            {
+              if (childMask & (1 << childIdx))
+                leafs_.push_back (*(const LeafT*)octree_arg.getBranchChild (branch_arg, childIdx));
+            }
+          }
+        }
+
+        /** \brief Count the bits set in a child mask.
+         *  \param mask_arg: child mask
+         *  \return amount of children
+         **/
+        static inline unsigned int
+        countBits (unsigned int mask_arg)
+        {
+          mask_arg = mask_arg - ((mask_arg >> 1) & 0x55);
+          mask_arg = (mask_arg & 0x33) + ((mask_arg >> 2) & 0x33);
+          return ((mask_arg + (mask_arg >> 4)) & 0x0F);
+        }
+
+        /** \brief Branch nodes. The root branch is stored at index 0. */
+        std::vector<CompactBranch> branches_;
+
+        /** \brief Leaf nodes. */
+        std::vector<LeafT> leafs_;
+
+        /** \brief Depth mask of the source octree. */
+        unsigned int depthMask_;
+      };
+  }
+}
+
+#endif
@@ -44,6 +44,7 @@
 #include <math.h>
 
 #include "octree_nodes.h"
+#include "octree_node_pool.h"
 
 #include "octree_iterator.h"
 
@@ -161,6 +162,7 @@ namespace pcl
         }
 
         /** \brief Delete the octree structure and its leaf nodes.
+         *  \note The memory of all nodes is freed.
          * */
         void
         deleteTree ( );
@@ -277,10 +279,11 @@ namespace pcl
             occupancyByte_ = 0;
           }
 
-          /** \brief Empty deconstructor. */
+          /** \brief Deconstructor. Frees the child pointer array. */
           virtual
           ~OctreeBranch ()
           {
+            this->reset ();
           }
 
           /** \brief Get the type of octree node. Returns BRANCH_NODE type
@@ -613,16 +616,17 @@ namespace pcl
                 // free child branch recursively
                 deleteBranch (*(OctreeBranch*)branchChild);
 
+                // push unused branch to branch pool
+                branchPool_.pushNode ((OctreeBranch*)branchChild);
                 break;
 
               case LEAF_NODE:
 
+                // push unused leaf to leaf pool
+                leafPool_.pushNode ((OctreeLeaf*)branchChild);
                 break;
             }
 
-            // delete branch child
-            delete (branchChild);
-
             // set branch child pointer to 0
             setBranchChild (branch_arg, childIdx_arg, 0);
           }
@@ -650,8 +654,9 @@ namespace pcl
         createBranch (OctreeBranch*& newBranchChild_arg)
         {
 
-          // we need to create a new octree branch class
-          newBranchChild_arg = (OctreeBranch*)new OctreeBranch ();
+          // fetch branch from branch pool
+          newBranchChild_arg = branchPool_.popNode ();
+          branchReset (*newBranchChild_arg);
 
         }
 
@@ -677,8 +682,8 @@ namespace pcl
         createLeafChild (OctreeBranch& branch_arg, const unsigned char childIdx_arg, OctreeLeaf*& newLeafChild_arg)
         {
 
-          // we need to create a new octree leaf class
-          newLeafChild_arg = (OctreeLeaf*)new OctreeLeaf ();
+          // fetch leaf from leaf pool
+          newLeafChild_arg = leafPool_.popNode ();
           newLeafChild_arg->reset();
 
           setBranchChild (branch_arg, childIdx_arg, (OctreeNode*)newLeafChild_arg);
@@ -883,11 +888,11 @@ namespace pcl
         /** \brief Octree depth */
         unsigned int octreeDepth_;
 
-        /** \brief Vector pools of unused branch nodes   **/
-        std::vector<OctreeBranch*> unusedBranchesPool_;
+        /** \brief Pool of branch nodes - released branches are freed immediately   **/
+        OctreeNodePool<OctreeBranch> branchPool_;
 
-        /** \brief Vector pools of unused leaf nodes   **/
-        std::vector<LeafT*> unusedLeafsPool_;
+        /** \brief Pool of leaf nodes - released leafs are freed immediately   **/
+        OctreeNodePool<LeafT> leafPool_;
 
       };
   }
@@ -0,0 +1,343 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ */
+#ifndef OCTREE_NODE_POOL_H
+#define OCTREE_NODE_POOL_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace pcl
+{
+  namespace octree
+  {
+    // enum of node pool release policies
+    enum pool_policy_t
+    {
+      KEEP_RELEASED_NODES, FREE_RELEASED_NODES
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /** \brief @b Octree node pool class
+     *  \note With the KEEP_RELEASED_NODES policy, octree nodes are allocated in contiguous slabs of slabSize_ nodes
+     *  instead of one heap allocation per node. Every node is addressed by a 32-bit index, released nodes are kept in
+     *  a free list and handed out again before the next slab is touched. reset () returns all nodes to the pool at once
+     *  without visiting them, clear () frees the slab memory.
+     *  \note With the FREE_RELEASED_NODES policy, every node is allocated on its own and freed as soon as it is pushed
+     *  back to the pool. Node indices, reset () and clear () are not available - the owner releases its nodes one by one.
+     *  \note Nodes are not reset by the pool - this is done by the octree when a node is taken from the pool.
+     *  \ingroup octree
+     */
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename NodeT>
+      class OctreeNodePool
+      {
+      public:
+
+        /** \brief Constructor.
+         *  \param slabSize_arg: amount of nodes allocated at once (rounded up to a power of two)
+         *  \param policy_arg: handling of released nodes
+         * */
+        OctreeNodePool (std::size_t slabSize_arg = 1024, pool_policy_t policy_arg = KEEP_RELEASED_NODES) :
+          slabShift_ (0), activeSlabShift_ (0), policy_ (policy_arg), slabs_ (), slabOrder_ (), freeNodes_ (),
+          nextNode_ (0), nodeCount_ (0)
+        {
+          setSlabSize (slabSize_arg);
+        }
+
+        /** \brief Deconstructor. Frees all slabs. */
+        ~OctreeNodePool ()
+        {
+          clear ();
+        }
+
+        /** \brief Set the amount of nodes per slab. The size is rounded up to a power of two so that a node index maps
+         *  to its slab by a shift. Slabs that are already allocated keep their size until clear () is called.
+         *  \param slabSize_arg: amount of nodes allocated at once
+         * */
+        inline void
+        setSlabSize (std::size_t slabSize_arg)
+        {
+          slabShift_ = 0;
+          while ((slabShift_ < 31) && ((std::size_t (1) << slabShift_) < slabSize_arg))
+            slabShift_++;
+
+          if (slabs_.empty ())
+            activeSlabShift_ = slabShift_;
+        }
+
+        /** \brief Get the amount of nodes per slab.
+         *  \return amount of nodes allocated at once
+         * */
+        inline std::size_t
+        getSlabSize () const
+        {
+          return (std::size_t (1) << slabShift_);
+        }
+
+        /** \brief Get the release policy of the pool.
+         *  \return handling of released nodes
+         * */
+        inline pool_policy_t
+        getPolicy () const
+        {
+          return policy_;
+        }
+
+        /** \brief Fetch a node from the pool. Released nodes are reused first, then the current slab is filled up. A new
+         *  slab is allocated only if all existing slabs are in use.
+         *  \return pointer to an unused node
+         * */
+        inline NodeT*
+        popNode ()
+        {
+          if (policy_ == FREE_RELEASED_NODES)
+          {
+            nodeCount_++;
+            return (new (::operator new (sizeof (NodeT))) NodeT);
+          }
+
+          boost::uint32_t index;
+          return popNode (index);
+        }
+
+        /** \brief Fetch a node from the pool together with its index (KEEP_RELEASED_NODES policy only).
+         *  \param index_arg: writes the index of the node to this reference
+         *  \return pointer to an unused node
+         * */
+        inline NodeT*
+        popNode (boost::uint32_t& index_arg)
+        {
+          assert (policy_ == KEEP_RELEASED_NODES);
+
+          if (!freeNodes_.empty ())
+          {
+            // reuse released node
+            index_arg = freeNodes_.back ();
+            freeNodes_.pop_back ();
+          }
+          else
+          {
+            if (nextNode_ >= getCapacity ())
+            {
+              // all slabs are in use - allocate a new one
+              assert (getCapacity () + getActiveSlabSize () - 1 <= 0xFFFFFFFFu);
+              NodeT* slab = new NodeT[getActiveSlabSize ()];
+              SlabAddress address (slab, (boost::uint32_t)slabs_.size ());
+              slabs_.push_back (slab);
+              slabOrder_.insert (std::upper_bound (slabOrder_.begin (), slabOrder_.end (), address, &compareSlabAddress),
+                                 address);
+            }
+            index_arg = (boost::uint32_t)nextNode_++;
+          }
+
+          nodeCount_++;
+          return getNode (index_arg);
+        }
+
+        /** \brief Return a single node to the pool.
+         *  \param node_arg: pointer to node that was fetched from this pool
+         * */
+        inline void
+        pushNode (NodeT* node_arg)
+        {
+          if (policy_ == FREE_RELEASED_NODES)
+          {
+            // the pool allocated the node with its exact type - destroy and free it as such
+            nodeCount_--;
+            node_arg->~NodeT ();
+            ::operator delete (node_arg);
+            return;
+          }
+
+          pushNode (getNodeIndex (node_arg));
+        }
+
+        /** \brief Return a single node to the pool by its index (KEEP_RELEASED_NODES policy only).
+         *  \param index_arg: index of node that was fetched from this pool
+         * */
+        inline void
+        pushNode (boost::uint32_t index_arg)
+        {
+          assert (policy_ == KEEP_RELEASED_NODES);
+          assert (index_arg < nextNode_);
+
+          nodeCount_--;
+          freeNodes_.push_back (index_arg);
+        }
+
+        /** \brief Resolve a node index (KEEP_RELEASED_NODES policy only).
+         *  \param index_arg: index of node that was fetched from this pool
+         *  \return pointer to the node
+         * */
+        inline NodeT*
+        getNode (boost::uint32_t index_arg) const
+        {
+          return (slabs_[index_arg >> activeSlabShift_] + (index_arg & (getActiveSlabSize () - 1)));
+        }
+
+        /** \brief Look up the index of a node (KEEP_RELEASED_NODES policy only). Runs in O(log(slab count)).
+         *  \param node_arg: pointer to node that was fetched from this pool
+         *  \return index of the node
+         * */
+        inline boost::uint32_t
+        getNodeIndex (const NodeT* node_arg) const
+        {
+          assert (policy_ == KEEP_RELEASED_NODES);
+
+          // find slab with the largest start address not above node_arg
+          typename std::vector<SlabAddress>::const_iterator it;
+          it = std::upper_bound (slabOrder_.begin (), slabOrder_.end (), SlabAddress (node_arg, 0), &compareSlabAddress);
+          assert (it != slabOrder_.begin ());
+          --it;
+
+          assert (std::size_t (node_arg - it->first) < getActiveSlabSize ());
+          return ((it->second << activeSlabShift_) + (boost::uint32_t)(node_arg - it->first));
+        }
+
+        /** \brief Return all nodes to the pool. Slab memory is kept for reuse, nodes are neither visited nor destroyed.
+         *  \note Not available for the FREE_RELEASED_NODES policy.
+         * */
+        inline void
+        reset ()
+        {
+          assert (policy_ == KEEP_RELEASED_NODES);
+
+          freeNodes_.clear ();
+          nextNode_ = 0;
+          nodeCount_ = 0;
+        }
+
+        /** \brief Free all slabs. All nodes fetched from this pool become invalid. A slab size set in the meantime takes
+         *  effect now.
+         *  \note With the FREE_RELEASED_NODES policy, nodes are owned by the caller until they are pushed back.
+         * */
+        inline void
+        clear ()
+        {
+          typename std::vector<NodeT*>::iterator it;
+          for (it = slabs_.begin (); it != slabs_.end (); ++it)
+            delete[] *it;
+
+          slabs_.clear ();
+          slabOrder_.clear ();
+          freeNodes_.clear ();
+          activeSlabShift_ = slabShift_;
+          nextNode_ = 0;
+          if (policy_ == KEEP_RELEASED_NODES)
+            nodeCount_ = 0;
+        }
+
+        /** \brief Get the amount of nodes that are currently handed out by the pool.
+         *  \return amount of nodes in use
+         * */
+        inline std::size_t
+        getNodeCount () const
+        {
+          return (nodeCount_);
+        }
+
+        /** \brief Get the amount of nodes the pool holds memory for.
+         *  \return pool capacity in nodes
+         * */
+        inline std::size_t
+        getCapacity () const
+        {
+          if (policy_ == FREE_RELEASED_NODES)
+            return (nodeCount_);
+
+          return (slabs_.size () * getActiveSlabSize ());
+        }
+
+      private:
+
+        /** \brief Start address and number of a slab. */
+        typedef std::pair<const NodeT*, boost::uint32_t> SlabAddress;
+
+        /** \brief Order slabs by their start address. */
+        static bool
+        compareSlabAddress (const SlabAddress& a, const SlabAddress& b)
+        {
+          return (std::less<const NodeT*> () (a.first, b.first));
+        }
+
+        /** \brief Amount of nodes in the allocated slabs. */
+        inline std::size_t
+        getActiveSlabSize () const
+        {
+          return (std::size_t (1) << activeSlabShift_);
+        }
+
+        // disable copy constructor and assignment
+        OctreeNodePool (const OctreeNodePool&);
+        OctreeNodePool& operator = (const OctreeNodePool&);
+
+        /** \brief Binary logarithm of the requested slab size. */
+        unsigned int slabShift_;
+
+        /** \brief Binary logarithm of the size of the allocated slabs. */
+        unsigned int activeSlabShift_;
+
+        /** \brief Handling of released nodes. */
+        pool_policy_t policy_;
+
+        /** \brief Allocated slabs. */
+        std::vector<NodeT*> slabs_;
+
+        /** \brief Allocated slabs sorted by start address for getNodeIndex (). */
+        std::vector<SlabAddress> slabOrder_;
+
+        /** \brief Indices of nodes released by pushNode (). */
+        std::vector<boost::uint32_t> freeNodes_;
+
+        /** \brief Index of next node that has never been handed out. */
+        std::size_t nextNode_;
+
+        /** \brief Amount of nodes in use. */
+        std::size_t nodeCount_;
+      };
+  }
+}
+
+#endif
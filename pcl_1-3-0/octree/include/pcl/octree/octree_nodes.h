@@ -295,6 +295,27 @@ namespace pcl
           return leafDataTVector_;
         }
 
+        /** \brief Remove the first occurrence of a DataT element from the internal DataT vector. The order of the
+         *  remaining elements is not preserved.
+         *  \param data_arg: reference to DataT element to be removed.
+         *  \return "true" if the element was found; "false" otherwise
+         * */
+        virtual bool
+        removeData (const DataT& data_arg)
+        {
+          typename std::vector<DataT>::iterator it;
+          for (it = leafDataTVector_.begin (); it != leafDataTVector_.end (); ++it)
+          {
+            if (*it == data_arg)
+            {
+              *it = leafDataTVector_.back ();
+              leafDataTVector_.pop_back ();
+              return true;
+            }
+          }
+          return false;
+        }
+
         /** \brief Reset leaf node. Clear DataT vector.*/
         virtual void
         reset ()
@@ -157,6 +157,17 @@ namespace pcl
           return (epsilon_);
         }
 
+        /** \brief Set the number of threads used for generating octree keys in \a addPointsFromInputCloud.
+         * \param nr_threads the number of hardware threads to use
+         */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads)
+        {
+          if (nr_threads == 0)
+            nr_threads = 1;
+          threads_ = nr_threads;
+        }
+
         /** \brief Set/change the octree voxel resolution
          * \param resolution_arg side length of voxels at lowest tree level
          */
@@ -177,7 +188,11 @@ namespace pcl
           return (resolution_);
         }
 
-        /** \brief Add points from input point cloud to octree. */
+        /** \brief Add points from input point cloud to octree.
+         *  \note Octree keys are generated in parallel and sorted in Morton order before the points are added to their
+         *  voxels, so every voxel is accessed only once. The resulting octree is identical to adding the points one by
+         *  one in the order of the input cloud (or indices).
+         * */
         void
         addPointsFromInputCloud ();
 
@@ -360,6 +375,17 @@ namespace pcl
         const PointT&
         getPointByIndex (const unsigned int index_arg) const;
 
+        /** \brief Check if a point lies within the current octree bounding box
+         * \param point_arg point to be checked
+         * \return "true" if point is within bounding box; "false" otherwise
+         */
+        inline bool
+        isPointWithinBoundingBox (const PointT& point_arg) const
+        {
+          return (boundingBoxDefined_ && (point_arg.x >= minX_) && (point_arg.y >= minY_) && (point_arg.z >= minZ_)
+              && (point_arg.x < maxX_) && (point_arg.y < maxY_) && (point_arg.z < maxZ_));
+        }
+
         /** \brief Find octree leaf node at a given point
          * \param point_arg query point
          * \return pointer to leaf node. If leaf node does not exist, pointer is 0.
@@ -479,6 +505,9 @@ namespace pcl
         /** \brief Flag indicating if octree has defined bounding box. */
         bool boundingBoxDefined_;
 
+        /** \brief The number of threads the scheduler should use. */
+        unsigned int threads_;
+
       };
 
   }
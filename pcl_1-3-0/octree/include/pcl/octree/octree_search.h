@@ -88,7 +88,8 @@ namespace pcl
           *  \param resolution: octree resolution at lowest octree level
           */
         OctreePointCloudSearch (const double resolution) :
-          OctreePointCloud<PointT, LeafT, OctreeT> (resolution)
+          OctreePointCloud<PointT, LeafT, OctreeT> (resolution), dynamicCloud_ (), pointLeaves_ (),
+          freePointSlots_ (), emptyLeafCount_ (0), pruneRatio_ (0.25)
         {
         }
 
@@ -228,6 +229,117 @@ namespace pcl
         radiusSearch (int index, const double radius, std::vector<int> &k_indices,
                       std::vector<float> &k_sqr_distances, int max_nn = INT_MAX) const;
 
+        /** \brief Search for k-nearest neighbors for a set of query points.
+         * \note The queries are answered in Morton order of their octree keys, so that consecutive queries visit the
+         * same octree nodes, and in parallel using the number of threads given by setNumberOfThreads ().
+         * \param cloud the point cloud holding the query points
+         * \param indices the indices in \a cloud of the query points - if empty, all points of \a cloud are queried
+         * \param k the number of neighbors to search for
+         * \param k_indices the resultant indices of the neighboring points, one vector per query point
+         * \param k_sqr_distances the resultant squared distances to the neighboring points, one vector per query point
+         */
+        void
+        nearestKSearch (const PointCloud &cloud, const std::vector<int> &indices, int k,
+                        std::vector<std::vector<int> > &k_indices,
+                        std::vector<std::vector<float> > &k_sqr_distances) const;
+
+        /** \brief Search for all neighbors within a given radius for a set of query points.
+         * \note The queries are answered in Morton order of their octree keys, so that consecutive queries visit the
+         * same octree nodes, and in parallel using the number of threads given by setNumberOfThreads ().
+         * \param cloud the point cloud holding the query points
+         * \param indices the indices in \a cloud of the query points - if empty, all points of \a cloud are queried
+         * \param radius the radius of the sphere bounding all neighbors
+         * \param k_indices the resultant indices of the neighboring points, one vector per query point
+         * \param k_sqr_distances the resultant squared distances to the neighboring points, one vector per query point
+         * \param max_nn if given, bounds the maximum returned neighbors per query point to this value
+         */
+        void
+        radiusSearch (const PointCloud &cloud, const std::vector<int> &indices, double radius,
+                      std::vector<std::vector<int> > &k_indices,
+                      std::vector<std::vector<float> > &k_sqr_distances, int max_nn = INT_MAX) const;
+
+        /** \brief Switch the octree to dynamic mode. The points referenced by the octree are copied into a point cloud
+         * owned by the octree, which replaces the input cloud. Afterwards, single points can be inserted, removed and
+         * moved without rebuilding the octree. Point indices of the octree are preserved, unless the input cloud was
+         * given together with an indices vector - in that case point i of the dynamic cloud is point indices[i].
+         * \note In dynamic mode, the octree must not be modified by other means (addPointsFromInputCloud, deleteTree,
+         * switchBuffers, ...).
+         */
+        void
+        enableDynamicUpdates ();
+
+        /** \brief Check if the octree is in dynamic mode.
+         * \return "true" if enableDynamicUpdates () was called; "false" otherwise
+         */
+        inline bool
+        isDynamic () const
+        {
+          return (dynamicCloud_.get () != 0);
+        }
+
+        /** \brief Get the point cloud owned by the octree in dynamic mode. Unused slots of removed points remain in the
+         * cloud until they are reused by insertPoint () or dropped by compactPointStorage ().
+         * \return pointer to the dynamic point cloud
+         */
+        inline PointCloudConstPtr
+        getDynamicCloud () const
+        {
+          return (dynamicCloud_);
+        }
+
+        /** \brief Insert a point into the octree (dynamic mode). Slots of removed points are reused.
+         * \param point_arg the point to be inserted
+         * \return index of the point in the dynamic point cloud; -1 if the point is not finite
+         */
+        int
+        insertPoint (const PointT& point_arg);
+
+        /** \brief Remove a point from the octree (dynamic mode). Emptied voxels are pruned lazily, see setPruneRatio ().
+         * Voxels of leaf types other than OctreeLeafDataTVector are deleted as soon as they get empty.
+         * \param pointIdx_arg index of the point in the dynamic point cloud
+         * \return "true" if the point was found and removed; "false" otherwise
+         */
+        bool
+        removePoint (const int pointIdx_arg);
+
+        /** \brief Move a point to a new position (dynamic mode). The point keeps its index.
+         * \param pointIdx_arg index of the point in the dynamic point cloud
+         * \param point_arg the new point position
+         * \return "true" if the point was moved; "false" if the index is unused or the new position is not finite
+         */
+        bool
+        movePoint (const int pointIdx_arg, const PointT& point_arg);
+
+        /** \brief Delete all empty leaf nodes and the branches that no longer hold any leaf node. */
+        void
+        pruneEmptyVoxels ();
+
+        /** \brief Set the ratio of empty to total leaf nodes above which removePoint () and movePoint () prune empty
+         * voxels. A ratio of 0 prunes on every update.
+         * \param ratio_arg the prune ratio (default: 0.25)
+         */
+        inline void
+        setPruneRatio (double ratio_arg)
+        {
+          pruneRatio_ = ratio_arg;
+        }
+
+        /** \brief Get the ratio of empty to total leaf nodes above which empty voxels are pruned.
+         * \return the prune ratio
+         */
+        inline double
+        getPruneRatio () const
+        {
+          return (pruneRatio_);
+        }
+
+        /** \brief Remove the slots of removed points from the dynamic point cloud. The remaining points keep their
+         * relative order and get consecutive indices, empty voxels are pruned.
+         * \param indexMap_arg the new index of every previous point index is written to this vector, -1 for removed points
+         */
+        void
+        compactPointStorage (std::vector<int>& indexMap_arg);
+
         /** \brief Get a PointT vector of centers of all voxels that intersected by a ray (origin, direction).
           * \param[in] origin ray origin
           * \param[in] direction ray direction vector
@@ -257,90 +369,28 @@ namespace pcl
 
 
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        /** \brief @b Priority queue entry for branch nodes
-         *  \note This class defines priority queue entries for the nearest neighbor search.
-         *  \author Julius Kammerl (julius@kammerl.de)
+        /** \brief @b Search stack entry
+         *  \note Octree node waiting to be explored by the iterative nearest neighbor and radius search.
          */
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        class prioBranchQueueEntry
+        struct SearchStackEntry
         {
-        public:
-
-          /** \brief Empty constructor  */
-          prioBranchQueueEntry ()
-          {
-          }
-
-          /** \brief Constructor for initializing priority queue entry.
-           * \param node pointer to octree node
-           * \param key octree key addressing voxel in octree structure
-           * \param pointDistance distance of query point to voxel center
-           * */
-          prioBranchQueueEntry (OctreeNode* node, OctreeKey& key, double pointDistance)
-          {
-            node = node;
-            pointDistance = pointDistance;
-            key = key;
-          }
-
-          /** \brief Operator< for comparing priority queue entries with each other.  */
-          bool
-          operator< (const prioBranchQueueEntry rhs) const
-          {
-            return (this->pointDistance > rhs.pointDistance);
-          }
-
           // pointer to octree node
           const OctreeNode* node;
 
-          // distance to query point
-          double pointDistance;
-
-          // octree key
+          // octree key addressing the node voxel
           OctreeKey key;
 
-        };
-
-        //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        /** \brief @b Priority queue entry for point candidates
-         *  \note This class defines priority queue entries for the nearest neighbor point candidates.
-         *  \author Julius Kammerl (julius@kammerl.de)
-         */
-        //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        class prioPointQueueEntry
-        {
-        public:
-
-          /** \brief Empty constructor  */
-          prioPointQueueEntry ()
-          {
-          }
-
-          /** \brief Constructor for initializing priority queue entry.
-           * \param pointIdx an index representing a point in the dataset given by \a setInputCloud
-           * \param pointDistance distance of query point to voxel center
-           * */
-          prioPointQueueEntry (unsigned int& pointIdx, double pointDistance)
-          {
-            pointIdx_ = pointIdx;
-            pointDistance_ = pointDistance;
-          }
-
-          /** \brief Operator< for comparing priority queue entries with each other.  */
-          bool
-          operator< (const prioPointQueueEntry& rhs) const
-          {
-            return (this->pointDistance_ < rhs.pointDistance_);
-          }
-
-          // index representing a point in the dataset given by \a setInputCloud
-          int pointIdx_;
-
-          // distance to query point
-          double pointDistance_;
+          // depth/level of the node in the octree
+          unsigned int depth;
 
+          // squared distance of query point to node voxel
+          float sqrDistance;
         };
 
+        /** \brief Maximum amount of entries on the search stack. Every explored branch pushes at most 8 children. */
+        static const unsigned int SEARCH_STACK_SIZE = 8 * (OCT_MAXTREEDEPTH + 1);
+
         /** \brief Helper function to calculate the squared distance between two points
          * \param pointA point A
          * \param pointB point B
@@ -349,42 +399,173 @@ namespace pcl
         double
         pointSquaredDist (const PointT & pointA, const PointT & pointB) const;
 
-        //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        // Recursive search routine methods
-        //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        /** \brief Helper function to calculate the squared distance between a point and an octree voxel. Points within
+         * the voxel have a distance of zero.
+         * \param point query point
+         * \param key octree key addressing the voxel
+         * \param treeDepth depth/level of the voxel in the octree
+         * \return squared distance between point and voxel
+         */
+        float
+        voxelSquaredDist (const PointT & point, const OctreeKey& key, unsigned int treeDepth) const;
+
+        /** \brief Get the point indices stored in a leaf node without copying them.
+         * \param leaf octree leaf node
+         * \param count the amount of indices is written to this reference
+         * \note The index buffer argument is not used for this leaf type.
+         * \return pointer to the point indices
+         */
+        static inline const int*
+        getLeafIndices (OctreeLeafDataTVector<int>& leaf, size_t& count, std::vector<int>&)
+        {
+          const std::vector<int>& indices = leaf.getIdxVector ();
+          count = indices.size ();
+          return (count ? &indices[0] : 0);
+        }
 
+        /** \brief Get the point index stored in a leaf node without copying it.
+         * \param leaf octree leaf node
+         * \param count the amount of indices is written to this reference
+         * \note The index buffer argument is not used for this leaf type.
+         * \return pointer to the point index
+         */
+        static inline const int*
+        getLeafIndices (OctreeLeafDataT<int>& leaf, size_t& count, std::vector<int>&)
+        {
+          const int* index;
+          leaf.getData (index);
+          count = 1;
+          return (index);
+        }
+
+        /** \brief Get the point indices stored in a leaf node of any other type. The indices are copied to \a buffer.
+         * \param leaf octree leaf node
+         * \param count the amount of indices is written to this reference
+         * \param buffer the point indices are written to this vector
+         * \return pointer to the point indices
+         */
+        template<typename LeafType> static inline const int*
+        getLeafIndices (LeafType& leaf, size_t& count, std::vector<int>& buffer)
+        {
+          buffer.clear ();
+          leaf.getData (buffer);
+          count = buffer.size ();
+          return (count ? &buffer[0] : 0);
+        }
+
+        /** \brief Iterative search method that explores the octree depth-first, nearest child voxel first, and finds
+         * the K nearest neighbors. The output vectors are used as bounded max-heap, no other memory is allocated.
+         * \param point query point
+         * \param K amount of nearest neighbors to be found
+         * \param k_indices the resultant indices of the neighboring points, ordered by decreasing distance
+         * \param k_sqr_distances the resultant squared distances to the neighboring points
+         * \return number of neighbors found
+         */
+        int
+        getKNearestNeighbors (const PointT & point, unsigned int K, std::vector<int> &k_indices,
+                              std::vector<float> &k_sqr_distances) const;
 
-        /** \brief Recursive search method that explores the octree and finds neighbors within a given radius
+        /** \brief Iterative search method that explores the octree and finds neighbors within a given radius
          * \param point query point
          * \param radiusSquared squared search radius
-         * \param node current octree node to be explored
-         * \param key octree key addressing a leaf node.
-         * \param treeDepth current depth/level in the octree
          * \param k_indices vector of indices found to be neighbors of query point
          * \param k_sqr_distances squared distances of neighbors to query point
          * \param max_nn maximum of neighbors to be found
+         * \return number of neighbors found
+         */
+        int
+        getNeighborsWithinRadius (const PointT & point, const float radiusSquared, std::vector<int>& k_indices,
+                                  std::vector<float>& k_sqr_distances, int max_nn) const;
+
+        /** \brief Remove a point index from a leaf node.
+         * \param leaf octree leaf node
+         * \param pointIdx point index to be removed
+         * \return "true" if the leaf node does not contain any point index anymore
+         */
+        static inline bool
+        removeLeafIndex (OctreeLeafDataTVector<int>& leaf, int pointIdx)
+        {
+          leaf.removeData (pointIdx);
+          return (leaf.getIdxVector ().empty ());
+        }
+
+        /** \brief Remove a point index from a leaf node of any other type by decoding and refilling it.
+         * \param leaf octree leaf node
+         * \param pointIdx point index to be removed
+         * \return "true" if the leaf node does not contain any point index anymore
+         */
+        template<typename LeafType> static inline bool
+        removeLeafIndex (LeafType& leaf, int pointIdx)
+        {
+          std::vector<int> indices;
+          leaf.getData (indices);
+          leaf.reset ();
+
+          bool empty = true;
+          for (size_t i = 0; i < indices.size (); i++)
+            if (indices[i] != pointIdx)
+            {
+              leaf.setData (indices[i]);
+              empty = false;
+            }
+
+          return (empty);
+        }
+
+        /** \brief Check whether an emptied leaf node can stay in the octree until it is pruned lazily. Only leaf
+         * nodes that report their amount of indices can be told apart from occupied ones.
+         * \return "true" for index vector leaf nodes
+         */
+        static inline bool
+        keepsEmptyLeaf (const OctreeLeafDataTVector<int>&)
+        {
+          return (true);
+        }
+
+        /** \brief Check whether an emptied leaf node can stay in the octree until it is pruned lazily. Leaf nodes of
+         * any other type (e.g. single index leaf nodes) still report a stale index after reset () and are deleted
+         * right away.
+         * \return "false"
+         */
+        template<typename LeafType> static inline bool
+        keepsEmptyLeaf (const LeafType&)
+        {
+          return (false);
+        }
+
+        /** \brief Remove a point index from its leaf node and account for or delete the leaf node if it got empty.
+         * \param pointIdx_arg index of the point in the dynamic point cloud
          */
         void
-        getNeighborsWithinRadiusRecursive (const PointT & point, const double radiusSquared,
-                                           const OctreeBranch* node, const OctreeKey& key,
-                                           unsigned int treeDepth, std::vector<int>& k_indices,
-                                           std::vector<float>& k_sqr_distances, int max_nn) const;
+        detachPointFromLeaf (const int pointIdx_arg);
 
-        /** \brief Recursive search method that explores the octree and finds the K nearest neighbors
-         * \param point query point
-         * \param K amount of nearest neighbors to be found
-         * \param node current octree node to be explored
-         * \param key octree key addressing a leaf node.
-         * \param treeDepth current depth/level in the octree
-         * \param squaredSearchRadius squared search radius distance
-         * \param pointCandidates priority queue of nearest neigbor point candidates
-         * \return squared search radius based on current point candidate set found
+        /** \brief Store the leaf node of every point index found below a branch (dynamic mode).
+         * \param branch_arg current branch node
+         * \param treeDepth_arg depth/level of the children of the branch node
          */
-        double
-        getKNearestNeighborRecursive (const PointT & point, unsigned int K, const OctreeBranch* node,
-                                      const OctreeKey& key, unsigned int treeDepth,
-                                      const double squaredSearchRadius,
-                                      std::vector<prioPointQueueEntry>& pointCandidates) const;
+        void
+        collectPointLeavesRecursive (const OctreeBranch* branch_arg, unsigned int treeDepth_arg);
+
+        /** \brief Recursively delete empty leaf nodes and empty branches.
+         * \param branch_arg current branch node
+         * \param treeDepth_arg depth/level of the children of the branch node
+         * \return "true" if the branch node still has children; "false" otherwise
+         */
+        bool
+        pruneEmptyVoxelsRecursive (OctreeBranch* branch_arg, unsigned int treeDepth_arg);
+
+        /** \brief Prune empty voxels if their share of all leaf nodes exceeds the prune ratio. */
+        void
+        pruneEmptyVoxelsLazily ();
+
+        /** \brief Sort query points in Morton order of their octree keys.
+         * \param cloud the point cloud holding the query points
+         * \param indices the indices in \a cloud of the query points - if empty, all points of \a cloud are used
+         * \param order positions of the query points in \a indices (or \a cloud) are written to this vector in Morton order
+         */
+        void
+        sortQueriesInMortonOrder (const PointCloud &cloud, const std::vector<int> &indices,
+                                  std::vector<int> &order) const;
 
         /** \brief Recursive search method that explores the octree and finds the approximate nearest neighbor
          * \param point query point
@@ -581,6 +762,21 @@ namespace pcl
           return 0;
         }
 
+        /** \brief Point cloud owned by the octree in dynamic mode. */
+        PointCloudPtr dynamicCloud_;
+
+        /** \brief Leaf node holding each point of the dynamic point cloud, 0 for unused slots. */
+        std::vector<OctreeLeaf*> pointLeaves_;
+
+        /** \brief Unused slots in the dynamic point cloud. */
+        std::vector<int> freePointSlots_;
+
+        /** \brief Amount of empty leaf nodes that have not been pruned yet. */
+        unsigned int emptyLeafCount_;
+
+        /** \brief Ratio of empty to total leaf nodes above which empty voxels are pruned. */
+        double pruneRatio_;
+
       };
   }
 }
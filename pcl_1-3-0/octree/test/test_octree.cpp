@@ -699,6 +699,180 @@ TEST (PCL, Octree2Buf_Base_Double_Buffering_XOR_Test)
 
 }
 
+TEST (PCL, Octree_Node_Pool_Test)
+{
+  unsigned int i;
+
+  OctreeNodePool<int> pool (4);
+
+  // fill two slabs and release a node
+  std::vector<int*> nodes;
+  for (i = 0; i < 8; i++)
+    nodes.push_back (pool.popNode ());
+
+  ASSERT_EQ (pool.getCapacity (), 8u);
+  ASSERT_EQ (pool.getNodeCount (), 8u);
+
+  pool.pushNode (nodes[3]);
+  ASSERT_EQ (pool.getNodeCount (), 7u);
+
+  // released node is reused first
+  ASSERT_EQ (pool.popNode (), nodes[3]);
+
+  // nodes within a slab are contiguous
+  ASSERT_EQ (nodes[1], nodes[0] + 1);
+
+  // reset returns all nodes without freeing the slabs
+  pool.reset ();
+  ASSERT_EQ (pool.getNodeCount (), 0u);
+  ASSERT_EQ (pool.getCapacity (), 8u);
+  ASSERT_EQ (pool.popNode (), nodes[0]);
+
+  // nodes are addressed by 32-bit indices
+  boost::uint32_t index;
+  int* node = pool.popNode (index);
+  ASSERT_EQ (index, 1u);
+  ASSERT_EQ (pool.getNode (index), node);
+  ASSERT_EQ (pool.getNodeIndex (nodes[6]), 6u);
+
+  pool.pushNode (index);
+  ASSERT_EQ (pool.popNode (), nodes[1]);
+
+  pool.clear ();
+  ASSERT_EQ (pool.getCapacity (), 0u);
+
+  // slab sizes are rounded up to a power of two
+  pool.setSlabSize (5);
+  ASSERT_EQ (pool.getSlabSize (), 8u);
+
+  // released nodes are freed at once
+  OctreeNodePool<int> freePool (4, FREE_RELEASED_NODES);
+  int* nodeA = freePool.popNode ();
+  int* nodeB = freePool.popNode ();
+  ASSERT_EQ (freePool.getCapacity (), 2u);
+  freePool.pushNode (nodeA);
+  ASSERT_EQ (freePool.getNodeCount (), 1u);
+  ASSERT_EQ (freePool.getCapacity (), 1u);
+  freePool.pushNode (nodeB);
+  ASSERT_EQ (freePool.getCapacity (), 0u);
+
+  // rebuild octrees after deleting them - nodes are taken from the node pools
+  OctreeBase<int> octreeA;
+  Octree2BufBase<int> octreeB;
+  OctreeLowMemBase<int> octreeC;
+
+  octreeA.setNodePoolSlabSize (16);
+  ASSERT_EQ (octreeA.getNodePoolSlabSize (), 16u);
+
+  for (unsigned int run = 0; run < 3; run++)
+  {
+    octreeA.setTreeDepth (8);
+    octreeB.setTreeDepth (8);
+    octreeC.setTreeDepth (8);
+
+    for (i = 0; i < 256; i++)
+    {
+      int data = i;
+      octreeA.add (i, 255 - i, i, data);
+      octreeB.add (i, 255 - i, i, data);
+      octreeC.add (i, 255 - i, i, data);
+    }
+
+    ASSERT_EQ (octreeA.getLeafCount (), 256u);
+    ASSERT_EQ (octreeB.getLeafCount (), 256u);
+    ASSERT_EQ (octreeC.getLeafCount (), 256u);
+
+    for (i = 0; i < 256; i++)
+    {
+      int data;
+      ASSERT_EQ (octreeA.get (i, 255 - i, i, data), true);
+      ASSERT_EQ (data, (int)i);
+      ASSERT_EQ (octreeB.get (i, 255 - i, i, data), true);
+      ASSERT_EQ (data, (int)i);
+      ASSERT_EQ (octreeC.get (i, 255 - i, i, data), true);
+      ASSERT_EQ (data, (int)i);
+    }
+
+    // remove some leafs - their nodes go back to the pools
+    for (i = 0; i < 256; i += 2)
+    {
+      octreeA.removeLeaf (i, 255 - i, i);
+      octreeC.removeLeaf (i, 255 - i, i);
+    }
+    ASSERT_EQ (octreeA.getLeafCount (), 128u);
+    ASSERT_EQ (octreeC.getLeafCount (), 128u);
+
+    octreeA.deleteTree (run == 1);
+    octreeB.deleteTree (run == 1);
+    octreeC.deleteTree ();
+
+    ASSERT_EQ (octreeA.getLeafCount (), 0u);
+    ASSERT_EQ (octreeA.getBranchCount (), 1u);
+    ASSERT_EQ (octreeA.existLeaf (1, 254, 1), false);
+    ASSERT_EQ (octreeC.existLeaf (1, 254, 1), false);
+  }
+}
+
+TEST (PCL, Octree_Compact_Tree_Test)
+{
+  unsigned int i;
+  int data;
+
+  OctreeBase<int> octree;
+  OctreeCompactTree<int> compactTree;
+
+  // empty tree
+  compactTree.build (octree);
+  ASSERT_EQ (compactTree.getLeafCount (), 0u);
+  ASSERT_EQ (compactTree.existLeaf (0, 0, 0), false);
+
+  octree.setTreeDepth (8);
+
+  srand (static_cast<unsigned int> (time (NULL)));
+
+  std::vector<unsigned int> voxels;
+  for (i = 0; i < 1000; i++)
+  {
+    unsigned int idxX = rand () % 256;
+    unsigned int idxY = rand () % 256;
+    unsigned int idxZ = rand () % 256;
+
+    octree.add (idxX, idxY, idxZ, (int)i);
+    voxels.push_back (idxX);
+    voxels.push_back (idxY);
+    voxels.push_back (idxZ);
+  }
+
+  // remove some leafs so that branch nodes are reused
+  for (i = 0; i < voxels.size (); i += 9)
+    octree.removeLeaf (voxels[i], voxels[i + 1], voxels[i + 2]);
+
+  compactTree.build (octree);
+
+  ASSERT_EQ (compactTree.getLeafCount (), (std::size_t)octree.getLeafCount ());
+  ASSERT_EQ (compactTree.getBranchCount (), (std::size_t)octree.getBranchCount ());
+
+  for (i = 0; i < voxels.size (); i += 3)
+  {
+    ASSERT_EQ (compactTree.existLeaf (voxels[i], voxels[i + 1], voxels[i + 2]),
+               octree.existLeaf (voxels[i], voxels[i + 1], voxels[i + 2]));
+
+    if (octree.get (voxels[i], voxels[i + 1], voxels[i + 2], data))
+    {
+      int compactData;
+      ASSERT_EQ (compactTree.get (voxels[i], voxels[i + 1], voxels[i + 2], compactData), true);
+      ASSERT_EQ (compactData, data);
+    }
+  }
+
+  // check all voxels of a slice
+  for (i = 0; i < 256 * 256; i++)
+    ASSERT_EQ (compactTree.existLeaf (i % 256, i / 256, 7), octree.existLeaf (i % 256, i / 256, 7));
+
+  compactTree.clear ();
+  ASSERT_EQ (compactTree.getBranchCount (), 0u);
+}
+
 TEST (PCL, Octree_Pointcloud_Test)
 {
 
@@ -837,6 +1011,86 @@ TEST (PCL, Octree_Pointcloud_Test)
 
 
 
+TEST (PCL, Octree_Pointcloud_Bulk_Build_Test)
+{
+  size_t i;
+  int test_runs = 10;
+  int pointcount = 3000;
+
+  int test, point;
+
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+
+  for (test = 0; test < test_runs; ++test)
+  {
+    cloud->points.clear ();
+
+    for (point = 0; point < pointcount; point++)
+    {
+      // random points spread over growing ranges so that the bounding box has to be adapted several times
+      float range = (float)(1 + point % 5) * 10.0f;
+      cloud->points.push_back (PointXYZ (range * ((float)rand () / (float)RAND_MAX - 0.5f),
+                                         range * ((float)rand () / (float)RAND_MAX - 0.5f),
+                                         range * (float)rand () / (float)RAND_MAX));
+    }
+
+    // add an invalid point
+    cloud->points[pointcount / 2].x = std::numeric_limits<float>::quiet_NaN ();
+
+    float resolution = (test % 2) ? 0.05f : 0.5f;
+
+    // octree built in bulk
+    OctreePointCloudPointVector<PointXYZ> octreeA (resolution);
+    octreeA.setNumberOfThreads (2);
+    octreeA.setInputCloud (cloud);
+    octreeA.addPointsFromInputCloud ();
+
+    OctreePointCloudDensity<PointXYZ> densityA (resolution);
+    densityA.setInputCloud (cloud);
+    densityA.addPointsFromInputCloud ();
+
+    // octree built point by point
+    OctreePointCloudPointVector<PointXYZ> octreeB (resolution);
+    OctreePointCloudDensity<PointXYZ> densityB (resolution);
+    octreeB.setInputCloud (cloud);
+    densityB.setInputCloud (cloud);
+
+    for (i = 0; i < cloud->points.size (); i++)
+    {
+      if (pcl_isnan (cloud->points[i].x))
+        continue;
+
+      octreeB.addPointFromCloud ((int)i, OctreePointCloudPointVector<PointXYZ>::IndicesPtr ());
+      densityB.addPointFromCloud ((int)i, OctreePointCloudDensity<PointXYZ>::IndicesPtr ());
+    }
+
+    ASSERT_EQ (octreeA.getTreeDepth (), octreeB.getTreeDepth ());
+    ASSERT_EQ (octreeA.getLeafCount (), octreeB.getLeafCount ());
+    ASSERT_EQ (octreeA.getBranchCount (), octreeB.getBranchCount ());
+
+    // both octrees must have identical structure and leaf content
+    std::vector<char> treeBinaryA;
+    std::vector<char> treeBinaryB;
+    std::vector<int> leafVectorA;
+    std::vector<int> leafVectorB;
+
+    octreeA.serializeTree (treeBinaryA, leafVectorA);
+    octreeB.serializeTree (treeBinaryB, leafVectorB);
+
+    ASSERT_EQ ((treeBinaryA == treeBinaryB), true);
+    ASSERT_EQ ((leafVectorA == leafVectorB), true);
+    ASSERT_EQ (leafVectorA.size (), (size_t)pointcount - 1);
+
+    for (i = 0; i < cloud->points.size (); i++)
+    {
+      if (pcl_isnan (cloud->points[i].x))
+        continue;
+
+      ASSERT_EQ (densityA.getVoxelDensityAtPoint (cloud->points[i]), densityB.getVoxelDensityAtPoint (cloud->points[i]));
+    }
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Density_Test)
 {
 
@@ -1396,6 +1650,305 @@ TEST (PCL, Octree_Pointcloud_Neighbours_Within_Radius_Search)
 }
 
 
+TEST (PCL, Octree_Pointcloud_Batched_Search)
+{
+  const unsigned int test_runs = 10;
+  unsigned int test_id;
+
+  // instantiate point clouds
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+  PointCloud<PointXYZ>::Ptr cloudQuery (new PointCloud<PointXYZ> ());
+
+  size_t i, j;
+
+  srand (time (NULL));
+
+  for (test_id = 0; test_id < test_runs; test_id++)
+  {
+    cloudIn->width = 1000;
+    cloudIn->height = 1;
+    cloudIn->points.resize (cloudIn->width * cloudIn->height);
+
+    // generate point cloud data
+    for (i = 0; i < 1000; i++)
+    {
+      cloudIn->points[i] = PointXYZ (10.0 * ((double)rand () / (double)RAND_MAX),
+                                     10.0 * ((double)rand () / (double)RAND_MAX),
+                                     5.0 * ((double)rand () / (double)RAND_MAX));
+    }
+
+    // query points - some of them are located outside of the octree bounding box
+    cloudQuery->width = 200;
+    cloudQuery->height = 1;
+    cloudQuery->points.resize (cloudQuery->width * cloudQuery->height);
+
+    for (i = 0; i < 200; i++)
+    {
+      cloudQuery->points[i] = PointXYZ (12.0 * ((double)rand () / (double)RAND_MAX) - 1.0,
+                                        12.0 * ((double)rand () / (double)RAND_MAX) - 1.0,
+                                        7.0 * ((double)rand () / (double)RAND_MAX) - 1.0);
+    }
+
+    OctreePointCloudSearch<PointXYZ> octree (0.01);
+    octree.setNumberOfThreads (2);
+
+    // build octree
+    octree.setInputCloud (cloudIn);
+    octree.addPointsFromInputCloud ();
+
+    const int K = 1 + (rand () % 10);
+    const double searchRadius = 2.0 * ((double)rand () / (double)RAND_MAX);
+
+    // every second query point
+    vector<int> queryIndices;
+    for (i = 0; i < cloudQuery->points.size (); i += 2)
+      queryIndices.push_back ((int)i);
+
+    vector<vector<int> > batchKIndices;
+    vector<vector<float> > batchKDistances;
+    vector<vector<int> > batchRIndices;
+    vector<vector<float> > batchRDistances;
+
+    octree.nearestKSearch (*cloudQuery, queryIndices, K, batchKIndices, batchKDistances);
+    octree.radiusSearch (*cloudQuery, queryIndices, searchRadius, batchRIndices, batchRDistances);
+
+    ASSERT_EQ (batchKIndices.size (), queryIndices.size ());
+    ASSERT_EQ (batchRIndices.size (), queryIndices.size ());
+
+    for (i = 0; i < queryIndices.size (); i++)
+    {
+      const PointXYZ& searchPoint = cloudQuery->points[queryIndices[i]];
+
+      vector<int> kIndices;
+      vector<float> kDistances;
+
+      // batched k nearest neighbor search must match the single query search
+      octree.nearestKSearch (searchPoint, K, kIndices, kDistances);
+
+      ASSERT_EQ (batchKIndices[i].size (), (size_t)K);
+      ASSERT_EQ (batchKIndices[i].size (), kIndices.size ());
+      for (j = 0; j < kIndices.size (); j++)
+      {
+        EXPECT_EQ (batchKIndices[i][j], kIndices[j]);
+        EXPECT_EQ (batchKDistances[i][j], kDistances[j]);
+      }
+
+      // results are ordered by decreasing distance
+      for (j = 1; j < kDistances.size (); j++)
+        ASSERT_EQ (kDistances[j - 1] >= kDistances[j], true);
+
+      // bruteforce nearest neighbor distance
+      double bestDist = numeric_limits<double>::max ();
+      for (j = 0; j < cloudIn->points.size (); j++)
+      {
+        double pointDist = (cloudIn->points[j].x - searchPoint.x) * (cloudIn->points[j].x - searchPoint.x)
+                         + (cloudIn->points[j].y - searchPoint.y) * (cloudIn->points[j].y - searchPoint.y)
+                         + (cloudIn->points[j].z - searchPoint.z) * (cloudIn->points[j].z - searchPoint.z);
+        if (pointDist < bestDist)
+          bestDist = pointDist;
+      }
+      EXPECT_NEAR (kDistances.back (), bestDist, 1e-4);
+
+      // batched radius search must match the single query search
+      octree.radiusSearch (searchPoint, searchRadius, kIndices, kDistances);
+
+      ASSERT_EQ (batchRIndices[i].size (), kIndices.size ());
+      for (j = 0; j < kIndices.size (); j++)
+        EXPECT_EQ (batchRIndices[i][j], kIndices[j]);
+    }
+  }
+}
+
+
+TEST (PCL, Octree_Pointcloud_Dynamic_Update_Test)
+{
+  const unsigned int test_runs = 20;
+  unsigned int test_id;
+
+  // instantiate point cloud
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+
+  size_t i, j;
+
+  srand (time (NULL));
+
+  cloudIn->width = 1000;
+  cloudIn->height = 1;
+  cloudIn->points.resize (cloudIn->width * cloudIn->height);
+
+  // generate point cloud data
+  for (i = 0; i < 1000; i++)
+  {
+    cloudIn->points[i] = PointXYZ (10.0 * ((double)rand () / (double)RAND_MAX),
+                                   10.0 * ((double)rand () / (double)RAND_MAX),
+                                   5.0 * ((double)rand () / (double)RAND_MAX));
+  }
+
+  OctreePointCloudSearch<PointXYZ> octree (0.1);
+
+  // build octree
+  octree.setInputCloud (cloudIn);
+  octree.addPointsFromInputCloud ();
+
+  octree.enableDynamicUpdates ();
+  ASSERT_EQ (octree.isDynamic (), true);
+
+  // track which point indices are in use
+  vector<bool> alive (1000, true);
+
+  for (test_id = 0; test_id < test_runs; test_id++)
+  {
+    // remove, move and insert 5% of the points each - the map drifts towards positive x
+    for (i = 0; i < 50; i++)
+    {
+      int idx = rand () % (int)alive.size ();
+      if (alive[idx])
+      {
+        ASSERT_EQ (octree.removePoint (idx), true);
+        alive[idx] = false;
+      }
+      else
+      {
+        ASSERT_EQ (octree.removePoint (idx), false);
+      }
+
+      idx = rand () % (int)alive.size ();
+      PointXYZ newPoint (10.0 * ((double)rand () / (double)RAND_MAX) + test_id,
+                         10.0 * ((double)rand () / (double)RAND_MAX),
+                         5.0 * ((double)rand () / (double)RAND_MAX));
+      ASSERT_EQ (octree.movePoint (idx, newPoint), (bool)alive[idx]);
+
+      int newIdx = octree.insertPoint (newPoint);
+      ASSERT_EQ (newIdx >= 0, true);
+      if (newIdx >= (int)alive.size ())
+        alive.resize (newIdx + 1, false);
+      ASSERT_EQ (alive[newIdx], false);
+      alive[newIdx] = true;
+    }
+
+    // every second run, compact the point storage
+    if (test_id % 2)
+    {
+      vector<int> indexMap;
+      octree.compactPointStorage (indexMap);
+
+      ASSERT_EQ (indexMap.size (), alive.size ());
+
+      vector<bool> compactAlive (octree.getDynamicCloud ()->points.size (), false);
+      for (i = 0; i < indexMap.size (); i++)
+      {
+        ASSERT_EQ (indexMap[i] >= 0, (bool)alive[i]);
+        if (indexMap[i] >= 0)
+          compactAlive[indexMap[i]] = true;
+      }
+      alive = compactAlive;
+    }
+
+    PointCloud<PointXYZ>::ConstPtr cloud = octree.getDynamicCloud ();
+    ASSERT_EQ (cloud->points.size (), alive.size ());
+
+    // compare radius search against bruteforce search over all points in use
+    PointXYZ searchPoint (10.0 * ((double)rand () / (double)RAND_MAX) + test_id,
+                          10.0 * ((double)rand () / (double)RAND_MAX),
+                          5.0 * ((double)rand () / (double)RAND_MAX));
+    double searchRadius = 3.0 * ((double)rand () / (double)RAND_MAX);
+
+    vector<int> cloudSearchBruteforce;
+    for (i = 0; i < cloud->points.size (); i++)
+    {
+      if (!alive[i])
+        continue;
+
+      double pointDist = (cloud->points[i].x - searchPoint.x) * (cloud->points[i].x - searchPoint.x)
+                       + (cloud->points[i].y - searchPoint.y) * (cloud->points[i].y - searchPoint.y)
+                       + (cloud->points[i].z - searchPoint.z) * (cloud->points[i].z - searchPoint.z);
+
+      if (pointDist <= searchRadius * searchRadius)
+        cloudSearchBruteforce.push_back ((int)i);
+    }
+
+    vector<int> cloudNWRSearch;
+    vector<float> cloudNWRRadius;
+
+    octree.radiusSearch (searchPoint, searchRadius, cloudNWRSearch, cloudNWRRadius);
+
+    std::sort (cloudNWRSearch.begin (), cloudNWRSearch.end ());
+    ASSERT_EQ (cloudNWRSearch.size (), cloudSearchBruteforce.size ());
+    for (j = 0; j < cloudNWRSearch.size (); j++)
+      ASSERT_EQ (cloudNWRSearch[j], cloudSearchBruteforce[j]);
+
+    // the octree must still hold every point in use exactly once
+    vector<int> leafIndices;
+    octree.serializeLeafs (leafIndices);
+    std::sort (leafIndices.begin (), leafIndices.end ());
+    ASSERT_EQ (leafIndices.size (), (size_t)std::count (alive.begin (), alive.end (), true));
+    for (j = 0; j < leafIndices.size (); j++)
+      ASSERT_EQ (alive[leafIndices[j]], true);
+  }
+
+  // removing all points prunes all voxels
+  for (i = 0; i < alive.size (); i++)
+    if (alive[i])
+      octree.removePoint ((int)i);
+  octree.pruneEmptyVoxels ();
+
+  ASSERT_EQ (octree.getLeafCount (), 0u);
+  ASSERT_EQ (octree.getBranchCount (), 1u);
+}
+
+
+TEST (PCL, Octree_Pointcloud_Dynamic_Single_Index_Leaf_Test)
+{
+  // instantiate point cloud - every point gets its own voxel
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+
+  cloudIn->width = 10;
+  cloudIn->height = 1;
+  cloudIn->points.resize (cloudIn->width * cloudIn->height);
+
+  size_t i;
+  for (i = 0; i < cloudIn->points.size (); i++)
+    cloudIn->points[i] = PointXYZ ((float)i, 0.5f * (float)i, 1.0f);
+
+  OctreePointCloudSearch<PointXYZ, OctreeLeafDataT<int> > octree (0.1);
+  octree.setInputCloud (cloudIn);
+  octree.addPointsFromInputCloud ();
+  octree.enableDynamicUpdates ();
+
+  // keep empty vector leafs around - single index leafs still have to go right away
+  octree.setPruneRatio (1.0);
+
+  ASSERT_EQ (octree.getLeafCount (), 10u);
+  ASSERT_EQ (octree.removePoint (5), true);
+  ASSERT_EQ (octree.getLeafCount (), 9u);
+
+  vector<int> k_indices;
+  vector<float> k_sqr_distances;
+
+  // the removed voxel does not report any point
+  octree.radiusSearch (PointXYZ (5.0f, 2.5f, 1.0f), 0.3, k_indices, k_sqr_distances);
+  ASSERT_EQ (k_indices.size (), 0u);
+
+  octree.nearestKSearch (PointXYZ (5.0f, 2.5f, 1.0f), 1, k_indices, k_sqr_distances);
+  ASSERT_EQ (k_indices.size (), 1u);
+  ASSERT_EQ (k_indices[0] == 4 || k_indices[0] == 6, true);
+
+  // moving a point out of its voxel deletes the old voxel
+  ASSERT_EQ (octree.movePoint (3, PointXYZ (3.0f, 7.0f, 1.0f)), true);
+  ASSERT_EQ (octree.getLeafCount (), 9u);
+  octree.radiusSearch (PointXYZ (3.0f, 1.5f, 1.0f), 0.3, k_indices, k_sqr_distances);
+  ASSERT_EQ (k_indices.size (), 0u);
+  octree.radiusSearch (PointXYZ (3.0f, 7.0f, 1.0f), 0.3, k_indices, k_sqr_distances);
+  ASSERT_EQ (k_indices.size (), 1u);
+  ASSERT_EQ (k_indices[0], 3);
+
+  // a reused slot is found again
+  ASSERT_EQ (octree.insertPoint (PointXYZ (5.0f, 2.5f, 1.0f)), 5);
+  octree.radiusSearch (PointXYZ (5.0f, 2.5f, 1.0f), 0.3, k_indices, k_sqr_distances);
+  ASSERT_EQ (k_indices.size (), 1u);
+  ASSERT_EQ (k_indices[0], 5);
+}
+
 TEST (PCL, Octree_Pointcloud_Ray_Traversal)
 {
 
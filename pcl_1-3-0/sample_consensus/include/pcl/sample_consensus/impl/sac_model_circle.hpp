@@ -169,6 +169,23 @@ pcl::SampleConsensusModelCircle2D<PointT>::countWithinDistance (
     return (0);
   int nr_p = 0;
 
+  // Read the coordinate columns if a structure-of-arrays copy of the input was given
+  const float *x, *y, *z;
+  if (this->getInputColumns (x, y, z))
+  {
+    for (size_t i = 0; i < indices_->size (); ++i)
+    {
+      int idx = (*indices_)[i];
+      float distance = fabs (sqrt (
+                                   ( x[idx] - model_coefficients[0] ) * ( x[idx] - model_coefficients[0] ) +
+                                   ( y[idx] - model_coefficients[1] ) * ( y[idx] - model_coefficients[1] )
+                                  ) - model_coefficients[2]);
+      if (distance < threshold)
+        nr_p++;
+    }
+    return (nr_p);
+  }
+
   // Iterate through the 3d points and calculate the distances from them to the sphere
   for (size_t i = 0; i < indices_->size (); ++i)
   {
@@ -162,6 +162,21 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
   line_dir.normalize ();
 
+  // Read the coordinate columns if a structure-of-arrays copy of the input was given
+  const float *x, *y, *z;
+  if (this->getInputColumns (x, y, z))
+  {
+    for (size_t i = 0; i < indices_->size (); ++i)
+    {
+      Eigen::Vector4f pt (x[(*indices_)[i]], y[(*indices_)[i]], z[(*indices_)[i]], 0);
+      double sqr_distance = (line_pt - pt).cross3 (line_dir).squaredNorm ();
+
+      if (sqr_distance < sqr_threshold)
+        nr_p++;
+    }
+    return (nr_p);
+  }
+
   // Iterate through the 3d points and calculate the distances from them to the line
   for (size_t i = 0; i < indices_->size (); ++i)
   {
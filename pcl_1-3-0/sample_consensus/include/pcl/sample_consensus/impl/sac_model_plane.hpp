@@ -182,6 +182,19 @@ pcl::SampleConsensusModelPlane<PointT>::countWithinDistance (
 
   int nr_p = 0;
 
+  // Read the coordinate columns if a structure-of-arrays copy of the input was given
+  const float *x, *y, *z;
+  if (this->getInputColumns (x, y, z))
+  {
+    for (size_t i = 0; i < indices_->size (); ++i)
+    {
+      Eigen::Vector4f pt (x[(*indices_)[i]], y[(*indices_)[i]], z[(*indices_)[i]], 1);
+      if (fabs (model_coefficients.dot (pt)) < threshold)
+        nr_p++;
+    }
+    return (nr_p);
+  }
+
   // Iterate through the 3d points and calculate the distances from them to the plane
   for (size_t i = 0; i < indices_->size (); ++i)
   {
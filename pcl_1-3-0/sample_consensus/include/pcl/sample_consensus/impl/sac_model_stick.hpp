@@ -186,6 +186,22 @@ pcl::SampleConsensusModelStick<PointT>::countWithinDistance (
   //Eigen::Vector4f line_dir (model_coefficients[3] - model_coefficients[0], model_coefficients[4] - model_coefficients[1], model_coefficients[5] - model_coefficients[2], 0);
   //Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
 
+  // Read the coordinate columns if a structure-of-arrays copy of the input was given
+  const float *x, *y, *z;
+  if (this->getInputColumns (x, y, z))
+  {
+    for (size_t i = 0; i < indices_->size (); ++i)
+    {
+      Eigen::Vector4f dir = Eigen::Vector4f (x[(*indices_)[i]], y[(*indices_)[i]], z[(*indices_)[i]], 0) - line_pt1;
+      float sqr_distance = dir.cross3 (line_dir).squaredNorm ();
+      if (sqr_distance < sqr_threshold)
+        nr_i++;
+      else if (sqr_distance < 4 * sqr_threshold)
+        nr_o++;
+    }
+    return (nr_i - nr_o < 0 ? 0 : nr_i - nr_o);
+  }
+
   // Iterate through the 3d points and calculate the distances from them to the line
   for (size_t i = 0; i < indices_->size (); ++i)
   {
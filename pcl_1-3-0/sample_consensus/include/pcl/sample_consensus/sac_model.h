@@ -46,6 +46,7 @@
 
 #include <pcl/console/print.h>
 #include <pcl/point_cloud.h>
+#include <pcl/point_cloud_soa.h>
 #include "pcl/sample_consensus/model_types.h"
 
 namespace pcl
@@ -67,20 +68,23 @@ namespace pcl
       typedef typename pcl::PointCloud<PointT> PointCloud;
       typedef typename pcl::PointCloud<PointT>::ConstPtr PointCloudConstPtr;
       typedef typename pcl::PointCloud<PointT>::Ptr PointCloudPtr;
+      typedef boost::shared_ptr<const pcl::PointCloudSoA<PointT> > PointCloudSoAConstPtr;
 
       typedef boost::shared_ptr<SampleConsensusModel> Ptr;
       typedef boost::shared_ptr<const SampleConsensusModel> ConstPtr;
 
     private:
       /** \brief Empty constructor for base SampleConsensusModel. */
-      SampleConsensusModel () : radius_min_ (-DBL_MAX), radius_max_ (DBL_MAX) {};
+      SampleConsensusModel () : radius_min_ (-DBL_MAX), radius_max_ (DBL_MAX),
+                                soa_x_ (NULL), soa_y_ (NULL), soa_z_ (NULL), soa_size_ (0) {};
 
     public:
       /** \brief Constructor for base SampleConsensusModel.
         * \param[in] cloud the input point cloud dataset
         */
       SampleConsensusModel (const PointCloudConstPtr &cloud) : 
-        radius_min_ (-DBL_MAX), radius_max_ (DBL_MAX)
+        radius_min_ (-DBL_MAX), radius_max_ (DBL_MAX),
+        soa_x_ (NULL), soa_y_ (NULL), soa_z_ (NULL), soa_size_ (0)
       {
         // Sets the input cloud and creates a vector of "fake" indices
         setInputCloud (cloud);
@@ -92,7 +96,8 @@ namespace pcl
         */
       SampleConsensusModel (const PointCloudConstPtr &cloud, const std::vector<int> &indices) :
                             input_ (cloud),
-                            radius_min_ (-DBL_MAX), radius_max_ (DBL_MAX) 
+                            radius_min_ (-DBL_MAX), radius_max_ (DBL_MAX),
+                            soa_x_ (NULL), soa_y_ (NULL), soa_z_ (NULL), soa_size_ (0)
     
       {
         indices_.reset (new std::vector<int> (indices));
@@ -236,6 +241,10 @@ namespace pcl
       setInputCloud (const PointCloudConstPtr &cloud)
       {
         input_ = cloud;
+        // Columns of a previous dataset no longer describe the input
+        input_soa_.reset ();
+        soa_x_ = soa_y_ = soa_z_ = NULL;
+        soa_size_ = 0;
         if (!indices_)
           indices_.reset (new std::vector<int> ());
         if (indices_->empty ())
@@ -252,6 +261,29 @@ namespace pcl
       inline PointCloudConstPtr 
       getInputCloud () const { return (input_); }
 
+      /** \brief Provide a structure-of-arrays copy of the input dataset. The plane, line, sphere, circle and stick
+        * models then count inliers from its x, y and z columns instead of the point structs.
+        * \param[in] cloud the columns of the dataset given to setInputCloud ()
+        * \note The columns are ignored if their size differs from the input cloud, and setInputCloud () drops them.
+        */
+      inline void
+      setInputCloudSoA (const PointCloudSoAConstPtr &cloud)
+      {
+        input_soa_ = cloud;
+        soa_x_ = soa_y_ = soa_z_ = NULL;
+        soa_size_ = 0;
+        if (!cloud || cloud->empty ())
+          return;
+        soa_x_ = cloud->x ();
+        soa_y_ = cloud->y ();
+        soa_z_ = cloud->z ();
+        soa_size_ = cloud->size ();
+      }
+
+      /** \brief Get a pointer to the structure-of-arrays copy of the input dataset. */
+      inline PointCloudSoAConstPtr 
+      getInputCloudSoA () const { return (input_soa_); }
+
       /** \brief Provide a pointer to the vector of indices that represents the input data.
         * \param[in] indices a pointer to the vector of indices that represents the input data.
         */
@@ -347,6 +379,23 @@ namespace pcl
       virtual bool
       isSampleGood (const std::vector<int> &samples) const = 0;
 
+      /** \brief Get the coordinate columns of the structure-of-arrays input, if one matching the input cloud was given.
+        * \param[out] x the x column
+        * \param[out] y the y column
+        * \param[out] z the z column
+        * \return true if the columns can be used instead of the points of input_
+        */
+      inline bool
+      getInputColumns (const float *&x, const float *&y, const float *&z) const
+      {
+        if (!soa_x_ || !input_ || soa_size_ != input_->points.size ())
+          return (false);
+        x = soa_x_;
+        y = soa_y_;
+        z = soa_z_;
+        return (true);
+      }
+
       /** \brief A boost shared pointer to the point cloud data array. */
       PointCloudConstPtr input_;
 
@@ -363,6 +412,16 @@ namespace pcl
 
       /** Data containing a shuffled version of the indices. This is used and modified when drawing samples. */
       std::vector<int> shuffled_indices_;
+
+      /** \brief An optional structure-of-arrays copy of the input dataset. */
+      PointCloudSoAConstPtr input_soa_;
+
+      /** \brief The coordinate columns of input_soa_, kept as plain pointers so that models for point types without
+        * registered fields never instantiate PointCloudSoA. */
+      const float *soa_x_, *soa_y_, *soa_z_;
+
+      /** \brief The number of points in input_soa_. */
+      size_t soa_size_;
   };
 
   /** \brief @b SampleConsensusModelFromNormals represents the base model class
@@ -67,6 +67,68 @@ namespace pcl
   template <typename PointT> bool 
   isXYPointIn2DXYPolygon (const PointT &point, const pcl::PointCloud<PointT> &polygon);
 
+  ////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief @b PreparedXYPolygon is a 2D polygon (X and Y coordinates considered only!)
+    * preprocessed for fast repeated point in polygon queries.
+    *
+    * The X axis is split into slabs at the X coordinates of the polygon
+    * vertices. No vertex lies strictly inside a slab, so the edges that can be
+    * crossed by a point of a slab are known in advance and stored per slab. A
+    * query locates the slab by binary search and only tests the edges spanning
+    * it (two for a convex polygon) instead of all edges of the polygon. The
+    * results are identical to \a isXYPointIn2DXYPolygon.
+    *
+    * Once built, \a contains () does not modify the object and can be called
+    * from several threads concurrently.
+    * \ingroup segmentation
+    */
+  class PCL_EXPORTS PreparedXYPolygon
+  {
+    public:
+      /** \brief Empty constructor. */
+      PreparedXYPolygon () : slab_x_ (), slab_begin_ (), slab_edges_ () {}
+
+      /** \brief Build the slab decomposition of a polygon.
+        * \param polygon a polygon, only the X and Y coordinates of its points are used
+        */
+      template <typename PointT> void
+      setPolygon (const pcl::PointCloud<PointT> &polygon);
+
+      /** \brief Build the slab decomposition of a polygon.
+        * \param x the X coordinates of the polygon vertices
+        * \param y the Y coordinates of the polygon vertices
+        */
+      void
+      setPolygon (const std::vector<double> &x, const std::vector<double> &y);
+
+      /** \brief Check if a 2D point is inside the polygon.
+        * \param x the X coordinate of the point
+        * \param y the Y coordinate of the point
+        */
+      bool
+      contains (double x, double y) const;
+
+      /** \brief Get the number of slabs the polygon has been split into. */
+      inline size_t
+      getNumberOfSlabs () const { return (slab_x_.empty () ? 0 : slab_x_.size () - 1); }
+
+    private:
+      /** \brief A non-vertical polygon edge, with x1 < x2. */
+      struct Edge
+      {
+        double x1, y1, x2, y2;
+      };
+
+      /** \brief Sorted, unique X coordinates of the polygon vertices. Slab i is (slab_x_[i], slab_x_[i + 1]]. */
+      std::vector<double> slab_x_;
+
+      /** \brief Offsets of the edges of each slab in slab_edges_ (one entry per slab plus one). */
+      std::vector<int> slab_begin_;
+
+      /** \brief The edges spanning each slab, stored consecutively slab after slab. */
+      std::vector<Edge> slab_edges_;
+  };
+
   ////////////////////////////////////////////////////////////////////////////////////////////
   /** \brief @b ExtractPolygonalPrismData uses a set of point indices that
     * represent a planar model, and together with a given height, generates a 3D
@@ -98,14 +160,21 @@ namespace pcl
       /** \brief Empty constructor. */
       ExtractPolygonalPrismData () : min_pts_hull_ (3), 
                                      height_limit_min_ (0), height_limit_max_ (FLT_MAX),
-                                     vpx_ (0), vpy_ (0), vpz_ (0)
+                                     vpx_ (0), vpy_ (0), vpz_ (0),
+                                     k1_ (0), k2_ (1), hull_prepared_ (false), threads_ (1)
       {};
 
-      /** \brief Provide a pointer to the input planar hull dataset.
+      /** \brief Provide a pointer to the input planar hull dataset. The hull is
+        * prepared for point in polygon queries once, on the next call to \a segment ().
+        * Call this method again if the hull data is modified afterwards.
         * \param hull the input planar hull dataset
         */
       inline void 
-      setInputPlanarHull (const PointCloudConstPtr &hull) { planar_hull_ = hull; }
+      setInputPlanarHull (const PointCloudConstPtr &hull) 
+      { 
+        planar_hull_ = hull; 
+        hull_prepared_ = false;
+      }
 
       /** \brief Get a pointer the input planar hull dataset. */
       inline PointCloudConstPtr 
@@ -158,6 +227,21 @@ namespace pcl
         vpz = vpz_;
       }
 
+      /** \brief Set the number of threads used to test the points against the prism.
+        * \param nr_threads the number of threads to use (0 is treated as 1), default is 1
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads used to test the points against the prism. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Cluster extraction in a PointCloud given by <setInputCloud (), setIndices ()>
         * \param output the resultant point indices that support the model found (inliers)
         */
@@ -184,6 +268,18 @@ namespace pcl
       /** \brief Values describing the data acquisition viewpoint. Default: 0,0,0. */
       float vpx_, vpy_, vpz_;
 
+      /** \brief The planar hull projected onto its best fitting coordinate plane and prepared for queries. */
+      PreparedXYPolygon polygon_;
+
+      /** \brief The two coordinates (0 = X, 1 = Y, 2 = Z) spanning the plane \a polygon_ lies in. */
+      int k1_, k2_;
+
+      /** \brief True if \a polygon_ has been built from the current planar hull. */
+      bool hull_prepared_;
+
+      /** \brief The number of threads used to test the points against the prism. */
+      unsigned int threads_;
+
       /** \brief Class getName method. */
       virtual std::string 
       getClassName () const { return ("ExtractPolygonalPrismData"); }
@@ -145,6 +145,19 @@ pcl::isXYPointIn2DXYPolygon (const PointT &point, const pcl::PointCloud<PointT>
   return (in_poly);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PreparedXYPolygon::setPolygon (const pcl::PointCloud<PointT> &polygon)
+{
+  std::vector<double> x (polygon.points.size ()), y (polygon.points.size ());
+  for (size_t i = 0; i < polygon.points.size (); ++i)
+  {
+    x[i] = polygon.points[i].x;
+    y[i] = polygon.points[i].y;
+  }
+  setPolygon (x, y);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::ExtractPolygonalPrismData<PointT>::segment (pcl::PointIndices &output)
@@ -204,53 +217,63 @@ pcl::ExtractPolygonalPrismData<PointT>::segment (pcl::PointIndices &output)
     model_coefficients[3] = -1 * (model_coefficients.dot (planar_hull_->points[0].getVector4fMap ()));
   }
     
-  // Project all points
-  PointCloud projected_points;
-  SampleConsensusModelPlane<PointT> sacmodel (input_);
-  sacmodel.projectPoints (*indices_, model_coefficients, projected_points, false);
-
   // Create a X-Y projected representation for within bounds polygonal checking
-  int k0, k1, k2;
-  // Determine the best plane to project points onto
-  k0 = (fabs (model_coefficients[0] ) > fabs (model_coefficients[1])) ? 0  : 1;
-  k0 = (fabs (model_coefficients[k0]) > fabs (model_coefficients[2])) ? k0 : 2;
-  k1 = (k0 + 1) % 3;
-  k2 = (k0 + 2) % 3;
-  // Project the convex hull
-  pcl::PointCloud<PointT> polygon;
-  polygon.points.resize (planar_hull_->points.size ());
-  for (size_t i = 0; i < planar_hull_->points.size (); ++i)
+  if (!hull_prepared_)
   {
-    Eigen::Vector4f pt (planar_hull_->points[i].x, planar_hull_->points[i].y, planar_hull_->points[i].z, 0);
-    polygon.points[i].x = pt[k1];
-    polygon.points[i].y = pt[k2];
-    polygon.points[i].z = 0;
+    int k0;
+    // Determine the best plane to project points onto
+    k0 = (fabs (model_coefficients[0] ) > fabs (model_coefficients[1])) ? 0  : 1;
+    k0 = (fabs (model_coefficients[k0]) > fabs (model_coefficients[2])) ? k0 : 2;
+    k1_ = (k0 + 1) % 3;
+    k2_ = (k0 + 2) % 3;
+    // Project the convex hull
+    std::vector<double> polygon_x (planar_hull_->points.size ()), polygon_y (planar_hull_->points.size ());
+    for (size_t i = 0; i < planar_hull_->points.size (); ++i)
+    {
+      Eigen::Vector4f pt (planar_hull_->points[i].x, planar_hull_->points[i].y, planar_hull_->points[i].z, 0);
+      polygon_x[i] = pt[k1_];
+      polygon_y[i] = pt[k2_];
+    }
+    polygon_.setPolygon (polygon_x, polygon_y);
+    hull_prepared_ = true;
   }
 
-  PointT pt_xy;
-  pt_xy.z = 0;
-
-  output.indices.resize (indices_->size ());
-  int l = 0;
-  for (size_t i = 0; i < projected_points.points.size (); ++i)
+  // Normalized plane normal used to project the points onto the plane
+  Eigen::Vector4f mc (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
+  mc.normalize ();
+  Eigen::Vector4f projection_coefficients = model_coefficients;
+  projection_coefficients[0] = mc[0];
+  projection_coefficients[1] = mc[1];
+  projection_coefficients[2] = mc[2];
+
+  // Test all points against the prism, then gather the inliers in their original order
+  int nr_points = (int)indices_->size ();
+  std::vector<uint8_t> inside (nr_points);
+#pragma omp parallel for schedule (static) num_threads (threads_)
+  for (int i = 0; i < nr_points; ++i)
   {
+    const PointT &point = input_->points[(*indices_)[i]];
+    inside[i] = 0;
+
     // Check the distance to the user imposed limits from the table planar model
-    double distance = pointToPlaneDistanceSigned (input_->points[(*indices_)[i]], model_coefficients);
+    double distance = pointToPlaneDistanceSigned (point, model_coefficients);
     if (distance < height_limit_min_ || distance > height_limit_max_)
       continue;
 
-    // Check what points are inside the hull
-    Eigen::Vector4f pt (projected_points.points[i].x,
-                         projected_points.points[i].y,
-                         projected_points.points[i].z, 0);
-    pt_xy.x = pt[k1];
-    pt_xy.y = pt[k2];
-
-    if (!pcl::isXYPointIn2DXYPolygon (pt_xy, polygon))
-      continue;
+    // Project the point onto the plane and check if it is inside the hull
+    Eigen::Vector4f pt (point.x, point.y, point.z, 1);
+    float distance_to_plane = projection_coefficients.dot (pt);
+    pt -= mc * distance_to_plane;
 
-    output.indices[l++] = (*indices_)[i];
+    if (polygon_.contains (pt[k1_], pt[k2_]))
+      inside[i] = 1;
   }
+
+  output.indices.resize (nr_points);
+  int l = 0;
+  for (int i = 0; i < nr_points; ++i)
+    if (inside[i])
+      output.indices[l++] = (*indices_)[i];
   output.indices.resize (l);
 
   deinitCompute ();
@@ -259,6 +282,7 @@ pcl::ExtractPolygonalPrismData<PointT>::segment (pcl::PointIndices &output)
 #define PCL_INSTANTIATE_ExtractPolygonalPrismData(T) template class PCL_EXPORTS pcl::ExtractPolygonalPrismData<T>;
 #define PCL_INSTANTIATE_isPointIn2DPolygon(T) template bool PCL_EXPORTS pcl::isPointIn2DPolygon<T>(const T&, const pcl::PointCloud<T> &);
 #define PCL_INSTANTIATE_isXYPointIn2DXYPolygon(T) template bool PCL_EXPORTS pcl::isXYPointIn2DXYPolygon<T>(const T &, const pcl::PointCloud<T> &);
+#define PCL_INSTANTIATE_PreparedXYPolygonSetPolygon(T) template void PCL_EXPORTS pcl::PreparedXYPolygon::setPolygon<T>(const pcl::PointCloud<T> &);
 
 #endif    // PCL_SEGMENTATION_IMPL_EXTRACT_POLYGONAL_PRISM_DATA_H_
 
@@ -39,6 +39,8 @@
 #define PCL_SEGMENTATION_IMPL_SAC_SEGMENTATION_H_
 
 #include "pcl/segmentation/sac_segmentation.h"
+#include <climits>
+#include <limits>
 
 // Sample Consensus methods
 #include "pcl/sample_consensus/method_types.h"
@@ -124,6 +126,177 @@ pcl::SACSegmentation<PointT>::segment (PointIndices &inliers, ModelCoefficients
   deinitCompute ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SACSegmentation<PointT>::segmentModels (int max_models, int min_inliers, 
+                                             std::vector<PointIndices> &inliers, 
+                                             std::vector<ModelCoefficients> &model_coefficients)
+{
+  inliers.clear ();
+  model_coefficients.clear ();
+
+  if (!initCompute ()) 
+    return;
+
+  // Initialize the Sample Consensus model and method once, over all the given indices
+  if (!initSACModel (model_type_))
+  {
+    PCL_ERROR ("[pcl::%s::segmentModels] Error initializing the SAC model!\n", getClassName ().c_str ());
+    deinitCompute ();
+    return;
+  }
+  initSAC (method_type_);
+
+  // The points that have not been assigned to a model yet
+  std::vector<uint8_t> active (input_->points.size (), 0);
+  for (size_t i = 0; i < indices_->size (); ++i)
+    active[(*indices_)[i]] = 1;
+  boost::shared_ptr<std::vector<int> > remaining (new std::vector<int> (*indices_));
+
+  min_inliers = (std::max) (min_inliers, (int)model_->getSampleSize ());
+  for (int m = 0; m < max_models; ++m)
+  {
+    if ((int)remaining->size () < min_inliers)
+      break;
+    if (m > 0)
+      model_->setIndices (remaining);
+
+    Eigen::VectorXf coeff;
+    PointIndices model_inliers;
+    model_inliers.header = input_->header;
+    if (threads_ > 1 && method_type_ == SAC_RANSAC)
+    {
+      if (!computeModelParallel (coeff, model_inliers.indices))
+        break;
+    }
+    else
+    {
+      if (!sac_->computeModel (0))
+        break;
+      sac_->getInliers (model_inliers.indices);
+      sac_->getModelCoefficients (coeff);
+    }
+
+    ModelCoefficients model;
+    model.header = input_->header;
+    // If the user needs optimized coefficients
+    if (optimize_coefficients_)
+    {
+      Eigen::VectorXf coeff_refined;
+      model_->optimizeModelCoefficients (model_inliers.indices, coeff, coeff_refined);
+      model.values.resize (coeff_refined.size ());
+      memcpy (&model.values[0], &coeff_refined[0], coeff_refined.size () * sizeof (float));
+      // Refine inliers
+      model_->selectWithinDistance (coeff_refined, threshold_, model_inliers.indices);
+    }
+    else
+    {
+      model.values.resize (coeff.size ());
+      memcpy (&model.values[0], &coeff[0], coeff.size () * sizeof (float));
+    }
+
+    if ((int)model_inliers.indices.size () < min_inliers)
+      break;
+
+    // Remove the inliers from the active set
+    for (size_t i = 0; i < model_inliers.indices.size (); ++i)
+      active[model_inliers.indices[i]] = 0;
+    boost::shared_ptr<std::vector<int> > next (new std::vector<int>);
+    next->reserve (remaining->size () - model_inliers.indices.size ());
+    for (size_t i = 0; i < remaining->size (); ++i)
+      if (active[(*remaining)[i]])
+        next->push_back ((*remaining)[i]);
+    remaining = next;
+
+    inliers.push_back (model_inliers);
+    model_coefficients.push_back (model);
+  }
+
+  deinitCompute ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SACSegmentation<PointT>::computeModelParallel (Eigen::VectorXf &model_coefficients, std::vector<int> &inliers)
+{
+  int iterations = 0;
+  int n_best_inliers_count = -INT_MAX;
+  double k = 1.0;
+  int max_iterations = sac_->getMaxIterations ();
+  double probability = sac_->getProbability ();
+  bool found = false;
+  bool done = false;
+
+  int batch_size = (int)threads_;
+  std::vector<std::vector<int> > selections (batch_size);
+  std::vector<Eigen::VectorXf> hypotheses (batch_size);
+  std::vector<int> counts (batch_size);
+
+  while (!done && iterations < k)
+  {
+    // Draw a batch of hypotheses in the same order RandomSampleConsensus would draw them
+    int nr_hypotheses = 0, nr_failed = 0;
+    while (nr_hypotheses < batch_size && nr_failed <= max_iterations)
+    {
+      model_->getSamples (iterations, selections[nr_hypotheses]);
+      if (selections[nr_hypotheses].empty ())
+      {
+        PCL_ERROR ("[pcl::%s::computeModelParallel] No samples could be selected!\n", getClassName ().c_str ());
+        done = true;
+        break;
+      }
+      if (!model_->computeModelCoefficients (selections[nr_hypotheses], hypotheses[nr_hypotheses]))
+      {
+        ++nr_failed;
+        continue;
+      }
+      ++nr_hypotheses;
+    }
+    if (nr_hypotheses == 0)
+      break;
+
+    // Score the batch
+#pragma omp parallel for schedule (dynamic) num_threads (threads_)
+    for (int h = 0; h < nr_hypotheses; ++h)
+      counts[h] = model_->countWithinDistance (hypotheses[h], threshold_);
+
+    // Accept the hypotheses in order, until RandomSampleConsensus would have stopped
+    for (int h = 0; h < nr_hypotheses && iterations < k; ++h)
+    {
+      if (counts[h] > n_best_inliers_count)
+      {
+        n_best_inliers_count = counts[h];
+        model_coefficients = hypotheses[h];
+        found = true;
+
+        // Compute the k parameter (k=log(z)/log(1-w^n))
+        double w = (double)((double)n_best_inliers_count / (double)model_->getIndices ()->size ());
+        double p_no_outliers = 1.0 - pow (w, (double)selections[h].size ());
+        p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+        p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+        k = log (1.0 - probability) / log (p_no_outliers);
+      }
+
+      ++iterations;
+      if (iterations > max_iterations)
+      {
+        done = true;
+        break;
+      }
+    }
+  }
+
+  if (!found)
+  {
+    inliers.clear ();
+    return (false);
+  }
+
+  // Get the set of inliers that correspond to the best model found so far
+  model_->selectWithinDistance (model_coefficients, threshold_, inliers);
+  return (true);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> bool
 pcl::SACSegmentation<PointT>::initSACModel (const int model_type)
@@ -40,6 +40,9 @@
 
 #include "pcl/segmentation/segment_differences.h"
 #include "pcl/common/concatenate.h"
+#include "pcl/common/io.h"
+#include <algorithm>
+#include <cfloat>
 
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -92,6 +95,116 @@ pcl::getPointCloudDifference (
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void 
+pcl::SegmentDifferences<PointT>::initTargetIndex ()
+{
+  if (index_type_ == SEARCH_TREE)
+  {
+    // Initialize the spatial locator
+    if (!tree_)
+    {
+      if (target_->isOrganized ())
+        tree_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
+      else
+        tree_.reset (new pcl::search::KdTree<PointT> (false));
+    }
+    // Send the input dataset to the spatial locator
+    tree_->setInputCloud (target_);
+    voxel_map_.clear ();
+    voxel_points_.clear ();
+    return;
+  }
+
+  // Collect the finite target points and their bounding box
+  std::vector<int> valid;
+  valid.reserve (target_->points.size ());
+  voxel_min_.setConstant (FLT_MAX);
+  voxel_max_.setConstant (-FLT_MAX);
+  for (size_t i = 0; i < target_->points.size (); ++i)
+  {
+    const PointT &p = target_->points[i];
+    if (!pcl_isfinite (p.x) || !pcl_isfinite (p.y) || !pcl_isfinite (p.z))
+      continue;
+    valid.push_back ((int)i);
+    voxel_min_ = voxel_min_.cwiseMin (p.getVector3fMap ());
+    voxel_max_ = voxel_max_.cwiseMax (p.getVector3fMap ());
+  }
+
+  // Voxels as large as the search radius, so that all neighbors of a point lie in
+  // the 3x3x3 voxels around it, but coarse enough to keep the voxel coordinates small
+  float radius = (float)sqrt (std::max (distance_threshold_, 0.0));
+  voxel_size_ = radius;
+  if (!valid.empty ())
+  {
+    float extent = std::max (voxel_min_.cwiseAbs ().maxCoeff (), voxel_max_.cwiseAbs ().maxCoeff ()) + radius;
+    voxel_size_ = std::max (voxel_size_, extent / (1 << 20));
+  }
+  if (voxel_size_ <= 0)
+    voxel_size_ = 1;
+  voxel_min_.array () -= radius;
+  voxel_max_.array () += radius;
+
+  // Sort the points by voxel and store them grouped
+  std::vector<std::pair<VoxelKey, int> > keys (valid.size ());
+  for (size_t i = 0; i < valid.size (); ++i)
+  {
+    const PointT &p = target_->points[valid[i]];
+    keys[i].first = getVoxelKey (p.x, p.y, p.z);
+    keys[i].second = valid[i];
+  }
+  std::sort (keys.begin (), keys.end ());
+
+  voxel_map_.clear ();
+  voxel_points_.resize (keys.size () * 3);
+  for (size_t i = 0; i < keys.size (); ++i)
+  {
+    const PointT &p = target_->points[keys[i].second];
+    voxel_points_[i * 3 + 0] = p.x;
+    voxel_points_[i * 3 + 1] = p.y;
+    voxel_points_[i * 3 + 2] = p.z;
+
+    if (i == 0 || !(keys[i].first == keys[i - 1].first))
+      voxel_map_[keys[i].first] = std::make_pair ((int)i, (int)i + 1);
+    else
+      voxel_map_[keys[i].first].second = (int)i + 1;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SegmentDifferences<PointT>::hasVoxelNeighbor (const PointT &point) const
+{
+  if (point.x < voxel_min_[0] || point.y < voxel_min_[1] || point.z < voxel_min_[2] ||
+      point.x > voxel_max_[0] || point.y > voxel_max_[1] || point.z > voxel_max_[2])
+    return (false);
+
+  VoxelKey center = getVoxelKey (point.x, point.y, point.z);
+  VoxelKey key;
+  for (key.x = center.x - 1; key.x <= center.x + 1; ++key.x)
+  {
+    for (key.y = center.y - 1; key.y <= center.y + 1; ++key.y)
+    {
+      for (key.z = center.z - 1; key.z <= center.z + 1; ++key.z)
+      {
+        typename boost::unordered_map<VoxelKey, std::pair<int, int>, VoxelKeyHash>::const_iterator it = voxel_map_.find (key);
+        if (it == voxel_map_.end ())
+          continue;
+
+        for (int i = it->second.first; i < it->second.second; ++i)
+        {
+          float dx = voxel_points_[i * 3 + 0] - point.x;
+          float dy = voxel_points_[i * 3 + 1] - point.y;
+          float dz = voxel_points_[i * 3 + 2] - point.z;
+          if (dx * dx + dy * dy + dz * dz <= distance_threshold_)
+            return (true);
+        }
+      }
+    }
+  }
+  return (false);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void 
 pcl::SegmentDifferences<PointT>::segment (PointCloud &output)
@@ -112,18 +225,62 @@ pcl::SegmentDifferences<PointT>::segment (PointCloud &output)
     return;
   }
 
-  // Initialize the spatial locator
-  if (!tree_)
+  if (!keep_target_index_ || !target_index_valid_ || (index_type_ == SEARCH_TREE && !tree_))
   {
-    if (target_->isOrganized ())
-      tree_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
-    else
-      tree_.reset (new pcl::search::KdTree<PointT> (false));
+    initTargetIndex ();
+    target_index_valid_ = true;
   }
-  // Send the input dataset to the spatial locator
-  tree_->setInputCloud (target_);
 
-  getPointCloudDifference (*input_, *target_, distance_threshold_, tree_, output);
+  // Organized neighbor searches keep state in the search object
+  unsigned int nr_threads = threads_;
+  if (index_type_ == SEARCH_TREE && boost::dynamic_pointer_cast<pcl::search::OrganizedNeighbor<PointT> > (tree_))
+    nr_threads = 1;
+
+  // Mark the source points that do not have a neighbor in the target
+  int nr_points = (int)input_->points.size ();
+  std::vector<uint8_t> different (nr_points);
+#pragma omp parallel num_threads (nr_threads)
+  {
+    // We're interested in a single nearest neighbor only
+    std::vector<int> nn_indices (1);
+    std::vector<float> nn_distances (1);
+
+#pragma omp for schedule (static)
+    for (int i = 0; i < nr_points; ++i)
+    {
+      const PointT &point = input_->points[i];
+      different[i] = 0;
+
+      if (index_type_ == VOXEL_HASH)
+      {
+        if (!pcl_isfinite (point.x) || !pcl_isfinite (point.y) || !pcl_isfinite (point.z))
+        {
+          PCL_WARN ("No neighbor found for point %lu (%f %f %f)!\n", (unsigned long)i, point.x, point.y, point.z);
+          continue;
+        }
+        different[i] = !hasVoxelNeighbor (point);
+        continue;
+      }
+
+      // Search for the closest point in the target data set (number of neighbors to find = 1)
+      if (!tree_->nearestKSearch (point, 1, nn_indices, nn_distances))
+      {
+        PCL_WARN ("No neighbor found for point %lu (%f %f %f)!\n", (unsigned long)i, point.x, point.y, point.z);
+        continue;
+      }
+
+      if (nn_distances[0] > distance_threshold_)
+        different[i] = 1;
+    }
+  }
+
+  // The src indices that do not have a neighbor in tgt
+  std::vector<int> src_indices;
+  for (int i = 0; i < nr_points; ++i)
+    if (different[i])
+      src_indices.push_back (i);
+
+  copyPointCloud (*input_, src_indices, output);
 
   deinitCompute ();
 }
@@ -75,7 +75,7 @@ namespace pcl
       /** \brief Empty constructor. */
       SACSegmentation () :  model_type_ (-1), method_type_ (0), optimize_coefficients_ (true), 
                             radius_min_ (-DBL_MAX), radius_max_ (DBL_MAX), eps_angle_ (0.0),
-                            max_iterations_ (50), probability_ (0.99)
+                            max_iterations_ (50), probability_ (0.99), threads_ (1)
       {
         axis_.setZero ();
         //srand ((unsigned)time (0)); // set a random seed
@@ -202,6 +202,39 @@ namespace pcl
       virtual void 
       segment (PointIndices &inliers, ModelCoefficients &model_coefficients);
 
+      /** \brief Segment several models of the same type one after the other. The
+        * inliers of every model found are removed from the search before the next
+        * one is estimated. Only the active point indices are updated between the
+        * rounds; neither the input cloud nor the SAC model are copied or rebuilt.
+        * \param max_models the maximum number of models to extract
+        * \param min_inliers stop as soon as a model has less than this many inliers
+        * \param inliers the resultant point indices of each model found, in the order they were found
+        * \param model_coefficients the resultant model coefficients of each model found
+        */
+      void 
+      segmentModels (int max_models, int min_inliers, 
+                     std::vector<PointIndices> &inliers, 
+                     std::vector<ModelCoefficients> &model_coefficients);
+
+      /** \brief Set the number of threads used by \a segmentModels () to score the
+        * model hypotheses of the SAC_RANSAC method. Hypotheses are drawn in the
+        * same order as by RandomSampleConsensus, scored in batches of this size and
+        * accepted in order, so the stopping criterion is unchanged. The samples drawn
+        * for the rest of the last batch are discarded.
+        * \param nr_threads the number of threads to use (0 is treated as 1), default is 1
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads used to score the model hypotheses. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
     protected:
       /** \brief Initialize the Sample Consensus model and set its parameters.
         * \param model_type the type of SAC model that is to be used
@@ -215,6 +248,15 @@ namespace pcl
       virtual void 
       initSAC (const int method_type);
 
+      /** \brief Run RANSAC on the current SAC model with the model hypotheses
+        * scored in parallel. Equivalent to RandomSampleConsensus::computeModel ().
+        * \param model_coefficients the resultant model coefficients
+        * \param inliers the resultant model inliers
+        * \return true if a model was found, false otherwise
+        */
+      bool 
+      computeModelParallel (Eigen::VectorXf &model_coefficients, std::vector<int> &inliers);
+
       /** \brief The model that needs to be segmented. */
       SampleConsensusModelPtr model_;
 
@@ -248,6 +290,9 @@ namespace pcl
       /** \brief Desired probability of choosing at least one sample free from outliers (user given parameter). */
       double probability_;
 
+      /** \brief The number of threads used to score model hypotheses in segmentModels (). */
+      unsigned int threads_;
+
       /** \brief Class get name method. */
       virtual std::string 
       getClassName () const { return ("SACSegmentation"); }
@@ -40,6 +40,8 @@
 
 #include <pcl/pcl_base.h>
 #include "pcl/search/pcl_search.h"
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
 
 namespace pcl
 {
@@ -65,6 +67,14 @@ namespace pcl
   /** \brief @b SegmentDifferences obtains the difference between two spatially
     * aligned point clouds and returns the difference between them for a maximum
     * given distance threshold.
+    *
+    * When the same target (e.g., a static reference scene) is compared against
+    * many input clouds, \a setKeepTargetIndex (true) avoids rebuilding the
+    * spatial index of the target on every call to \a segment (). For large
+    * static targets \a setTargetIndexType (VOXEL_HASH) replaces the nearest
+    * neighbor queries by a radius test in a voxel hash whose voxels are as
+    * large as the distance threshold. Both index types give the same result.
+    *
     * \author Radu Bogdan Rusu
     * \ingroup segmentation
     */
@@ -84,9 +94,20 @@ namespace pcl
       typedef PointIndices::Ptr PointIndicesPtr;
       typedef PointIndices::ConstPtr PointIndicesConstPtr;
 
+      /** \brief The spatial index built over the target cloud. */
+      enum TargetIndexType
+      {
+        /** \brief nearest neighbor queries on the search object, see \a setSearchMethod () */
+        SEARCH_TREE,
+        /** \brief radius test on a hash of voxels with the size of the distance threshold */
+        VOXEL_HASH
+      };
+
       /** \brief Empty constructor. */
       SegmentDifferences () : 
-        tree_ (), target_ (), distance_threshold_ (0)
+        tree_ (), target_ (), distance_threshold_ (0),
+        index_type_ (SEARCH_TREE), keep_target_index_ (false), target_index_valid_ (false), threads_ (1),
+        voxel_size_ (0), voxel_map_ (), voxel_points_ ()
       {};
 
       /** \brief Provide a pointer to the target dataset against which we
@@ -95,7 +116,11 @@ namespace pcl
         * \param cloud the target PointCloud dataset
         */
       inline void 
-      setTargetCloud (const PointCloudConstPtr &cloud) { target_ = cloud; }
+      setTargetCloud (const PointCloudConstPtr &cloud) 
+      { 
+        target_ = cloud; 
+        target_index_valid_ = false;
+      }
 
       /** \brief Get a pointer to the input target point cloud dataset. */
       inline PointCloudConstPtr const 
@@ -105,7 +130,11 @@ namespace pcl
         * \param tree a pointer to the spatial search object.
         */
       inline void 
-      setSearchMethod (const KdTreePtr &tree) { tree_ = tree; }
+      setSearchMethod (const KdTreePtr &tree) 
+      { 
+        tree_ = tree; 
+        target_index_valid_ = false;
+      }
 
       /** \brief Get a pointer to the search method used. */
       inline KdTreePtr 
@@ -117,7 +146,13 @@ namespace pcl
         * \param sqr_threshold the squared distance tolerance as a measure in L2 Euclidean space
         */
       inline void 
-      setDistanceThreshold (double sqr_threshold) { distance_threshold_ = sqr_threshold; }
+      setDistanceThreshold (double sqr_threshold) 
+      { 
+        distance_threshold_ = sqr_threshold; 
+        // the voxel size of the hash depends on the threshold
+        if (index_type_ == VOXEL_HASH)
+          target_index_valid_ = false;
+      }
 
       /** \brief Get the squared distance tolerance between corresponding points as a
         * measure in the L2 Euclidean space.
@@ -125,6 +160,53 @@ namespace pcl
       inline double 
       getDistanceThreshold () { return (distance_threshold_); }
 
+      /** \brief Set the type of spatial index built over the target cloud.
+        * \param type the index type, default is SEARCH_TREE
+        */
+      inline void
+      setTargetIndexType (TargetIndexType type)
+      {
+        if (type != index_type_)
+          target_index_valid_ = false;
+        index_type_ = type;
+      }
+
+      /** \brief Get the type of spatial index built over the target cloud. */
+      inline TargetIndexType
+      getTargetIndexType () const { return (index_type_); }
+
+      /** \brief Keep the spatial index of the target between calls to \a segment ().
+        * The index is rebuilt only after the target cloud, the search method, the
+        * index type or (for VOXEL_HASH) the distance threshold have been changed
+        * through the setters. If the target data is modified in place, call
+        * \a setTargetCloud () again.
+        * \param keep true to keep the index, default is false (rebuild on every call)
+        */
+      inline void
+      setKeepTargetIndex (bool keep) { keep_target_index_ = keep; }
+
+      /** \brief Get whether the spatial index of the target is kept between calls to \a segment (). */
+      inline bool
+      getKeepTargetIndex () const { return (keep_target_index_); }
+
+      /** \brief Set the number of threads used to look up the input points in the target index.
+        * \note With SEARCH_TREE the search object is queried concurrently, so it must support
+        * concurrent nearestKSearch () calls (e.g. search::KdTree). An OrganizedNeighbor search
+        * object is always queried from a single thread.
+        * \param nr_threads the number of threads to use (0 is treated as 1), default is 1
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the number of threads used to look up the input points in the target index. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Segment differences between two input point clouds.
         * \param output the resultant difference between the two point clouds as a PointCloud
         */
@@ -149,6 +231,80 @@ namespace pcl
         */
       double distance_threshold_;
 
+      /** \brief The type of spatial index built over the target. */
+      TargetIndexType index_type_;
+
+      /** \brief True if the target index is kept between calls to segment (). */
+      bool keep_target_index_;
+
+      /** \brief True if the target index has been built for the current target and settings. */
+      bool target_index_valid_;
+
+      /** \brief The number of threads used to look up the input points. */
+      unsigned int threads_;
+
+      /** \brief Integer coordinates of a voxel of the target voxel hash. */
+      struct VoxelKey
+      {
+        int x, y, z;
+
+        inline bool
+        operator == (const VoxelKey &other) const { return (x == other.x && y == other.y && z == other.z); }
+
+        inline bool
+        operator < (const VoxelKey &other) const 
+        { 
+          return (x < other.x || (x == other.x && (y < other.y || (y == other.y && z < other.z))));
+        }
+      };
+
+      /** \brief Hash functor for VoxelKey. */
+      struct VoxelKeyHash
+      {
+        inline std::size_t
+        operator () (const VoxelKey &key) const
+        {
+          std::size_t seed = 0;
+          boost::hash_combine (seed, key.x);
+          boost::hash_combine (seed, key.y);
+          boost::hash_combine (seed, key.z);
+          return (seed);
+        }
+      };
+
+      /** \brief The edge length of the voxels of the target voxel hash. */
+      float voxel_size_;
+
+      /** \brief Range [first, second) of every occupied voxel in \a voxel_points_. */
+      boost::unordered_map<VoxelKey, std::pair<int, int>, VoxelKeyHash> voxel_map_;
+
+      /** \brief XYZ coordinates of the finite target points, grouped by voxel. */
+      std::vector<float> voxel_points_;
+
+      /** \brief Bounding box of the target points, grown by the search radius. */
+      Eigen::Vector3f voxel_min_, voxel_max_;
+
+      /** \brief Build the spatial index of the target for the current index type. */
+      void
+      initTargetIndex ();
+
+      /** \brief Get the voxel a point falls into. */
+      inline VoxelKey
+      getVoxelKey (float x, float y, float z) const
+      {
+        VoxelKey key;
+        key.x = (int)floor (x / voxel_size_);
+        key.y = (int)floor (y / voxel_size_);
+        key.z = (int)floor (z / voxel_size_);
+        return (key);
+      }
+
+      /** \brief Check if the voxel hash holds a target point within the distance threshold of a point.
+        * \param point the query point, must be finite
+        */
+      bool
+      hasVoxelNeighbor (const PointT &point) const;
+
       /** \brief Class getName method. */
       virtual std::string 
       getClassName () const { return ("SegmentDifferences"); }
@@ -39,9 +39,87 @@
 #include "pcl/point_types.h"
 #include "pcl/segmentation/extract_polygonal_prism_data.h"
 #include "pcl/segmentation/impl/extract_polygonal_prism_data.hpp"
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::PreparedXYPolygon::setPolygon (const std::vector<double> &x, const std::vector<double> &y)
+{
+  slab_x_ = x;
+  std::sort (slab_x_.begin (), slab_x_.end ());
+  slab_x_.erase (std::unique (slab_x_.begin (), slab_x_.end ()), slab_x_.end ());
+
+  int nr_slabs = slab_x_.empty () ? 0 : (int)slab_x_.size () - 1;
+  slab_begin_.assign (nr_slabs + 1, 0);
+  slab_edges_.clear ();
+  if (nr_slabs == 0)
+    return;
+
+  // Collect the non-vertical edges together with the range of slabs they span.
+  // Vertical edges never change the in/out state of a point, see isXYPointIn2DXYPolygon.
+  int nr_poly_points = (int)x.size ();
+  std::vector<Edge> edges;
+  std::vector<std::pair<int, int> > spans;
+  edges.reserve (nr_poly_points);
+  spans.reserve (nr_poly_points);
+  for (int i = 0, j = nr_poly_points - 1; i < nr_poly_points; j = i++)
+  {
+    if (x[i] == x[j])
+      continue;
+
+    Edge edge;
+    if (x[i] > x[j])
+    {
+      edge.x1 = x[j]; edge.y1 = y[j];
+      edge.x2 = x[i]; edge.y2 = y[i];
+    }
+    else
+    {
+      edge.x1 = x[i]; edge.y1 = y[i];
+      edge.x2 = x[j]; edge.y2 = y[j];
+    }
+    int first = (int)(std::lower_bound (slab_x_.begin (), slab_x_.end (), edge.x1) - slab_x_.begin ());
+    int last  = (int)(std::lower_bound (slab_x_.begin (), slab_x_.end (), edge.x2) - slab_x_.begin ());
+    edges.push_back (edge);
+    spans.push_back (std::make_pair (first, last));
+  }
+
+  // Count the edges per slab, then store them slab after slab
+  for (size_t e = 0; e < spans.size (); ++e)
+    for (int s = spans[e].first; s < spans[e].second; ++s)
+      ++slab_begin_[s + 1];
+  for (int s = 0; s < nr_slabs; ++s)
+    slab_begin_[s + 1] += slab_begin_[s];
+
+  slab_edges_.resize (slab_begin_[nr_slabs]);
+  std::vector<int> fill (slab_begin_.begin (), slab_begin_.end () - 1);
+  for (size_t e = 0; e < spans.size (); ++e)
+    for (int s = spans[e].first; s < spans[e].second; ++s)
+      slab_edges_[fill[s]++] = edges[e];
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool
+pcl::PreparedXYPolygon::contains (double x, double y) const
+{
+  // Slab s holds the points with slab_x_[s] < x <= slab_x_[s + 1]
+  int s = (int)(std::lower_bound (slab_x_.begin (), slab_x_.end (), x) - slab_x_.begin ()) - 1;
+  if (s < 0 || s >= (int)slab_x_.size () - 1)
+    return (false);
+
+  bool in_poly = false;
+  for (int e = slab_begin_[s]; e < slab_begin_[s + 1]; ++e)
+  {
+    const Edge &edge = slab_edges_[e];
+    if ((y - edge.y1) * (edge.x2 - edge.x1) < (edge.y2 - edge.y1) * (x - edge.x1))
+      in_poly = !in_poly;
+  }
+  return (in_poly);
+}
 
 // Instantiations of specific point types
 PCL_INSTANTIATE(ExtractPolygonalPrismData, PCL_XYZ_POINT_TYPES);
 PCL_INSTANTIATE(isPointIn2DPolygon, PCL_XYZ_POINT_TYPES);
 PCL_INSTANTIATE(isXYPointIn2DXYPolygon, PCL_XYZ_POINT_TYPES);
+PCL_INSTANTIATE(PreparedXYPolygonSetPolygon, PCL_XYZ_POINT_TYPES);
 
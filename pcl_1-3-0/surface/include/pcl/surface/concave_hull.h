@@ -42,9 +42,17 @@
 #define PCL_CONCAVE_HULL_H
 
 #include "pcl/surface/convex_hull.h"
+#include <boost/thread/mutex.hpp>
 
 namespace pcl
 {
+  /** \brief Get the mutex that serializes all calls into the qhull library. qhull keeps its state in
+    * global variables, so at most one qhull computation may run at a time in the process.
+    * \ingroup surface
+    */
+  PCL_EXPORTS boost::mutex&
+  getQhullMutex ();
+
   ////////////////////////////////////////////////////////////////////////////////////////////
   /** \brief @b ConcaveHull (alpha shapes) using libqhull library.
    * \author Aitor Aldoma
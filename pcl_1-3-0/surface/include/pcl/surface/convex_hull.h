@@ -35,9 +35,6 @@
  *
  */
 
-#include <pcl/pcl_config.h>
-#ifdef HAVE_QHULL
-
 #ifndef PCL_CONVEX_HULL_2D_H_
 #define PCL_CONVEX_HULL_2D_H_
 
@@ -46,6 +43,7 @@
 
 #include "pcl/ModelCoefficients.h"
 #include "pcl/PolygonMesh.h"
+#include "pcl/surface/quick_hull.h"
 #include <math.h>
 
 namespace pcl
@@ -114,8 +112,7 @@ namespace pcl
         keep_information_ = value;
       }
 
-      /** \brief If set to true, the qhull library is called to compute the total area and volume of the convex hull.
-       * NOTE: When this option is activated, the qhull library produces output to the console.
+      /** \brief If set to true, the total area and volume of the convex hull are computed.
        * \param value wheter to compute the area and the volume, default is false
        */
       void
@@ -159,6 +156,14 @@ namespace pcl
       double total_area_;
       double total_volume_;
 
+      /** \brief Hull engine. Keeps its workspace between calls; each ConvexHull instance owns one, so
+        * different instances can be used from different threads concurrently.
+        */
+      QuickHull quick_hull_;
+
+      /** \brief Demeaned (and for planar sets projected) coordinates handed to the hull engine. */
+      std::vector<double> coordinates_;
+
     protected:
       /** \brief Class get name method. */
       std::string
@@ -170,4 +175,3 @@ namespace pcl
 }
 
 #endif  //#ifndef PCL_CONVEX_HULL_2D_H_
-#endif
@@ -149,6 +149,7 @@ namespace pcl
       using SurfaceReconstruction<PointInT>::tree_;
       using SurfaceReconstruction<PointInT>::input_;
       using SurfaceReconstruction<PointInT>::indices_;
+      using SurfaceReconstruction<PointInT>::check_tree_;
 
       typedef typename pcl::KdTree<PointInT> KdTree;
       typedef typename pcl::KdTree<PointInT>::Ptr KdTreePtr;
@@ -170,7 +171,8 @@ namespace pcl
       /** \brief Empty constructor. */
       GreedyProjectionTriangulation () : nnn_ (0), mu_ (0), search_radius_ (0), 
                                          minimum_angle_ (0), maximum_angle_ (0), 
-                                         eps_angle_(0), consistent_(false) 
+                                         eps_angle_(0), consistent_(false), 
+                                         tile_size_ (0), tile_overlap_ (0), threads_ (1)
       {};
 
       /** \brief Set the multiplier of the nearest neighbor distance to obtain the final search radius for each point
@@ -249,6 +251,50 @@ namespace pcl
       inline bool 
       getNormalConsistency () { return (consistent_); }
 
+      /** \brief Set the edge length of the cubic tiles used for partitioned reconstruction. The interiors of the
+        * tiles are triangulated independently, and the points along the tile borders are then added to the
+        * resulting meshes with updateMesh (), which stitches them together.
+        * \param tile_size the tile edge length (0 disables tiling and grows the mesh from a single front)
+        * \note The tiles are grown if the grid would have more tiles than a third of the number of points.
+        * \note Connected component IDs (see getPartIDs ()) are not merged across tile borders.
+        */
+      inline void 
+      setTileSize (double tile_size) 
+      { 
+        tile_size_ = tile_size; 
+        // every tile builds its own search tree, so the global one is not needed
+        check_tree_ = (tile_size_ <= 0);
+      }
+
+      /** \brief Get the edge length of the tiles used for partitioned reconstruction. */
+      inline double 
+      getTileSize () { return (tile_size_); }
+
+      /** \brief Set the width of the seam band on each side of the inner tile borders. Points in the band are 
+        * left out of the tiles and triangulated by the stitching pass.
+        * \param overlap the seam width (0 uses the search radius)
+        * \note The seam should be at least the maximum edge length, so that no tile triangle reaches across a
+        *       border.
+        */
+      inline void 
+      setTileOverlap (double overlap) { tile_overlap_ = overlap; }
+
+      /** \brief Get the width of the seam band on each side of the inner tile borders. */
+      inline double 
+      getTileOverlap () { return (tile_overlap_); }
+
+      /** \brief Set the number of threads used to triangulate tiles concurrently, using the OpenMP standard.
+        * \param nr_threads the number of hardware threads to use
+        * \note Only used if the tile size is set (see setTileSize ()).
+        */
+      inline void 
+      setNumberOfThreads (unsigned int nr_threads) 
+      { 
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads; 
+      }
+
       /** \brief Get the state of each point after reconstruction.
         * \note Options are defined as constants: FREE, FRINGE, COMPLETED, BOUNDARY and NONE
         */
@@ -319,6 +365,15 @@ namespace pcl
       /** \brief Set this to true if the normals of the input are consistently oriented. */
       bool consistent_;
 
+      /** \brief The edge length of the tiles used for partitioned reconstruction (0 if disabled). */
+      double tile_size_;
+
+      /** \brief The width of the seam band on each side of the inner tile borders. */
+      double tile_overlap_;
+
+      /** \brief The number of threads the scheduler should use for partitioned reconstruction. */
+      unsigned int threads_;
+
     private:
       /** \brief Struct for storing the angles to nearest neighbors **/
       struct nnAngle
@@ -409,6 +464,13 @@ namespace pcl
       void 
       performReconstruction (pcl::PolygonMesh &output);
 
+      /** \brief Partition the input into tiles, triangulate the tile interiors in parallel and stitch the
+        * resulting meshes by adding the seam points along the tile borders with updateMesh ().
+        * \param output the resultant polygonal mesh
+        */
+      void 
+      performTiledReconstruction (pcl::PolygonMesh &output);
+
       /** \brief Class get name method. */
       std::string 
       getClassName () const { return ("GreedyProjectionTriangulation"); }
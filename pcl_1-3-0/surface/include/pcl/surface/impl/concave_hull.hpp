@@ -201,6 +201,9 @@ pcl::ConcaveHull<PointInT>::performReconstruction (PointCloud &alpha_shape, std:
       points[i * dim + 2] = (coordT)cloud_transformed.points[i].z;
   }
 
+  // qhull works on global state, hold the lock until the state has been freed again
+  boost::mutex::scoped_lock qhull_lock (getQhullMutex ());
+
   // Compute concave hull
   exitcode = qh_new_qhull (dim, cloud_transformed.points.size (), points, ismalloc, flags, outfile, errfile);
 
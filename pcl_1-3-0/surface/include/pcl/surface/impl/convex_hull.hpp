@@ -35,9 +35,6 @@
  *
  */
 
-#include <pcl/pcl_config.h>
-#ifdef HAVE_QHULL
-
 #ifndef PCL_SURFACE_IMPL_CONVEX_HULL_H_
 #define PCL_SURFACE_IMPL_CONVEX_HULL_H_
 
@@ -51,29 +48,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-extern "C"
-{
-#ifdef HAVE_QHULL_2011
-#  include "libqhull/libqhull.h"
-#  include "libqhull/mem.h"
-#  include "libqhull/qset.h"
-#  include "libqhull/geom.h"
-#  include "libqhull/merge.h"
-#  include "libqhull/poly.h"
-#  include "libqhull/io.h"
-#  include "libqhull/stat.h"
-#else
-#  include "qhull/qhull.h"
-#  include "qhull/mem.h"
-#  include "qhull/qset.h"
-#  include "qhull/geom.h"
-#  include "qhull/merge.h"
-#  include "qhull/poly.h"
-#  include "qhull/io.h"
-#  include "qhull/stat.h"
-#endif
-}
-
 //////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
 pcl::ConvexHull<PointInT>::performReconstruction (PointCloud &hull, std::vector<pcl::Vertices> &polygons,
@@ -117,60 +91,42 @@ pcl::ConvexHull<PointInT>::performReconstruction (PointCloud &hull, std::vector<
   else
     transform1.setIdentity ();
 
-  PointCloud cloud_transformed;
-  pcl::demeanPointCloud (*input_, *indices_, xyz_centroid, cloud_transformed);
-  pcl::transformPointCloud (cloud_transformed, cloud_transformed, transform1);
-
-  // True if qhull should free points in qh_freeqhull() or reallocation
-  boolT ismalloc = True;
-  // output from qh_produce_output(), use NULL to skip qh_produce_output()
-  FILE *outfile = NULL;
-
-  std::string flags_str;
-  flags_str = "qhull Tc";
-
-  if (compute_area_)
+  // Demean and rotate the points into the coordinate buffer of the hull engine
+  const int nr_points = static_cast<int> (indices_->size ());
+  coordinates_.resize (nr_points * dim);
+  for (int i = 0; i < nr_points; ++i)
   {
-    flags_str.append (" FA");
-    outfile = stderr;
+    Eigen::Vector3f pt = input_->points[(*indices_)[i]].getVector3fMap () - xyz_centroid.head<3> ();
+    pt = transform1 * pt;
+    for (int d = 0; d < dim; ++d)
+      coordinates_[i * dim + d] = pt[d];
   }
 
-  // option flags for qhull, see qh_opt.htm
-  //char flags[] = "qhull Tc FA";
-  char * flags = (char *)flags_str.c_str();
-  // error messages from qhull code
-  FILE *errfile = stderr;
-  // 0 if no error from qhull
-  int exitcode;
-
-  // Array of coordinates for each point
-  coordT *points = (coordT *)calloc (cloud_transformed.points.size () * dim, sizeof(coordT));
-
-  for (size_t i = 0; i < cloud_transformed.points.size (); ++i)
+  // Compute convex hull
+  std::vector<int> hull_vertices;
+  std::vector<pcl::Vertices> hull_triangles;
+  bool success = false;
+  if (nr_points > 0)
   {
-    points[i * dim + 0] = (coordT)cloud_transformed.points[i].x;
-    points[i * dim + 1] = (coordT)cloud_transformed.points[i].y;
-
-    if (dim > 2)
-      points[i * dim + 2] = (coordT)cloud_transformed.points[i].z;
+    if (dim == 2)
+      success = quick_hull_.compute2D (&coordinates_[0], nr_points, hull_vertices);
+    else
+      success = quick_hull_.compute3D (&coordinates_[0], nr_points, hull_vertices, hull_triangles);
   }
 
-  // Compute convex hull
-  exitcode = qh_new_qhull (dim, cloud_transformed.points.size (), points, ismalloc, flags, outfile, errfile);
-
-  if (exitcode != 0)
+  if (!success)
   {
-    PCL_ERROR ("[pcl::%s::performReconstrution] ERROR: qhull was unable to compute a convex hull for the given point cloud (%lu)!\n", getClassName ().c_str (), (unsigned long) input_->points.size ());
+    PCL_ERROR ("[pcl::%s::performReconstrution] ERROR: unable to compute a convex hull for the given point cloud (%lu)!\n", getClassName ().c_str (), (unsigned long) indices_->size ());
 
     //check if it fails because of NaN values...
-    if (!cloud_transformed.is_dense)
+    if (!input_->is_dense)
     {
       bool NaNvalues = false;
-      for (size_t i = 0; i < cloud_transformed.size (); ++i)
+      for (size_t i = 0; i < indices_->size (); ++i)
       {
-        if (!pcl_isfinite (cloud_transformed.points[i].x) || 
-            !pcl_isfinite (cloud_transformed.points[i].y) ||
-            !pcl_isfinite (cloud_transformed.points[i].z))
+        if (!pcl_isfinite (input_->points[(*indices_)[i]].x) || 
+            !pcl_isfinite (input_->points[(*indices_)[i]].y) ||
+            !pcl_isfinite (input_->points[(*indices_)[i]].z))
         {
           NaNvalues = true;
           break;
@@ -184,113 +140,66 @@ pcl::ConvexHull<PointInT>::performReconstruction (PointCloud &hull, std::vector<
     hull.points.resize (0);
     hull.width = hull.height = 0;
     polygons.resize (0);
-
-    qh_freeqhull (!qh_ALL);
-    int curlong, totlong;
-    qh_memfreeshort (&curlong, &totlong);
-
     return;
   }
 
-  qh_triangulate ();
-
-  int num_facets = qh num_facets;
-
-  int num_vertices = qh num_vertices;
+  int num_vertices = static_cast<int> (hull_vertices.size ());
   hull.points.resize (num_vertices);
-
-  vertexT * vertex;
-  int i = 0;
-  // Max vertex id
-  int max_vertex_id = -1;
-  FORALLvertices
-  {
-    if ((int)vertex->id > max_vertex_id)
-    max_vertex_id = vertex->id;
-  }
-
-  ++max_vertex_id;
-  std::vector<int> qhid_to_pcidx (max_vertex_id);
-
-  FORALLvertices
+  for (int i = 0; i < num_vertices; ++i)
   {
     // Add vertices to hull point_cloud
-    hull.points[i].x = vertex->point[0];
-    hull.points[i].y = vertex->point[1];
+    hull.points[i].x = coordinates_[hull_vertices[i] * dim + 0];
+    hull.points[i].y = coordinates_[hull_vertices[i] * dim + 1];
 
     if (dim>2)
-    hull.points[i].z = vertex->point[2];
+    hull.points[i].z = coordinates_[hull_vertices[i] * dim + 2];
     else
     hull.points[i].z = 0;
-
-    qhid_to_pcidx[vertex->id] = i; // map the vertex id of qhull to the point cloud index
-    ++i;
   }
 
   if (compute_area_)
   {
-    total_area_  = qh totarea;
-    total_volume_ = qh totvol;
+    total_area_  = quick_hull_.getArea ();
+    total_volume_ = quick_hull_.getVolume ();
   }
 
-  if (fill_polygon_data)
+  if (dim == 3)
   {
-    if (dim == 3)
+    if (fill_polygon_data)
+      polygons.swap (hull_triangles);
+  }
+  else
+  {
+    // dim=2, we want to return just a polygon with all vertices sorted
+    // so that they form a non-intersecting polygon...
+    Eigen::Vector4f centroid;
+    pcl::compute3DCentroid (hull, centroid);
+    centroid[3] = 0;
+
+    // Copy all vertices
+    std::vector<std::pair<int, Eigen::Vector4f>, Eigen::aligned_allocator<std::pair<int, Eigen::Vector4f> > > idx_points (num_vertices);
+    for (int dd = 0; dd < num_vertices; ++dd)
     {
-      polygons.resize (num_facets);
-      int dd = 0;
-
-      facetT * facet;
-      FORALLfacets
-      {
-        polygons[dd].vertices.resize (3);
-
-        // Needed by FOREACHvertex_i_
-        int vertex_n, vertex_i;
-        FOREACHvertex_i_((*facet).vertices)
-        //facet_vertices.vertices.push_back (qhid_to_pcidx[vertex->id]);
-        polygons[dd].vertices[vertex_i] = qhid_to_pcidx[vertex->id];
-        ++dd;
-      }
-
-
+      idx_points[dd].first = dd;
+      idx_points[dd].second = hull.points[dd].getVector4fMap () - centroid;
     }
-    else
-    {
-      // dim=2, we want to return just a polygon with all vertices sorted
-      // so that they form a non-intersecting polygon...
-      // this can be moved to the upper loop probably and here just
-      // the sorting + populate
-
-      Eigen::Vector4f centroid;
-      pcl::compute3DCentroid (hull, centroid);
-      centroid[3] = 0;
-      polygons.resize (1);
 
-      int num_vertices = qh num_vertices, dd = 0;
+    // Sort idx_points
+    std::sort (idx_points.begin (), idx_points.end (), comparePoints2D);
 
-      // Copy all vertices
-      std::vector<std::pair<int, Eigen::Vector4f>, Eigen::aligned_allocator<std::pair<int, Eigen::Vector4f> > > idx_points (num_vertices);
+    //Sort also points...
+    PointCloud hull_sorted;
+    hull_sorted.points.resize (hull.points.size ());
 
-      FORALLvertices
-      {
-        idx_points[dd].first = qhid_to_pcidx[vertex->id];
-        idx_points[dd].second = hull.points[idx_points[dd].first].getVector4fMap () - centroid;
-        ++dd;
-      }
+    for (size_t j = 0; j < idx_points.size (); ++j)
+    hull_sorted.points[j] = hull.points[idx_points[j].first];
 
-      // Sort idx_points
-      std::sort (idx_points.begin (), idx_points.end (), comparePoints2D);
-      polygons[0].vertices.resize (idx_points.size () + 1);
-
-      //Sort also points...
-      PointCloud hull_sorted;
-      hull_sorted.points.resize (hull.points.size ());
-
-      for (size_t j = 0; j < idx_points.size (); ++j)
-      hull_sorted.points[j] = hull.points[idx_points[j].first];
+    hull.points = hull_sorted.points;
 
-      hull.points = hull_sorted.points;
+    if (fill_polygon_data)
+    {
+      polygons.resize (1);
+      polygons[0].vertices.resize (idx_points.size () + 1);
 
       // Populate points
       for (size_t j = 0; j < idx_points.size (); ++j)
@@ -299,46 +208,6 @@ pcl::ConvexHull<PointInT>::performReconstruction (PointCloud &hull, std::vector<
       polygons[0].vertices[idx_points.size ()] = 0;
     }
   }
-  else
-  {
-    if (dim == 2)
-    {
-      // We want to sort the points
-      Eigen::Vector4f centroid;
-      pcl::compute3DCentroid (hull, centroid);
-      centroid[3] = 0;
-      polygons.resize (1);
-
-      int num_vertices = qh num_vertices, dd = 0;
-
-      // Copy all vertices
-      std::vector<std::pair<int, Eigen::Vector4f>, Eigen::aligned_allocator<std::pair<int, Eigen::Vector4f> > > idx_points (num_vertices);
-
-      FORALLvertices
-      {
-        idx_points[dd].first = qhid_to_pcidx[vertex->id];
-        idx_points[dd].second = hull.points[idx_points[dd].first].getVector4fMap () - centroid;
-        ++dd;
-      }
-
-      // Sort idx_points
-      std::sort (idx_points.begin (), idx_points.end (), comparePoints2D);
-
-      //Sort also points...
-      PointCloud hull_sorted;
-      hull_sorted.points.resize (hull.points.size ());
-
-      for (size_t j = 0; j < idx_points.size (); ++j)
-      hull_sorted.points[j] = hull.points[idx_points[j].first];
-
-      hull.points = hull_sorted.points;
-    }
-  }
-
-  // Deallocates memory (also the points)
-  qh_freeqhull(!qh_ALL);
-  int curlong, totlong;
-  qh_memfreeshort (&curlong, &totlong);
 
   // Rotate the hull point cloud by transform's inverse
   // If the input point cloud has been rotated
@@ -346,14 +215,6 @@ pcl::ConvexHull<PointInT>::performReconstruction (PointCloud &hull, std::vector<
   {
     Eigen::Affine3f transInverse = transform1.inverse ();
     pcl::transformPointCloud (hull, hull, transInverse);
-
-    //for 2D sets, the qhull library delivers the actual area of the 2d hull in the volume
-    if(compute_area_)
-    {
-      total_area_ = total_volume_;
-      total_volume_ = 0.0;
-    }
-
   }
 
   xyz_centroid[0] = -xyz_centroid[0];
@@ -439,4 +300,3 @@ pcl::ConvexHull<PointInT>::reconstruct (PointCloud &points, std::vector<pcl::Ver
 #define PCL_INSTANTIATE_ConvexHull(T) template class PCL_EXPORTS pcl::ConvexHull<T>;
 
 #endif    // PCL_SURFACE_IMPL_CONVEX_HULL_H_
-#endif
@@ -40,6 +40,8 @@
 
 #include "pcl/surface/gp3.h"
 #include "pcl/kdtree/impl/kdtree_flann.hpp"
+#include "pcl/common/common.h"
+#include <set>
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
@@ -53,6 +55,11 @@ pcl::GreedyProjectionTriangulation<PointInT>::performReconstruction (pcl::Polygo
     output.polygons.clear ();
     return;
   }
+  if (tile_size_ > 0)
+  {
+    performTiledReconstruction (output);
+    return;
+  }
   const double sqr_mu = mu_*mu_;
   const double sqr_max_edge = search_radius_*search_radius_;
   if (nnn_ > (int)indices_->size ())
@@ -993,6 +1000,257 @@ pcl::GreedyProjectionTriangulation<PointInT>::performReconstruction (pcl::Polygo
   PCL_DEBUG ("Number of processed points: %d / %d\n", (int)fringe_queue_.size(), (int)indices_->size ());
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::GreedyProjectionTriangulation<PointInT>::performTiledReconstruction (pcl::PolygonMesh &output)
+{
+  const double seam = (tile_overlap_ > 0) ? tile_overlap_ : search_radius_;
+
+  // Computing the tile grid over the bounding box of the input
+  Eigen::Vector4f min_pt, max_pt;
+  getMinMax3D (*input_, *indices_, min_pt, max_pt);
+
+  // A tile needs at least 3 points to hold a triangle, so the tiles are grown until there are no more of 
+  // them than that. The count is computed in floating point, as the product of the tile numbers can 
+  // overflow an int for small tiles.
+  const double max_tiles = (std::max) ((double)(indices_->size () / 3), 1.0);
+  double tile_size = tile_size_;
+  double nr_tiles_d[3];
+  while (true)
+  {
+    for (int d = 0; d < 3; ++d)
+      nr_tiles_d[d] = floor ((max_pt[d] - min_pt[d]) / tile_size) + 1;
+    if (nr_tiles_d[0] * nr_tiles_d[1] * nr_tiles_d[2] <= max_tiles)
+      break;
+    tile_size *= 2;
+  }
+  if (tile_size != tile_size_)
+    PCL_WARN ("[pcl::%s::performTiledReconstruction] Tile size %f gives more tiles than the input can fill, using %f instead.\n", getClassName ().c_str (), tile_size_, tile_size);
+
+  int nr_tiles[3];
+  for (int d = 0; d < 3; ++d)
+    nr_tiles[d] = (int)nr_tiles_d[d];
+  const size_t total_tiles = (size_t)nr_tiles[0] * nr_tiles[1] * nr_tiles[2];
+  const float inv_tile_size = (float)(1.0 / tile_size);
+
+  // Assigning each point either to the interior of its tile, or to the seam band along the inner tile borders
+  std::vector<std::vector<int> > tile_points (total_tiles);
+  std::vector<int> seam_points;
+  for (size_t cp = 0; cp < indices_->size (); ++cp)
+  {
+    const PointInT &pt = input_->points[(*indices_)[cp]];
+    int c[3];
+    bool in_seam = false;
+    for (int d = 0; d < 3; ++d)
+    {
+      const float p = pt.data[d] - min_pt[d];
+      c[d] = (std::min) ((int)(floor (p * inv_tile_size)), nr_tiles[d] - 1);
+      const double offset = p - c[d] * tile_size;
+      if ((c[d] > 0 && offset < seam) || (c[d] < nr_tiles[d] - 1 && offset > tile_size - seam))
+        in_seam = true;
+    }
+    if (in_seam)
+      seam_points.push_back ((int)cp);
+    else
+      tile_points[(c[2] * nr_tiles[1] + c[1]) * nr_tiles[0] + c[0]].push_back ((int)cp);
+  }
+
+  // Tiles too small to be triangulated on their own are left to the stitching pass
+  for (size_t t = 0; t < total_tiles; ++t)
+  {
+    if (tile_points[t].empty () || tile_points[t].size () >= 3)
+      continue;
+    seam_points.insert (seam_points.end (), tile_points[t].begin (), tile_points[t].end ());
+    tile_points[t].clear ();
+  }
+
+  // The interior points are numbered tile by tile, followed by the seam points
+  std::vector<int> tile_offset (total_tiles + 1, 0);
+  for (size_t t = 0; t < total_tiles; ++t)
+    tile_offset[t+1] = tile_offset[t] + (int)tile_points[t].size ();
+  const int nr_interior = tile_offset[total_tiles];
+  std::vector<int> positions;
+  positions.reserve (indices_->size ());
+  for (size_t t = 0; t < total_tiles; ++t)
+    positions.insert (positions.end (), tile_points[t].begin (), tile_points[t].end ());
+  positions.insert (positions.end (), seam_points.begin (), seam_points.end ());
+
+  // initializing states and fringe neighbors of the interior points
+  part_.assign (nr_interior, -1);
+  state_.assign (nr_interior, FREE);
+  source_.assign (nr_interior, NONE);
+  ffn_.assign (nr_interior, NONE);
+  sfn_.assign (nr_interior, NONE);
+
+  std::vector<std::vector<pcl::Vertices> > tile_polygons (total_tiles);
+  std::vector<int> tile_parts (total_tiles, 0);
+
+  // Triangulating the tile interiors independently. The interiors do not share points, so the per point
+  // results are written without synchronization.
+  const int nr_tiles_total = (int)total_tiles;
+#pragma omp parallel for schedule (dynamic) num_threads (threads_)
+  for (int t = 0; t < nr_tiles_total; ++t)
+  {
+    const std::vector<int> &points = tile_points[t];
+    if (points.empty ())
+      continue;
+
+    PointCloudInPtr tile_cloud (new PointCloudIn);
+    tile_cloud->points.resize (points.size ());
+    for (size_t i = 0; i < points.size (); ++i)
+      tile_cloud->points[i] = input_->points[(*indices_)[points[i]]];
+    tile_cloud->width = (uint32_t) points.size ();
+    tile_cloud->height = 1;
+    tile_cloud->is_dense = input_->is_dense;
+
+    GreedyProjectionTriangulation<PointInT> tile_gp3;
+    tile_gp3.nnn_ = nnn_;
+    tile_gp3.mu_ = mu_;
+    tile_gp3.search_radius_ = search_radius_;
+    tile_gp3.minimum_angle_ = minimum_angle_;
+    tile_gp3.maximum_angle_ = maximum_angle_;
+    tile_gp3.eps_angle_ = eps_angle_;
+    tile_gp3.consistent_ = consistent_;
+    tile_gp3.setInputCloud (tile_cloud);
+    if (!tile_gp3.initCompute ())
+      continue;
+    tile_gp3.tree_.reset (new pcl::search::KdTree<PointInT> (false));
+    tile_gp3.tree_->setInputCloud (tile_cloud);
+
+    pcl::PolygonMesh tile_mesh;
+    tile_gp3.performReconstruction (tile_mesh);
+    tile_gp3.deinitCompute ();
+
+    const int offset = tile_offset[t];
+    std::vector<pcl::Vertices> &polygons = tile_polygons[t];
+    polygons.swap (tile_mesh.polygons);
+    for (size_t i = 0; i < polygons.size (); ++i)
+      for (size_t j = 0; j < polygons[i].vertices.size (); ++j)
+        polygons[i].vertices[j] += offset;
+
+    for (size_t i = 0; i < points.size (); ++i)
+    {
+      const int cp = offset + (int)i;
+      state_[cp] = tile_gp3.state_[i];
+      part_[cp] = tile_gp3.part_[i];
+      if (tile_gp3.source_[i] != NONE)
+        source_[cp] = offset + tile_gp3.source_[i];
+      if (tile_gp3.ffn_[i] != NONE)
+        ffn_[cp] = offset + tile_gp3.ffn_[i];
+      if (tile_gp3.sfn_[i] != NONE)
+        sfn_[cp] = offset + tile_gp3.sfn_[i];
+      if (part_[cp] >= tile_parts[t])
+        tile_parts[t] = part_[cp] + 1;
+    }
+  }
+
+  // Making the part IDs unique over all tiles
+  std::vector<int> part_offset (total_tiles + 1, 0);
+  for (size_t t = 0; t < total_tiles; ++t)
+    part_offset[t+1] = part_offset[t] + tile_parts[t];
+  for (size_t t = 0; t < total_tiles; ++t)
+    for (int cp = tile_offset[t]; cp < tile_offset[t+1]; ++cp)
+      if (part_[cp] >= 0)
+        part_[cp] += part_offset[t];
+
+  // Collecting the tile meshes
+  pcl::PolygonMesh stitched;
+  size_t nr_triangles = 0;
+  for (size_t t = 0; t < total_tiles; ++t)
+    nr_triangles += tile_polygons[t].size ();
+  stitched.polygons.reserve (nr_triangles + 2 * seam_points.size ());
+  for (size_t t = 0; t < total_tiles; ++t)
+    stitched.polygons.insert (stitched.polygons.end (), tile_polygons[t].begin (), tile_polygons[t].end ());
+
+  // Stitching: the seam points are added to the interior meshes with updateMesh (), which continues the 
+  // advancing front from the tile borders. It works on the member state, so the input, indices and search 
+  // method are swapped for the renumbered interior points while it runs.
+  const PointCloudInConstPtr input = input_;
+  const boost::shared_ptr<std::vector<int> > indices = indices_;
+  const typename SurfaceReconstruction<PointInT>::KdTreePtr tree = tree_;
+  if (!seam_points.empty ())
+  {
+    PointCloudInPtr interior_cloud (new PointCloudIn);
+    PointCloudInPtr seam_cloud (new PointCloudIn);
+    interior_cloud->points.resize (nr_interior);
+    seam_cloud->points.resize (seam_points.size ());
+    coords_.resize (nr_interior);
+    for (int cp = 0; cp < nr_interior; ++cp)
+    {
+      interior_cloud->points[cp] = input->points[(*indices)[positions[cp]]];
+      coords_[cp] = interior_cloud->points[cp].getVector3fMap ();
+    }
+    for (size_t i = 0; i < seam_points.size (); ++i)
+      seam_cloud->points[i] = input->points[(*indices)[seam_points[i]]];
+    interior_cloud->width = nr_interior;
+    seam_cloud->width = (uint32_t) seam_points.size ();
+    interior_cloud->height = seam_cloud->height = 1;
+    interior_cloud->is_dense = seam_cloud->is_dense = input->is_dense;
+
+    input_ = interior_cloud;
+    indices_.reset (new std::vector<int> (nr_interior));
+    for (int cp = 0; cp < nr_interior; ++cp)
+      (*indices_)[cp] = cp;
+    tree_.reset (new pcl::search::KdTree<PointInT> (false));
+
+    updateMesh (seam_cloud, stitched);
+
+    // The parts started by the stitching pass are numbered after the ones of the tiles
+    for (size_t cp = nr_interior; cp < part_.size (); ++cp)
+      if (part_[cp] >= 0)
+        part_[cp] += part_offset[total_tiles];
+    // Interior boundary points the front did not reach stay boundary points
+    for (int cp = 0; cp < nr_interior; ++cp)
+      if (state_[cp] == FRINGE)
+        state_[cp] = BOUNDARY;
+
+    input_ = input;
+    indices_ = indices;
+    tree_ = tree;
+  }
+
+  // Numbering the points and the triangles as in the input again
+  std::vector<int> part (indices_->size ()), state (indices_->size ()), source (indices_->size ());
+  std::vector<int> ffn (indices_->size ()), sfn (indices_->size ());
+  for (size_t cp = 0; cp < positions.size (); ++cp)
+  {
+    const int pos = positions[cp];
+    part[pos] = part_[cp];
+    state[pos] = state_[cp];
+    source[pos] = (source_[cp] == NONE) ? NONE : positions[source_[cp]];
+    ffn[pos] = (ffn_[cp] == NONE) ? NONE : positions[ffn_[cp]];
+    sfn[pos] = (sfn_[cp] == NONE) ? NONE : positions[sfn_[cp]];
+  }
+  part_.swap (part);
+  state_.swap (state);
+  source_.swap (source);
+  ffn_.swap (ffn);
+  sfn_.swap (sfn);
+  fringe_queue_.clear ();
+  coords_.resize (indices_->size ());
+  for (size_t cp = 0; cp < indices_->size (); ++cp)
+    coords_[cp] = input_->points[(*indices_)[cp]].getVector3fMap ();
+
+  // Restarting the front on the boundaries of the tiles can close a triangle a second time, so repeated 
+  // triangles are dropped
+  std::set<std::vector<uint32_t> > triangles;
+  output.polygons.reserve (output.polygons.size () + stitched.polygons.size ());
+  for (size_t i = 0; i < stitched.polygons.size (); ++i)
+  {
+    pcl::Vertices triangle;
+    triangle.vertices.resize (stitched.polygons[i].vertices.size ());
+    for (size_t j = 0; j < triangle.vertices.size (); ++j)
+      triangle.vertices[j] = positions[stitched.polygons[i].vertices[j]];
+    std::vector<uint32_t> key = triangle.vertices;
+    std::sort (key.begin (), key.end ());
+    if (triangles.insert (key).second)
+      output.polygons.push_back (triangle);
+  }
+
+  PCL_DEBUG ("Number of tiles: %d (%d x %d x %d), seam points: %d\n", nr_tiles_total, nr_tiles[0], nr_tiles[1], nr_tiles[2], (int)seam_points.size ());
+  PCL_DEBUG ("Number of triangles: %d\n", (int)output.polygons.size());
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
 pcl::GreedyProjectionTriangulation<PointInT>::closeTriangle (pcl::PolygonMesh &output)
@@ -44,7 +44,8 @@
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT>
-pcl::MarchingCubes<PointNT>::MarchingCubes ()
+pcl::MarchingCubes<PointNT>::MarchingCubes () : 
+  blocks_per_side_ (0), last_block_index_ (-1), last_block_ (NULL), threads_ (1)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -69,7 +70,11 @@ pcl::MarchingCubes<PointNT>::getBoundingBox ()
     (std::max) ((std::max)(bounding_box_size.x (), bounding_box_size.y ()),
                 bounding_box_size.z ());
 
-  data_size_ = max_size / leaf_size_;
+  // keep an empty layer of cells below the data, so that the surface is also closed at the lower bounds
+  min_p_ -= Eigen::Vector4f (leaf_size_, leaf_size_, leaf_size_, 0);
+  data_size_ = max_size / leaf_size_ + 1;
+  // cells are indexed up to data_size_ + 1 (the neighbors of the cells at the upper bound)
+  blocks_per_side_ = ((data_size_ + 1) >> 3) + 1;
   PCL_DEBUG ("[pcl::MarchingCubes::getBoundingBox] Lower left point is [%f, %f, %f]\n",
       min_p_.x (), min_p_.y (), min_p_.z ());
   PCL_DEBUG ("[pcl::MarchingCubes::getBoundingBox] Upper left point is [%f, %f, %f]\n",
@@ -99,8 +104,13 @@ pcl::MarchingCubes<PointNT>::interpolateEdge(float iso_level, Eigen::Vector3f &p
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> void
-pcl::MarchingCubes<PointNT>::createSurface (Leaf leaf_node, Eigen::Vector3i &index_3d, pcl::PointCloud<pcl::PointXYZ> &cloud, float iso_level)
+pcl::MarchingCubes<PointNT>::createSurface (const Leaf &leaf_node, const Eigen::Vector3i &index_3d, pcl::PointCloud<pcl::PointXYZ> &cloud, 
+                                            std::vector<boost::uint64_t> &edge_keys, float iso_level)
 {
+  // The two cube vertices of every edge
+  static const int edge_corners[12][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, 
+                                          {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
   int cubeindex = 0;
   Eigen::Vector3f vertex_list[12];
   if (leaf_node.vertex[0] < iso_level) cubeindex |= 1;
@@ -167,8 +177,25 @@ pcl::MarchingCubes<PointNT>::createSurface (Leaf leaf_node, Eigen::Vector3i &ind
   if (edgeTable[cubeindex] & 2048)
     interpolateEdge(iso_level,p[3],p[7],leaf_node.vertex[3],leaf_node.vertex[7], vertex_list[11]);
 
+  // Every edge is identified by its lower grid vertex and its axis, so that neighboring cells agree on it
+  const boost::uint64_t grid_size = data_size_ + 3;
+  boost::uint64_t edge_key[12];
+  for (int e = 0; e < 12; ++e)
+  {
+    const int *c1 = cornerOffsetTable[edge_corners[e][0]];
+    const int *c2 = cornerOffsetTable[edge_corners[e][1]];
+    int axis = (c1[0] != c2[0]) ? 0 : ((c1[1] != c2[1]) ? 1 : 2);
+    boost::uint64_t gx = index_3d[0] + (std::min) (c1[0], c2[0]);
+    boost::uint64_t gy = index_3d[1] + (std::min) (c1[1], c2[1]);
+    boost::uint64_t gz = index_3d[2] + (std::min) (c1[2], c2[2]);
+    edge_key[e] = ((gx * grid_size + gy) * grid_size + gz) * 3 + axis;
+  }
+
   // Create the triangle
   for (int i=0;triTable[cubeindex][i]!=-1;i+=3) {
+    edge_keys.push_back (edge_key[triTable[cubeindex][i  ]]);
+    edge_keys.push_back (edge_key[triTable[cubeindex][i+1]]);
+    edge_keys.push_back (edge_key[triTable[cubeindex][i+2]]);
     pcl::PointXYZ p1,p2,p3;
     p1.x = vertex_list[triTable[cubeindex][i  ]][0];
     p1.y = vertex_list[triTable[cubeindex][i  ]][1];
@@ -187,7 +214,7 @@ pcl::MarchingCubes<PointNT>::createSurface (Leaf leaf_node, Eigen::Vector3i &ind
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> void
-pcl::MarchingCubes<PointNT>::getNeighborList1D (Leaf leaf, Eigen::Vector3i &index3d, HashMap &neighbor_list)
+pcl::MarchingCubes<PointNT>::getNeighborList1D (const Leaf &leaf, const Eigen::Vector3i &index3d, HashMap &neighbor_list)
 {
   for (int x = -1; x < 2; ++x)
   {
@@ -299,30 +326,78 @@ pcl::MarchingCubes<PointNT>::performReconstruction (pcl::PolygonMesh &output)
 
   getBoundingBox();
 
+  cell_hash_map_.clear ();
+  blocks_.clear ();
+  last_block_index_ = -1;
+  last_block_ = NULL;
+
   // transform the point cloud into a voxel grid
   // this needs to be implemented in a child class
   voxelizeData();
 
-  // run the actual marching cubes algorithm, store it into a point cloud,
-  // and copy the point cloud + connectivity into output
-  pcl::PointCloud<pcl::PointXYZ> cloud;
+  // move the leaves stored in the hash map into the block grid
   BOOST_FOREACH (typename HashMap::value_type entry, cell_hash_map_)
   {
     Eigen::Vector3i leaf_index;
     getIndexIn3D (entry.first, leaf_index);
-    createSurface (entry.second, leaf_index, cloud, iso_level_);
+    getLeaf (leaf_index) = entry.second;
   }
-  pcl::toROSMsg (cloud, output.cloud);
-  output.polygons.resize (cloud.size () / 3);
+  cell_hash_map_.clear ();
+
+  std::vector<std::pair<int, LeafBlock*> > blocks;
+  blocks.reserve (blocks_.size ());
+  for (typename BlockMap::const_iterator it = blocks_.begin (); it != blocks_.end (); ++it)
+    blocks.push_back (std::make_pair (it->first, it->second.get ()));
+
+  // run the actual marching cubes algorithm on every block, storing the vertices of 
+  // each triangle together with the grid edges they lie on
+  std::vector<pcl::PointCloud<pcl::PointXYZ> > block_vertices (blocks.size ());
+  std::vector<std::vector<boost::uint64_t> > block_edges (blocks.size ());
+#pragma omp parallel for schedule (dynamic) num_threads (threads_)
+  for (int b = 0; b < (int)blocks.size (); ++b)
+  {
+    int block_index = blocks[b].first;
+    Eigen::Vector3i offset;
+    offset[0] = (block_index / (blocks_per_side_ * blocks_per_side_)) << 3;
+    offset[1] = ((block_index / blocks_per_side_) % blocks_per_side_) << 3;
+    offset[2] = (block_index % blocks_per_side_) << 3;
+    for (int i = 0; i < 512; ++i)
+    {
+      Eigen::Vector3i leaf_index (offset[0] + (i >> 6), offset[1] + ((i >> 3) & 7), offset[2] + (i & 7));
+      createSurface (blocks[b].second->leaf[i], leaf_index, block_vertices[b], block_edges[b], iso_level_);
+    }
+  }
+
+  // merge the vertices shared by neighboring cells, which lie on the same grid edge
+  std::vector<boost::uint64_t> edges;
+  size_t nr_corners = 0;
+  for (size_t b = 0; b < blocks.size (); ++b)
+    nr_corners += block_edges[b].size ();
+  edges.reserve (nr_corners);
+  for (size_t b = 0; b < blocks.size (); ++b)
+    edges.insert (edges.end (), block_edges[b].begin (), block_edges[b].end ());
+  std::sort (edges.begin (), edges.end ());
+  edges.erase (std::unique (edges.begin (), edges.end ()), edges.end ());
+
+  pcl::PointCloud<pcl::PointXYZ> cloud;
+  cloud.points.resize (edges.size ());
+  cloud.width = (uint32_t) edges.size ();
+  cloud.height = 1;
 
-  for (size_t i = 0; i < output.polygons.size (); ++i)
+  output.polygons.resize (nr_corners / 3);
+  size_t corner = 0;
+  for (size_t b = 0; b < blocks.size (); ++b)
   {
-    pcl::Vertices v;
-    v.vertices.resize (3);
-    for (int j = 0; j < 3; ++j)
-      v.vertices[j] = i*3+j;
-     output.polygons[i] = v;
+    for (size_t i = 0; i < block_edges[b].size (); ++i, ++corner)
+    {
+      uint32_t idx = std::lower_bound (edges.begin (), edges.end (), block_edges[b][i]) - edges.begin ();
+      cloud.points[idx] = block_vertices[b].points[i];
+      if (corner % 3 == 0)
+        output.polygons[corner / 3].vertices.resize (3);
+      output.polygons[corner / 3].vertices[corner % 3] = idx;
+    }
   }
+  pcl::toROSMsg (cloud, output.cloud);
 }
 
 #define PCL_INSTANTIATE_MarchingCubes(T) template class PCL_EXPORTS pcl::MarchingCubes<T>;
@@ -62,35 +62,26 @@ pcl::MarchingCubesGreedy<PointNT>::voxelizeData()
 
     Eigen::Vector3i index_3d;
     MarchingCubes<PointNT>::getCellIndex (input_->points[cp].getVector4fMap (), index_3d);
-    int index_1d = MarchingCubes<PointNT>::getIndexIn1D (index_3d);
-    Leaf cell_data;
+    Leaf &cell_data = MarchingCubes<PointNT>::getLeaf (index_3d);
     for (int i = 0; i < 8; ++i)
     {
       cell_data.vertex[i] = 1;
     }
-    cell_hash_map_[index_1d] = cell_data;
 
-    // the vertices are shared by 8 voxels, so we need to update all 8 of them
-    HashMap neighbor_list;
-    getNeighborList1D (cell_data, index_3d, neighbor_list);
-    BOOST_FOREACH (typename HashMap::value_type entry, neighbor_list)
-    {
-      Eigen::Vector3i i3d;
-      getIndexIn3D(entry.first, i3d);
-      // if the neighbor doesn't exist, add it, otherwise we need to do an OR operation on the vertices
-      if (cell_hash_map_.find (entry.first) == cell_hash_map_.end ())
-      {
-        cell_hash_map_[entry.first] = entry.second;
-      }
-      else
-      {
-        for(int i = 0; i < 8; ++i)
+    // the vertices are shared with the 26 neighboring voxels, so we need to update them too
+    for (int x = -1; x < 2; ++x)
+      for (int y = -1; y < 2; ++y)
+        for (int z = -1; z < 2; ++z)
         {
-          if(entry.second.vertex[i] > 0)
-            cell_hash_map_[entry.first].vertex[i] = entry.second.vertex[i];
+          if ((x == 0 && y == 0 && z == 0) || 
+              (index_3d[0] == 0 && x == -1) || (index_3d[1] == 0 && y == -1) || (index_3d[2] == 0 && z == -1))
+            continue;
+
+          Eigen::Vector3i offset (x, y, z);
+          Eigen::Vector3i neighbor_index = index_3d + offset;
+          // if the neighbor doesn't exist, it is created, otherwise we do an OR operation on the vertices
+          MarchingCubes<PointNT>::updateNeighborLeaf (cell_data, offset, MarchingCubes<PointNT>::getLeaf (neighbor_index));
         }
-      }
-    }
   }
 }
 
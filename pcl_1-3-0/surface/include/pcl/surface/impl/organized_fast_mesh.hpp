@@ -70,6 +70,117 @@ pcl::OrganizedFastMesh<PointInT>::reconstructPolygons (std::vector<pcl::Vertices
     makeQuadMesh(polygons);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::OrganizedFastMesh<PointInT>::reconstructIndexBuffer (std::vector<uint32_t>& vertices)
+{
+  if (input_->width <= (unsigned int)triangle_pixel_size_ || input_->height <= (unsigned int)triangle_pixel_size_)
+  {
+    vertices.clear ();
+    return;
+  }
+  unsigned int last_column = input_->width - triangle_pixel_size_;
+  unsigned int last_row = input_->height - triangle_pixel_size_;
+  int nr_columns = (last_column + triangle_pixel_size_ - 1) / triangle_pixel_size_;
+  int nr_rows = (last_row + triangle_pixel_size_ - 1) / triangle_pixel_size_;
+
+  // every row gets room for its largest possible mesh (one quad or two triangles per pixel)
+  size_t row_capacity = (triangulation_type_ == QUAD_MESH) ? 4 * nr_columns : 6 * nr_columns;
+  vertices.resize (nr_rows * row_capacity);
+  row_sizes_.resize (nr_rows);
+
+#pragma omp parallel for schedule (dynamic) num_threads (threads_)
+  for (int row = 0; row < nr_rows; ++row)
+    row_sizes_[row] = makeRowIndexBuffer (row * triangle_pixel_size_, &vertices[row * row_capacity]);
+
+  // close the gaps between the rows
+  size_t size = row_sizes_[0];
+  for (int row = 1; row < nr_rows; ++row)
+  {
+    std::copy (vertices.begin () + row * row_capacity, vertices.begin () + row * row_capacity + row_sizes_[row], 
+               vertices.begin () + size);
+    size += row_sizes_[row];
+  }
+  vertices.resize (size);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> size_t
+pcl::OrganizedFastMesh<PointInT>::makeRowIndexBuffer (unsigned int y, uint32_t* vertices)
+{
+  uint32_t* start = vertices;
+  unsigned int last_column = input_->width - triangle_pixel_size_;
+  for ( unsigned int x = 0; x < last_column; x+=triangle_pixel_size_ )
+  {
+    int i = getIndex(x, y);
+    int index_right = getIndex(x+triangle_pixel_size_, y);
+    int index_down = getIndex(x, y+triangle_pixel_size_);
+    int index_down_right = getIndex(x+triangle_pixel_size_, y+triangle_pixel_size_);
+
+    if ( triangulation_type_ == QUAD_MESH )
+    {
+      if ( isValidQuad(i, index_right, index_down_right, index_down) )
+        if ( !isShadowedQuad(i, index_right, index_down_right, index_down) )
+        {
+          *vertices++ = i;
+          *vertices++ = index_right;
+          *vertices++ = index_down_right;
+          *vertices++ = index_down;
+        }
+    }
+    else if ( triangulation_type_ == TRIANGLE_RIGHT_CUT )
+    {
+      if ( isValidTriangle(i, index_right, index_down_right) )
+        addTriangle(i, index_right, index_down_right, vertices);
+      if ( isValidTriangle(i, index_down, index_down_right) )
+        addTriangle(i, index_down, index_down_right, vertices);
+    }
+    else if ( triangulation_type_ == TRIANGLE_LEFT_CUT )
+    {
+      if ( isValidTriangle(i, index_right, index_down) )
+        addTriangle(i, index_right, index_down, vertices);
+      if ( isValidTriangle(index_right, index_down, index_down_right) )
+        addTriangle(index_right, index_down, index_down_right, vertices);
+    }
+    else
+    {
+      const bool right_cut_upper = isValidTriangle(i, index_right, index_down_right);
+      const bool right_cut_lower = isValidTriangle(i, index_down, index_down_right);
+      const bool left_cut_upper = isValidTriangle(i, index_right, index_down);
+      const bool left_cut_lower = isValidTriangle(index_right, index_down, index_down_right);
+
+      if ( right_cut_upper && right_cut_lower && left_cut_upper && left_cut_lower )
+      {
+        float dist_right_cut = fabs (input_->points[index_down].z - input_->points[index_right].z);
+        float dist_left_cut = fabs (input_->points[i].z - input_->points[index_down_right].z);
+        if ( dist_right_cut >= dist_left_cut )
+        {
+          addTriangle(i, index_right, index_down_right, vertices);
+          addTriangle(i, index_down, index_down_right, vertices);
+        }
+        else
+        {
+          addTriangle(i, index_right, index_down, vertices);
+          addTriangle(index_right, index_down, index_down_right, vertices);
+        }
+      }
+      else
+      {
+        // at most one of the points is invalid, so at most one of these triangles is valid
+        if (right_cut_upper)
+          addTriangle(i, index_right, index_down_right, vertices);
+        if (right_cut_lower)
+          addTriangle(i, index_down, index_down_right, vertices);
+        if (left_cut_upper)
+          addTriangle(i, index_right, index_down, vertices);
+        if (left_cut_lower)
+          addTriangle(index_right, index_down, index_down_right, vertices);
+      }
+    }
+  }
+  return (vertices - start);
+}
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT> void
@@ -38,6 +38,7 @@
 
 #include <pcl/surface/reconstruction.h>
 #include <boost/unordered_map.hpp>
+#include <boost/cstdint.hpp>
 
 namespace pcl
 {
@@ -348,6 +349,10 @@ namespace pcl
     {0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
     {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}
   };
+  /* Offsets (x, y, z) of the cube vertices from the cube origin (vertex 0) */
+  const int cornerOffsetTable[8][3]={
+    {0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}, {0, 1, 0}, {1, 1, 0}, {1, 1, 1}, {0, 1, 1}
+  };
 
 
   /** \brief The marching cubes surface reconstruction algorithm.
@@ -375,6 +380,16 @@ namespace pcl
 
       typedef boost::unordered_map<int, Leaf, boost::hash<int>, std::equal_to<int>, Eigen::aligned_allocator<int> > HashMap;
 
+      /** \brief Dense block of 8x8x8 voxels. The grid is stored as a hash map of such blocks, so that
+        * neighboring voxels are addressed without hashing and blocks can be processed independently.
+        */
+      struct LeafBlock
+      {
+        Leaf leaf[512];
+      };
+
+      typedef boost::unordered_map<int, boost::shared_ptr<LeafBlock> > BlockMap;
+
 
       /** \brief Constructor. */ 
       MarchingCubes ();
@@ -391,6 +406,18 @@ namespace pcl
         leaf_size_ = leaf_size;
       };
 
+      /** \brief Set the number of threads used to extract the surface from the voxel blocks, using the
+        * OpenMP standard.
+        * \param nr_threads the number of hardware threads to use
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
       /** \brief set the iso level.
         * \param iso_level the iso level.
         */
@@ -444,7 +471,50 @@ namespace pcl
        *
        */
       void
-      getNeighborList1D (Leaf leaf, Eigen::Vector3i &index3d, HashMap &neighbor_list);
+      getNeighborList1D (const Leaf &leaf, const Eigen::Vector3i &index3d, HashMap &neighbor_list);
+
+      /** \brief Copy the (positive) vertex values a leaf shares with one of its neighbors into the
+        * neighbor's leaf.
+        * \param leaf the source leaf
+        * \param offset the offset of the neighbor from the source leaf (each component in [-1, 1])
+        * \param neighbor_leaf the leaf of the neighbor to be updated
+        */
+      inline void
+      updateNeighborLeaf (const Leaf &leaf, const Eigen::Vector3i &offset, Leaf &neighbor_leaf) const
+      {
+        for (int i = 0; i < 8; ++i)
+        {
+          bool shared = true;
+          for (int d = 0; d < 3; ++d)
+          {
+            int c = cornerOffsetTable[i][d] + offset[d];
+            shared = shared && (c == 0 || c == 1);
+          }
+          if (shared && leaf.vertex[i] > 0)
+            neighbor_leaf.vertex[i] = leaf.vertex[i];
+        }
+      }
+
+      /** \brief Get the leaf of a cell in the sparse block grid, creating its (zero initialized) block if
+        * it does not exist yet.
+        * \param index_3d the 3d index of the cell, each component in the range [0, data_size_ + 1]
+        */
+      inline Leaf&
+      getLeaf (const Eigen::Vector3i &index_3d)
+      {
+        int block_index = (((index_3d[0] >> 3) * blocks_per_side_ + (index_3d[1] >> 3)) * blocks_per_side_ + 
+                           (index_3d[2] >> 3));
+        // consecutive lookups mostly hit the same block
+        if (block_index != last_block_index_)
+        {
+          boost::shared_ptr<LeafBlock> &block = blocks_[block_index];
+          if (!block)
+            block.reset (new LeafBlock);
+          last_block_ = block.get ();
+          last_block_index_ = block_index;
+        }
+        return (last_block_->leaf[((index_3d[0] & 7) << 6) | ((index_3d[1] & 7) << 3) | (index_3d[2] & 7)]);
+      }
 
       /** \brief Given the 3d index (x, y, z) of the cell, get the
         * coordinates of the cell center
@@ -495,9 +565,25 @@ namespace pcl
       /** \brief iso level. */
       float iso_level_;
 
-      /** \brief Map containing the set of leaves. */
+      /** \brief Map containing the set of leaves. Derived classes may either fill this map or write into the
+        * sparse block grid through getLeaf (); leaves found in the map are moved into the block grid before
+        * the surface is extracted.
+        */
       HashMap cell_hash_map_;
 
+      /** \brief The sparse block grid holding the leaves. */
+      BlockMap blocks_;
+
+      /** \brief Number of blocks along each side of the grid. */
+      int blocks_per_side_;
+
+      /** \brief Index and pointer of the most recently accessed block. */
+      int last_block_index_;
+      LeafBlock *last_block_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
       /** \brief Convert the point cloud into voxel data. */
       virtual void
       voxelizeData() =0;
@@ -514,10 +600,12 @@ namespace pcl
        * \param leaf_node the leaf node to be checked
        * \param index_3d the 3d index of the leaf node to be checked
        * \param cloud point cloud to store the vertices of the polygon
+       * \param edge_keys the keys of the grid edges the vertices lie on, one per vertex added to \a cloud
        * \param iso_level the iso level to do the reconstruction on
        */
       void
-      createSurface (Leaf leaf_node, Eigen::Vector3i &index_3d, pcl::PointCloud<pcl::PointXYZ> &cloud, float iso_level);
+      createSurface (const Leaf &leaf_node, const Eigen::Vector3i &index_3d, pcl::PointCloud<pcl::PointXYZ> &cloud, 
+                     std::vector<boost::uint64_t> &edge_keys, float iso_level);
 
       /** \brief Get the bounding box for the input data points, also calculating the
         * cell size, and the gaussian scale factor
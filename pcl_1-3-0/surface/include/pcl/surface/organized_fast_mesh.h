@@ -74,6 +74,7 @@ namespace pcl
       , triangle_pixel_size_ (1)
       , triangulation_type_ (TRIANGLE_RIGHT_CUT)
       , store_shadowed_faces_(false)
+      , threads_ (1)
       {
         check_tree_ = false;
         cos_angle_tolerance_ = fabs(cos(pcl::deg2rad(12.5f)));
@@ -93,6 +94,27 @@ namespace pcl
       void
       reconstructPolygons (std::vector<pcl::Vertices>& polygons);
 
+      /** \brief Create the mesh as a flat index buffer, i.e., consecutive triples of point indices (quadruples
+        * for QUAD_MESH), without allocating a pcl::Vertices per face. The rows of the image are meshed in
+        * parallel (see setNumberOfThreads ()).
+        *
+        * \param vertices the resultant index buffer. Its memory is reused, so passing the same buffer for
+        * every frame avoids all allocations once it has grown to the size of the largest mesh.
+        */
+      void
+      reconstructIndexBuffer (std::vector<uint32_t>& vertices);
+
+      /** \brief Set the number of threads used by reconstructIndexBuffer (), using the OpenMP standard.
+        * \param nr_threads the number of hardware threads to use
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        if (nr_threads == 0)
+          nr_threads = 1;
+        threads_ = nr_threads;
+      }
+
       /** \brief Set a maximum edge length. TODO: Implement! */
       inline void
       setMaxEdgeLength(float max_edge_length)
@@ -150,6 +172,12 @@ namespace pcl
 
       float cos_angle_tolerance_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief Number of indices written for each row by reconstructIndexBuffer () */
+      std::vector<size_t> row_sizes_;
+
       /** \brief Add a new triangle to the current polygon mesh
         * \param a index of the first vertex
         * \param b index of the second vertex
@@ -169,6 +197,23 @@ namespace pcl
         polygons.push_back (triangle_);
       }
 
+      /** \brief Add a new triangle to a flat index buffer
+        * \param a index of the first vertex
+        * \param b index of the second vertex
+        * \param c index of the third vertex
+        * \param vertices the position in the index buffer, advanced past the new triangle
+        */
+      inline void
+      addTriangle (int a, int b, int c, uint32_t* &vertices)
+      {
+        if (isShadowedTriangle(a, b, c))
+          return;
+
+        *vertices++ = a;
+        *vertices++ = b;
+        *vertices++ = c;
+      }
+
       inline void
       addQuad(int a, int b, int c, int d, std::vector<pcl::Vertices>& polygons)
       {
@@ -254,6 +299,14 @@ namespace pcl
         return (int)(y * input_->width + x);
       }
 
+      /** \brief Mesh a single row of quads into a flat index buffer
+        * \param y the image row of the upper vertices of the quads
+        * \param vertices the start of the index buffer for this row
+        * \return the number of indices written
+        */
+      size_t
+      makeRowIndexBuffer (unsigned int y, uint32_t* vertices);
+
       void
       makeQuadMesh (std::vector<pcl::Vertices>& polygons);
 
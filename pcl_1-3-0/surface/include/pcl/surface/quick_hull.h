@@ -0,0 +1,205 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_SURFACE_QUICK_HULL_H_
+#define PCL_SURFACE_QUICK_HULL_H_
+
+#include <pcl/pcl_macros.h>
+#include <pcl/PolygonMesh.h>
+#include <Eigen/Core>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Native 2D and 3D convex hull computation.
+    *
+    * 2D hulls are computed with Andrew's monotone chain, 3D hulls with
+    * quickhull. All state lives in the object, so different instances can be
+    * used from different threads at the same time, and the internal buffers
+    * are kept between calls so that computing many small hulls with the same
+    * instance does not allocate.
+    *
+    * Points closer than a small tolerance (relative to the extent of the
+    * input) to a hull edge or facet are not reported as hull vertices.
+    * \ingroup surface
+    */
+  class PCL_EXPORTS QuickHull
+  {
+    public:
+      /** \brief Empty constructor. */
+      QuickHull () : points_ (NULL), epsilon_ (0), visit_ (0), area_ (0), volume_ (0) {}
+
+      /** \brief Compute the convex hull of a set of 2D points.
+        * \param points the point coordinates, x and y for every point
+        * \param nr_points the number of points
+        * \param vertices the indices of the hull vertices, in counter-clockwise order
+        * \return false if the points are not finite or do not span a 2D area
+        */
+      bool
+      compute2D (const double *points, int nr_points, std::vector<int> &vertices);
+
+      /** \brief Compute the convex hull of a set of 3D points.
+        * \param points the point coordinates, x, y and z for every point
+        * \param nr_points the number of points
+        * \param vertices the indices of the hull vertices
+        * \param triangles the hull facets as triangles with outward facing 
+        * counter-clockwise vertices, given as positions in \a vertices
+        * \return false if the points are not finite or do not span a 3D volume
+        */
+      bool
+      compute3D (const double *points, int nr_points, std::vector<int> &vertices, 
+                 std::vector<pcl::Vertices> &triangles);
+
+      /** \brief Get the area (3D: surface area) of the last computed hull. */
+      inline double
+      getArea () const
+      {
+        return (area_);
+      }
+
+      /** \brief Get the volume of the last computed 3D hull, 0 for 2D hulls. */
+      inline double
+      getVolume () const
+      {
+        return (volume_);
+      }
+
+    private:
+      /** \brief A triangular facet of the 3D hull. */
+      struct Face
+      {
+        /** \brief The vertices (point indices), counter-clockwise seen from outside. */
+        int v[3];
+        /** \brief The face across edge (v[i], v[(i+1)%3]). */
+        int neighbor[3];
+        /** \brief The outward facing unit normal. */
+        Eigen::Vector3d normal;
+        /** \brief The plane offset: the signed distance of p is normal.dot (p) - offset. */
+        double offset;
+        /** \brief The points above this face, in \a outside_points_ from outside_begin on. */
+        int outside_begin, outside_end;
+        /** \brief False once the face has been removed from the hull. */
+        bool alive;
+        /** \brief Visit stamp used while looking for the faces visible from a point. */
+        int visited;
+      };
+
+      /** \brief Return point i of the current 3D input. */
+      inline Eigen::Vector3d
+      point3D (int i) const
+      {
+        return (Eigen::Vector3d (points_[3*i], points_[3*i+1], points_[3*i+2]));
+      }
+
+      /** \brief Add face (a, b, c) and return its index. */
+      int
+      addFace (int a, int b, int c);
+
+      /** \brief Signed distance of point i to a face. */
+      inline double
+      distance (const Face &face, int i) const
+      {
+        return (face.normal.dot (point3D (i)) - face.offset);
+      }
+
+      /** \brief Assign the points in candidates_ to the given faces, dropping the ones not above any of them. 
+        * \param first_face the index of the first face to consider
+        */
+      void
+      assignOutsidePoints (int first_face);
+
+      /** \brief Build the initial tetrahedron. 
+        * \return false if the points do not span a 3D volume
+        */
+      bool
+      initSimplex (int nr_points);
+
+      /** \brief Add the point farthest above the given face to the hull. */
+      void
+      addPoint (int face_idx);
+
+      /** \brief The current 3D input. */
+      const double *points_;
+
+      /** \brief Distance tolerance for the current input. */
+      double epsilon_;
+
+      /** \brief All faces created for the current hull, removed ones included. */
+      std::vector<Face> faces_;
+
+      /** \brief Points above faces, each face owns a range. */
+      std::vector<int> outside_points_;
+
+      /** \brief Points waiting for a face, see assignOutsidePoints (). */
+      std::vector<int> candidates_;
+
+      /** \brief Per candidate: the face it was assigned to, -1 if none. */
+      std::vector<int> assignment_;
+
+      /** \brief Faces visible from the point being added. */
+      std::vector<int> visible_;
+
+      /** \brief Horizon edges (start vertex, end vertex, hidden face, edge index in hidden face). */
+      std::vector<Eigen::Vector4i, Eigen::aligned_allocator<Eigen::Vector4i> > horizon_;
+
+      /** \brief Per point: the new face whose horizon edge starts / ends at this vertex. */
+      std::vector<int> edge_start_, edge_end_;
+
+      /** \brief Per point: position in the output vertices, -1 if not a vertex. */
+      std::vector<int> vertex_map_;
+
+      /** \brief Work stack for face traversal. */
+      std::vector<int> stack_;
+
+      /** \brief Sorted point order for the 2D hull. */
+      std::vector<int> order_;
+
+      /** \brief Current visit stamp. */
+      int visit_;
+
+      /** \brief Area of the last computed hull. */
+      double area_;
+
+      /** \brief Volume of the last computed hull. */
+      double volume_;
+
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+}
+
+#endif  // #ifndef PCL_SURFACE_QUICK_HULL_H_
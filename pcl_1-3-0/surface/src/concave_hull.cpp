@@ -43,6 +43,19 @@
 #include "pcl/surface/concave_hull.h"
 #include "pcl/surface/impl/concave_hull.hpp"
 
+namespace
+{
+  // Constructed during static initialization, before any thread can call into qhull
+  boost::mutex qhull_mutex;
+}
+
+//////////////////////////////////////////////////////////////////////////
+boost::mutex&
+pcl::getQhullMutex ()
+{
+  return (qhull_mutex);
+}
+
 // Instantiations of specific point types
 PCL_INSTANTIATE(ConcaveHull, PCL_XYZ_POINT_TYPES);
 
@@ -35,9 +35,6 @@
  *
  */
 
-#include <pcl/pcl_config.h>
-#ifdef HAVE_QHULL
-
 #include "pcl/impl/instantiate.hpp"
 #include "pcl/point_types.h"
 #include "pcl/surface/convex_hull.h"
@@ -45,5 +42,3 @@
 
 // Instantiations of specific point types
 PCL_INSTANTIATE(ConvexHull, PCL_XYZ_POINT_TYPES);
-
-#endif
@@ -0,0 +1,413 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "pcl/surface/quick_hull.h"
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+  /** \brief Lexicographic (x, then y) order of 2D points given by index. */
+  struct Less2D
+  {
+    Less2D (const double *points) : points_ (points) {}
+
+    inline bool
+    operator () (int a, int b) const
+    {
+      if (points_[2*a] != points_[2*b])
+        return (points_[2*a] < points_[2*b]);
+      return (points_[2*a+1] < points_[2*b+1]);
+    }
+
+    const double *points_;
+  };
+
+  /** \brief Twice the signed area of the triangle (o, a, b), positive if counter-clockwise. */
+  inline double
+  cross2D (const double *points, int o, int a, int b)
+  {
+    return ((points[2*a] - points[2*o]) * (points[2*b+1] - points[2*o+1]) -
+            (points[2*a+1] - points[2*o+1]) * (points[2*b] - points[2*o]));
+  }
+
+  /** \brief Check that all coordinates are finite. */
+  inline bool
+  allFinite (const double *points, int nr_values)
+  {
+    for (int i = 0; i < nr_values; ++i)
+      if (!pcl_isfinite (points[i]))
+        return (false);
+    return (true);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool
+pcl::QuickHull::compute2D (const double *points, int nr_points, std::vector<int> &vertices)
+{
+  area_ = volume_ = 0;
+  vertices.clear ();
+  if (nr_points < 3 || !allFinite (points, 2 * nr_points))
+    return (false);
+
+  order_.resize (nr_points);
+  for (int i = 0; i < nr_points; ++i)
+    order_[i] = i;
+  std::sort (order_.begin (), order_.end (), Less2D (points));
+
+  // Andrew's monotone chain: lower hull left to right, upper hull right to left.
+  // Collinear and duplicate points are dropped.
+  stack_.resize (2 * nr_points);
+  int k = 0;
+  for (int i = 0; i < nr_points; ++i)
+  {
+    while (k >= 2 && cross2D (points, stack_[k-2], stack_[k-1], order_[i]) <= 0)
+      --k;
+    stack_[k++] = order_[i];
+  }
+  for (int i = nr_points - 2, lower = k + 1; i >= 0; --i)
+  {
+    while (k >= lower && cross2D (points, stack_[k-2], stack_[k-1], order_[i]) <= 0)
+      --k;
+    stack_[k++] = order_[i];
+  }
+
+  // The last point repeats the first one
+  if (k - 1 < 3)
+    return (false);
+  vertices.assign (stack_.begin (), stack_.begin () + (k - 1));
+
+  for (size_t i = 0; i < vertices.size (); ++i)
+    area_ += cross2D (points, vertices[0], vertices[i], vertices[(i + 1) % vertices.size ()]);
+  area_ *= 0.5;
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////
+int
+pcl::QuickHull::addFace (int a, int b, int c)
+{
+  Face face;
+  face.v[0] = a; face.v[1] = b; face.v[2] = c;
+  face.neighbor[0] = face.neighbor[1] = face.neighbor[2] = -1;
+  Eigen::Vector3d pa = point3D (a);
+  face.normal = (point3D (b) - pa).cross (point3D (c) - pa);
+  double norm = face.normal.norm ();
+  if (norm > 0)
+    face.normal /= norm;
+  face.offset = face.normal.dot (pa);
+  face.outside_begin = face.outside_end = 0;
+  face.alive = true;
+  face.visited = 0;
+  faces_.push_back (face);
+  return (static_cast<int> (faces_.size ()) - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::QuickHull::assignOutsidePoints (int first_face)
+{
+  const int nr_faces = static_cast<int> (faces_.size ());
+
+  // Assign every candidate to the face it is farthest above
+  assignment_.resize (candidates_.size ());
+  for (size_t i = 0; i < candidates_.size (); ++i)
+  {
+    assignment_[i] = -1;
+    double best = epsilon_;
+    for (int f = first_face; f < nr_faces; ++f)
+    {
+      double d = distance (faces_[f], candidates_[i]);
+      if (d > best)
+      {
+        best = d;
+        assignment_[i] = f;
+      }
+    }
+  }
+
+  // Give every face a contiguous range of outside_points_
+  for (int f = first_face; f < nr_faces; ++f)
+    faces_[f].outside_begin = faces_[f].outside_end = 0;
+  for (size_t i = 0; i < candidates_.size (); ++i)
+    if (assignment_[i] >= 0)
+      ++faces_[assignment_[i]].outside_end;
+
+  int begin = static_cast<int> (outside_points_.size ());
+  for (int f = first_face; f < nr_faces; ++f)
+  {
+    int count = faces_[f].outside_end;
+    faces_[f].outside_begin = faces_[f].outside_end = begin;
+    begin += count;
+  }
+  outside_points_.resize (begin);
+  for (size_t i = 0; i < candidates_.size (); ++i)
+    if (assignment_[i] >= 0)
+      outside_points_[faces_[assignment_[i]].outside_end++] = candidates_[i];
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool
+pcl::QuickHull::initSimplex (int nr_points)
+{
+  // The two most distant of the extreme points along the axes
+  int extremes[6] = {0, 0, 0, 0, 0, 0};
+  for (int i = 1; i < nr_points; ++i)
+    for (int d = 0; d < 3; ++d)
+    {
+      if (points_[3*i+d] < points_[3*extremes[2*d]+d])
+        extremes[2*d] = i;
+      if (points_[3*i+d] > points_[3*extremes[2*d+1]+d])
+        extremes[2*d+1] = i;
+    }
+
+  int a = 0, b = 0;
+  double best = -1;
+  for (int i = 0; i < 6; ++i)
+    for (int j = i + 1; j < 6; ++j)
+    {
+      double d = (point3D (extremes[i]) - point3D (extremes[j])).squaredNorm ();
+      if (d > best)
+      {
+        best = d;
+        a = extremes[i];
+        b = extremes[j];
+      }
+    }
+  if (std::sqrt (best) <= epsilon_)
+    return (false);
+
+  // The point farthest from the line ab
+  Eigen::Vector3d pa = point3D (a), ab = (point3D (b) - pa).normalized ();
+  int c = -1;
+  best = epsilon_;
+  for (int i = 0; i < nr_points; ++i)
+  {
+    double d = (point3D (i) - pa).cross (ab).norm ();
+    if (d > best)
+    {
+      best = d;
+      c = i;
+    }
+  }
+  if (c < 0)
+    return (false);
+
+  // The point farthest from the plane abc
+  Eigen::Vector3d normal = (point3D (b) - pa).cross (point3D (c) - pa).normalized ();
+  int d = -1;
+  best = epsilon_;
+  for (int i = 0; i < nr_points; ++i)
+  {
+    double dist = std::fabs (normal.dot (point3D (i) - pa));
+    if (dist > best)
+    {
+      best = dist;
+      d = i;
+    }
+  }
+  if (d < 0)
+    return (false);
+
+  // Orient the base so that d is below it
+  if (normal.dot (point3D (d) - pa) > 0)
+    std::swap (b, c);
+
+  addFace (a, b, c);
+  addFace (a, d, b);
+  addFace (b, d, c);
+  addFace (c, d, a);
+
+  // Connect the faces: the face across edge (x, y) is the one containing edge (y, x)
+  for (int f = 0; f < 4; ++f)
+    for (int e = 0; e < 3; ++e)
+      for (int g = 0; g < 4; ++g)
+        for (int h = 0; h < 3; ++h)
+          if (faces_[g].v[h] == faces_[f].v[(e + 1) % 3] && faces_[g].v[(h + 1) % 3] == faces_[f].v[e])
+            faces_[f].neighbor[e] = g;
+
+  candidates_.clear ();
+  for (int i = 0; i < nr_points; ++i)
+    if (i != a && i != b && i != c && i != d)
+      candidates_.push_back (i);
+  assignOutsidePoints (0);
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::QuickHull::addPoint (int face_idx)
+{
+  // The point farthest above the face
+  const Face &face = faces_[face_idx];
+  int eye = outside_points_[face.outside_begin];
+  double best = distance (face, eye);
+  for (int i = face.outside_begin + 1; i < face.outside_end; ++i)
+  {
+    double d = distance (face, outside_points_[i]);
+    if (d > best)
+    {
+      best = d;
+      eye = outside_points_[i];
+    }
+  }
+
+  // Collect the faces visible from the eye point and the horizon around them
+  ++visit_;
+  visible_.clear ();
+  horizon_.clear ();
+  stack_.clear ();
+  stack_.push_back (face_idx);
+  faces_[face_idx].visited = visit_;
+  while (!stack_.empty ())
+  {
+    int f = stack_.back ();
+    stack_.pop_back ();
+    visible_.push_back (f);
+    for (int e = 0; e < 3; ++e)
+    {
+      int n = faces_[f].neighbor[e];
+      if (faces_[n].visited == visit_)
+        continue;
+      if (distance (faces_[n], eye) > epsilon_)
+      {
+        faces_[n].visited = visit_;
+        stack_.push_back (n);
+      }
+      else
+      {
+        int a = faces_[f].v[e], b = faces_[f].v[(e + 1) % 3];
+        int edge = 0;
+        while (edge < 2 && !(faces_[n].v[edge] == b && faces_[n].v[(edge + 1) % 3] == a))
+          ++edge;
+        horizon_.push_back (Eigen::Vector4i (a, b, n, edge));
+      }
+    }
+  }
+
+  // Remove the visible faces, their outside points are assigned again below
+  candidates_.clear ();
+  for (size_t i = 0; i < visible_.size (); ++i)
+  {
+    Face &f = faces_[visible_[i]];
+    for (int j = f.outside_begin; j < f.outside_end; ++j)
+      if (outside_points_[j] != eye)
+        candidates_.push_back (outside_points_[j]);
+    f.alive = false;
+  }
+
+  // Cone the horizon to the eye point
+  int first_new = static_cast<int> (faces_.size ());
+  for (size_t i = 0; i < horizon_.size (); ++i)
+  {
+    const Eigen::Vector4i &h = horizon_[i];
+    int f = addFace (h[0], h[1], eye);
+    faces_[f].neighbor[0] = h[2];
+    faces_[h[2]].neighbor[h[3]] = f;
+    edge_start_[h[0]] = f;
+    edge_end_[h[1]] = f;
+  }
+  for (int f = first_new; f < static_cast<int> (faces_.size ()); ++f)
+  {
+    faces_[f].neighbor[1] = edge_start_[faces_[f].v[1]];
+    faces_[f].neighbor[2] = edge_end_[faces_[f].v[0]];
+  }
+
+  assignOutsidePoints (first_new);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool
+pcl::QuickHull::compute3D (const double *points, int nr_points, std::vector<int> &vertices, 
+                           std::vector<pcl::Vertices> &triangles)
+{
+  area_ = volume_ = 0;
+  vertices.clear ();
+  triangles.clear ();
+  if (nr_points < 4 || !allFinite (points, 3 * nr_points))
+    return (false);
+
+  points_ = points;
+  faces_.clear ();
+  outside_points_.clear ();
+  visit_ = 0;
+
+  // Tolerance relative to the extent of the input
+  Eigen::Vector3d max_abs = Eigen::Vector3d::Zero ();
+  for (int i = 0; i < nr_points; ++i)
+    max_abs = max_abs.cwiseMax (point3D (i).cwiseAbs ());
+  epsilon_ = 3 * DBL_EPSILON * (max_abs[0] + max_abs[1] + max_abs[2]);
+
+  if (!initSimplex (nr_points))
+    return (false);
+
+  edge_start_.resize (nr_points);
+  edge_end_.resize (nr_points);
+  for (size_t f = 0; f < faces_.size (); ++f)
+    if (faces_[f].alive && faces_[f].outside_end > faces_[f].outside_begin)
+      addPoint (static_cast<int> (f));
+
+  // Collect the remaining faces
+  vertex_map_.assign (nr_points, -1);
+  for (size_t f = 0; f < faces_.size (); ++f)
+  {
+    const Face &face = faces_[f];
+    if (!face.alive)
+      continue;
+
+    pcl::Vertices triangle;
+    triangle.vertices.resize (3);
+    for (int j = 0; j < 3; ++j)
+    {
+      if (vertex_map_[face.v[j]] == -1)
+      {
+        vertex_map_[face.v[j]] = static_cast<int> (vertices.size ());
+        vertices.push_back (face.v[j]);
+      }
+      triangle.vertices[j] = vertex_map_[face.v[j]];
+    }
+    triangles.push_back (triangle);
+
+    Eigen::Vector3d a = point3D (face.v[0]), b = point3D (face.v[1]), c = point3D (face.v[2]);
+    area_ += 0.5 * (b - a).cross (c - a).norm ();
+    volume_ += a.dot (b.cross (c)) / 6.0;
+  }
+  return (true);
+}
@@ -0,0 +1,433 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2010, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+using namespace std;
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/surface/gp3.h>
+#include <pcl/surface/convex_hull.h>
+#include <pcl/surface/marching_cubes_greedy.h>
+#include <pcl/surface/organized_fast_mesh.h>
+#include <pcl/ros/conversions.h>
+using namespace pcl;
+
+PointCloud<PointNormal>::Ptr scan (new PointCloud<PointNormal> ());
+
+/** \brief Triangulate the scan with the test parameters, optionally split into tiles. */
+void
+triangulate (double tile_size, PolygonMesh &mesh)
+{
+  GreedyProjectionTriangulation<PointNormal> gp3;
+  gp3.setSearchRadius (0.05);
+  gp3.setMu (2.5);
+  gp3.setMaximumNearestNeighbors (100);
+  gp3.setMaximumSurfaceAngle (M_PI/4);
+  gp3.setMinimumAngle (M_PI/18);
+  gp3.setMaximumAngle (2*M_PI/3);
+  gp3.setNormalConsistency (false);
+  gp3.setTileSize (tile_size);
+  gp3.setNumberOfThreads (4);
+  gp3.setInputCloud (scan);
+  gp3.reconstruct (mesh);
+}
+
+/** \brief Sum of the triangle areas of a mesh over the scan. */
+double
+meshArea (const PolygonMesh &mesh)
+{
+  double area = 0;
+  for (size_t i = 0; i < mesh.polygons.size (); ++i)
+  {
+    const vector<uint32_t> &v = mesh.polygons[i].vertices;
+    Eigen::Vector3f a = scan->points[v[1]].getVector3fMap () - scan->points[v[0]].getVector3fMap ();
+    Eigen::Vector3f b = scan->points[v[2]].getVector3fMap () - scan->points[v[0]].getVector3fMap ();
+    area += 0.5 * a.cross (b).norm ();
+  }
+  return (area);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GreedyProjectionTriangulation_tiled)
+{
+  PolygonMesh untiled, tiled;
+  triangulate (0, untiled);
+  triangulate (0.25, tiled);
+  ASSERT_GT (untiled.polygons.size (), 0u);
+
+  // Every triangle has to reference three distinct points of the input, and appear only once
+  set<vector<uint32_t> > triangles;
+  set<uint32_t> used;
+  int crossing = 0;
+  for (size_t i = 0; i < tiled.polygons.size (); ++i)
+  {
+    vector<uint32_t> v = tiled.polygons[i].vertices;
+    ASSERT_EQ (v.size (), 3u);
+    for (int j = 0; j < 3; ++j)
+    {
+      ASSERT_LT (v[j], scan->points.size ());
+      used.insert (v[j]);
+    }
+    EXPECT_TRUE (v[0] != v[1] && v[1] != v[2] && v[0] != v[2]);
+    // the seams are stitched, so triangles join points of neighboring tiles
+    if (floor (scan->points[v[0]].x / 0.25) != floor (scan->points[v[1]].x / 0.25) ||
+        floor (scan->points[v[0]].x / 0.25) != floor (scan->points[v[2]].x / 0.25))
+      ++crossing;
+    sort (v.begin (), v.end ());
+    EXPECT_TRUE (triangles.insert (v).second);
+  }
+  EXPECT_GT (crossing, 0);
+
+  set<uint32_t> untiled_used;
+  for (size_t i = 0; i < untiled.polygons.size (); ++i)
+    untiled_used.insert (untiled.polygons[i].vertices.begin (), untiled.polygons[i].vertices.end ());
+
+  // The tiled mesh has to cover the scan like the untiled one
+  EXPECT_NEAR ((double)tiled.polygons.size (), (double)untiled.polygons.size (), 0.05 * untiled.polygons.size ());
+  EXPECT_GE (used.size (), 0.98 * untiled_used.size ());
+  EXPECT_NEAR (meshArea (tiled), meshArea (untiled), 0.02 * meshArea (untiled));
+  EXPECT_EQ (tiled.cloud.width * tiled.cloud.height, scan->points.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GreedyProjectionTriangulation_tinyTiles)
+{
+  // Far more tiles than points: the tiles are grown instead of overflowing the tile count
+  PolygonMesh untiled, tiled;
+  triangulate (0, untiled);
+  triangulate (1e-9, tiled);
+  EXPECT_NEAR ((double)tiled.polygons.size (), (double)untiled.polygons.size (), 0.1 * untiled.polygons.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ConvexHull_cube)
+{
+  // Corners of a unit cube (each twice), face centers, edge midpoints and interior points
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+  for (int c = 0; c < 16; ++c)
+    cloud->points.push_back (PointXYZ ((float)(c & 1), (float)((c >> 1) & 1), (float)((c >> 2) & 1)));
+  for (int d = 0; d < 3; ++d)
+  {
+    for (int side = 0; side < 2; ++side)
+    {
+      PointXYZ center (0.5f, 0.5f, 0.5f);
+      center.data[d] = (float)side;
+      cloud->points.push_back (center);
+    }
+    PointXYZ midpoint (0.0f, 0.0f, 0.0f);
+    midpoint.data[d] = 0.5f;
+    cloud->points.push_back (midpoint);
+  }
+  srand (0);
+  for (int i = 0; i < 100; ++i)
+    cloud->points.push_back (PointXYZ (rand () / (float)RAND_MAX, rand () / (float)RAND_MAX, rand () / (float)RAND_MAX));
+  cloud->width = cloud->points.size ();
+  cloud->height = 1;
+
+  ConvexHull<PointXYZ> hull;
+  hull.setInputCloud (cloud);
+  hull.setComputeAreaVolume (true);
+  PointCloud<PointXYZ> vertices;
+  vector<Vertices> polygons;
+  hull.reconstruct (vertices, polygons);
+
+  // Only the corners are hull vertices, every face of the cube is split into two triangles
+  ASSERT_EQ (vertices.points.size (), 8u);
+  for (size_t i = 0; i < vertices.points.size (); ++i)
+    for (int d = 0; d < 3; ++d)
+      EXPECT_NEAR (min (fabs (vertices.points[i].data[d]), fabs (vertices.points[i].data[d] - 1.0f)), 0.0f, 1e-5);
+  ASSERT_EQ (polygons.size (), 12u);
+
+  // The triangles form a closed surface: every directed edge appears once, in opposite direction in its neighbor
+  set<pair<uint32_t, uint32_t> > edges;
+  for (size_t i = 0; i < polygons.size (); ++i)
+  {
+    ASSERT_EQ (polygons[i].vertices.size (), 3u);
+    for (int j = 0; j < 3; ++j)
+    {
+      ASSERT_LT (polygons[i].vertices[j], vertices.points.size ());
+      EXPECT_TRUE (edges.insert (make_pair (polygons[i].vertices[j], polygons[i].vertices[(j + 1) % 3])).second);
+    }
+  }
+  for (set<pair<uint32_t, uint32_t> >::const_iterator it = edges.begin (); it != edges.end (); ++it)
+    EXPECT_TRUE (edges.count (make_pair (it->second, it->first)) == 1);
+
+  EXPECT_NEAR (hull.getTotalArea (), 6.0, 1e-5);
+  EXPECT_NEAR (hull.getTotalVolume (), 1.0, 1e-5);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ConvexHull_planarSquare)
+{
+  // A square with side 2 in a tilted plane, with duplicate corners, points on the edges and inside
+  const Eigen::Vector3f origin (0.5f, -1.0f, 2.0f);
+  const Eigen::Vector3f axis_u = Eigen::Vector3f (1.0f, 0.0f, 1.0f).normalized ();
+  const Eigen::Vector3f axis_v = Eigen::Vector3f (0.0f, 1.0f, 0.0f);
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+  for (int i = 0; i <= 4; ++i)
+  {
+    for (int j = 0; j <= 4; ++j)
+    {
+      PointXYZ point;
+      point.getVector3fMap () = origin + 0.5f * i * axis_u + 0.5f * j * axis_v;
+      cloud->points.push_back (point);
+      if ((i == 0 || i == 4) && (j == 0 || j == 4))
+        cloud->points.push_back (point);
+    }
+  }
+  cloud->width = cloud->points.size ();
+  cloud->height = 1;
+
+  ConvexHull<PointXYZ> hull;
+  hull.setInputCloud (cloud);
+  hull.setComputeAreaVolume (true);
+  PointCloud<PointXYZ> vertices;
+  vector<Vertices> polygons;
+  hull.reconstruct (vertices, polygons);
+
+  // Only the corners are hull vertices, returned as a single closed polygon
+  ASSERT_EQ (vertices.points.size (), 4u);
+  for (size_t i = 0; i < vertices.points.size (); ++i)
+  {
+    Eigen::Vector3f p = vertices.points[i].getVector3fMap () - origin;
+    float u = p.dot (axis_u), v = p.dot (axis_v);
+    EXPECT_NEAR (min (fabs (u), fabs (u - 2.0f)), 0.0f, 1e-4);
+    EXPECT_NEAR (min (fabs (v), fabs (v - 2.0f)), 0.0f, 1e-4);
+    EXPECT_NEAR (p.dot (axis_u.cross (axis_v)), 0.0f, 1e-4);
+  }
+  ASSERT_EQ (polygons.size (), 1u);
+  ASSERT_EQ (polygons[0].vertices.size (), 5u);
+  set<uint32_t> used (polygons[0].vertices.begin (), polygons[0].vertices.end () - 1);
+  EXPECT_EQ (used.size (), 4u);
+  EXPECT_EQ (*used.rbegin (), 3u);
+  EXPECT_EQ (polygons[0].vertices[4], polygons[0].vertices[0]);
+
+  // For 2D-sets the area is the enclosed area and the volume is zero
+  EXPECT_NEAR (hull.getTotalArea (), 4.0, 1e-4);
+  EXPECT_EQ (hull.getTotalVolume (), 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MarchingCubesGreedy_sphere)
+{
+  // Points and normals of a unit sphere
+  PointCloud<PointNormal>::Ptr sphere (new PointCloud<PointNormal> ());
+  const int n = 80;
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < 2 * n; ++j)
+    {
+      double theta = M_PI * (i + 0.5) / n, phi = M_PI * j / n;
+      PointNormal p;
+      p.normal_x = p.x = (float)(sin (theta) * cos (phi));
+      p.normal_y = p.y = (float)(sin (theta) * sin (phi));
+      p.normal_z = p.z = (float)cos (theta);
+      sphere->points.push_back (p);
+    }
+  }
+  sphere->width = sphere->points.size ();
+  sphere->height = 1;
+
+  const double leaf_size = 0.1;
+  MarchingCubesGreedy<PointNormal> mc;
+  mc.setInputCloud (sphere);
+  mc.setLeafSize (leaf_size);
+  mc.setIsoLevel (0.5f);
+  mc.setNumberOfThreads (2);
+  PolygonMesh mesh;
+  mc.reconstruct (mesh);
+
+  PointCloud<PointXYZ> vertices;
+  fromROSMsg (mesh.cloud, vertices);
+  ASSERT_GT (mesh.polygons.size (), 0u);
+  ASSERT_GT (vertices.points.size (), 0u);
+
+  // The vertices lie on the boundary of the voxels around the sphere
+  for (size_t i = 0; i < vertices.points.size (); ++i)
+    EXPECT_NEAR (vertices.points[i].getVector3fMap ().norm (), 1.0, 2 * sqrt (3.0) * leaf_size);
+
+  // The surface is closed: every edge is shared by exactly two triangles, also at the bounding box
+  map<pair<uint32_t, uint32_t>, int> edges;
+  for (size_t i = 0; i < mesh.polygons.size (); ++i)
+  {
+    const vector<uint32_t> &v = mesh.polygons[i].vertices;
+    ASSERT_EQ (v.size (), 3u);
+    for (int j = 0; j < 3; ++j)
+    {
+      ASSERT_LT (v[j], vertices.points.size ());
+      ++edges[make_pair (min (v[j], v[(j + 1) % 3]), max (v[j], v[(j + 1) % 3]))];
+    }
+  }
+  int open = 0;
+  for (map<pair<uint32_t, uint32_t>, int>::const_iterator it = edges.begin (); it != edges.end (); ++it)
+    if (it->second != 2)
+      ++open;
+  EXPECT_EQ (open, 0);
+
+  // The voxel shell around the sphere has an outer and an inner surface, both of genus 0
+  EXPECT_EQ ((int)vertices.points.size () - (int)edges.size () + (int)mesh.polygons.size (), 4);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedFastMesh_hole)
+{
+  // A 5x4 organized grid in the plane z = 1 in front of the camera, with a hole at column 2, row 1
+  const unsigned int width = 5, height = 4, hole = 1 * width + 2;
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ> ());
+  cloud->width = width;
+  cloud->height = height;
+  cloud->points.resize (width * height);
+  for (unsigned int y = 0; y < height; ++y)
+  {
+    for (unsigned int x = 0; x < width; ++x)
+    {
+      PointXYZ &p = cloud->points[y * width + x];
+      p.x = 0.01f * (float)x - 0.02f;
+      p.y = 0.01f * (float)y - 0.015f;
+      p.z = 1.0f;
+    }
+  }
+  cloud->points[hole].x = cloud->points[hole].y = cloud->points[hole].z = numeric_limits<float>::quiet_NaN ();
+  cloud->is_dense = false;
+
+  OrganizedFastMesh<PointXYZ> ofm;
+  ofm.setInputCloud (cloud);
+  ofm.setNumberOfThreads (2);
+
+  // Right cut: two triangles for each of the 8 quads away from the hole, plus the one triangle
+  // in each of the two quads at the hole whose diagonal does not touch it
+  ofm.setTriangulationType (OrganizedFastMesh<PointXYZ>::TRIANGLE_RIGHT_CUT);
+  vector<Vertices> polygons;
+  ofm.reconstructPolygons (polygons);
+  ASSERT_EQ (polygons.size (), 18u);
+  set<vector<uint32_t> > triangles;
+  for (size_t i = 0; i < polygons.size (); ++i)
+  {
+    ASSERT_EQ (polygons[i].vertices.size (), 3u);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      EXPECT_LT (polygons[i].vertices[j], width * height);
+      EXPECT_NE (polygons[i].vertices[j], hole);
+    }
+    triangles.insert (polygons[i].vertices);
+  }
+  EXPECT_EQ (triangles.size (), 18u);
+  const uint32_t upper_right[] = {2, 3, 8}, lower_left[] = {6, 11, 12}, first[] = {0, 1, 6}, last[] = {13, 18, 19};
+  EXPECT_EQ (triangles.count (vector<uint32_t> (upper_right, upper_right + 3)), 1u);
+  EXPECT_EQ (triangles.count (vector<uint32_t> (lower_left, lower_left + 3)), 1u);
+  EXPECT_EQ (triangles.count (vector<uint32_t> (first, first + 3)), 1u);
+  EXPECT_EQ (triangles.count (vector<uint32_t> (last, last + 3)), 1u);
+
+  // Quad mesh: the 4 quads around the hole are dropped
+  ofm.setTriangulationType (OrganizedFastMesh<PointXYZ>::QUAD_MESH);
+  polygons.clear ();
+  ofm.reconstructPolygons (polygons);
+  ASSERT_EQ (polygons.size (), 8u);
+  for (size_t i = 0; i < polygons.size (); ++i)
+  {
+    ASSERT_EQ (polygons[i].vertices.size (), 4u);
+    const uint32_t a = polygons[i].vertices[0];
+    EXPECT_LT (a % width, width - 1);
+    EXPECT_LT (a / width, height - 1);
+    EXPECT_EQ (polygons[i].vertices[1], a + 1);
+    EXPECT_EQ (polygons[i].vertices[2], a + width + 1);
+    EXPECT_EQ (polygons[i].vertices[3], a + width);
+    EXPECT_TRUE (a != 1 && a != 2 && a != 6 && a != hole);
+  }
+
+  // The flat index buffer holds the same faces as the polygons, row by row
+  const OrganizedFastMesh<PointXYZ>::TriangulationType types[] =
+    {OrganizedFastMesh<PointXYZ>::TRIANGLE_RIGHT_CUT, OrganizedFastMesh<PointXYZ>::TRIANGLE_LEFT_CUT,
+     OrganizedFastMesh<PointXYZ>::TRIANGLE_ADAPTIVE_CUT, OrganizedFastMesh<PointXYZ>::QUAD_MESH};
+  vector<uint32_t> buffer;
+  for (int t = 0; t < 4; ++t)
+  {
+    ofm.setTriangulationType (types[t]);
+    polygons.clear ();
+    ofm.reconstructPolygons (polygons);
+    ofm.reconstructIndexBuffer (buffer);
+    const size_t face_size = (types[t] == OrganizedFastMesh<PointXYZ>::QUAD_MESH) ? 4 : 3;
+    ASSERT_EQ (buffer.size (), polygons.size () * face_size);
+
+    set<vector<uint32_t> > faces;
+    for (size_t i = 0; i < polygons.size (); ++i)
+      faces.insert (polygons[i].vertices);
+    for (size_t i = 0; i < buffer.size (); i += face_size)
+    {
+      EXPECT_EQ (faces.count (vector<uint32_t> (buffer.begin () + i, buffer.begin () + i + face_size)), 1u);
+      if (i > 0)
+        EXPECT_LE (buffer[i - face_size] / width, buffer[i] / width);
+    }
+  }
+}
+
+/* ---[ */
+int
+  main (int argc, char** argv)
+{
+  // A small scan of a curved surface, sampled on a jittered grid
+  srand (0);
+  const int n = 60;
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      PointNormal p;
+      p.x = (i + 0.2f * (rand () / (float)RAND_MAX - 0.5f)) / n;
+      p.y = (j + 0.2f * (rand () / (float)RAND_MAX - 0.5f)) / n;
+      p.z = 0.1f * sin (3 * p.x) * cos (3 * p.y);
+      Eigen::Vector3f normal (-0.3f * cos (3 * p.x) * cos (3 * p.y), 0.3f * sin (3 * p.x) * sin (3 * p.y), 1);
+      normal.normalize ();
+      p.normal_x = normal[0];
+      p.normal_y = normal[1];
+      p.normal_z = normal[2];
+      scan->points.push_back (p);
+    }
+  }
+  scan->width = scan->points.size ();
+  scan->height = 1;
+  scan->is_dense = true;
+
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */